@@ -16,3 +16,26 @@ foreach (config IN LISTS CMAKE_CONFIGURATION_TYPES)
     PROPERTIES
       COMPILE_DEFINITIONS_${upper_config} "${config_defines}")
 endforeach ()
+
+# The lowest log level which is compiled in. Messages below it cost nothing,
+# even when enabled at runtime.
+set(sprokit_log_levels
+  trace
+  debug
+  info
+  warn
+  error)
+set(SPROKIT_LOG_MIN_LEVEL "debug"
+  CACHE STRING "The lowest log level to compile in (trace, debug, info, warn, or error)")
+set_property(CACHE SPROKIT_LOG_MIN_LEVEL
+  PROPERTY
+    STRINGS ${sprokit_log_levels})
+mark_as_advanced(SPROKIT_LOG_MIN_LEVEL)
+
+list(FIND sprokit_log_levels "${SPROKIT_LOG_MIN_LEVEL}" sprokit_log_min_level)
+
+if (sprokit_log_min_level LESS 0)
+  message(FATAL_ERROR "Unknown log level: ${SPROKIT_LOG_MIN_LEVEL}")
+endif ()
+
+add_definitions("-DSPROKIT_LOG_MIN_LEVEL=${sprokit_log_min_level}")
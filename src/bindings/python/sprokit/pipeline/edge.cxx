@@ -77,6 +77,14 @@ BOOST_PYTHON_MODULE(edge)
       , "Returns True if the edge cannot hold anymore data, False otherwise.")
     .def("datum_count", &sprokit::edge::datum_count
       , "Returns the number of data packets within the edge.")
+    .def("dropped_count", &sprokit::edge::dropped_count
+      , "Returns the number of data packets dropped by the policy of the edge.")
+    .def("pushed_count", &sprokit::edge::pushed_count
+      , "Returns the number of data packets pushed into the edge.")
+    .def("popped_count", &sprokit::edge::popped_count
+      , "Returns the number of data packets taken out of the edge.")
+    .def("spilled_count", &sprokit::edge::spilled_count
+      , "Returns the number of data packets held on disk by the edge.")
     .def("push_datum", &sprokit::edge::push_datum
       , (arg("datum"))
       , "Pushes a datum packet into the edge.")
@@ -99,5 +107,9 @@ BOOST_PYTHON_MODULE(edge)
       , "Returns True if the downstream process is complete, False otherwise.")
     .def_readonly("config_dependency", &sprokit::edge::config_dependency)
     .def_readonly("config_capacity", &sprokit::edge::config_capacity)
+    .def_readonly("config_policy", &sprokit::edge::config_policy)
+    .def_readonly("config_spill_after", &sprokit::edge::config_spill_after)
+    .def_readonly("config_spill_dir", &sprokit::edge::config_spill_dir)
+    .def_readonly("config_type", &sprokit::edge::config_type)
   ;
 }
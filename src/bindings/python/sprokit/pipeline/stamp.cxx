@@ -52,6 +52,9 @@ using namespace boost::python;
 
 static bool stamp_eq(sprokit::stamp_t const& self, sprokit::stamp_t const& other);
 static bool stamp_lt(sprokit::stamp_t const& self, sprokit::stamp_t const& other);
+static bool stamp_has_origin(sprokit::stamp_t const& self);
+static sprokit::stamp::origin_t stamp_origin(sprokit::stamp_t const& self);
+static sprokit::stamp::stream_t stamp_stream(sprokit::stamp_t const& self);
 
 BOOST_PYTHON_MODULE(stamp)
 {
@@ -60,12 +63,26 @@ BOOST_PYTHON_MODULE(stamp)
   def("incremented_stamp", &sprokit::stamp::incremented_stamp
     , (arg("stamp"))
     , "Creates a stamp that is greater than the given stamp.");
+  def("origin_stamp", &sprokit::stamp::origin_stamp
+    , (arg("stamp"), arg("origin"))
+    , "Creates a copy of the given stamp with an origin.");
+  def("stream_stamp", &sprokit::stamp::stream_stamp
+    , (arg("stamp"), arg("stream"))
+    , "Creates a copy of the given stamp in another stream.");
+  def("now", &sprokit::stamp::now
+    , "The current time on the clock used for origins.");
 
   class_<sprokit::stamp_t>("Stamp"
     , "An identifier to help synchronize data within the pipeline."
     , no_init)
     .def("__eq__", stamp_eq)
     .def("__lt__", stamp_lt)
+    .def("has_origin", stamp_has_origin
+      , "Whether the stamp has an origin or not.")
+    .def("origin", stamp_origin
+      , "The origin of the stamp.")
+    .def("stream", stamp_stream
+      , "The stream the stamp is part of.")
   ;
 
   // Equivalent to:
@@ -94,3 +111,21 @@ stamp_lt(sprokit::stamp_t const& self, sprokit::stamp_t const& other)
 {
   return (*self < *other);
 }
+
+bool
+stamp_has_origin(sprokit::stamp_t const& self)
+{
+  return self->has_origin();
+}
+
+sprokit::stamp::origin_t
+stamp_origin(sprokit::stamp_t const& self)
+{
+  return self->origin();
+}
+
+sprokit::stamp::stream_t
+stamp_stream(sprokit::stamp_t const& self)
+{
+  return self->stream();
+}
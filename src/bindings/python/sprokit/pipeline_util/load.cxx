@@ -125,6 +125,7 @@ BOOST_PYTHON_MODULE(load)
     , "A block which declares a process.")
     .def_readwrite("name", &sprokit::process_pipe_block::name)
     .def_readwrite("type", &sprokit::process_pipe_block::type)
+    .def_readwrite("node", &sprokit::process_pipe_block::node)
     .def_readwrite("config_values", &sprokit::process_pipe_block::config_values)
   ;
   class_<sprokit::connect_pipe_block>("ConnectBlock"
@@ -39,17 +39,25 @@
 #include <sprokit/pipeline_util/pipe_bakery.h>
 #include <sprokit/pipeline_util/pipe_bakery_exception.h>
 
+#include <sprokit/pipeline/log.h>
 #include <sprokit/pipeline/process_registry.h>
 #include <sprokit/pipeline/process_registry_exception.h>
 #include <sprokit/pipeline/utils.h>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
+#include <boost/make_shared.hpp>
 
 #include <algorithm>
-#include <iostream>
+#include <string>
+#include <vector>
 
 /**
  * \file clusters/registration.cxx
@@ -68,13 +76,70 @@ typedef std::wstring cluster_path_t;
 typedef std::string cluster_path_t;
 #endif
 
+typedef std::vector<path_t> cluster_files_t;
+
+// Bakes a cluster file the first time a process of its type is created.
+class lazy_cluster
+{
+  public:
+    lazy_cluster(path_t const& path);
+    ~lazy_cluster();
+
+    process_t operator () (config_t const& config) const;
+  private:
+    class state
+    {
+      public:
+        state(path_t const& path_);
+        ~state();
+
+        path_t const path;
+
+        boost::mutex mut;
+        cluster_info_t info;
+    };
+
+    boost::shared_ptr<state> s;
+};
+
+// Bakes a set of cluster files using several threads.
+class parallel_baker
+{
+  public:
+    parallel_baker(cluster_files_t const& files_);
+    ~parallel_baker();
+
+    void run();
+
+    cluster_files_t const& files;
+
+    std::vector<cluster_info_t> infos;
+    std::vector<std::string> errors;
+  private:
+    void bake_files();
+
+    boost::mutex mut;
+    size_t next;
+};
+
 }
 
 static cluster_path_t const default_include_dirs = cluster_path_t(DEFAULT_CLUSTER_PATHS);
 static envvar_name_t const sprokit_include_envvar = envvar_name_t("SPROKIT_CLUSTER_PATH");
+static envvar_name_t const sprokit_bake_envvar = envvar_name_t("SPROKIT_CLUSTER_BAKE");
 static std::string const pipe_suffix = std::string(".cluster");
+static std::string const bake_eager = std::string("eager");
+static std::string const bake_parallel = std::string("parallel");
+static std::string const cluster_header = std::string("cluster");
+static std::string const description_header = std::string(":#");
+
+static logger const clusters_log("clusters");
 
 static bool is_separator(cluster_path_t::value_type ch);
+static bool scan_cluster_header(path_t const& path, process::type_t& type, process_registry::description_t& desc);
+static cluster_info_t bake_cluster_file(path_t const& path, std::string& error);
+static void register_cluster(process_registry_t const& registry, process::type_t const& type,
+                             process_registry::description_t const& desc, process_ctor_t const& ctor);
 
 void
 register_processes()
@@ -88,9 +153,6 @@ register_processes()
     return;
   }
 
-  process::types_t const current_types = registry->types();
-  process::types_t new_types;
-
   typedef path_t include_path_t;
   typedef std::vector<include_path_t> include_paths_t;
 
@@ -114,21 +176,21 @@ register_processes()
     include_dirs.insert(include_dirs.end(), include_dirs_tmp.begin(), include_dirs_tmp.end());
   }
 
+  cluster_files_t files;
+
   BOOST_FOREACH (include_path_t const& include_dir, include_dirs)
   {
-    // log file
-    std::cerr << "DEBUG - loading clusters from directory: " << include_dir << std::endl;
+    SPROKIT_LOG_DEBUG(clusters_log, "Loading clusters from directory: " << include_dir);
+
     if (!boost::filesystem::exists(include_dir))
     {
-      /// \todo Log error that path doesn't exist.
-      std::cerr << "DEBUG - Path not found loading clusters: " << include_dir << std::endl;
+      SPROKIT_LOG_DEBUG(clusters_log, "Path not found loading clusters: " << include_dir);
       continue;
     }
 
     if (!boost::filesystem::is_directory(include_dir))
     {
-      /// \todo Log error that path isn't a directory.
-      std::cerr << "ERROR - Path not directory loading clusters: " << include_dir << std::endl;
+      SPROKIT_LOG_ERROR(clusters_log, "Path not directory loading clusters: " << include_dir);
       continue;
     }
 
@@ -151,51 +213,68 @@ register_processes()
         continue;
       }
 
-      // log loading file
-      std::cerr << "DEBUG - Loading cluster from file: " << pstr << std::endl;
-
       if (ent.status().type() != boost::filesystem::regular_file)
       {
-        /// \todo Log warning that we found a non-file matching path.
-        std::cerr << "WARNING - found non file loading clusters: \n";
+        SPROKIT_LOG_WARN(clusters_log, "Found non file loading clusters: " << path);
         continue;
       }
 
-      cluster_info_t info;
+      files.push_back(path);
+    }
+  }
+
+  envvar_value_t const bake_mode = get_envvar(sprokit_bake_envvar);
+
+  if (bake_mode && (*bake_mode == bake_parallel))
+  {
+    parallel_baker baker(files);
+
+    baker.run();
 
-      try
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+      cluster_info_t const& info = baker.infos[i];
+
+      if (!info)
       {
-        info = bake_cluster_from_file(path);
+        SPROKIT_LOG_ERROR(clusters_log, "Exception caught loading cluster: " << baker.errors[i]);
+        continue;
       }
-      catch (load_pipe_exception const& e)
+
+      register_cluster(registry, info->type, info->description, info->ctor);
+    }
+  }
+  else
+  {
+    bool const eager = (bake_mode && (*bake_mode == bake_eager));
+
+    BOOST_FOREACH (path_t const& path, files)
+    {
+      SPROKIT_LOG_DEBUG(clusters_log, "Loading cluster from file: " << path);
+
+      process::type_t type;
+      process_registry::description_t desc;
+
+      // Only the header of the file is needed to know which type it provides;
+      // the full bake is deferred until the type is used.
+      if (!eager && scan_cluster_header(path, type, desc))
       {
-        /// \todo Handle exceptions.
-        std::cerr << "ERROR - exception caught loading cluster: " << e.what() << std::endl;
+        register_cluster(registry, type, desc, lazy_cluster(path));
+
         continue;
       }
-      catch (pipe_bakery_exception const& e)
+
+      std::string error;
+      cluster_info_t const info = bake_cluster_file(path, error);
+
+      if (!info)
       {
         /// \todo Handle exceptions.
-        std::cerr << "ERROR - exception caught loading cluster: " << e.what() << std::endl;
+        SPROKIT_LOG_ERROR(clusters_log, "Exception caught loading cluster: " << error);
         continue;
       }
 
-      if (info)
-      {
-        process::type_t const& type = info->type;
-        process_registry::description_t const& description = info->description;
-        process_ctor_t const& ctor = info->ctor;
-
-        try
-        {
-          registry->register_process(type, description, ctor);
-        }
-        catch (process_type_already_exists_exception const& e)
-        {
-          /// \todo Print out exception.
-          std::cerr << "ERROR - exception caught loading cluster: " << e.what() << std::endl;
-        }
-      }
+      register_cluster(registry, info->type, info->description, info->ctor);
     }
   }
 
@@ -214,3 +293,210 @@ is_separator(cluster_path_t::value_type ch)
 
   return (ch == separator);
 }
+
+bool
+scan_cluster_header(path_t const& path, process::type_t& type, process_registry::description_t& desc)
+{
+  boost::filesystem::ifstream fin(path);
+
+  if (!fin.good())
+  {
+    return false;
+  }
+
+  std::string line;
+  bool have_type = false;
+
+  while (std::getline(fin, line))
+  {
+    boost::trim(line);
+
+    if (line.empty() || boost::starts_with(line, "#"))
+    {
+      continue;
+    }
+
+    if (!have_type)
+    {
+      // Anything else (e.g., an include) needs the full parse.
+      if (!boost::starts_with(line, cluster_header + " "))
+      {
+        return false;
+      }
+
+      type = boost::trim_copy(line.substr(cluster_header.size()));
+      have_type = !type.empty();
+
+      if (!have_type)
+      {
+        return false;
+      }
+
+      continue;
+    }
+
+    if (!boost::starts_with(line, description_header + " "))
+    {
+      return false;
+    }
+
+    desc = boost::trim_copy(line.substr(description_header.size()));
+
+    return !desc.empty();
+  }
+
+  return false;
+}
+
+cluster_info_t
+bake_cluster_file(path_t const& path, std::string& error)
+{
+  try
+  {
+    return bake_cluster_from_file(path);
+  }
+  catch (load_pipe_exception const& e)
+  {
+    error = e.what();
+  }
+  catch (pipe_bakery_exception const& e)
+  {
+    error = e.what();
+  }
+
+  return cluster_info_t();
+}
+
+void
+register_cluster(process_registry_t const& registry, process::type_t const& type,
+                 process_registry::description_t const& desc, process_ctor_t const& ctor)
+{
+  try
+  {
+    registry->register_process(type, desc, ctor);
+  }
+  catch (process_type_already_exists_exception const& e)
+  {
+    SPROKIT_LOG_ERROR(clusters_log, "Exception caught loading cluster: " << e.what());
+  }
+}
+
+namespace
+{
+
+lazy_cluster
+::lazy_cluster(path_t const& path)
+  : s(boost::make_shared<state>(path))
+{
+}
+
+lazy_cluster
+::~lazy_cluster()
+{
+}
+
+process_t
+lazy_cluster
+::operator () (config_t const& config) const
+{
+  cluster_info_t info;
+
+  {
+    boost::mutex::scoped_lock const lock(s->mut);
+
+    (void)lock;
+
+    if (!s->info)
+    {
+      // Errors are reported to the code creating the process.
+      s->info = bake_cluster_from_file(s->path);
+    }
+
+    info = s->info;
+  }
+
+  if (!info)
+  {
+    return process_t();
+  }
+
+  return info->ctor(config);
+}
+
+lazy_cluster::state
+::state(path_t const& path_)
+  : path(path_)
+  , mut()
+  , info()
+{
+}
+
+lazy_cluster::state
+::~state()
+{
+}
+
+parallel_baker
+::parallel_baker(cluster_files_t const& files_)
+  : files(files_)
+  , infos(files_.size())
+  , errors(files_.size())
+  , mut()
+  , next(0)
+{
+}
+
+parallel_baker
+::~parallel_baker()
+{
+}
+
+void
+parallel_baker
+::run()
+{
+  size_t const num_threads = std::min(size_t(boost::thread::hardware_concurrency()), files.size());
+
+  if (num_threads < 2)
+  {
+    bake_files();
+
+    return;
+  }
+
+  boost::thread_group threads;
+
+  for (size_t i = 0; i < num_threads; ++i)
+  {
+    threads.create_thread(boost::bind(&parallel_baker::bake_files, this));
+  }
+
+  threads.join_all();
+}
+
+void
+parallel_baker
+::bake_files()
+{
+  while (true)
+  {
+    size_t i;
+
+    {
+      boost::mutex::scoped_lock const lock(mut);
+
+      (void)lock;
+
+      if (next == files.size())
+      {
+        return;
+      }
+
+      i = next++;
+    }
+
+    infos[i] = bake_cluster_file(files[i], errors[i]);
+  }
+}
+
+}
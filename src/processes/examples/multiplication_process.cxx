@@ -32,6 +32,8 @@
 
 #include <boost/cstdint.hpp>
 
+#include <vector>
+
 /**
  * \file multiplication_process.cxx
  *
@@ -103,6 +105,45 @@ ::_step()
   process::_step();
 }
 
+void
+multiplication_process
+::_step_batch(size_t n)
+{
+  std::vector<priv::number_t> factor1(n);
+  std::vector<priv::number_t> factor2(n);
+  std::vector<priv::number_t> product(n);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    factor1[i] = grab_from_port_as<priv::number_t>(priv::port_factor1);
+    factor2[i] = grab_from_port_as<priv::number_t>(priv::port_factor2);
+  }
+
+  // Keep the arithmetic in its own loop so that it may be vectorized.
+  for (size_t i = 0; i < n; ++i)
+  {
+    product[i] = factor1[i] * factor2[i];
+  }
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    push_to_port_as<priv::number_t>(priv::port_output, product[i]);
+  }
+
+  process::_step();
+}
+
+process::properties_t
+multiplication_process
+::_properties() const
+{
+  properties_t consts = process::_properties();
+
+  consts.insert(property_batch);
+
+  return consts;
+}
+
 multiplication_process::priv
 ::priv()
 {
@@ -87,6 +87,18 @@ class SPROKIT_PROCESSES_EXAMPLES_NO_EXPORT multiplication_process
      * \brief Step the process.
      */
     void _step();
+
+    /**
+     * \brief Step the process over a batch of inputs.
+     *
+     * \param n The number of sets of inputs to process.
+     */
+    void _step_batch(size_t n);
+
+    /**
+     * \brief The properties on the process.
+     */
+    properties_t _properties() const;
   private:
     class priv;
     boost::scoped_ptr<priv> d;
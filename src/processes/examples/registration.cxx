@@ -52,8 +52,11 @@
 #include "take_string_process.h"
 #include "tunable_process.h"
 
+#include <sprokit/pipeline/datum_codec.h>
 #include <sprokit/pipeline/process_registry.h>
 
+#include <boost/cstdint.hpp>
+
 /**
  * \file examples/registration.cxx
  *
@@ -96,5 +99,8 @@ register_processes()
   registry->register_process("take_string", "Print strings to a file", create_process<take_string_process>);
   registry->register_process("tunable", "A process with a tunable parameter", create_process<tunable_process>);
 
+  // Numbers may be sent between partitions.
+  datum_codec::register_pod_codec<int32_t>(process::port_type_t("integer"));
+
   registry->mark_module_as_loaded(module_name);
 }
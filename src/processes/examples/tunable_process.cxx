@@ -125,6 +125,12 @@ ::_step()
 
   mark_process_as_complete();
 
+  // Let downstream processes finish as well.
+  datum_t const dat = datum::complete_datum();
+
+  push_datum_to_port(priv::port_tunable, dat);
+  push_datum_to_port(priv::port_non_tunable, dat);
+
   process::_step();
 }
 
@@ -38,6 +38,7 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
 #include <map>
 #include <string>
 
@@ -214,9 +215,11 @@ ::_step()
 
     datum::type_t const status_type = status_dat->type();
 
-    bool const is_complete = (status_type == datum::complete);
+    // The end of any other stream arrives on every input like a flush; only
+    // the end of the default stream ends the tag.
+    bool const is_complete = is_final_complete(status_edat);
 
-    if (is_complete || (status_type == datum::flush))
+    if ((status_type == datum::complete) || (status_type == datum::flush))
     {
       push_to_port(output_port, status_edat);
 
@@ -228,9 +231,10 @@ ::_step()
       if (is_complete)
       {
         complete_ports.push_back(tag);
-
-        continue;
       }
+
+      // Every input had the datum, so it was not anyone's turn.
+      continue;
     }
     else
     {
@@ -308,7 +312,11 @@ ::_input_port_info(port_t const& port)
   {
     priv::tag_info& info = d->tag_data[tag];
 
-    info.ports.push_back(port);
+    // Port information may be asked for more than once.
+    if (std::find(info.ports.begin(), info.ports.end(), port) == info.ports.end())
+    {
+      info.ports.push_back(port);
+    }
 
     port_flags_t required;
 
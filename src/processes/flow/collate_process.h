@@ -58,6 +58,10 @@ namespace sprokit
  *
  * \process Collate incoming data into a single stream.
  *
+ * Data is collated in turn without regard to its stream, keeping its stamp.
+ * The end of a stream other than the default stream must arrive on every
+ * input, as \ref distribute_process sends it.
+ *
  * \iports
  *
  * \iport{status/\portvar{tag}} The status of the result \portvar{tag}.
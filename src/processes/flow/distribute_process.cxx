@@ -38,6 +38,7 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
 #include <map>
 #include <string>
 
@@ -219,9 +220,11 @@ ::_step()
 
     datum::type_t const src_type = src_dat->type();
 
-    bool const is_complete = (src_type == datum::complete);
+    // The end of any other stream is passed to every output like a flush;
+    // only the end of the default stream ends the tag.
+    bool const is_complete = is_final_complete(src_edat);
 
-    if (is_complete || (src_type == datum::flush))
+    if ((src_type == datum::complete) || (src_type == datum::flush))
     {
       push_to_port(status_port, src_edat);
 
@@ -233,9 +236,11 @@ ::_step()
       if (is_complete)
       {
         complete_ports.push_back(tag);
-
-        continue;
       }
+
+      // Every output got the datum, so it is not anyone's turn. The pipeline
+      // broadcasts these the same way before a step.
+      continue;
     }
     else
     {
@@ -315,7 +320,11 @@ ::_output_port_info(port_t const& port)
     port_t const group = d->group_for_dist_port(port);
     priv::tag_info& info = d->tag_data[tag];
 
-    info.ports.push_back(port);
+    // Port information may be asked for more than once.
+    if (std::find(info.ports.begin(), info.ports.end(), port) == info.ports.end())
+    {
+      info.ports.push_back(port);
+    }
 
     port_flags_t required;
 
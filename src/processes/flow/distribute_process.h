@@ -58,6 +58,10 @@ namespace sprokit
  *
  * \process Distribute input data among many output processes.
  *
+ * Data is distributed in turn without regard to its stream, keeping its
+ * stamp. The end of a stream other than the default stream is sent to every
+ * output like a flush.
+ *
  * \iports
  *
  * \iport{src/\portvar{tag}} The source input \portvar{tag}.
@@ -93,8 +93,9 @@ void
 pass_process
 ::_step()
 {
-  datum_t const dat = grab_datum_from_port(priv::port_input);
-  bool const complete = (dat->type() == datum::complete);
+  edge_datum_t const edat = grab_from_port(priv::port_input);
+  datum_t const& dat = edat.datum;
+  bool const complete = is_final_complete(edat);
 
   push_datum_to_port(priv::port_output, dat);
 
@@ -30,8 +30,23 @@
 
 #include "sink_process.h"
 
+#include <sprokit/pipeline_util/path.h>
+
+#include <sprokit/pipeline/config.h>
 #include <sprokit/pipeline/datum.h>
 #include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/process_exception.h>
+#include <sprokit/pipeline/stamp.h>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
 
 /**
  * \file sink_process.cxx
@@ -42,22 +57,78 @@
 namespace sprokit
 {
 
+namespace
+{
+
+// Latencies are counted in buckets so that the memory used does not depend on
+// how long the pipeline runs. Each power of two nanoseconds is split into
+// sub_count linear buckets, so a reported quantile is at most 1/sub_count
+// (12.5%) above the true value.
+class latency_histogram
+{
+  public:
+    typedef stamp::origin_t latency_t;
+    typedef uint64_t count_t;
+
+    latency_histogram();
+    ~latency_histogram();
+
+    void add(latency_t latency);
+
+    latency_t quantile(double q) const;
+
+    void write(std::ostream& ostr, process::port_t const& port) const;
+
+    static size_t const sub_bits;
+    static size_t const sub_count;
+    static size_t const num_buckets;
+
+    static size_t bucket_for(latency_t latency);
+    static latency_t bucket_limit(size_t bucket);
+
+    std::vector<count_t> buckets;
+    count_t count;
+    latency_t min;
+    latency_t max;
+};
+
+}
+
 class sink_process::priv
 {
   public:
-    priv();
+    priv(path_t const& output_path);
     ~priv();
 
+    void write_latencies();
+
+    path_t const path;
+
+    boost::filesystem::ofstream fout;
+
+    latency_histogram latencies;
+
+    static config::key_t const config_latency_output;
     static port_t const port_input;
 };
 
+config::key_t const sink_process::priv::config_latency_output = config::key_t("latency_output");
 process::port_t const sink_process::priv::port_input = port_t("sink");
 
 sink_process
 ::sink_process(config_t const& config)
   : process(config)
-  , d(new priv)
+  , d()
 {
+  // The end of the stream is handled by the process.
+  set_data_checking_level(check_sync);
+
+  declare_configuration_key(
+    priv::config_latency_output,
+    config::value_t(),
+    config::description_t("The path of the file to write end-to-end latencies to. "
+                          "Latencies are not recorded if it is empty."));
+
   port_flags_t required;
 
   required.insert(flag_required);
@@ -74,17 +145,112 @@ sink_process
 {
 }
 
+void
+sink_process
+::_configure()
+{
+  // Configure the process.
+  {
+    // An empty path cannot be cast directly.
+    config::value_t const path = config_value<config::value_t>(priv::config_latency_output);
+
+    d.reset(new priv(path_t(path)));
+  }
+
+  if (!d->path.empty())
+  {
+    d->fout.open(d->path);
+
+    if (!d->fout.good())
+    {
+      std::string const file_path = d->path.string<std::string>();
+      std::string const reason = "Failed to open the path: " + file_path;
+
+      throw invalid_configuration_exception(name(), reason);
+    }
+  }
+
+  process::_configure();
+}
+
 void
 sink_process
 ::_step()
 {
-  (void)grab_from_port(priv::port_input);
+  edge_datum_t const edat = grab_from_port(priv::port_input);
+  datum_t const& dat = edat.datum;
+  stamp_t const& st = edat.stamp;
+
+  bool const complete = is_final_complete(edat);
+
+  if (complete)
+  {
+    if (!d->path.empty())
+    {
+      d->write_latencies();
+    }
+
+    mark_process_as_complete();
+  }
+  else if (dat->type() == datum::complete)
+  {
+    // The end of a single stream.
+  }
+  else if (!d->path.empty() && st->has_origin())
+  {
+    stamp::origin_t const now = stamp::now();
+    stamp::origin_t const origin = st->origin();
+
+    d->latencies.add((origin < now) ? (now - origin) : 0);
+  }
 
   process::_step();
 }
 
+void
+sink_process
+::_step_batch(size_t n)
+{
+  // Batches only hold ordinary data, so there is no end of a stream to
+  // handle here.
+  edge_data_t const data = grab_batch_from_port(priv::port_input, n);
+
+  if (!d->path.empty())
+  {
+    stamp::origin_t const now = stamp::now();
+
+    BOOST_FOREACH (edge_datum_t const& edat, data)
+    {
+      stamp_t const& st = edat.stamp;
+
+      if (st->has_origin())
+      {
+        stamp::origin_t const origin = st->origin();
+
+        d->latencies.add((origin < now) ? (now - origin) : 0);
+      }
+    }
+  }
+
+  process::_step();
+}
+
+process::properties_t
+sink_process
+::_properties() const
+{
+  properties_t consts = process::_properties();
+
+  consts.insert(property_batch);
+
+  return consts;
+}
+
 sink_process::priv
-::priv()
+::priv(path_t const& output_path)
+  : path(output_path)
+  , fout()
+  , latencies()
 {
 }
 
@@ -93,4 +259,136 @@ sink_process::priv
 {
 }
 
+void
+sink_process::priv
+::write_latencies()
+{
+  latencies.write(fout, port_input);
+
+  fout.close();
+}
+
+size_t const latency_histogram::sub_bits = 3;
+size_t const latency_histogram::sub_count = size_t(1) << sub_bits;
+// Values below sub_count get a bucket each; every higher power of two gets
+// sub_count buckets.
+size_t const latency_histogram::num_buckets = (std::numeric_limits<latency_t>::digits - sub_bits + 1) * sub_count;
+
+latency_histogram
+::latency_histogram()
+  : buckets(num_buckets, 0)
+  , count(0)
+  , min(std::numeric_limits<latency_t>::max())
+  , max(0)
+{
+}
+
+latency_histogram
+::~latency_histogram()
+{
+}
+
+void
+latency_histogram
+::add(latency_t latency)
+{
+  ++buckets[bucket_for(latency)];
+  ++count;
+
+  min = std::min(min, latency);
+  max = std::max(max, latency);
+}
+
+latency_histogram::latency_t
+latency_histogram
+::quantile(double q) const
+{
+  // The rank of the sample at the quantile, counting from one.
+  count_t const rank = std::max(count_t(1), count_t(q * count + 0.5));
+  count_t seen = 0;
+
+  for (size_t i = 0; i < num_buckets; ++i)
+  {
+    seen += buckets[i];
+
+    if (rank <= seen)
+    {
+      return std::min(max, bucket_limit(i));
+    }
+  }
+
+  return max;
+}
+
+void
+latency_histogram
+::write(std::ostream& ostr, process::port_t const& port) const
+{
+  ostr << "# port count min_ns p50_ns p90_ns p99_ns max_ns" << std::endl;
+
+  ostr << port << " " << count;
+
+  if (count)
+  {
+    ostr << " " << min
+         << " " << quantile(0.50)
+         << " " << quantile(0.90)
+         << " " << quantile(0.99)
+         << " " << max;
+  }
+
+  ostr << std::endl;
+
+  ostr << "# port bucket_limit_ns count" << std::endl;
+
+  for (size_t i = 0; i < num_buckets; ++i)
+  {
+    if (buckets[i])
+    {
+      ostr << port << " " << bucket_limit(i) << " " << buckets[i] << std::endl;
+    }
+  }
+}
+
+size_t
+latency_histogram
+::bucket_for(latency_t latency)
+{
+  if (latency < sub_count)
+  {
+    return size_t(latency);
+  }
+
+  size_t msb = 0;
+
+  for (latency_t rest = latency; rest >>= 1; )
+  {
+    ++msb;
+  }
+
+  // The top sub_bits + 1 bits pick the bucket within the power of two.
+  size_t const shift = msb - sub_bits;
+  size_t const top = size_t(latency >> shift);
+
+  return ((shift + 1) * sub_count) + (top - sub_count);
+}
+
+latency_histogram::latency_t
+latency_histogram
+::bucket_limit(size_t bucket)
+{
+  if (bucket < sub_count)
+  {
+    return latency_t(bucket);
+  }
+
+  size_t const shift = (bucket / sub_count) - 1;
+  latency_t const top = latency_t(sub_count + (bucket % sub_count));
+  latency_t const width = latency_t(1) << shift;
+
+  // The largest latency in the bucket; this does not overflow for the last
+  // bucket since it ends at the largest representable latency.
+  return (top << shift) + (width - 1);
+}
+
 }
@@ -57,6 +57,14 @@ namespace sprokit
  *
  * \iport{sink} The data to ignore.
  *
+ * \configs
+ *
+ * \config{latency_output} Where to write end-to-end latencies of the data.
+ * When the stream completes, the count, minimum, p50, p90, p99 and maximum
+ * latencies (in nanoseconds) are written followed by a histogram. The
+ * histogram has eight buckets per power of two, so quantiles are reported
+ * as the top of their bucket: at most 12.5% above the true value.
+ *
  * \reqs
  *
  * \req The \port{sink} port must be connected.
@@ -78,10 +86,27 @@ class SPROKIT_PROCESSES_FLOW_NO_EXPORT sink_process
      */
     ~sink_process();
   protected:
+    /**
+     * \brief Configure the process.
+     */
+    void _configure();
+
     /**
      * \brief Step the process.
      */
     void _step();
+
+    /**
+     * \brief Step the process over a batch of inputs.
+     *
+     * \param n The number of data to ignore.
+     */
+    void _step_batch(size_t n);
+
+    /**
+     * \brief The properties on the process.
+     */
+    properties_t _properties() const;
   private:
     class priv;
     boost::scoped_ptr<priv> d;
@@ -0,0 +1,461 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "async_writer.h"
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * \file async_writer.cxx
+ *
+ * \brief Implementation of a file writer with its own I/O thread.
+ */
+
+namespace sprokit
+{
+
+class async_writer::priv
+{
+  public:
+    typedef std::deque<buffer_t> queue_t;
+    typedef boost::mutex mutex_t;
+    typedef boost::unique_lock<mutex_t> lock_t;
+
+    priv(std::string const& path_, size_t queue_size_, sync_t sync_);
+    ~priv();
+
+    void run();
+
+    // Returns an empty string on success.
+    std::string write_buffers(queue_t const& buffers);
+    std::string sync_file();
+
+    void check_error() const;
+
+    std::string const path;
+    size_t const queue_size;
+    sync_t const sync;
+
+    int fd;
+
+    mutex_t mut;
+    boost::condition_variable cond_queued;
+    boost::condition_variable cond_written;
+
+    queue_t queue;
+    queue_t spare;
+    bool writing;
+    bool stopping;
+    std::string error;
+
+    boost::scoped_ptr<boost::thread> thread;
+};
+
+async_writer
+::async_writer(std::string const& path, bool append, size_t queue_size, sync_t sync)
+  : d(new priv(path, queue_size, sync))
+{
+  int const flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+
+  d->fd = open(path.c_str(), flags, 0666);
+
+  if (d->fd < 0)
+  {
+    throw std::runtime_error("Failed to open \'" + path + "\': " + strerror(errno));
+  }
+
+  if (queue_size)
+  {
+    d->thread.reset(new boost::thread(boost::bind(&priv::run, d.get())));
+  }
+}
+
+async_writer
+::~async_writer()
+{
+  // Whatever is queued is written out on a best-effort basis.
+  try
+  {
+    close();
+  }
+  catch (std::runtime_error const&)
+  {
+  }
+}
+
+void
+async_writer
+::write(buffer_t& buffer)
+{
+  if (buffer.empty())
+  {
+    return;
+  }
+
+  if (!d->thread)
+  {
+    d->check_error();
+
+    priv::queue_t buffers(1);
+
+    buffers.back().swap(buffer);
+
+    std::string const err = d->write_buffers(buffers);
+
+    if (err.empty() && (d->sync == sync_always))
+    {
+      d->error = d->sync_file();
+    }
+    else
+    {
+      d->error = err;
+    }
+
+    // Keep the allocation for the next buffer.
+    buffer.swap(buffers.back());
+    buffer.clear();
+
+    d->check_error();
+
+    return;
+  }
+
+  priv::lock_t lock(d->mut);
+
+  while ((d->queue_size <= d->queue.size()) && d->error.empty())
+  {
+    d->cond_written.wait(lock);
+  }
+
+  d->check_error();
+
+  d->queue.push_back(buffer_t());
+  d->queue.back().swap(buffer);
+
+  if (!d->spare.empty())
+  {
+    buffer.swap(d->spare.back());
+    d->spare.pop_back();
+  }
+
+  d->cond_queued.notify_one();
+}
+
+void
+async_writer
+::barrier()
+{
+  if (d->fd < 0)
+  {
+    return;
+  }
+
+  if (d->thread)
+  {
+    priv::lock_t lock(d->mut);
+
+    while ((!d->queue.empty() || d->writing) && d->error.empty())
+    {
+      d->cond_written.wait(lock);
+    }
+  }
+
+  // Only the caller queues buffers, so the I/O thread is idle now.
+  if (d->error.empty() && (d->sync == sync_barrier))
+  {
+    d->error = d->sync_file();
+  }
+
+  d->check_error();
+}
+
+void
+async_writer
+::close()
+{
+  if (d->fd < 0)
+  {
+    return;
+  }
+
+  std::string err;
+
+  try
+  {
+    barrier();
+  }
+  catch (std::runtime_error const& e)
+  {
+    err = e.what();
+  }
+
+  if (d->thread)
+  {
+    {
+      priv::lock_t const lock(d->mut);
+
+      (void)lock;
+
+      d->stopping = true;
+    }
+
+    d->cond_queued.notify_one();
+    d->thread->join();
+    d->thread.reset();
+  }
+
+  if ((::close(d->fd) < 0) && err.empty())
+  {
+    err = "Failed to close \'" + d->path + "\': " + strerror(errno);
+  }
+
+  d->fd = -1;
+
+  if (!err.empty())
+  {
+    throw std::runtime_error(err);
+  }
+}
+
+bool
+async_writer
+::sync_from_string(std::string const& str, sync_t& sync)
+{
+  if (str == "none")
+  {
+    sync = sync_none;
+  }
+  else if (str == "barrier")
+  {
+    sync = sync_barrier;
+  }
+  else if (str == "always")
+  {
+    sync = sync_always;
+  }
+  else
+  {
+    return false;
+  }
+
+  return true;
+}
+
+async_writer::priv
+::priv(std::string const& path_, size_t queue_size_, sync_t sync_)
+  : path(path_)
+  , queue_size(queue_size_)
+  , sync(sync_)
+  , fd(-1)
+  , mut()
+  , cond_queued()
+  , cond_written()
+  , queue()
+  , spare()
+  , writing(false)
+  , stopping(false)
+  , error()
+  , thread()
+{
+}
+
+async_writer::priv
+::~priv()
+{
+}
+
+void
+async_writer::priv
+::run()
+{
+  queue_t batch;
+
+  while (true)
+  {
+    bool failed;
+
+    {
+      lock_t lock(mut);
+
+      // Hand the buffers from the last batch back for reuse.
+      while (!batch.empty())
+      {
+        if (spare.size() < queue_size)
+        {
+          spare.push_back(buffer_t());
+          spare.back().swap(batch.front());
+          spare.back().clear();
+        }
+
+        batch.pop_front();
+      }
+
+      writing = false;
+
+      cond_written.notify_all();
+
+      while (queue.empty() && !stopping)
+      {
+        cond_queued.wait(lock);
+      }
+
+      if (queue.empty())
+      {
+        return;
+      }
+
+      // Take everything queued so that it is written together.
+      batch.swap(queue);
+      writing = true;
+      failed = !error.empty();
+
+      cond_written.notify_all();
+    }
+
+    std::string err;
+
+    // Nothing more is written after a failure; the queue is only drained.
+    if (!failed)
+    {
+      err = write_buffers(batch);
+
+      if (err.empty() && (sync == sync_always))
+      {
+        err = sync_file();
+      }
+    }
+
+    if (!err.empty())
+    {
+      lock_t const lock(mut);
+
+      (void)lock;
+
+      error = err;
+    }
+  }
+}
+
+std::string
+async_writer::priv
+::write_buffers(queue_t const& buffers)
+{
+  std::vector<iovec> iov;
+
+  BOOST_FOREACH (buffer_t const& buffer, buffers)
+  {
+    if (buffer.empty())
+    {
+      continue;
+    }
+
+    iovec vec;
+
+    vec.iov_base = const_cast<char*>(&buffer[0]);
+    vec.iov_len = buffer.size();
+
+    iov.push_back(vec);
+  }
+
+  size_t first = 0;
+
+  while (first < iov.size())
+  {
+    int const count = static_cast<int>(std::min(iov.size() - first, size_t(IOV_MAX)));
+    ssize_t written = writev(fd, &iov[first], count);
+
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      return "Failed to write to \'" + path + "\': " + strerror(errno);
+    }
+
+    // Skip past whatever was written; the last buffer may be partial.
+    while ((first < iov.size()) && (iov[first].iov_len <= size_t(written)))
+    {
+      written -= iov[first].iov_len;
+      ++first;
+    }
+
+    if (written)
+    {
+      iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + written;
+      iov[first].iov_len -= written;
+    }
+  }
+
+  return std::string();
+}
+
+std::string
+async_writer::priv
+::sync_file()
+{
+  if (fdatasync(fd) < 0)
+  {
+    return "Failed to synchronize \'" + path + "\': " + strerror(errno);
+  }
+
+  return std::string();
+}
+
+void
+async_writer::priv
+::check_error() const
+{
+  if (!error.empty())
+  {
+    throw std::runtime_error(error);
+  }
+}
+
+}
@@ -0,0 +1,140 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PROCESSES_TRANSPORT_ASYNC_WRITER_H
+#define SPROKIT_PROCESSES_TRANSPORT_ASYNC_WRITER_H
+
+#include "transport-config.h"
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+/**
+ * \file async_writer.h
+ *
+ * \brief Declaration of a file writer with its own I/O thread.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class async_writer
+ *
+ * \brief Writes buffers to a file from a dedicated thread.
+ *
+ * Buffers are handed to the I/O thread through a bounded queue so that the
+ * caller only blocks when the disk falls behind by more than the queue holds.
+ * Whatever is queued when the thread wakes up is written with as few calls as
+ * possible. Errors from the I/O thread are reported by the next call.
+ *
+ * With a queue size of zero, no thread is started and buffers are written by
+ * the caller.
+ */
+class SPROKIT_PROCESSES_TRANSPORT_NO_EXPORT async_writer
+  : boost::noncopyable
+{
+  public:
+    /// The type for a buffer of bytes.
+    typedef std::vector<char> buffer_t;
+
+    /// When data is synchronized to the disk.
+    typedef enum
+    {
+      /// Leave it to the operating system.
+      sync_none,
+      /// At each barrier.
+      sync_barrier,
+      /// After every write.
+      sync_always
+    } sync_t;
+
+    /**
+     * \brief Constructor.
+     *
+     * \throws std::runtime_error Thrown when the file cannot be opened.
+     *
+     * \param path The path of the file.
+     * \param append Whether to append to an existing file instead of replacing it.
+     * \param queue_size The number of buffers which may wait to be written.
+     * \param sync When to synchronize the file to the disk.
+     */
+    async_writer(std::string const& path, bool append, size_t queue_size, sync_t sync);
+    /**
+     * \brief Destructor.
+     *
+     * Queued buffers are still written, but errors are ignored; call \ref close to see them.
+     */
+    ~async_writer();
+
+    /**
+     * \brief Queue a buffer to be written.
+     *
+     * \throws std::runtime_error Thrown when an earlier write failed.
+     *
+     * \param buffer The buffer to write. It is replaced with an empty buffer
+     *               which may have been reused.
+     */
+    void write(buffer_t& buffer);
+    /**
+     * \brief Wait until everything queued has been written.
+     *
+     * \throws std::runtime_error Thrown when a write failed.
+     */
+    void barrier();
+    /**
+     * \brief Write everything queued and close the file.
+     *
+     * \throws std::runtime_error Thrown when a write failed.
+     */
+    void close();
+
+    /**
+     * \brief Parse a synchronization policy.
+     *
+     * \param str The name of the policy: \c none, \c barrier, or \c always.
+     * \param sync Set to the policy.
+     *
+     * \returns True if \p str names a policy, false otherwise.
+     */
+    static bool sync_from_string(std::string const& str, sync_t& sync);
+  private:
+    class priv;
+    boost::scoped_ptr<priv> d;
+};
+
+}
+
+#endif // SPROKIT_PROCESSES_TRANSPORT_ASYNC_WRITER_H
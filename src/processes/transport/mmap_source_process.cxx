@@ -0,0 +1,216 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mmap_source_process.h"
+
+#include "recording.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/process_exception.h>
+#include <sprokit/pipeline/record.h>
+
+#include <boost/cstdint.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include <cstring>
+
+/**
+ * \file mmap_source_process.cxx
+ *
+ * \brief Implementation of the memory-mapped record source process.
+ */
+
+namespace sprokit
+{
+
+class mmap_source_process::priv
+{
+  public:
+    typedef std::string path_t;
+    typedef uint32_t length_t;
+
+    priv(path_t const& path_, size_t record_size_);
+    ~priv();
+
+    path_t const path;
+    size_t const record_size;
+
+    mapped_file_t file;
+    size_t pos;
+
+    static config::key_t const config_path;
+    static config::key_t const config_record_size;
+    static port_type_t const type_record;
+    static port_t const port_output;
+};
+
+config::key_t const mmap_source_process::priv::config_path = config::key_t("path");
+config::key_t const mmap_source_process::priv::config_record_size = config::key_t("record_size");
+process::port_type_t const mmap_source_process::priv::type_record = port_type_t("record");
+process::port_t const mmap_source_process::priv::port_output = port_t("record");
+
+mmap_source_process
+::mmap_source_process(config_t const& config)
+  : process(config)
+  , d()
+{
+  declare_configuration_key(
+    priv::config_path,
+    config::value_t(),
+    config::description_t("The path of the file to read records from."));
+  declare_configuration_key(
+    priv::config_record_size,
+    config::value_t("0"),
+    config::description_t("The size of each record. If 0, each record is preceded "
+                          "by its size as a 32-bit integer in host order."));
+
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_output_port(
+    priv::port_output,
+    priv::type_record,
+    required,
+    port_description_t("The records in the file."));
+}
+
+mmap_source_process
+::~mmap_source_process()
+{
+}
+
+void
+mmap_source_process
+::_configure()
+{
+  // Configure the process.
+  {
+    priv::path_t const path = config_value<priv::path_t>(priv::config_path);
+    size_t const record_size = config_value<size_t>(priv::config_record_size);
+
+    d.reset(new priv(path, record_size));
+  }
+
+  if (d->path.empty())
+  {
+    static std::string const reason = "The path must not be empty";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  try
+  {
+    d->file.reset(new mapped_file(d->path));
+  }
+  catch (std::runtime_error const& e)
+  {
+    throw invalid_configuration_exception(name(), e.what());
+  }
+
+  if (d->record_size && (d->file->size() % d->record_size))
+  {
+    static std::string const reason = "The file does not hold a whole number of records";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  process::_configure();
+}
+
+void
+mmap_source_process
+::_step()
+{
+  char const* const data = d->file->data();
+  size_t const size = d->file->size();
+
+  if (d->pos == size)
+  {
+    mark_process_as_complete();
+
+    push_datum_to_port(priv::port_output, datum::complete_datum());
+
+    process::_step();
+
+    return;
+  }
+
+  size_t length = d->record_size;
+
+  if (!length)
+  {
+    priv::length_t prefix;
+
+    if (size - d->pos < sizeof(prefix))
+    {
+      throw std::runtime_error("The record file \'" + d->path + "\' ends within a record size");
+    }
+
+    // Records are not aligned within the file.
+    memcpy(&prefix, data + d->pos, sizeof(prefix));
+    d->pos += sizeof(prefix);
+
+    length = prefix;
+
+    if (size - d->pos < length)
+    {
+      throw std::runtime_error("The record file \'" + d->path + "\' ends within a record");
+    }
+  }
+
+  // The record holds the mapping open rather than copying out of it.
+  record const rec(data + d->pos, length, d->file);
+
+  d->pos += length;
+
+  push_datum_to_port(priv::port_output, datum::new_datum(rec));
+
+  process::_step();
+}
+
+mmap_source_process::priv
+::priv(path_t const& path_, size_t record_size_)
+  : path(path_)
+  , record_size(record_size_)
+  , file()
+  , pos(0)
+{
+}
+
+mmap_source_process::priv
+::~priv()
+{
+}
+
+}
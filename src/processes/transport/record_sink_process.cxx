@@ -0,0 +1,329 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "record_sink_process.h"
+
+#include "async_writer.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/process_exception.h>
+#include <sprokit/pipeline/record.h>
+
+#include <boost/cstdint.hpp>
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+/**
+ * \file record_sink_process.cxx
+ *
+ * \brief Implementation of the record sink process.
+ */
+
+namespace sprokit
+{
+
+class record_sink_process::priv
+{
+  public:
+    typedef std::string path_t;
+    typedef uint32_t length_t;
+    typedef async_writer::buffer_t buffer_t;
+
+    priv(path_t const& path_, size_t record_size_, size_t buffer_size_, bool append_,
+         size_t queue_size_, async_writer::sync_t sync_);
+    ~priv();
+
+    void add(char const* data, size_t size);
+    void hand_off();
+
+    path_t const path;
+    size_t const record_size;
+    size_t const buffer_size;
+    bool const append;
+    size_t const queue_size;
+    async_writer::sync_t const sync;
+
+    boost::scoped_ptr<async_writer> writer;
+    buffer_t buffer;
+
+    static config::key_t const config_path;
+    static config::key_t const config_record_size;
+    static config::key_t const config_buffer_size;
+    static config::key_t const config_append;
+    static config::key_t const config_queue_size;
+    static config::key_t const config_sync;
+    static port_type_t const type_record;
+    static port_t const port_input;
+};
+
+config::key_t const record_sink_process::priv::config_path = config::key_t("path");
+config::key_t const record_sink_process::priv::config_record_size = config::key_t("record_size");
+config::key_t const record_sink_process::priv::config_buffer_size = config::key_t("buffer_size");
+config::key_t const record_sink_process::priv::config_append = config::key_t("append");
+config::key_t const record_sink_process::priv::config_queue_size = config::key_t("queue_size");
+config::key_t const record_sink_process::priv::config_sync = config::key_t("sync");
+process::port_type_t const record_sink_process::priv::type_record = port_type_t("record");
+process::port_t const record_sink_process::priv::port_input = port_t("record");
+
+record_sink_process
+::record_sink_process(config_t const& config)
+  : process(config)
+  , d()
+{
+  // The end of the stream is handled by the process.
+  set_data_checking_level(check_sync);
+
+  declare_configuration_key(
+    priv::config_path,
+    config::value_t(),
+    config::description_t("The path of the file to write records to."));
+  declare_configuration_key(
+    priv::config_record_size,
+    config::value_t("0"),
+    config::description_t("The size of each record. If 0, each record is preceded "
+                          "by its size as a 32-bit integer in host order."));
+  declare_configuration_key(
+    priv::config_buffer_size,
+    config::value_t("1048576"),
+    config::description_t("The number of bytes to gather before writing them to the file."));
+  declare_configuration_key(
+    priv::config_append,
+    config::value_t("false"),
+    config::description_t("Whether to append to the file instead of replacing it."));
+  declare_configuration_key(
+    priv::config_queue_size,
+    config::value_t("4"),
+    config::description_t("The number of full buffers which may wait for the I/O thread. "
+                          "If 0, buffers are written from the process' own thread."));
+  declare_configuration_key(
+    priv::config_sync,
+    config::value_t("none"),
+    config::description_t("When to synchronize the file to the disk. \'none\' leaves it "
+                          "to the operating system, \'barrier\' synchronizes at flush and "
+                          "complete data, and \'always\' synchronizes after every write."));
+
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_input_port(
+    priv::port_input,
+    priv::type_record,
+    required,
+    port_description_t("The records to write."));
+}
+
+record_sink_process
+::~record_sink_process()
+{
+}
+
+void
+record_sink_process
+::_configure()
+{
+  // Configure the process.
+  {
+    priv::path_t const path = config_value<priv::path_t>(priv::config_path);
+    size_t const record_size = config_value<size_t>(priv::config_record_size);
+    size_t const buffer_size = config_value<size_t>(priv::config_buffer_size);
+    bool const append = config_value<bool>(priv::config_append);
+    size_t const queue_size = config_value<size_t>(priv::config_queue_size);
+    config::value_t const sync_str = config_value<config::value_t>(priv::config_sync);
+
+    async_writer::sync_t sync;
+
+    if (!async_writer::sync_from_string(sync_str, sync))
+    {
+      std::string const reason = "The sync policy must be \'none\', \'barrier\', or \'always\', not \'" + sync_str + "\'";
+
+      throw invalid_configuration_exception(name(), reason);
+    }
+
+    d.reset(new priv(path, record_size, buffer_size, append, queue_size, sync));
+  }
+
+  if (d->path.empty())
+  {
+    static std::string const reason = "The path must not be empty";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  process::_configure();
+}
+
+void
+record_sink_process
+::_init()
+{
+  try
+  {
+    d->writer.reset(new async_writer(d->path, d->append, d->queue_size, d->sync));
+  }
+  catch (std::runtime_error const& e)
+  {
+    throw invalid_configuration_exception(name(), e.what());
+  }
+
+  process::_init();
+}
+
+void
+record_sink_process
+::_step()
+{
+  edge_datum_t const edat = grab_from_port(priv::port_input);
+  datum_t const& dat = edat.datum;
+
+  switch (dat->type())
+  {
+    case datum::data:
+    {
+      record const rec = dat->get_datum<record>();
+
+      if (d->record_size && (rec.size() != d->record_size))
+      {
+        throw std::runtime_error("A record written to \'" + d->path + "\' is not the configured size");
+      }
+
+      if (!d->record_size)
+      {
+        if (std::numeric_limits<priv::length_t>::max() < rec.size())
+        {
+          throw std::runtime_error("A record written to \'" + d->path + "\' is too large for its size prefix");
+        }
+
+        priv::length_t const length = rec.size();
+
+        d->add(reinterpret_cast<char const*>(&length), sizeof(length));
+      }
+
+      d->add(rec.data(), rec.size());
+
+      break;
+    }
+    case datum::flush:
+      // Everything before a flush is written before it is passed.
+      d->hand_off();
+      d->writer->barrier();
+      break;
+    case datum::complete:
+      if (is_final_complete(edat))
+      {
+        d->hand_off();
+        d->writer->close();
+
+        mark_process_as_complete();
+      }
+      else
+      {
+        d->hand_off();
+        d->writer->barrier();
+      }
+
+      break;
+    case datum::invalid:
+    case datum::empty:
+    case datum::error:
+    default:
+      break;
+  }
+
+  process::_step();
+}
+
+record_sink_process::priv
+::priv(path_t const& path_, size_t record_size_, size_t buffer_size_, bool append_,
+       size_t queue_size_, async_writer::sync_t sync_)
+  : path(path_)
+  , record_size(record_size_)
+  , buffer_size(buffer_size_)
+  , append(append_)
+  , queue_size(queue_size_)
+  , sync(sync_)
+  , writer()
+  , buffer()
+{
+  buffer.reserve(buffer_size);
+}
+
+record_sink_process::priv
+::~priv()
+{
+  // Queue whatever is buffered so that the writer writes it out when it is
+  // destroyed.
+  if (writer)
+  {
+    try
+    {
+      hand_off();
+    }
+    catch (std::runtime_error const&)
+    {
+    }
+  }
+}
+
+void
+record_sink_process::priv
+::add(char const* data, size_t size)
+{
+  if (buffer_size < (buffer.size() + size))
+  {
+    hand_off();
+  }
+
+  buffer.insert(buffer.end(), data, data + size);
+
+  // Records larger than the buffer are handed off on their own.
+  if (buffer_size <= buffer.size())
+  {
+    hand_off();
+  }
+}
+
+void
+record_sink_process::priv
+::hand_off()
+{
+  writer->write(buffer);
+
+  if (buffer.capacity() < buffer_size)
+  {
+    buffer.reserve(buffer_size);
+  }
+}
+
+}
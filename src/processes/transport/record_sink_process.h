@@ -0,0 +1,121 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PROCESSES_TRANSPORT_RECORD_SINK_PROCESS_H
+#define SPROKIT_PROCESSES_TRANSPORT_RECORD_SINK_PROCESS_H
+
+#include "transport-config.h"
+
+#include <sprokit/pipeline/process.h>
+
+#include <boost/scoped_ptr.hpp>
+
+/**
+ * \file record_sink_process.h
+ *
+ * \brief Declaration of the record sink process.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class record_sink_process
+ *
+ * \brief A process which writes binary records to a file.
+ *
+ * Records are gathered into a buffer which is handed to an I/O thread when it
+ * fills so that writing does not hold up the scheduler. Flush and complete
+ * data are barriers: they are not passed until everything before them has
+ * been written. Files written by this process may be read back with a \ref
+ * mmap_source_process with the same \key{record_size}.
+ *
+ * \process Writes records to a file.
+ *
+ * \iports
+ *
+ * \iport{record} The records to write.
+ *
+ * \configs
+ *
+ * \config{path} The path of the file.
+ * \config{record_size} The size of each record, or \c 0 to precede each
+ *                      record with its size as a 32-bit host-order integer.
+ * \config{buffer_size} The number of bytes to gather before writing.
+ * \config{append} Whether to append to an existing file instead of replacing it.
+ * \config{queue_size} The number of full buffers which may wait to be written.
+ * \config{sync} When to synchronize the file: \c none, \c barrier, or \c always.
+ *
+ * \reqs
+ *
+ * \req The \port{record} port must be connected.
+ * \req The \key{path} configuration must be writable.
+ * \req With a fixed \key{record_size}, every record must be that size.
+ * \req Without a fixed \key{record_size}, records must be smaller than 4 GiB.
+ *
+ * \ingroup process_transport
+ */
+class SPROKIT_PROCESSES_TRANSPORT_NO_EXPORT record_sink_process
+  : public process
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param config The configuration for the process.
+     */
+    record_sink_process(config_t const& config);
+    /**
+     * \brief Destructor.
+     */
+    ~record_sink_process();
+  protected:
+    /**
+     * \brief Configure the process.
+     */
+    void _configure();
+
+    /**
+     * \brief Initialize the process.
+     */
+    void _init();
+
+    /**
+     * \brief Step the process.
+     */
+    void _step();
+  private:
+    class priv;
+    boost::scoped_ptr<priv> d;
+};
+
+}
+
+#endif // SPROKIT_PROCESSES_TRANSPORT_RECORD_SINK_PROCESS_H
@@ -0,0 +1,319 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "recording.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * \file recording.cxx
+ *
+ * \brief Implementation of the file format for recorded data streams.
+ */
+
+namespace sprokit
+{
+
+namespace
+{
+
+typedef uint32_t version_t;
+typedef uint32_t length_t;
+
+static char const magic[8] = { 'S', 'P', 'R', 'K', 'R', 'E', 'C', '\0' };
+static version_t const version = 2;
+
+static void throw_error(std::string const& action, std::string const& path, std::string const& reason);
+static void throw_file_error(std::string const& action, std::string const& path, std::string const& reason);
+
+}
+
+mapped_file
+::mapped_file(std::string const& path)
+  : m_data(NULL)
+  , m_size(0)
+{
+  int const fd = open(path.c_str(), O_RDONLY);
+
+  if (fd < 0)
+  {
+    throw_file_error("open", path, strerror(errno));
+  }
+
+  struct stat st;
+
+  if (fstat(fd, &st) < 0)
+  {
+    int const err = errno;
+
+    ::close(fd);
+
+    throw_file_error("stat", path, strerror(err));
+  }
+
+  m_size = st.st_size;
+
+  if (m_size)
+  {
+    void* const data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (data == MAP_FAILED)
+    {
+      int const err = errno;
+
+      ::close(fd);
+
+      throw_file_error("map", path, strerror(err));
+    }
+
+    madvise(data, m_size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<char const*>(data);
+  }
+
+  // The mapping stays valid without the descriptor.
+  ::close(fd);
+}
+
+mapped_file
+::~mapped_file()
+{
+  if (m_data)
+  {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+}
+
+char const*
+mapped_file
+::data() const
+{
+  return m_data;
+}
+
+size_t
+mapped_file
+::size() const
+{
+  return m_size;
+}
+
+recording_writer
+::recording_writer(std::string const& path, process::port_type_t const& type)
+  : m_path(path)
+  , m_file(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc)
+  , m_started(false)
+  , m_start(0)
+{
+  if (!m_file.good())
+  {
+    throw_error("create", m_path, strerror(errno));
+  }
+
+  length_t const type_length = type.size();
+
+  m_file.write(magic, sizeof(magic));
+  m_file.write(reinterpret_cast<char const*>(&version), sizeof(version));
+  m_file.write(reinterpret_cast<char const*>(&type_length), sizeof(type_length));
+  m_file.write(type.data(), type_length);
+
+  check();
+}
+
+recording_writer
+::~recording_writer()
+{
+}
+
+void
+recording_writer
+::write(nanoseconds_t time, bytes_t const& bytes)
+{
+  if (!m_started)
+  {
+    m_start = time;
+    m_started = true;
+  }
+
+  nanoseconds_t const offset = (m_start < time) ? (time - m_start) : 0;
+  length_t const length = bytes.size();
+
+  m_file.write(reinterpret_cast<char const*>(&offset), sizeof(offset));
+  m_file.write(reinterpret_cast<char const*>(&length), sizeof(length));
+  m_file.write(bytes.data(), length);
+
+  check();
+}
+
+void
+recording_writer
+::close()
+{
+  if (!m_file.is_open())
+  {
+    return;
+  }
+
+  m_file.close();
+
+  check();
+}
+
+void
+recording_writer
+::check()
+{
+  if (m_file.fail())
+  {
+    throw_error("write", m_path, "the stream is in a bad state");
+  }
+}
+
+recording_reader
+::recording_reader(std::string const& path)
+  : m_path(path)
+  , m_type()
+  , m_file(new mapped_file(path))
+  , m_data(m_file->data())
+  , m_size(m_file->size())
+  , m_pos(0)
+{
+  char file_magic[sizeof(magic)];
+  version_t file_version;
+  length_t type_length;
+
+  try
+  {
+    take(file_magic, sizeof(file_magic));
+    take(&file_version, sizeof(file_version));
+    take(&type_length, sizeof(type_length));
+  }
+  catch (std::runtime_error const&)
+  {
+    throw_error("read", m_path, "the file is not a recording");
+  }
+
+  if (memcmp(file_magic, magic, sizeof(magic)) || (file_version != version) || (m_size - m_pos < type_length))
+  {
+    throw_error("read", m_path, "the file is not a recording");
+  }
+
+  m_type.assign(m_data + m_pos, type_length);
+  m_pos += type_length;
+}
+
+recording_reader
+::~recording_reader()
+{
+}
+
+process::port_type_t
+recording_reader
+::type() const
+{
+  return m_type;
+}
+
+bool
+recording_reader
+::read(nanoseconds_t& time, bytes_t& bytes)
+{
+  if (m_pos == m_size)
+  {
+    return false;
+  }
+
+  length_t length;
+
+  take(&time, sizeof(time));
+  take(&length, sizeof(length));
+
+  if (m_size - m_pos < length)
+  {
+    throw_error("read", m_path, "a record is truncated");
+  }
+
+  bytes.assign(m_data + m_pos, length);
+  m_pos += length;
+
+  return true;
+}
+
+void
+recording_reader
+::take(void* dest, size_t size)
+{
+  if (m_size - m_pos < size)
+  {
+    throw_error("read", m_path, "a record is truncated");
+  }
+
+  // Records are not aligned within the file.
+  memcpy(dest, m_data + m_pos, size);
+  m_pos += size;
+}
+
+namespace
+{
+
+void
+throw_error(std::string const& action, std::string const& path, std::string const& reason)
+{
+  std::ostringstream sstr;
+
+  sstr << "Failed to " << action << " the recording "
+          "\'" << path << "\': " << reason;
+
+  throw std::runtime_error(sstr.str());
+}
+
+void
+throw_file_error(std::string const& action, std::string const& path, std::string const& reason)
+{
+  std::ostringstream sstr;
+
+  sstr << "Failed to " << action << " the file "
+          "\'" << path << "\': " << reason;
+
+  throw std::runtime_error(sstr.str());
+}
+
+}
+
+}
@@ -0,0 +1,218 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PROCESSES_TRANSPORT_RECORDING_H
+#define SPROKIT_PROCESSES_TRANSPORT_RECORDING_H
+
+#include "transport-config.h"
+
+#include <sprokit/pipeline/process.h>
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <fstream>
+#include <string>
+
+#include <cstddef>
+
+/**
+ * \file recording.h
+ *
+ * \brief Declaration of the file format for recorded data streams.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class mapped_file
+ *
+ * \brief A read-only mapping of a whole file.
+ *
+ * The file is expected to be read front to back.
+ */
+class SPROKIT_PROCESSES_TRANSPORT_NO_EXPORT mapped_file
+  : boost::noncopyable
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \throws std::runtime_error Thrown when the file cannot be mapped.
+     *
+     * \param path The path of the file.
+     */
+    mapped_file(std::string const& path);
+    /**
+     * \brief Destructor.
+     */
+    ~mapped_file();
+
+    /**
+     * \brief The contents of the file.
+     *
+     * \returns The first byte of the file, or \c NULL if it is empty.
+     */
+    char const* data() const;
+    /**
+     * \brief The size of the file.
+     *
+     * \returns The number of bytes in the file.
+     */
+    size_t size() const;
+  private:
+    char const* m_data;
+    size_t m_size;
+};
+/// A handle to a \ref mapped_file.
+typedef boost::shared_ptr<mapped_file const> mapped_file_t;
+
+/**
+ * \class recording_writer
+ *
+ * \brief Writes a data stream to a recording file.
+ *
+ * A recording starts with a header naming the port type of the data and is
+ * followed by one record per datum: the time since the first record in
+ * nanoseconds, the size of the serialized datum, and the datum as serialized
+ * by its \ref datum_codec. Numbers are in host order so that a mapped file
+ * may be read in place.
+ */
+class SPROKIT_PROCESSES_TRANSPORT_NO_EXPORT recording_writer
+  : boost::noncopyable
+{
+  public:
+    /// The type for a time in nanoseconds.
+    typedef uint64_t nanoseconds_t;
+    /// The type for a serialized datum.
+    typedef std::string bytes_t;
+
+    /**
+     * \brief Constructor.
+     *
+     * \throws std::runtime_error Thrown when the file cannot be created.
+     *
+     * \param path The path to write the recording to.
+     * \param type The port type of the recorded data.
+     */
+    recording_writer(std::string const& path, process::port_type_t const& type);
+    /**
+     * \brief Destructor.
+     */
+    ~recording_writer();
+
+    /**
+     * \brief Append a record.
+     *
+     * \throws std::runtime_error Thrown when the record cannot be written.
+     *
+     * \param time When the datum was seen.
+     * \param bytes The serialized datum.
+     */
+    void write(nanoseconds_t time, bytes_t const& bytes);
+    /**
+     * \brief Flush and close the file.
+     *
+     * \throws std::runtime_error Thrown when the file cannot be written.
+     */
+    void close();
+  private:
+    void check();
+
+    std::string const m_path;
+    std::ofstream m_file;
+    bool m_started;
+    nanoseconds_t m_start;
+};
+
+/**
+ * \class recording_reader
+ *
+ * \brief Reads the records of a recording file.
+ *
+ * The file is mapped into memory rather than read so that replaying does not
+ * wait on read calls.
+ */
+class SPROKIT_PROCESSES_TRANSPORT_NO_EXPORT recording_reader
+  : boost::noncopyable
+{
+  public:
+    /// The type for a time in nanoseconds.
+    typedef recording_writer::nanoseconds_t nanoseconds_t;
+    /// The type for a serialized datum.
+    typedef recording_writer::bytes_t bytes_t;
+
+    /**
+     * \brief Constructor.
+     *
+     * \throws std::runtime_error Thrown when the file cannot be mapped or is not a recording.
+     *
+     * \param path The path of the recording.
+     */
+    recording_reader(std::string const& path);
+    /**
+     * \brief Destructor.
+     */
+    ~recording_reader();
+
+    /**
+     * \brief The port type of the recorded data.
+     *
+     * \returns The type of the recorded data.
+     */
+    process::port_type_t type() const;
+
+    /**
+     * \brief Read the next record.
+     *
+     * \throws std::runtime_error Thrown when the record is truncated.
+     *
+     * \param time Set to the time of the record.
+     * \param bytes Set to the serialized datum.
+     *
+     * \returns True if a record was read, false at the end of the recording.
+     */
+    bool read(nanoseconds_t& time, bytes_t& bytes);
+  private:
+    void take(void* dest, size_t size);
+
+    std::string const m_path;
+    process::port_type_t m_type;
+    mapped_file_t const m_file;
+    char const* m_data;
+    size_t m_size;
+    size_t m_pos;
+};
+
+}
+
+#endif // SPROKIT_PROCESSES_TRANSPORT_RECORDING_H
@@ -0,0 +1,74 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "registration.h"
+
+#include "mmap_source_process.h"
+#include "record_sink_process.h"
+#include "replay_process.h"
+#include "shm_input_process.h"
+#include "shm_output_process.h"
+#include "socket_input_process.h"
+#include "socket_output_process.h"
+#include "tap_process.h"
+
+#include <sprokit/pipeline/process_registry.h>
+
+/**
+ * \file transport/registration.cxx
+ *
+ * \brief Register processes for use.
+ */
+
+using namespace sprokit;
+
+void
+register_processes()
+{
+  static process_registry::module_t const module_name = process_registry::module_t("transport_processes");
+
+  process_registry_t const registry = process_registry::self();
+
+  if (registry->is_module_loaded(module_name))
+  {
+    return;
+  }
+
+  registry->register_process("mmap_source", "Reads binary records from a memory-mapped file", create_process<mmap_source_process>);
+  registry->register_process("record_sink", "Writes binary records to a file", create_process<record_sink_process>);
+  registry->register_process("replay", "Plays back a recorded data stream", create_process<replay_process>);
+  registry->register_process("shm_input", "Receives data from another process through shared memory", create_process<shm_input_process>);
+  registry->register_process("shm_output", "Sends data to another process through shared memory", create_process<shm_output_process>);
+  registry->register_process("socket_input", "Receives data from another process through a socket", create_process<socket_input_process>);
+  registry->register_process("socket_output", "Sends data to another process through a socket", create_process<socket_output_process>);
+  registry->register_process("tap", "Records the data stream passing through it", create_process<tap_process>);
+
+  registry->mark_module_as_loaded(module_name);
+}
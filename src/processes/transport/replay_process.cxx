@@ -0,0 +1,251 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "replay_process.h"
+
+#include "recording.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/datum_codec.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/process_exception.h>
+#include <sprokit/pipeline/stamp.h>
+
+#include <boost/thread/thread.hpp>
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * \file replay_process.cxx
+ *
+ * \brief Implementation of the replay process.
+ */
+
+namespace sprokit
+{
+
+class replay_process::priv
+{
+  public:
+    typedef std::string path_t;
+    typedef std::string timing_t;
+    typedef recording_reader::nanoseconds_t nanoseconds_t;
+
+    priv(path_t const& path_, bool original_timing_);
+    ~priv();
+
+    void wait_until(nanoseconds_t offset);
+
+    path_t const path;
+    bool const original_timing;
+
+    boost::scoped_ptr<recording_reader> reader;
+    bool started;
+    stamp::origin_t start;
+
+    static config::key_t const config_path;
+    static config::key_t const config_timing;
+    static timing_t const timing_fast;
+    static timing_t const timing_original;
+    static port_t const port_output;
+};
+
+config::key_t const replay_process::priv::config_path = config::key_t("path");
+config::key_t const replay_process::priv::config_timing = config::key_t("timing");
+replay_process::priv::timing_t const replay_process::priv::timing_fast = timing_t("fast");
+replay_process::priv::timing_t const replay_process::priv::timing_original = timing_t("original");
+process::port_t const replay_process::priv::port_output = port_t("replay");
+
+replay_process
+::replay_process(config_t const& config)
+  : process(config)
+  , d()
+{
+  declare_configuration_key(
+    priv::config_path,
+    config::value_t(),
+    config::description_t("The path of the recording to play back."));
+  declare_configuration_key(
+    priv::config_timing,
+    priv::timing_fast,
+    config::description_t("How to pace the data. \'fast\' sends data as quickly as "
+                          "downstream accepts it; \'original\' keeps the spacing it "
+                          "was recorded with."));
+
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  // The type is read from the recording.
+  declare_output_port(
+    priv::port_output,
+    type_data_dependent,
+    required,
+    port_description_t("The recorded data."));
+}
+
+replay_process
+::~replay_process()
+{
+}
+
+void
+replay_process
+::_configure()
+{
+  // Configure the process.
+  {
+    priv::path_t const path = config_value<priv::path_t>(priv::config_path);
+    priv::timing_t const timing = config_value<priv::timing_t>(priv::config_timing);
+
+    if ((timing != priv::timing_fast) && (timing != priv::timing_original))
+    {
+      std::string const reason = "The timing must be \'fast\' or \'original\', not \'" + timing + "\'";
+
+      throw invalid_configuration_exception(name(), reason);
+    }
+
+    d.reset(new priv(path, timing == priv::timing_original));
+  }
+
+  if (d->path.empty())
+  {
+    static std::string const reason = "The path must not be empty";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  try
+  {
+    d->reader.reset(new recording_reader(d->path));
+  }
+  catch (std::runtime_error const& e)
+  {
+    throw invalid_configuration_exception(name(), e.what());
+  }
+
+  set_output_port_type(priv::port_output, d->reader->type());
+
+  process::_configure();
+}
+
+void
+replay_process
+::_init()
+{
+  port_type_t const type = d->reader->type();
+
+  if (!datum_codec::has_codec(type))
+  {
+    std::string const reason = "There is no codec for the \'" + type + "\' type";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  process::_init();
+}
+
+void
+replay_process
+::_step()
+{
+  priv::nanoseconds_t offset;
+  recording_reader::bytes_t bytes;
+  datum_t dat;
+  // Data keeps the stream it was recorded in.
+  stamp::stream_t stream = stamp::default_stream;
+
+  if (d->reader->read(offset, bytes))
+  {
+    edge_datum_t const edat = datum_codec::decode(d->reader->type(), bytes);
+
+    dat = edat.datum;
+    stream = edat.stamp->stream();
+
+    if (d->original_timing)
+    {
+      d->wait_until(offset);
+    }
+  }
+  else
+  {
+    // The recording was cut short.
+    dat = datum::complete_datum();
+  }
+
+  push_datum_to_stream(priv::port_output, stream, dat);
+
+  if ((dat->type() == datum::complete) && (stream == stamp::default_stream))
+  {
+    mark_process_as_complete();
+  }
+
+  process::_step();
+}
+
+replay_process::priv
+::priv(path_t const& path_, bool original_timing_)
+  : path(path_)
+  , original_timing(original_timing_)
+  , reader()
+  , started(false)
+  , start(0)
+{
+}
+
+replay_process::priv
+::~priv()
+{
+}
+
+void
+replay_process::priv
+::wait_until(nanoseconds_t offset)
+{
+  stamp::origin_t const now = stamp::now();
+
+  if (!started)
+  {
+    start = now;
+    started = true;
+  }
+
+  stamp::origin_t const due = start + offset;
+
+  if (now < due)
+  {
+    // Sleeping is an interruption point, so the process may still be stopped.
+    boost::this_thread::sleep(boost::posix_time::microseconds((due - now) / 1000));
+  }
+}
+
+}
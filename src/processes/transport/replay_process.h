@@ -0,0 +1,112 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PROCESSES_TRANSPORT_REPLAY_PROCESS_H
+#define SPROKIT_PROCESSES_TRANSPORT_REPLAY_PROCESS_H
+
+#include "transport-config.h"
+
+#include <sprokit/pipeline/process.h>
+
+#include <boost/scoped_ptr.hpp>
+
+/**
+ * \file replay_process.h
+ *
+ * \brief Declaration of the replay process.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class replay_process
+ *
+ * \brief A process which plays back a data stream recorded by a \ref tap_process.
+ *
+ * Data is stamped anew as it is played back, so latencies measured downstream
+ * are those of the replay.
+ *
+ * \process Reads data from a recording.
+ *
+ * \oports
+ *
+ * \oport{replay} The recorded data.
+ *
+ * \configs
+ *
+ * \config{path} The path of the recording.
+ * \config{timing} Either \c fast or \c original.
+ *
+ * \reqs
+ *
+ * \req The \port{replay} port must be connected.
+ * \req The \key{path} configuration must be a recording.
+ * \req The type of the recording must have a \ref datum_codec.
+ *
+ * \ingroup process_transport
+ */
+class SPROKIT_PROCESSES_TRANSPORT_NO_EXPORT replay_process
+  : public process
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param config The configuration for the process.
+     */
+    replay_process(config_t const& config);
+    /**
+     * \brief Destructor.
+     */
+    ~replay_process();
+  protected:
+    /**
+     * \brief Configure the process.
+     */
+    void _configure();
+
+    /**
+     * \brief Initialize the process.
+     */
+    void _init();
+
+    /**
+     * \brief Step the process.
+     */
+    void _step();
+  private:
+    class priv;
+    boost::scoped_ptr<priv> d;
+};
+
+}
+
+#endif // SPROKIT_PROCESSES_TRANSPORT_REPLAY_PROCESS_H
@@ -0,0 +1,110 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PROCESSES_TRANSPORT_SHM_INPUT_PROCESS_H
+#define SPROKIT_PROCESSES_TRANSPORT_SHM_INPUT_PROCESS_H
+
+#include "transport-config.h"
+
+#include <sprokit/pipeline/process.h>
+
+#include <boost/scoped_ptr.hpp>
+
+/**
+ * \file shm_input_process.h
+ *
+ * \brief Declaration of the shared memory input process.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class shm_input_process
+ *
+ * \brief A process which receives a data stream from another OS process.
+ *
+ * \process Reads data from a shared memory ring.
+ *
+ * \oports
+ *
+ * \oport{receive} The received data.
+ *
+ * \configs
+ *
+ * \config{segment} The name of the shared memory segment.
+ * \config{capacity} The size of the ring, in bytes.
+ * \config{type} The type of the data. Inferred from the connection if empty.
+ *
+ * \reqs
+ *
+ * \req The \port{receive} port must be connected.
+ * \req The \key{segment} configuration must be set.
+ * \req The type of the \port{receive} port must have a \ref datum_codec.
+ *
+ * \ingroup process_transport
+ */
+class SPROKIT_PROCESSES_TRANSPORT_NO_EXPORT shm_input_process
+  : public process
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param config The configuration for the process.
+     */
+    shm_input_process(config_t const& config);
+    /**
+     * \brief Destructor.
+     */
+    ~shm_input_process();
+  protected:
+    /**
+     * \brief Configure the process.
+     */
+    void _configure();
+
+    /**
+     * \brief Initialize the process.
+     */
+    void _init();
+
+    /**
+     * \brief Step the process.
+     */
+    void _step();
+  private:
+    class priv;
+    boost::scoped_ptr<priv> d;
+};
+
+}
+
+#endif // SPROKIT_PROCESSES_TRANSPORT_SHM_INPUT_PROCESS_H
@@ -0,0 +1,188 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "shm_output_process.h"
+
+#include "shm_ring.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/datum_codec.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/process_exception.h>
+
+#include <string>
+
+/**
+ * \file shm_output_process.cxx
+ *
+ * \brief Implementation of the shared memory output process.
+ */
+
+namespace sprokit
+{
+
+class shm_output_process::priv
+{
+  public:
+    typedef std::string segment_t;
+    typedef size_t capacity_t;
+
+    priv(segment_t const& segment_, capacity_t capacity_);
+    ~priv();
+
+    segment_t const segment;
+    capacity_t const capacity;
+
+    port_type_t type;
+    boost::scoped_ptr<shm_ring> ring;
+
+    static config::key_t const config_segment;
+    static config::key_t const config_capacity;
+    static config::value_t const default_capacity;
+    static port_t const port_input;
+};
+
+config::key_t const shm_output_process::priv::config_segment = config::key_t("segment");
+config::key_t const shm_output_process::priv::config_capacity = config::key_t("capacity");
+config::value_t const shm_output_process::priv::default_capacity = config::value_t("4194304");
+process::port_t const shm_output_process::priv::port_input = port_t("send");
+
+shm_output_process
+::shm_output_process(config_t const& config)
+  : process(config)
+  , d()
+{
+  // The end of the stream is handled by the process.
+  set_data_checking_level(check_sync);
+
+  declare_configuration_key(
+    priv::config_segment,
+    config::value_t(),
+    config::description_t("The name of the shared memory segment to write to."));
+  declare_configuration_key(
+    priv::config_capacity,
+    priv::default_capacity,
+    config::description_t("The size of the ring, in bytes. The reading side should use the same size."));
+
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_input_port(
+    priv::port_input,
+    type_flow_dependent,
+    required,
+    port_description_t("The data to send."));
+}
+
+shm_output_process
+::~shm_output_process()
+{
+}
+
+void
+shm_output_process
+::_configure()
+{
+  // Configure the process.
+  {
+    priv::segment_t const segment = config_value<priv::segment_t>(priv::config_segment);
+    priv::capacity_t const capacity = config_value<priv::capacity_t>(priv::config_capacity);
+
+    d.reset(new priv(segment, capacity));
+  }
+
+  if (d->segment.empty())
+  {
+    static std::string const reason = "The segment must not be empty";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  process::_configure();
+}
+
+void
+shm_output_process
+::_init()
+{
+  d->type = input_port_info(priv::port_input)->type;
+
+  if (!datum_codec::has_codec(d->type))
+  {
+    std::string const reason = "There is no codec for the \'" + d->type + "\' type";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  try
+  {
+    d->ring.reset(new shm_ring(d->segment, d->capacity, shm_ring::role_writer));
+  }
+  catch (std::runtime_error const& e)
+  {
+    throw invalid_configuration_exception(name(), e.what());
+  }
+
+  process::_init();
+}
+
+void
+shm_output_process
+::_step()
+{
+  edge_datum_t const edat = grab_from_port(priv::port_input);
+
+  d->ring->write(datum_codec::encode(d->type, edat));
+
+  if (is_final_complete(edat))
+  {
+    mark_process_as_complete();
+  }
+
+  process::_step();
+}
+
+shm_output_process::priv
+::priv(segment_t const& segment_, capacity_t capacity_)
+  : segment(segment_)
+  , capacity(capacity_)
+  , type()
+  , ring()
+{
+}
+
+shm_output_process::priv
+::~priv()
+{
+}
+
+}
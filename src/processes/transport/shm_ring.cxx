@@ -0,0 +1,634 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "shm_ring.h"
+
+#include <boost/thread/thread.hpp>
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * \file shm_ring.cxx
+ *
+ * \brief Implementation of a ring buffer in shared memory.
+ */
+
+namespace sprokit
+{
+
+namespace
+{
+
+typedef uint32_t length_t;
+typedef uint32_t state_t;
+
+static state_t const state_empty = 0;
+static state_t const state_initializing = 1;
+static state_t const state_ready = 2;
+
+// How long blocking calls sleep before checking for interruption.
+static long const wait_interval_ns = 100 * 1000 * 1000;
+
+// How long to wait for the side which created the segment to initialize it.
+static useconds_t const init_poll_us = 1000;
+static size_t const init_polls = 10 * 1000;
+
+class ring_lock
+  : boost::noncopyable
+{
+  public:
+    ring_lock(pthread_mutex_t* mutex);
+    ~ring_lock();
+
+    void wait(pthread_cond_t* cond);
+
+    bool owner_died() const;
+  private:
+    void check(int ret);
+
+    pthread_mutex_t* const m_mutex;
+    bool m_owner_died;
+};
+
+static bool is_running(pid_t pid);
+static std::string segment_name(std::string const& name);
+static void throw_error(std::string const& action, std::string const& name, int err);
+
+}
+
+struct shm_ring::header_t
+{
+  state_t volatile state;
+  // The process which initialized the segment.
+  pid_t volatile initializer;
+  uint64_t capacity;
+  // Both positions are counts of bytes and only increase.
+  uint64_t head;
+  uint64_t tail;
+  // The processes which opened the ring, indexed by role.
+  pid_t peers[2];
+  // How many threads of each role are waiting on their condition.
+  uint32_t waiting[2];
+  pthread_mutex_t mutex;
+  // The writer waits for room and the reader waits for data.
+  pthread_cond_t wakeup[2];
+};
+
+// Keep the data away from the cache lines the header uses.
+size_t const shm_ring::data_offset = ((sizeof(shm_ring::header_t) + 63) / 64) * 64;
+
+shm_ring
+::shm_ring(std::string const& name, size_t capacity, role_t role)
+  : m_name(segment_name(name))
+  , m_role(role)
+  , m_fd(-1)
+  , m_mapped(0)
+  , m_header(NULL)
+  , m_data(NULL)
+{
+  if (!capacity)
+  {
+    static std::string const reason = "A shared memory ring must have a capacity";
+
+    throw std::runtime_error(reason);
+  }
+
+  m_fd = shm_open(m_name.c_str(), O_CREAT | O_RDWR, 0600);
+
+  if (m_fd < 0)
+  {
+    throw_error("open", m_name, errno);
+  }
+
+  size_t const size = data_offset + capacity;
+
+  struct stat st;
+
+  if (fstat(m_fd, &st))
+  {
+    int const err = errno;
+
+    close(m_fd);
+    throw_error("query", m_name, err);
+  }
+
+  if (size_t(st.st_size) < size)
+  {
+    if (ftruncate(m_fd, size))
+    {
+      int const err = errno;
+
+      close(m_fd);
+      throw_error("resize", m_name, err);
+    }
+  }
+
+  map(size);
+
+  try
+  {
+    if (__sync_bool_compare_and_swap(&m_header->state, state_empty, state_initializing))
+    {
+      initialize(capacity);
+    }
+    else
+    {
+      wait_for_initialization(capacity);
+    }
+
+    attach();
+  }
+  catch (...)
+  {
+    // The destructor does not run for a constructor which throws.
+    if (m_header)
+    {
+      munmap(m_header, m_mapped);
+    }
+
+    if (0 <= m_fd)
+    {
+      close(m_fd);
+    }
+
+    throw;
+  }
+}
+
+shm_ring
+::~shm_ring()
+{
+  if (m_header)
+  {
+    munmap(m_header, m_mapped);
+  }
+
+  if (0 <= m_fd)
+  {
+    close(m_fd);
+  }
+}
+
+void
+shm_ring
+::write(message_t const& message)
+{
+  header_t* const h = m_header;
+  length_t const length = length_t(message.size());
+  uint64_t const needed = sizeof(length_t) + message.size();
+
+  if (h->capacity < needed)
+  {
+    std::ostringstream sstr;
+
+    sstr << "A message of " << message.size() << " bytes "
+            "does not fit into the shared memory ring "
+            "\'" << m_name << "\' which holds " << h->capacity << " bytes";
+
+    throw std::runtime_error(sstr.str());
+  }
+
+  ring_lock lock(&h->mutex);
+
+  check_peer(lock.owner_died(), false);
+
+  while ((h->capacity - (h->head - h->tail)) < needed)
+  {
+    ++h->waiting[m_role];
+    lock.wait(&h->wakeup[m_role]);
+    --h->waiting[m_role];
+
+    boost::this_thread::interruption_point();
+
+    check_peer(lock.owner_died(), true);
+  }
+
+  copy_in(reinterpret_cast<char const*>(&length), sizeof(length_t));
+  copy_in(message.data(), message.size());
+
+  wake_peer();
+}
+
+shm_ring::message_t
+shm_ring
+::read()
+{
+  header_t* const h = m_header;
+
+  ring_lock lock(&h->mutex);
+
+  check_peer(lock.owner_died(), false);
+
+  while (h->head == h->tail)
+  {
+    ++h->waiting[m_role];
+    lock.wait(&h->wakeup[m_role]);
+    --h->waiting[m_role];
+
+    boost::this_thread::interruption_point();
+
+    check_peer(lock.owner_died(), h->head == h->tail);
+  }
+
+  length_t length;
+
+  copy_out(reinterpret_cast<char*>(&length), sizeof(length_t));
+
+  message_t message(length, '\0');
+
+  if (length)
+  {
+    copy_out(&message[0], length);
+  }
+
+  wake_peer();
+
+  return message;
+}
+
+void
+shm_ring
+::unlink()
+{
+  shm_unlink(m_name.c_str());
+}
+
+void
+shm_ring
+::map(size_t size)
+{
+  if (m_header)
+  {
+    munmap(m_header, m_mapped);
+
+    m_header = NULL;
+    m_data = NULL;
+    m_mapped = 0;
+  }
+
+  void* const base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+
+  if (base == MAP_FAILED)
+  {
+    int const err = errno;
+
+    close(m_fd);
+    m_fd = -1;
+
+    throw_error("map", m_name, err);
+  }
+
+  m_mapped = size;
+  m_header = static_cast<header_t*>(base);
+  m_data = static_cast<char*>(base) + data_offset;
+}
+
+void
+shm_ring
+::initialize(size_t capacity)
+{
+  header_t* const h = m_header;
+
+  h->initializer = getpid();
+
+  pthread_mutexattr_t mattr;
+
+  pthread_mutexattr_init(&mattr);
+  pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_setrobust(&mattr, PTHREAD_MUTEX_ROBUST);
+  pthread_mutex_init(&h->mutex, &mattr);
+  pthread_mutexattr_destroy(&mattr);
+
+  h->capacity = capacity;
+  h->head = 0;
+  h->tail = 0;
+
+  reset_role(role_writer);
+  reset_role(role_reader);
+
+  __sync_synchronize();
+
+  h->state = state_ready;
+}
+
+void
+shm_ring
+::wait_for_initialization(size_t capacity)
+{
+  header_t* const h = m_header;
+
+  for (size_t polls = 0; h->state != state_ready; ++polls)
+  {
+    boost::this_thread::interruption_point();
+
+    pid_t const initializer = h->initializer;
+
+    // The creator either died part way through or before it could say who it
+    // is; take the initialization over.
+    bool const abandoned = initializer ? !is_running(initializer) : (init_polls <= polls);
+
+    if (abandoned && __sync_bool_compare_and_swap(&h->initializer, initializer, getpid()))
+    {
+      initialize(capacity);
+
+      return;
+    }
+
+    if (init_polls <= polls)
+    {
+      std::ostringstream sstr;
+
+      sstr << "The shared memory segment \'" << m_name << "\' "
+              "was not initialized by process " << initializer;
+
+      throw std::runtime_error(sstr.str());
+    }
+
+    usleep(init_poll_us);
+  }
+
+  __sync_synchronize();
+
+  // The other side decides how large the ring is.
+  size_t const actual_size = data_offset + h->capacity;
+
+  if (m_mapped < actual_size)
+  {
+    map(actual_size);
+  }
+}
+
+void
+shm_ring
+::attach()
+{
+  header_t* const h = m_header;
+  pid_t const self = getpid();
+
+  ring_lock lock(&h->mutex);
+
+  role_t const other_role = (m_role == role_writer) ? role_reader : role_writer;
+  pid_t& mine = h->peers[m_role];
+  pid_t const other = h->peers[other_role];
+
+  // Data which was half written when a process died is not trusted.
+  bool stale = lock.owner_died();
+
+  if (mine && (mine != self))
+  {
+    if (is_running(mine))
+    {
+      std::ostringstream sstr;
+
+      sstr << "The shared memory ring \'" << m_name << "\' "
+              "is already in use by process " << mine;
+
+      throw std::runtime_error(sstr.str());
+    }
+
+    // Only one process opens each side during a run, so the segment was left
+    // behind by an earlier one.
+    stale = true;
+  }
+
+  // A reader removes the segment once it sees the end of the data, so a
+  // reader which is gone before a writer shows up is from an earlier run. A
+  // writer which is gone may just have finished before the reader started.
+  if ((m_role == role_writer) && other && !is_running(other))
+  {
+    stale = true;
+  }
+
+  if (stale)
+  {
+    h->head = 0;
+    h->tail = 0;
+
+    // No live process waits as this side, but a dead one may have been left
+    // waiting; condition variables with such waiters can block signals
+    // forever, so start them over. The other side is only reset if it is gone
+    // as well since a live one may be waiting right now.
+    reset_role(m_role);
+
+    if (other && !is_running(other))
+    {
+      reset_role(other_role);
+    }
+  }
+
+  mine = self;
+}
+
+void
+shm_ring
+::reset_role(role_t role)
+{
+  header_t* const h = m_header;
+
+  pthread_condattr_t cattr;
+
+  pthread_condattr_init(&cattr);
+  pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+  pthread_cond_init(&h->wakeup[role], &cattr);
+  pthread_condattr_destroy(&cattr);
+
+  h->peers[role] = 0;
+  h->waiting[role] = 0;
+}
+
+void
+shm_ring
+::wake_peer()
+{
+  header_t* const h = m_header;
+  role_t const peer_role = (m_role == role_writer) ? role_reader : role_writer;
+
+  // Signalling a condition which a dead process was waiting on may never
+  // return, so only wake a peer which is still around. Checking is only
+  // needed when the peer is actually waiting.
+  if (h->waiting[peer_role] && is_running(h->peers[peer_role]))
+  {
+    pthread_cond_signal(&h->wakeup[peer_role]);
+  }
+}
+
+void
+shm_ring
+::check_peer(bool owner_died, bool waiting) const
+{
+  header_t const* const h = m_header;
+  bool const writer = (m_role == role_writer);
+  pid_t const peer = h->peers[writer ? role_reader : role_writer];
+
+  if (!owner_died && !(waiting && peer && !is_running(peer)))
+  {
+    return;
+  }
+
+  std::ostringstream sstr;
+
+  sstr << "The " << (writer ? "reader" : "writer") << " of the shared memory "
+          "ring \'" << m_name << "\' exited before the data was complete";
+
+  throw std::runtime_error(sstr.str());
+}
+
+void
+shm_ring
+::copy_in(char const* src, size_t size)
+{
+  header_t* const h = m_header;
+  size_t const pos = h->head % h->capacity;
+  size_t const first = std::min(size, size_t(h->capacity - pos));
+
+  memcpy(m_data + pos, src, first);
+  memcpy(m_data, src + first, size - first);
+
+  h->head += size;
+}
+
+void
+shm_ring
+::copy_out(char* dest, size_t size)
+{
+  header_t* const h = m_header;
+  size_t const pos = h->tail % h->capacity;
+  size_t const first = std::min(size, size_t(h->capacity - pos));
+
+  memcpy(dest, m_data + pos, first);
+  memcpy(dest + first, m_data, size - first);
+
+  h->tail += size;
+}
+
+namespace
+{
+
+ring_lock
+::ring_lock(pthread_mutex_t* mutex)
+  : m_mutex(mutex)
+  , m_owner_died(false)
+{
+  check(pthread_mutex_lock(m_mutex));
+}
+
+ring_lock
+::~ring_lock()
+{
+  pthread_mutex_unlock(m_mutex);
+}
+
+void
+ring_lock
+::wait(pthread_cond_t* cond)
+{
+  timespec deadline;
+
+  clock_gettime(CLOCK_REALTIME, &deadline);
+
+  // Both parts are non-negative and the sum fits easily; do the carry in
+  // unsigned arithmetic so that the compiler need not assume anything about
+  // overflow.
+  unsigned long const nsec = static_cast<unsigned long>(deadline.tv_nsec) + static_cast<unsigned long>(wait_interval_ns);
+  unsigned long const nsec_per_sec = 1000000000UL;
+
+  deadline.tv_sec += static_cast<time_t>(nsec / nsec_per_sec);
+  deadline.tv_nsec = static_cast<long>(nsec % nsec_per_sec);
+
+  check(pthread_cond_timedwait(cond, m_mutex, &deadline));
+}
+
+bool
+ring_lock
+::owner_died() const
+{
+  return m_owner_died;
+}
+
+void
+ring_lock
+::check(int ret)
+{
+  // The other side died while holding the lock; take it over rather than
+  // waiting forever.
+  if (ret == EOWNERDEAD)
+  {
+    pthread_mutex_consistent(m_mutex);
+
+    m_owner_died = true;
+  }
+}
+
+bool
+is_running(pid_t pid)
+{
+  // Permission errors still mean that the process exists.
+  return !kill(pid, 0) || (errno == EPERM);
+}
+
+std::string
+segment_name(std::string const& name)
+{
+  if (!name.empty() && (name[0] == '/'))
+  {
+    return name;
+  }
+
+  return "/" + name;
+}
+
+void
+throw_error(std::string const& action, std::string const& name, int err)
+{
+  std::ostringstream sstr;
+
+  sstr << "Failed to " << action << " the shared memory segment "
+          "\'" << name << "\': " << strerror(err);
+
+  throw std::runtime_error(sstr.str());
+}
+
+}
+
+}
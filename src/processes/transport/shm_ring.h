@@ -0,0 +1,155 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PROCESSES_TRANSPORT_SHM_RING_H
+#define SPROKIT_PROCESSES_TRANSPORT_SHM_RING_H
+
+#include "transport-config.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <string>
+
+#include <cstddef>
+
+/**
+ * \file shm_ring.h
+ *
+ * \brief Declaration of a ring buffer in shared memory.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class shm_ring
+ *
+ * \brief A ring buffer of messages in a named shared memory segment.
+ *
+ * The segment is created by whichever side opens it first. There may be one
+ * writer and one reader for a ring and each records its process in the
+ * segment. A segment left behind by an earlier run, i.e., one where a process
+ * recorded for the opening side has exited, is reset before it is used.
+ * Messages are copied in and out under a process-shared mutex; a peer which
+ * dies while holding it does not deadlock the other side.
+ *
+ * Blocking calls wake up periodically to check for thread interruption so
+ * that schedulers are able to stop processes which use a ring. They also
+ * check that the other side is still running so that a peer which exited
+ * without finishing does not leave them waiting forever.
+ */
+class SPROKIT_PROCESSES_TRANSPORT_NO_EXPORT shm_ring
+  : boost::noncopyable
+{
+  public:
+    /// The type for a message.
+    typedef std::string message_t;
+
+    /// The side of the ring a process is on.
+    typedef enum
+    {
+      /// The process writes messages into the ring.
+      role_writer,
+      /// The process reads messages from the ring.
+      role_reader
+    } role_t;
+
+    /**
+     * \brief Constructor.
+     *
+     * \throws std::runtime_error Thrown when the segment cannot be mapped,
+     * another running process has already opened the same side of it, or it
+     * is never initialized by the side which created it.
+     *
+     * \param name The name of the segment.
+     * \param capacity The number of bytes for messages if the segment is created.
+     * \param role The side of the ring to open.
+     */
+    shm_ring(std::string const& name, size_t capacity, role_t role);
+    /**
+     * \brief Destructor.
+     */
+    ~shm_ring();
+
+    /**
+     * \brief Append a message to the ring.
+     *
+     * Blocks until there is room for the message.
+     *
+     * \throws std::runtime_error Thrown when the message can never fit or the
+     * reader has exited.
+     *
+     * \param message The message to append.
+     */
+    void write(message_t const& message);
+    /**
+     * \brief Remove a message from the ring.
+     *
+     * Blocks until a message is available.
+     *
+     * \throws std::runtime_error Thrown when the writer has exited and the
+     * ring is empty.
+     *
+     * \returns The oldest message in the ring.
+     */
+    message_t read();
+
+    /**
+     * \brief Remove the name of the segment.
+     *
+     * Processes which have the segment mapped are unaffected.
+     */
+    void unlink();
+  private:
+    struct header_t;
+
+    static size_t const data_offset;
+
+    void map(size_t size);
+    void initialize(size_t capacity);
+    void wait_for_initialization(size_t capacity);
+    void attach();
+    void reset_role(role_t role);
+    void check_peer(bool owner_died, bool waiting) const;
+    void wake_peer();
+    void copy_in(char const* src, size_t size);
+    void copy_out(char* dest, size_t size);
+
+    std::string const m_name;
+    role_t const m_role;
+    int m_fd;
+    size_t m_mapped;
+    header_t* m_header;
+    char* m_data;
+};
+
+}
+
+#endif // SPROKIT_PROCESSES_TRANSPORT_SHM_RING_H
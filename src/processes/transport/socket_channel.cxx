@@ -0,0 +1,530 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "socket_channel.h"
+
+#include <sprokit/pipeline/trace.h>
+
+#include <boost/date_time/posix_time/posix_time_duration.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include <cerrno>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * \file socket_channel.cxx
+ *
+ * \brief Implementation of a stream socket between two processes.
+ */
+
+namespace sprokit
+{
+
+namespace
+{
+
+static std::string const prefix_tcp = std::string("tcp:");
+static std::string const prefix_unix = std::string("unix:");
+
+// How long blocking calls sleep before checking for interruption.
+static int const wait_interval_ms = 100;
+static size_t const read_chunk_size = 64 * 1024;
+
+class resolved_address
+{
+  public:
+    resolved_address(std::string const& address, bool passive);
+    ~resolved_address();
+
+    bool is_unix() const;
+
+    int family;
+    sockaddr_storage storage;
+    socklen_t length;
+    std::string path;
+};
+
+class scoped_fd
+  : boost::noncopyable
+{
+  public:
+    scoped_fd(int fd);
+    ~scoped_fd();
+
+    int release();
+
+    int const m_fd;
+  private:
+    bool m_released;
+};
+
+static bool wait_for(int fd, short events, int timeout);
+static void throw_error(std::string const& action, std::string const& address, int err);
+
+}
+
+socket_channel
+::socket_channel(std::string const& address, mode_t mode, double connect_timeout)
+  : m_fd(-1)
+  , m_buffer()
+  , m_buffer_pos(0)
+{
+  switch (mode)
+  {
+    case mode_listen:
+      listen(address);
+      break;
+    case mode_connect:
+      connect(address, connect_timeout);
+      break;
+    default:
+      break;
+  }
+}
+
+socket_channel
+::~socket_channel()
+{
+  if (0 <= m_fd)
+  {
+    close(m_fd);
+  }
+}
+
+void
+socket_channel
+::write(bytes_t const& bytes)
+{
+  if (!write_if_open(bytes))
+  {
+    throw_error("send to", "the peer", EPIPE);
+  }
+}
+
+bool
+socket_channel
+::write_if_open(bytes_t const& bytes)
+{
+  size_t offset = 0;
+
+  while (offset < bytes.size())
+  {
+    if (!wait_for(m_fd, POLLOUT, wait_interval_ms))
+    {
+      boost::this_thread::interruption_point();
+
+      continue;
+    }
+
+    ssize_t const ret = send(m_fd, bytes.data() + offset, bytes.size() - offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+    if (ret < 0)
+    {
+      int const err = errno;
+
+      if ((err == EINTR) || (err == EAGAIN) || (err == EWOULDBLOCK))
+      {
+        continue;
+      }
+
+      if ((err == EPIPE) || (err == ECONNRESET))
+      {
+        return false;
+      }
+
+      throw_error("send to", "the peer", err);
+    }
+
+    offset += size_t(ret);
+  }
+
+  return true;
+}
+
+socket_channel::bytes_t
+socket_channel
+::read(size_t size)
+{
+  bytes_t bytes;
+
+  bytes.reserve(size);
+
+  while (bytes.size() < size)
+  {
+    if (m_buffer_pos == m_buffer.size())
+    {
+      fill();
+    }
+
+    size_t const count = std::min(size - bytes.size(), m_buffer.size() - m_buffer_pos);
+
+    bytes.append(m_buffer, m_buffer_pos, count);
+    m_buffer_pos += count;
+  }
+
+  return bytes;
+}
+
+bool
+socket_channel
+::readable() const
+{
+  return ((m_buffer_pos < m_buffer.size()) || wait_for(m_fd, POLLIN, 0));
+}
+
+socket_channel::bytes_t
+socket_channel
+::encode_u32(uint32_t value)
+{
+  uint32_t const net_value = htonl(value);
+
+  return bytes_t(reinterpret_cast<char const*>(&net_value), sizeof(uint32_t));
+}
+
+uint32_t
+socket_channel
+::decode_u32(bytes_t const& bytes)
+{
+  uint32_t net_value = 0;
+
+  memcpy(&net_value, bytes.data(), std::min(bytes.size(), sizeof(uint32_t)));
+
+  return ntohl(net_value);
+}
+
+void
+socket_channel
+::listen(std::string const& address)
+{
+  resolved_address const addr(address, true);
+
+  scoped_fd listener(socket(addr.family, SOCK_STREAM, 0));
+
+  if (listener.m_fd < 0)
+  {
+    throw_error("create a socket for", address, errno);
+  }
+
+  if (addr.is_unix())
+  {
+    // Remove a socket left behind by an earlier run.
+    unlink(addr.path.c_str());
+  }
+  else
+  {
+    int const reuse = 1;
+
+    setsockopt(listener.m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  }
+
+  if (bind(listener.m_fd, reinterpret_cast<sockaddr const*>(&addr.storage), addr.length))
+  {
+    throw_error("bind to", address, errno);
+  }
+
+  if (::listen(listener.m_fd, 1))
+  {
+    throw_error("listen on", address, errno);
+  }
+
+  while (!wait_for(listener.m_fd, POLLIN, wait_interval_ms))
+  {
+    boost::this_thread::interruption_point();
+  }
+
+  m_fd = accept(listener.m_fd, NULL, NULL);
+
+  if (m_fd < 0)
+  {
+    throw_error("accept a connection on", address, errno);
+  }
+
+  if (addr.is_unix())
+  {
+    unlink(addr.path.c_str());
+  }
+  else
+  {
+    int const nodelay = 1;
+
+    setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+  }
+}
+
+void
+socket_channel
+::connect(std::string const& address, double timeout)
+{
+  resolved_address const addr(address, false);
+
+  trace::timestamp_t const timeout_ns = trace::timestamp_t(timeout * 1e9);
+  trace::timestamp_t const start = trace::now();
+
+  while (true)
+  {
+    scoped_fd conn(socket(addr.family, SOCK_STREAM, 0));
+
+    if (conn.m_fd < 0)
+    {
+      throw_error("create a socket for", address, errno);
+    }
+
+    if (!::connect(conn.m_fd, reinterpret_cast<sockaddr const*>(&addr.storage), addr.length))
+    {
+      m_fd = conn.release();
+
+      break;
+    }
+
+    int const err = errno;
+
+    // The listening side may not be up yet.
+    if ((err != ECONNREFUSED) && (err != ENOENT) && (err != EINTR))
+    {
+      throw_error("connect to", address, err);
+    }
+
+    if (timeout_ns && (timeout_ns <= (trace::now() - start)))
+    {
+      std::ostringstream sstr;
+
+      sstr << "Failed to connect to " << address << " "
+              "within " << timeout << " seconds: " << strerror(err);
+
+      throw std::runtime_error(sstr.str());
+    }
+
+    boost::this_thread::sleep(boost::posix_time::milliseconds(wait_interval_ms));
+  }
+
+  if (!addr.is_unix())
+  {
+    int const nodelay = 1;
+
+    setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+  }
+}
+
+void
+socket_channel
+::fill()
+{
+  m_buffer.resize(read_chunk_size);
+  m_buffer_pos = 0;
+
+  while (true)
+  {
+    if (!wait_for(m_fd, POLLIN, wait_interval_ms))
+    {
+      boost::this_thread::interruption_point();
+
+      continue;
+    }
+
+    ssize_t const ret = recv(m_fd, &m_buffer[0], m_buffer.size(), 0);
+
+    if (0 < ret)
+    {
+      m_buffer.resize(size_t(ret));
+
+      return;
+    }
+
+    if (!ret)
+    {
+      m_buffer.clear();
+
+      static std::string const reason = "The peer closed the connection";
+
+      throw std::runtime_error(reason);
+    }
+
+    int const err = errno;
+
+    if (err != EINTR)
+    {
+      m_buffer.clear();
+
+      throw_error("receive from", "the peer", err);
+    }
+  }
+}
+
+namespace
+{
+
+resolved_address
+::resolved_address(std::string const& address, bool passive)
+  : family(AF_UNSPEC)
+  , storage()
+  , length(0)
+  , path()
+{
+  memset(&storage, 0, sizeof(storage));
+
+  if (!address.compare(0, prefix_unix.size(), prefix_unix))
+  {
+    path = address.substr(prefix_unix.size());
+
+    sockaddr_un* const sun = reinterpret_cast<sockaddr_un*>(&storage);
+
+    if (path.empty() || (sizeof(sun->sun_path) <= path.size()))
+    {
+      throw_error("use", address, ENAMETOOLONG);
+    }
+
+    sun->sun_family = AF_UNIX;
+    strncpy(sun->sun_path, path.c_str(), sizeof(sun->sun_path) - 1);
+
+    family = AF_UNIX;
+    length = sizeof(sockaddr_un);
+
+    return;
+  }
+
+  size_t const port_pos = address.rfind(':');
+
+  if (address.compare(0, prefix_tcp.size(), prefix_tcp) || (port_pos < prefix_tcp.size()))
+  {
+    std::string const reason = "The address \'" + address + "\' is not "
+                               "of the form \'tcp:HOST:PORT\' or \'unix:PATH\'";
+
+    throw std::runtime_error(reason);
+  }
+
+  std::string const host = address.substr(prefix_tcp.size(), port_pos - prefix_tcp.size());
+  std::string const port = address.substr(port_pos + 1);
+
+  addrinfo hints;
+
+  memset(&hints, 0, sizeof(hints));
+
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = (passive ? AI_PASSIVE : 0);
+
+  addrinfo* result = NULL;
+
+  int const ret = getaddrinfo((host.empty() ? NULL : host.c_str()), port.c_str(), &hints, &result);
+
+  if (ret || !result)
+  {
+    std::string const reason = "Failed to resolve the address \'" + address + "\': " + gai_strerror(ret);
+
+    throw std::runtime_error(reason);
+  }
+
+  family = result->ai_family;
+  length = result->ai_addrlen;
+  memcpy(&storage, result->ai_addr, result->ai_addrlen);
+
+  freeaddrinfo(result);
+}
+
+resolved_address
+::~resolved_address()
+{
+}
+
+bool
+resolved_address
+::is_unix() const
+{
+  return (family == AF_UNIX);
+}
+
+scoped_fd
+::scoped_fd(int fd)
+  : m_fd(fd)
+  , m_released(false)
+{
+}
+
+scoped_fd
+::~scoped_fd()
+{
+  if (!m_released && (0 <= m_fd))
+  {
+    close(m_fd);
+  }
+}
+
+int
+scoped_fd
+::release()
+{
+  m_released = true;
+
+  return m_fd;
+}
+
+bool
+wait_for(int fd, short events, int timeout)
+{
+  pollfd pfd;
+
+  pfd.fd = fd;
+  pfd.events = events;
+  pfd.revents = 0;
+
+  int const ret = poll(&pfd, 1, timeout);
+
+  // Errors and hangups are reported by the call which follows.
+  return (0 < ret);
+}
+
+void
+throw_error(std::string const& action, std::string const& address, int err)
+{
+  std::ostringstream sstr;
+
+  sstr << "Failed to " << action << " "
+       << address << ": " << strerror(err);
+
+  throw std::runtime_error(sstr.str());
+}
+
+}
+
+}
@@ -0,0 +1,162 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PROCESSES_TRANSPORT_SOCKET_CHANNEL_H
+#define SPROKIT_PROCESSES_TRANSPORT_SOCKET_CHANNEL_H
+
+#include "transport-config.h"
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <string>
+
+#include <cstddef>
+
+/**
+ * \file socket_channel.h
+ *
+ * \brief Declaration of a stream socket between two processes.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class socket_channel
+ *
+ * \brief A connected stream socket.
+ *
+ * Addresses are either \c tcp:HOST:PORT or \c unix:PATH. One side listens on
+ * the address and accepts a single peer; the other side connects to it,
+ * retrying until the listening side is up or the connect timeout passes.
+ *
+ * Blocking calls wake up periodically to check for thread interruption so
+ * that schedulers are able to stop processes which use a channel.
+ */
+class SPROKIT_PROCESSES_TRANSPORT_NO_EXPORT socket_channel
+  : boost::noncopyable
+{
+  public:
+    /// The type for bytes sent over the channel.
+    typedef std::string bytes_t;
+
+    /// How the channel is established.
+    typedef enum
+    {
+      /// Accept a connection on the address.
+      mode_listen,
+      /// Connect to the address.
+      mode_connect
+    } mode_t;
+
+    /**
+     * \brief Constructor.
+     *
+     * \throws std::runtime_error Thrown when the address is malformed or cannot be used.
+     * \throws std::runtime_error Thrown when no peer is listening before the connect timeout.
+     *
+     * \param address The address of the channel.
+     * \param mode How to establish the channel.
+     * \param connect_timeout How long to retry connecting, in seconds. Zero retries forever.
+     */
+    socket_channel(std::string const& address, mode_t mode, double connect_timeout = 0);
+    /**
+     * \brief Destructor.
+     */
+    ~socket_channel();
+
+    /**
+     * \brief Send bytes to the peer.
+     *
+     * \throws std::runtime_error Thrown when the peer has gone away.
+     *
+     * \param bytes The bytes to send.
+     */
+    void write(bytes_t const& bytes);
+    /**
+     * \brief Send bytes to the peer if it is still there.
+     *
+     * \throws std::runtime_error Thrown when sending fails for another reason.
+     *
+     * \param bytes The bytes to send.
+     *
+     * \returns False if the peer has closed the connection, true otherwise.
+     */
+    bool write_if_open(bytes_t const& bytes);
+    /**
+     * \brief Receive bytes from the peer.
+     *
+     * Blocks until all of the bytes have arrived. Incoming bytes are
+     * buffered so that small reads do not each cost a system call.
+     *
+     * \throws std::runtime_error Thrown when the peer has gone away.
+     *
+     * \param size The number of bytes to receive.
+     *
+     * \returns The received bytes.
+     */
+    bytes_t read(size_t size);
+    /**
+     * \brief Query whether bytes may be read without blocking.
+     *
+     * \returns True if bytes are waiting, false otherwise.
+     */
+    bool readable() const;
+
+    /**
+     * \brief Encode a 32-bit integer for sending.
+     *
+     * \param value The value to encode.
+     *
+     * \returns The value in network byte order.
+     */
+    static bytes_t encode_u32(uint32_t value);
+    /**
+     * \brief Decode a 32-bit integer which has been received.
+     *
+     * \param bytes The value in network byte order.
+     *
+     * \returns The value.
+     */
+    static uint32_t decode_u32(bytes_t const& bytes);
+  private:
+    void listen(std::string const& address);
+    void connect(std::string const& address, double timeout);
+    void fill();
+
+    int m_fd;
+    bytes_t m_buffer;
+    size_t m_buffer_pos;
+};
+
+}
+
+#endif // SPROKIT_PROCESSES_TRANSPORT_SOCKET_CHANNEL_H
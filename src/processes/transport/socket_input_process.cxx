@@ -0,0 +1,231 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "socket_input_process.h"
+
+#include "socket_channel.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/datum_codec.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/process_exception.h>
+#include <sprokit/pipeline/stamp.h>
+
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <string>
+
+/**
+ * \file socket_input_process.cxx
+ *
+ * \brief Implementation of the socket input process.
+ */
+
+namespace sprokit
+{
+
+class socket_input_process::priv
+{
+  public:
+    typedef std::string address_t;
+    typedef uint32_t count_t;
+
+    priv(address_t const& address_, count_t window_);
+    ~priv();
+
+    address_t const address;
+    count_t const window;
+    count_t const credit_chunk;
+
+    port_type_t type;
+    boost::scoped_ptr<socket_channel> channel;
+    count_t consumed;
+
+    static config::key_t const config_address;
+    static config::key_t const config_window;
+    static config::key_t const config_type;
+    static config::value_t const default_window;
+    static port_t const port_output;
+};
+
+config::key_t const socket_input_process::priv::config_address = config::key_t("address");
+config::key_t const socket_input_process::priv::config_window = config::key_t("window");
+config::key_t const socket_input_process::priv::config_type = config::key_t("type");
+config::value_t const socket_input_process::priv::default_window = config::value_t("64");
+process::port_t const socket_input_process::priv::port_output = port_t("receive");
+
+socket_input_process
+::socket_input_process(config_t const& config)
+  : process(config)
+  , d()
+{
+  declare_configuration_key(
+    priv::config_address,
+    config::value_t(),
+    config::description_t("The address to listen on. Either \'tcp:HOST:PORT\' or \'unix:PATH\'."));
+  declare_configuration_key(
+    priv::config_window,
+    priv::default_window,
+    config::description_t("The most data the sender may have in flight."));
+  declare_configuration_key(
+    priv::config_type,
+    config::value_t(),
+    config::description_t("The type of the received data. If empty, the type is "
+                          "taken from the connected port."));
+
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  // The type is decided once the configuration is known.
+  declare_output_port(
+    priv::port_output,
+    type_data_dependent,
+    required,
+    port_description_t("The received data."));
+}
+
+socket_input_process
+::~socket_input_process()
+{
+}
+
+void
+socket_input_process
+::_configure()
+{
+  // Configure the process.
+  {
+    priv::address_t const address = config_value<priv::address_t>(priv::config_address);
+    priv::count_t const window = config_value<priv::count_t>(priv::config_window);
+
+    d.reset(new priv(address, window));
+  }
+
+  if (d->address.empty())
+  {
+    static std::string const reason = "The address must not be empty";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  if (!d->window)
+  {
+    static std::string const reason = "The window must be positive";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  port_type_t const type = config_value<port_type_t>(priv::config_type);
+
+  // Sinks accept any type, so the connection may not be able to tell us. A
+  // flow-dependent type set here would not be propagated, so the port is data
+  // dependent until now.
+  set_output_port_type(priv::port_output, type.empty() ? type_flow_dependent : type);
+
+  process::_configure();
+}
+
+void
+socket_input_process
+::_init()
+{
+  d->type = output_port_info(priv::port_output)->type;
+
+  if (!datum_codec::has_codec(d->type))
+  {
+    std::string const reason = "There is no codec for the \'" + d->type + "\' type";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  process::_init();
+}
+
+void
+socket_input_process
+::_step()
+{
+  // Wait for the sender here rather than during setup so that the nodes may
+  // start in any order.
+  if (!d->channel)
+  {
+    d->channel.reset(new socket_channel(d->address, socket_channel::mode_listen));
+
+    d->channel->write(socket_channel::encode_u32(d->window));
+  }
+
+  uint32_t const size = socket_channel::decode_u32(d->channel->read(sizeof(uint32_t)));
+  edge_datum_t const edat = datum_codec::decode(d->type, d->channel->read(size));
+  datum_t const& dat = edat.datum;
+  stamp_t const& st = edat.stamp;
+
+  // Origins come from the clock of the sending host, so they are not
+  // comparable with times taken here.
+  stamp_t const local_stamp = stamp::restored_stamp(st->increment(), st->index(), st->stream());
+
+  push_to_port(priv::port_output, edge_datum_t(dat, local_stamp));
+
+  if (is_final_complete(edat))
+  {
+    mark_process_as_complete();
+  }
+  else if (d->credit_chunk <= ++d->consumed)
+  {
+    // The datum is downstream now, so there is room for another. The sender
+    // closes once it has sent its last datum, so it may already be gone; its
+    // data is still read, so only a failed read is an error.
+    d->channel->write_if_open(socket_channel::encode_u32(d->consumed));
+
+    d->consumed = 0;
+  }
+
+  process::_step();
+}
+
+socket_input_process::priv
+::priv(address_t const& address_, count_t window_)
+  : address(address_)
+  , window(window_)
+  , credit_chunk(std::max(count_t(1), window_ / 2))
+  , type()
+  , channel()
+  , consumed(0)
+{
+}
+
+socket_input_process::priv
+::~priv()
+{
+}
+
+}
@@ -0,0 +1,262 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "socket_output_process.h"
+
+#include "socket_channel.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/datum_codec.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/process_exception.h>
+
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+/**
+ * \file socket_output_process.cxx
+ *
+ * \brief Implementation of the socket output process.
+ */
+
+namespace sprokit
+{
+
+class socket_output_process::priv
+{
+  public:
+    typedef std::string address_t;
+    typedef uint32_t count_t;
+
+    priv(address_t const& address_, count_t batch_size_, double connect_timeout_);
+    ~priv();
+
+    void wait_for_credit();
+
+    address_t const address;
+    count_t const batch_size;
+    double const connect_timeout;
+
+    port_type_t type;
+    boost::scoped_ptr<socket_channel> channel;
+    count_t credits;
+
+    static config::key_t const config_address;
+    static config::key_t const config_batch_size;
+    static config::key_t const config_connect_timeout;
+    static config::value_t const default_batch_size;
+    static config::value_t const default_connect_timeout;
+    static port_t const port_input;
+};
+
+config::key_t const socket_output_process::priv::config_address = config::key_t("address");
+config::key_t const socket_output_process::priv::config_batch_size = config::key_t("batch_size");
+config::key_t const socket_output_process::priv::config_connect_timeout = config::key_t("connect_timeout");
+config::value_t const socket_output_process::priv::default_batch_size = config::value_t("16");
+config::value_t const socket_output_process::priv::default_connect_timeout = config::value_t("60");
+process::port_t const socket_output_process::priv::port_input = port_t("send");
+
+socket_output_process
+::socket_output_process(config_t const& config)
+  : process(config)
+  , d()
+{
+  // The end of the stream is handled by the process.
+  set_data_checking_level(check_sync);
+
+  declare_configuration_key(
+    priv::config_address,
+    config::value_t(),
+    config::description_t("The address to send data to. Either \'tcp:HOST:PORT\' or \'unix:PATH\'."));
+  declare_configuration_key(
+    priv::config_batch_size,
+    priv::default_batch_size,
+    config::description_t("The most data to send at once."));
+  declare_configuration_key(
+    priv::config_connect_timeout,
+    priv::default_connect_timeout,
+    config::description_t("How long to wait for the receiver to listen, in seconds. Zero waits forever."));
+
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_input_port(
+    priv::port_input,
+    type_flow_dependent,
+    required,
+    port_description_t("The data to send."));
+}
+
+socket_output_process
+::~socket_output_process()
+{
+}
+
+void
+socket_output_process
+::_configure()
+{
+  // Configure the process.
+  {
+    priv::address_t const address = config_value<priv::address_t>(priv::config_address);
+    priv::count_t const batch_size = config_value<priv::count_t>(priv::config_batch_size);
+    double const connect_timeout = config_value<double>(priv::config_connect_timeout);
+
+    d.reset(new priv(address, batch_size, connect_timeout));
+  }
+
+  if (d->address.empty())
+  {
+    static std::string const reason = "The address must not be empty";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  if (!d->batch_size)
+  {
+    static std::string const reason = "The batch size must be positive";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  if (d->connect_timeout < 0)
+  {
+    static std::string const reason = "The connect timeout must not be negative";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  process::_configure();
+}
+
+void
+socket_output_process
+::_init()
+{
+  d->type = input_port_info(priv::port_input)->type;
+
+  if (!datum_codec::has_codec(d->type))
+  {
+    std::string const reason = "There is no codec for the \'" + d->type + "\' type";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  process::_init();
+}
+
+void
+socket_output_process
+::_step()
+{
+  // Connect lazily so that setting up the pipeline does not depend on the
+  // other node being up.
+  if (!d->channel)
+  {
+    d->channel.reset(new socket_channel(d->address, socket_channel::mode_connect, d->connect_timeout));
+  }
+
+  d->wait_for_credit();
+
+  // Send whatever is already queued along with this datum, but never more
+  // than the receiver has room for.
+  size_t const queued = count_on_port(priv::port_input);
+  priv::count_t const limit = std::min(d->batch_size, d->credits);
+  priv::count_t const count = priv::count_t(std::max(size_t(1), std::min(queued, size_t(limit))));
+
+  socket_channel::bytes_t batch;
+  bool complete = false;
+  priv::count_t sent = 0;
+
+  while ((sent < count) && !complete)
+  {
+    edge_datum_t const edat = grab_from_port(priv::port_input);
+
+    socket_channel::bytes_t const frame = datum_codec::encode(d->type, edat);
+
+    if (std::numeric_limits<uint32_t>::max() < frame.size())
+    {
+      throw std::runtime_error("A datum sent to \'" + d->address + "\' is too large for its size prefix");
+    }
+
+    batch += socket_channel::encode_u32(uint32_t(frame.size()));
+    batch += frame;
+
+    complete = is_final_complete(edat);
+
+    ++sent;
+  }
+
+  d->channel->write(batch);
+  d->credits -= sent;
+
+  if (complete)
+  {
+    mark_process_as_complete();
+  }
+
+  process::_step();
+}
+
+socket_output_process::priv
+::priv(address_t const& address_, count_t batch_size_, double connect_timeout_)
+  : address(address_)
+  , batch_size(batch_size_)
+  , connect_timeout(connect_timeout_)
+  , type()
+  , channel()
+  , credits(0)
+{
+}
+
+socket_output_process::priv
+::~priv()
+{
+}
+
+void
+socket_output_process::priv
+::wait_for_credit()
+{
+  // Collect any credits which have arrived, but only block when there are
+  // none left.
+  while (!credits || channel->readable())
+  {
+    credits += socket_channel::decode_u32(channel->read(sizeof(uint32_t)));
+  }
+}
+
+}
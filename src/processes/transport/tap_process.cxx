@@ -0,0 +1,195 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "tap_process.h"
+
+#include "recording.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/datum_codec.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/process_exception.h>
+#include <sprokit/pipeline/stamp.h>
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * \file tap_process.cxx
+ *
+ * \brief Implementation of the tap process.
+ */
+
+namespace sprokit
+{
+
+class tap_process::priv
+{
+  public:
+    typedef std::string path_t;
+    typedef port_t tag_t;
+
+    priv(path_t const& path_);
+    ~priv();
+
+    path_t const path;
+
+    port_type_t type;
+    boost::scoped_ptr<recording_writer> writer;
+
+    static config::key_t const config_path;
+    static port_t const port_input;
+    static port_t const port_output;
+    static tag_t const tag;
+};
+
+config::key_t const tap_process::priv::config_path = config::key_t("path");
+process::port_t const tap_process::priv::port_input = port_t("tap");
+process::port_t const tap_process::priv::port_output = port_t("tap");
+tap_process::priv::tag_t const tap_process::priv::tag = tag_t("tap");
+
+tap_process
+::tap_process(config_t const& config)
+  : process(config)
+  , d()
+{
+  // The end of the stream is recorded as well.
+  set_data_checking_level(check_sync);
+
+  declare_configuration_key(
+    priv::config_path,
+    config::value_t(),
+    config::description_t("The path to write the recording to."));
+
+  port_flags_t required;
+
+  required.insert(flag_required);
+
+  declare_input_port(
+    priv::port_input,
+    type_flow_dependent + priv::tag,
+    required,
+    port_description_t("The datum to record."));
+
+  declare_output_port(
+    priv::port_output,
+    type_flow_dependent + priv::tag,
+    required,
+    port_description_t("The recorded datum."));
+}
+
+tap_process
+::~tap_process()
+{
+}
+
+void
+tap_process
+::_configure()
+{
+  // Configure the process.
+  {
+    priv::path_t const path = config_value<priv::path_t>(priv::config_path);
+
+    d.reset(new priv(path));
+  }
+
+  if (d->path.empty())
+  {
+    static std::string const reason = "The path must not be empty";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  process::_configure();
+}
+
+void
+tap_process
+::_init()
+{
+  d->type = input_port_info(priv::port_input)->type;
+
+  if (!datum_codec::has_codec(d->type))
+  {
+    std::string const reason = "There is no codec for the \'" + d->type + "\' type";
+
+    throw invalid_configuration_exception(name(), reason);
+  }
+
+  try
+  {
+    d->writer.reset(new recording_writer(d->path, d->type));
+  }
+  catch (std::runtime_error const& e)
+  {
+    throw invalid_configuration_exception(name(), e.what());
+  }
+
+  process::_init();
+}
+
+void
+tap_process
+::_step()
+{
+  edge_datum_t const edat = grab_from_port(priv::port_input);
+  datum_t const& dat = edat.datum;
+  bool const complete = is_final_complete(edat);
+
+  d->writer->write(stamp::now(), datum_codec::encode(d->type, edat));
+
+  push_datum_to_port(priv::port_output, dat);
+
+  if (complete)
+  {
+    d->writer->close();
+
+    mark_process_as_complete();
+  }
+
+  process::_step();
+}
+
+tap_process::priv
+::priv(path_t const& path_)
+  : path(path_)
+  , type()
+  , writer()
+{
+}
+
+tap_process::priv
+::~priv()
+{
+}
+
+}
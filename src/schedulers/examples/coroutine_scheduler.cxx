@@ -0,0 +1,1085 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "coroutine_scheduler.h"
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/scheduler_exception.h>
+#include <sprokit/pipeline/trace.h>
+#include <sprokit/pipeline/utils.h>
+
+#include <boost/coroutine/asymmetric_coroutine.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \file coroutine_scheduler.cxx
+ *
+ * \brief Implementation of the coroutine scheduler.
+ */
+
+namespace sprokit
+{
+
+static thread_name_t const thread_name = thread_name_t("coroutine_worker");
+static thread_name_t const pool_thread_name = thread_name_t("coroutine_pool");
+
+class coroutine_scheduler::priv
+{
+  public:
+    class queue_t;
+
+    priv(coroutine_scheduler* sched, size_t num_threads_, size_t stack_size_, bool shared_, size_t weight_);
+    ~priv();
+
+    class task_t;
+    class worker_hook_t;
+    class observer_t;
+    class pool_t;
+
+    void run_worker();
+    task_t* next_task();
+    void run_slice(task_t* task, bool& complete);
+    void finish_slice(task_t* task, bool complete);
+    void fail(std::string const& reason);
+    void rethrow_failure();
+    void unwind_tasks();
+    void edge_changed(edge const& e);
+    bool runnable() const;
+
+    coroutine_scheduler* const q;
+
+    size_t const num_threads;
+    size_t const stack_size;
+    bool const shared;
+    size_t const weight;
+
+    boost::ptr_vector<task_t> tasks;
+    boost::scoped_ptr<observer_t> observer;
+    edges_t observed;
+
+    typedef std::multimap<edge const*, task_t*> blocked_t;
+
+    // The lock and wakeups for the task queues. Schedulers on the shared pool
+    // use the pool's so that its workers may wait on all of them at once.
+    class queue_t
+    {
+      public:
+        queue_t();
+        ~queue_t();
+
+        boost::mutex mut;
+        boost::condition_variable cond;
+
+        // The number of workers waiting for a task.
+        size_t idle;
+    };
+
+    queue_t own_queue;
+    queue_t& queue;
+
+    // Tasks which may be resumed immediately.
+    std::deque<task_t*> ready;
+    // Tasks suspended while waiting on an edge, keyed by that edge.
+    blocked_t blocked;
+    // The number of tasks which have not completed.
+    size_t remaining;
+    // The number of slices being run by the shared pool.
+    size_t active;
+    // Pausing and stopping on the shared pool only affect this pipeline.
+    bool paused;
+    bool stopped;
+    // The number of slices left in this pipeline's turn on the shared pool.
+    size_t credit;
+    // Identifies the pipeline to pool workers so they know when to apply its
+    // placement.
+    size_t serial;
+    // The first exception thrown by a step stops the pipeline and is reported
+    // from wait(). Only its message is kept since exceptions thrown without
+    // boost::throw_exception cannot be cloned.
+    bool failed;
+    std::string failure;
+
+    boost::condition_variable done_cond;
+
+    boost::thread_group workers;
+
+    typedef boost::shared_mutex mutex_t;
+    typedef boost::shared_lock<mutex_t> shared_lock_t;
+
+    mutable mutex_t mut;
+
+    static config::key_t const config_num_threads;
+    static config::key_t const config_stack_size;
+    static config::key_t const config_shared_pool;
+    static config::key_t const config_weight;
+};
+
+config::key_t const coroutine_scheduler::priv::config_num_threads = config::key_t("num_threads");
+config::key_t const coroutine_scheduler::priv::config_stack_size = config::key_t("stack_size");
+config::key_t const coroutine_scheduler::priv::config_shared_pool = config::key_t("shared_pool");
+config::key_t const coroutine_scheduler::priv::config_weight = config::key_t("weight");
+
+// A process-wide set of workers which runs the tasks of every scheduler
+// attached to it.
+class coroutine_scheduler::priv::pool_t
+  : boost::noncopyable
+{
+  public:
+    ~pool_t();
+
+    static pool_t& instance(size_t num_threads);
+
+    void attach(priv* client);
+    void detach(priv* client);
+
+    queue_t queue;
+  private:
+    pool_t(size_t num_threads);
+
+    void run_worker();
+    task_t* next_task(priv*& client);
+
+    typedef std::vector<priv*> clients_t;
+
+    clients_t clients;
+    // The client whose turn it is.
+    size_t current;
+    size_t next_serial;
+    bool shutdown;
+
+    boost::thread_group workers;
+};
+
+class coroutine_scheduler::priv::task_t
+  : boost::noncopyable
+{
+  public:
+    task_t(process_t const& proc, size_t stack_size);
+    ~task_t();
+
+    bool resume();
+    void unwind();
+    bool can_continue();
+    edge const* waiting_on() const;
+
+    void wait(edge const& e, edge_wait_hook::wait_t what, size_t count);
+  private:
+    typedef boost::coroutines::asymmetric_coroutine<void> coroutine_t;
+
+    void run(coroutine_t::push_type& sink);
+
+    process_t const process;
+    edge_t const monitor_edge;
+
+    coroutine_t::push_type* yield;
+
+    edge const* blocked_edge;
+    edge_wait_hook::wait_t blocked_for;
+    size_t blocked_count;
+
+    boost::scoped_ptr<coroutine_t::pull_type> coro;
+};
+
+class coroutine_scheduler::priv::worker_hook_t
+  : public edge_wait_hook
+{
+  public:
+    worker_hook_t();
+    ~worker_hook_t();
+
+    void wait(edge const& e, wait_t what, size_t count);
+
+    task_t* current;
+};
+
+class coroutine_scheduler::priv::observer_t
+  : public edge_observer
+{
+  public:
+    observer_t(priv* p);
+    ~observer_t();
+
+    void notify(edge const& e, event_t event);
+  private:
+    priv* const d;
+};
+
+static config_t monitor_edge_config();
+
+coroutine_scheduler
+::coroutine_scheduler(pipeline_t const& pipe, config_t const& config)
+  : scheduler(pipe, config)
+  , d()
+{
+  pipeline_t const p = pipeline();
+  process::names_t const names = p->process_names();
+
+  BOOST_FOREACH (process::name_t const& name, names)
+  {
+    process_t const proc = p->process_by_name(name);
+    process::properties_t const consts = proc->properties();
+
+    if (consts.count(process::property_no_threads))
+    {
+      std::string const reason = "The process \'" + name + "\' does "
+                                 "not support being run from multiple threads";
+
+      throw incompatible_pipeline_exception(reason);
+    }
+  }
+
+  size_t num_threads = config->get_value<size_t>(priv::config_num_threads, 0);
+  size_t const stack_size = config->get_value<size_t>(priv::config_stack_size, 0);
+  bool const shared = config->get_value<bool>(priv::config_shared_pool, false);
+  size_t const weight = config->get_value<size_t>(priv::config_weight, 1);
+
+  if (!num_threads)
+  {
+    num_threads = boost::thread::hardware_concurrency();
+  }
+
+  d.reset(new priv(this, std::max(num_threads, size_t(1)), stack_size, shared, std::max(weight, size_t(1))));
+}
+
+coroutine_scheduler
+::~coroutine_scheduler()
+{
+  shutdown();
+}
+
+void
+coroutine_scheduler
+::_start()
+{
+  pipeline_t const p = pipeline();
+  process::names_t const names = p->process_names();
+
+  BOOST_FOREACH (process::name_t const& name, names)
+  {
+    process_t const process = p->process_by_name(name);
+
+    priv::task_t* const task = new priv::task_t(process, d->stack_size);
+
+    d->tasks.push_back(task);
+    d->ready.push_back(task);
+
+    // Every edge is the output of exactly one process.
+    edges_t const edges = p->output_edges_for_process(name);
+
+    d->observed.insert(d->observed.end(), edges.begin(), edges.end());
+  }
+
+  // Admission tokens are waited on like any other edge.
+  edges_t const admission = p->admission_edges();
+
+  d->observed.insert(d->observed.end(), admission.begin(), admission.end());
+
+  BOOST_FOREACH (edge_t const& e, d->observed)
+  {
+    e->add_observer(d->observer.get());
+  }
+
+  if (d->shared)
+  {
+    {
+      boost::unique_lock<boost::mutex> const lock(d->queue.mut);
+
+      (void)lock;
+
+      d->remaining = d->tasks.size();
+    }
+
+    priv::pool_t::instance(d->num_threads).attach(d.get());
+
+    return;
+  }
+
+  // With a single worker every edge is only used from that thread.
+  if (d->num_threads == 1)
+  {
+    p->run_single_threaded();
+  }
+
+  d->remaining = d->tasks.size();
+
+  for (size_t i = 0; i < d->num_threads; ++i)
+  {
+    d->workers.create_thread(boost::bind(&priv::run_worker, d.get()));
+  }
+}
+
+void
+coroutine_scheduler
+::_wait()
+{
+  if (d->shared)
+  {
+    boost::unique_lock<boost::mutex> lock(d->queue.mut);
+
+    while ((d->remaining && !d->stopped) || d->active)
+    {
+      d->done_cond.wait(lock);
+    }
+  }
+  else
+  {
+    d->workers.join_all();
+
+    d->unwind_tasks();
+  }
+
+  d->rethrow_failure();
+}
+
+void
+coroutine_scheduler
+::_pause()
+{
+  if (d->shared)
+  {
+    // Workers of the pool are shared with other pipelines, so they may not be
+    // blocked; this pipeline's tasks are just not handed out.
+    boost::unique_lock<boost::mutex> const lock(d->queue.mut);
+
+    (void)lock;
+
+    d->paused = true;
+
+    return;
+  }
+
+  d->mut.lock();
+}
+
+void
+coroutine_scheduler
+::_resume()
+{
+  if (d->shared)
+  {
+    boost::unique_lock<boost::mutex> const lock(d->queue.mut);
+
+    (void)lock;
+
+    d->paused = false;
+    d->queue.cond.notify_all();
+
+    return;
+  }
+
+  d->mut.unlock();
+}
+
+void
+coroutine_scheduler
+::_stop()
+{
+  if (d->shared)
+  {
+    boost::unique_lock<boost::mutex> lock(d->queue.mut);
+
+    d->stopped = true;
+    d->ready.clear();
+    d->blocked.clear();
+    d->done_cond.notify_all();
+
+    // Slices which are still running own their tasks.
+    while (d->active)
+    {
+      d->done_cond.wait(lock);
+    }
+
+    lock.unlock();
+
+    d->unwind_tasks();
+
+    return;
+  }
+
+  // Workers may be held by a pause until after this returns; their tasks
+  // are unwound once they have been joined.
+  d->workers.interrupt_all();
+}
+
+coroutine_scheduler::priv
+::priv(coroutine_scheduler* sched, size_t num_threads_, size_t stack_size_, bool shared_, size_t weight_)
+  : q(sched)
+  , num_threads(num_threads_)
+  , stack_size(stack_size_)
+  , shared(shared_)
+  , weight(weight_)
+  , tasks()
+  , observer(new observer_t(this))
+  , observed()
+  , own_queue()
+  , queue(shared_ ? pool_t::instance(num_threads_).queue : own_queue)
+  , ready()
+  , blocked()
+  , remaining(0)
+  , active(0)
+  , paused(false)
+  , stopped(false)
+  , credit(weight_)
+  , serial(0)
+  , failed(false)
+  , failure()
+  , done_cond()
+  , workers()
+  , mut()
+{
+}
+
+coroutine_scheduler::priv
+::~priv()
+{
+  if (shared)
+  {
+    pool_t::instance(num_threads).detach(this);
+  }
+
+  BOOST_FOREACH (edge_t const& e, observed)
+  {
+    e->remove_observer(observer.get());
+  }
+}
+
+void
+coroutine_scheduler::priv
+::run_worker()
+{
+  name_thread(thread_name);
+  q->place_thread();
+
+  worker_hook_t hook;
+
+  edge_wait_hook::install(&hook);
+
+  while (task_t* const task = next_task())
+  {
+    bool complete = false;
+
+    {
+      shared_lock_t const lock(mut);
+
+      (void)lock;
+
+      boost::this_thread::interruption_point();
+
+      try
+      {
+        run_slice(task, complete);
+      }
+      catch (boost::thread_interrupted const&)
+      {
+        throw;
+      }
+      catch (std::exception const& e)
+      {
+        fail(e.what());
+      }
+      catch (...)
+      {
+        fail("An unknown exception was thrown");
+      }
+    }
+
+    finish_slice(task, complete);
+  }
+
+  edge_wait_hook::install(NULL);
+}
+
+coroutine_scheduler::priv::task_t*
+coroutine_scheduler::priv
+::next_task()
+{
+  boost::unique_lock<boost::mutex> lock(queue.mut);
+
+  while (remaining && !stopped)
+  {
+    if (!ready.empty())
+    {
+      task_t* const task = ready.front();
+      ready.pop_front();
+
+      return task;
+    }
+
+    ++queue.idle;
+    queue.cond.wait(lock);
+    --queue.idle;
+  }
+
+  return NULL;
+}
+
+void
+coroutine_scheduler::priv
+::run_slice(task_t* task, bool& complete)
+{
+  worker_hook_t* const hook = static_cast<worker_hook_t*>(edge_wait_hook::installed());
+
+  SPROKIT_TRACE_SCOPE(trace_dispatch, "scheduler", "dispatch");
+
+  hook->current = task;
+  complete = task->resume();
+  hook->current = NULL;
+}
+
+void
+coroutine_scheduler::priv
+::finish_slice(task_t* task, bool complete)
+{
+  boost::unique_lock<boost::mutex> const lock(queue.mut);
+
+  (void)lock;
+
+  if (shared)
+  {
+    --active;
+  }
+
+  if (stopped)
+  {
+    // The rest of the pipeline is not run.
+  }
+  else if (complete)
+  {
+    --remaining;
+  }
+  else if (edge const* const e = task->waiting_on())
+  {
+    // The edge may have changed before the task was suspended; its
+    // notification would have been missed.
+    if (task->can_continue())
+    {
+      ready.push_back(task);
+    }
+    else
+    {
+      blocked.insert(blocked_t::value_type(e, task));
+    }
+  }
+  else
+  {
+    ready.push_back(task);
+  }
+
+  if (shared && ((!remaining || stopped) && !active))
+  {
+    done_cond.notify_all();
+  }
+
+  // The task may have made progress which other tasks are waiting on.
+  if (queue.idle)
+  {
+    queue.cond.notify_all();
+  }
+}
+
+void
+coroutine_scheduler::priv
+::edge_changed(edge const& e)
+{
+  boost::unique_lock<boost::mutex> const lock(queue.mut);
+
+  (void)lock;
+
+  std::pair<blocked_t::iterator, blocked_t::iterator> const range = blocked.equal_range(&e);
+  blocked_t::iterator i = range.first;
+  bool woke = false;
+
+  while (i != range.second)
+  {
+    task_t* const task = i->second;
+
+    if (task->can_continue())
+    {
+      ready.push_back(task);
+      blocked.erase(i++);
+      woke = true;
+    }
+    else
+    {
+      ++i;
+    }
+  }
+
+  if (woke && queue.idle)
+  {
+    queue.cond.notify_all();
+  }
+}
+
+void
+coroutine_scheduler::priv
+::fail(std::string const& reason)
+{
+  boost::unique_lock<boost::mutex> const lock(queue.mut);
+
+  (void)lock;
+
+  if (!failed)
+  {
+    failed = true;
+    failure = reason;
+  }
+
+  // Nothing else in the pipeline is run; every worker waiting for a task
+  // must notice.
+  stopped = true;
+  ready.clear();
+  blocked.clear();
+
+  queue.cond.notify_all();
+  done_cond.notify_all();
+}
+
+void
+coroutine_scheduler::priv
+::rethrow_failure()
+{
+  bool was_failed;
+  std::string reason;
+
+  {
+    boost::unique_lock<boost::mutex> const lock(queue.mut);
+
+    (void)lock;
+
+    was_failed = failed;
+    reason = failure;
+
+    failed = false;
+    failure.clear();
+  }
+
+  if (was_failed)
+  {
+    throw step_failed_exception(reason);
+  }
+}
+
+void
+coroutine_scheduler::priv
+::unwind_tasks()
+{
+  // Tasks suspended in the middle of a step hold resources on their stacks;
+  // release them now rather than when the scheduler is destroyed.
+  BOOST_FOREACH (task_t& task, tasks)
+  {
+    task.unwind();
+  }
+}
+
+bool
+coroutine_scheduler::priv
+::runnable() const
+{
+  return (!paused && !stopped && !ready.empty());
+}
+
+coroutine_scheduler::priv::queue_t
+::queue_t()
+  : mut()
+  , cond()
+  , idle(0)
+{
+}
+
+coroutine_scheduler::priv::queue_t
+::~queue_t()
+{
+}
+
+coroutine_scheduler::priv::pool_t
+::pool_t(size_t num_threads)
+  : queue()
+  , clients()
+  , current(0)
+  , next_serial(0)
+  , shutdown(false)
+  , workers()
+{
+  for (size_t i = 0; i < num_threads; ++i)
+  {
+    workers.create_thread(boost::bind(&pool_t::run_worker, this));
+  }
+}
+
+coroutine_scheduler::priv::pool_t
+::~pool_t()
+{
+  {
+    boost::unique_lock<boost::mutex> const lock(queue.mut);
+
+    (void)lock;
+
+    shutdown = true;
+    queue.cond.notify_all();
+  }
+
+  workers.join_all();
+}
+
+coroutine_scheduler::priv::pool_t&
+coroutine_scheduler::priv::pool_t
+::instance(size_t num_threads)
+{
+  // The first scheduler to use the pool sets its size.
+  static pool_t pool(num_threads);
+
+  return pool;
+}
+
+void
+coroutine_scheduler::priv::pool_t
+::attach(priv* client)
+{
+  boost::unique_lock<boost::mutex> const lock(queue.mut);
+
+  (void)lock;
+
+  client->serial = ++next_serial;
+
+  clients.push_back(client);
+  queue.cond.notify_all();
+}
+
+void
+coroutine_scheduler::priv::pool_t
+::detach(priv* client)
+{
+  boost::unique_lock<boost::mutex> lock(queue.mut);
+
+  // Slices which are still running refer to the client.
+  while (client->active)
+  {
+    client->done_cond.wait(lock);
+  }
+
+  clients_t::iterator const i = std::find(clients.begin(), clients.end(), client);
+
+  if (i == clients.end())
+  {
+    return;
+  }
+
+  size_t const pos = i - clients.begin();
+
+  clients.erase(i);
+
+  if (pos < current)
+  {
+    --current;
+  }
+
+  if (clients.size() <= current)
+  {
+    current = 0;
+  }
+}
+
+void
+coroutine_scheduler::priv::pool_t
+::run_worker()
+{
+  name_thread(pool_thread_name);
+
+  worker_hook_t hook;
+
+  edge_wait_hook::install(&hook);
+
+  priv* client = NULL;
+  // The pipeline whose placement the thread currently has.
+  size_t placed = 0;
+
+  while (task_t* const task = next_task(client))
+  {
+    bool complete = false;
+
+    // Each pipeline's placement applies while its tasks run.
+    if (client->serial != placed)
+    {
+      client->q->place_thread();
+      placed = client->serial;
+    }
+
+    try
+    {
+      client->run_slice(task, complete);
+    }
+    catch (std::exception const& e)
+    {
+      client->fail(e.what());
+    }
+    catch (...)
+    {
+      client->fail("An unknown exception was thrown");
+    }
+
+    client->finish_slice(task, complete);
+  }
+
+  edge_wait_hook::install(NULL);
+}
+
+coroutine_scheduler::priv::task_t*
+coroutine_scheduler::priv::pool_t
+::next_task(priv*& client)
+{
+  boost::unique_lock<boost::mutex> lock(queue.mut);
+
+  while (!shutdown)
+  {
+    // Each pipeline gets as many slices in a row as its weight before the
+    // next pipeline gets its turn.
+    for (size_t n = 0; n < (2 * clients.size()); ++n)
+    {
+      client = clients[current];
+
+      if (client->credit && client->runnable())
+      {
+        task_t* const task = client->ready.front();
+        client->ready.pop_front();
+
+        --client->credit;
+        ++client->active;
+
+        if (!client->credit)
+        {
+          client->credit = client->weight;
+          current = (current + 1) % clients.size();
+        }
+
+        return task;
+      }
+
+      client->credit = client->weight;
+      current = (current + 1) % clients.size();
+    }
+
+    ++queue.idle;
+    queue.cond.wait(lock);
+    --queue.idle;
+  }
+
+  return NULL;
+}
+
+coroutine_scheduler::priv::task_t
+::task_t(process_t const& proc, size_t stack_size)
+  : process(proc)
+  , monitor_edge(boost::make_shared<edge>(monitor_edge_config()))
+  , yield(NULL)
+  , blocked_edge(NULL)
+  , blocked_for(edge_wait_hook::wait_for_data)
+  , blocked_count(0)
+  , coro()
+{
+  process->connect_output_port(process::port_heartbeat, monitor_edge);
+
+  boost::coroutines::attributes attrs;
+
+  if (stack_size)
+  {
+    attrs.size = stack_size;
+  }
+
+  // The coroutine runs until its first yield on construction.
+  coro.reset(new coroutine_t::pull_type(boost::bind(&task_t::run, this, _1), attrs));
+}
+
+coroutine_scheduler::priv::task_t
+::~task_t()
+{
+}
+
+bool
+coroutine_scheduler::priv::task_t
+::resume()
+{
+  if (!coro)
+  {
+    return true;
+  }
+
+  (*coro)();
+
+  return !*coro;
+}
+
+void
+coroutine_scheduler::priv::task_t
+::unwind()
+{
+  // Destroying a suspended coroutine unwinds its stack.
+  coro.reset();
+}
+
+bool
+coroutine_scheduler::priv::task_t
+::can_continue()
+{
+  if (!blocked_edge)
+  {
+    return true;
+  }
+
+  bool can = false;
+
+  switch (blocked_for)
+  {
+    case edge_wait_hook::wait_for_data:
+      can = (blocked_count <= blocked_edge->datum_count());
+      break;
+    case edge_wait_hook::wait_for_space:
+      can = !blocked_edge->full_of_data();
+      break;
+    default:
+      break;
+  }
+
+  if (can)
+  {
+    blocked_edge = NULL;
+  }
+
+  return can;
+}
+
+edge const*
+coroutine_scheduler::priv::task_t
+::waiting_on() const
+{
+  return blocked_edge;
+}
+
+void
+coroutine_scheduler::priv::task_t
+::wait(edge const& e, edge_wait_hook::wait_t what, size_t count)
+{
+  blocked_edge = &e;
+  blocked_for = what;
+  blocked_count = count;
+
+  (*yield)();
+}
+
+void
+coroutine_scheduler::priv::task_t
+::run(coroutine_t::push_type& sink)
+{
+  yield = &sink;
+
+  sink();
+
+  while (true)
+  {
+    process->step();
+
+    while (monitor_edge->has_data())
+    {
+      edge_datum_t const edat = monitor_edge->get_datum();
+      datum_t const dat = edat.datum;
+
+      if (dat->type() == datum::complete)
+      {
+        return;
+      }
+    }
+
+    sink();
+  }
+}
+
+coroutine_scheduler::priv::worker_hook_t
+::worker_hook_t()
+  : current(NULL)
+{
+}
+
+coroutine_scheduler::priv::worker_hook_t
+::~worker_hook_t()
+{
+}
+
+void
+coroutine_scheduler::priv::worker_hook_t
+::wait(edge const& e, wait_t what, size_t count)
+{
+  current->wait(e, what, count);
+}
+
+coroutine_scheduler::priv::observer_t
+::observer_t(priv* p)
+  : d(p)
+{
+}
+
+coroutine_scheduler::priv::observer_t
+::~observer_t()
+{
+}
+
+void
+coroutine_scheduler::priv::observer_t
+::notify(edge const& e, event_t /*event*/)
+{
+  d->edge_changed(e);
+}
+
+config_t
+monitor_edge_config()
+{
+  config_t conf = config::empty_config();
+
+  return conf;
+}
+
+}
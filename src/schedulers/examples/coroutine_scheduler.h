@@ -0,0 +1,124 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_SCHEDULERS_EXAMPLES_SCHEDULERS_COROUTINE_SCHEDULER_H
+#define SPROKIT_SCHEDULERS_EXAMPLES_SCHEDULERS_COROUTINE_SCHEDULER_H
+
+#include "examples-config.h"
+
+#include <sprokit/pipeline/scheduler.h>
+
+#include <boost/scoped_ptr.hpp>
+
+/**
+ * \file coroutine_scheduler.h
+ *
+ * \brief Declaration of the coroutine scheduler.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class coroutine_scheduler
+ *
+ * \brief A scheduler which multiplexes processes over a pool of threads.
+ *
+ * \scheduler Run each process in a coroutine on a pool of worker threads.
+ *
+ * Each process is stepped within its own stackful coroutine. When a process
+ * would block on an edge (no data to read or no space to write), its
+ * coroutine is suspended instead of blocking the worker thread and is
+ * resumed once the edge can make progress. This allows large pipelines to
+ * run on as many threads as there are cores.
+ *
+ * Many pipelines may share one process-wide pool of workers instead of each
+ * starting their own. Pipelines on the pool take turns; each turn runs as
+ * many slices as the pipeline's weight. Pausing or stopping a scheduler only
+ * affects its own pipeline. A pool worker takes on the placement of each
+ * pipeline (see \ref scheduler::place_thread) while running its tasks.
+ *
+ * Tasks suspended in the middle of a step when the pipeline stops are
+ * unwound once no worker is running them.
+ *
+ * \configs
+ *
+ * \config{num_threads} The number of worker threads. A setting of \c 0 means
+ * "auto". For the shared pool, the first scheduler to use it sets its size.
+ * \config{stack_size} The size of the stack (in bytes) for each process. A
+ * setting of \c 0 uses the default size.
+ * \config{shared_pool} Whether to run on the process-wide pool of workers.
+ * \config{weight} The share of the shared pool given to the pipeline relative
+ * to other pipelines.
+ */
+class SPROKIT_SCHEDULERS_EXAMPLES_NO_EXPORT coroutine_scheduler
+  : public scheduler
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param config Contains config for the edge.
+     * \param pipe The pipeline to scheduler.
+     */
+    coroutine_scheduler(pipeline_t const& pipe, config_t const& config);
+    /**
+     * \brief Destructor.
+     */
+    ~coroutine_scheduler();
+  protected:
+    /**
+     * \brief Starts execution.
+     */
+    void _start();
+    /**
+     * \brief Waits until execution is finished.
+     */
+    void _wait();
+    /**
+     * \brief Pauses execution.
+     */
+    void _pause();
+    /**
+     * \brief Resumes execution.
+     */
+    void _resume();
+    /**
+     * \brief Stop execution of the pipeline.
+     */
+    void _stop();
+  private:
+    class priv;
+    boost::scoped_ptr<priv> d;
+};
+
+}
+
+#endif // SPROKIT_SCHEDULERS_EXAMPLES_SCHEDULERS_COROUTINE_SCHEDULER_H
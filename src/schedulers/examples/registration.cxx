@@ -30,6 +30,9 @@
 
 #include "registration.h"
 
+#ifdef HAVE_COROUTINE_SCHEDULER
+#include "coroutine_scheduler.h"
+#endif
 #include "sync_scheduler.h"
 #include "thread_per_process_scheduler.h"
 #include "thread_pool_scheduler.h"
@@ -59,6 +62,9 @@ register_schedulers()
   registry->register_scheduler("sync", "Run the pipeline synchronously", create_scheduler<sync_scheduler>);
   registry->register_scheduler("thread_per_process", "Run each process in its own thread", create_scheduler<thread_per_process_scheduler>);
   registry->register_scheduler("thread_pool", "Use a pool of threads to step processes", create_scheduler<thread_pool_scheduler>);
+#ifdef HAVE_COROUTINE_SCHEDULER
+  registry->register_scheduler("coroutine", "Run processes as coroutines on a pool of threads", create_scheduler<coroutine_scheduler>);
+#endif
 
   registry->mark_module_as_loaded(module_name);
 }
@@ -36,6 +36,7 @@
 #include <sprokit/pipeline/pipeline.h>
 #include <sprokit/pipeline/process.h>
 #include <sprokit/pipeline/scheduler_exception.h>
+#include <sprokit/pipeline/trace.h>
 #include <sprokit/pipeline/utils.h>
 
 #include <boost/graph/directed_graph.hpp>
@@ -48,9 +49,11 @@
 #include <boost/make_shared.hpp>
 
 #include <deque>
+#include <exception>
 #include <iterator>
 #include <map>
 #include <queue>
+#include <string>
 
 /**
  * \file sync_scheduler.cxx
@@ -66,13 +69,20 @@ static thread_name_t const thread_name = thread_name_t("sync_scheduler");
 class sync_scheduler::priv
 {
   public:
-    priv();
+    priv(sync_scheduler* sched);
     ~priv();
 
     void run(pipeline_t const& pipe);
+    void run_processes(pipeline_t const& pipe);
+
+    sync_scheduler* const q;
 
     boost::thread thread;
 
+    // Set by the thread before it exits; only read once it has been joined.
+    bool failed;
+    std::string failure;
+
     typedef boost::shared_mutex mutex_t;
     typedef boost::shared_lock<mutex_t> shared_lock_t;
 
@@ -82,7 +92,7 @@ class sync_scheduler::priv
 sync_scheduler
 ::sync_scheduler(pipeline_t const& pipe, config_t const& config)
   : scheduler(pipe, config)
-  , d(new priv)
+  , d(new priv(this))
 {
   pipeline_t const p = pipeline();
   process::names_t const names = p->process_names();
@@ -120,6 +130,9 @@ void
 sync_scheduler
 ::_start()
 {
+  // Every process is stepped from the one thread started here.
+  pipeline()->run_single_threaded();
+
   d->thread = boost::thread(boost::bind(&priv::run, d.get(), pipeline()));
 }
 
@@ -128,6 +141,16 @@ sync_scheduler
 ::_wait()
 {
   d->thread.join();
+
+  if (d->failed)
+  {
+    std::string const reason = d->failure;
+
+    d->failed = false;
+    d->failure.clear();
+
+    throw step_failed_exception(reason);
+  }
 }
 
 void
@@ -152,8 +175,11 @@ ::_stop()
 }
 
 sync_scheduler::priv
-::priv()
-  : thread()
+::priv(sync_scheduler* sched)
+  : q(sched)
+  , thread()
+  , failed(false)
+  , failure()
   , mut()
 {
 }
@@ -169,8 +195,35 @@ static config_t monitor_edge_config();
 void
 sync_scheduler::priv
 ::run(pipeline_t const& pipe)
+{
+  // An exception escaping the thread would terminate the program, so it is
+  // reported from wait() instead.
+  try
+  {
+    run_processes(pipe);
+  }
+  catch (boost::thread_interrupted const&)
+  {
+    throw;
+  }
+  catch (std::exception const& e)
+  {
+    failed = true;
+    failure = e.what();
+  }
+  catch (...)
+  {
+    failed = true;
+    failure = "An unknown exception was thrown";
+  }
+}
+
+void
+sync_scheduler::priv
+::run_processes(pipeline_t const& pipe)
 {
   name_thread(thread_name);
+  q->place_thread();
 
   process::names_t const names = sorted_names(pipe);
   std::queue<process_t> processes;
@@ -183,6 +236,8 @@ ::run(pipeline_t const& pipe)
     process_t const proc = pipe->process_by_name(name);
     edge_t const monitor_edge = boost::make_shared<edge>(edge_conf);
 
+    monitor_edge->set_synchronized(false);
+
     proc->connect_output_port(process::port_heartbeat, monitor_edge);
     monitor_edges[name] = monitor_edge;
 
@@ -197,6 +252,8 @@ ::run(pipeline_t const& pipe)
 
     boost::this_thread::interruption_point();
 
+    SPROKIT_TRACE_SCOPE(trace_dispatch, "scheduler", "dispatch");
+
     process_t proc = processes.front();
     processes.pop();
 
@@ -51,6 +51,10 @@ namespace sprokit
  *
  * \brief A scheduler which runs the entire pipeline in one thread.
  *
+ * Every process is stepped once per pass over the pipeline. Since nothing else
+ * can drain an edge while a process waits on it, admission windows only work
+ * when the sources and sinks run at the same frequency.
+ *
  * \scheduler Run the pipeline in one thread.
  */
 class SPROKIT_SCHEDULERS_EXAMPLES_NO_EXPORT sync_scheduler
@@ -75,6 +79,8 @@ class SPROKIT_SCHEDULERS_EXAMPLES_NO_EXPORT sync_scheduler
     void _start();
     /**
      * \brief Waits until execution is finished.
+     *
+     * \throws step_failed_exception Thrown when stepping a process failed.
      */
     void _wait();
     /**
@@ -35,6 +35,7 @@
 #include <sprokit/pipeline/edge.h>
 #include <sprokit/pipeline/pipeline.h>
 #include <sprokit/pipeline/scheduler_exception.h>
+#include <sprokit/pipeline/trace.h>
 #include <sprokit/pipeline/utils.h>
 
 #include <boost/thread/locks.hpp>
@@ -43,6 +44,9 @@
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 
+#include <set>
+#include <vector>
+
 /**
  * \file thread_per_process_scheduler.cxx
  *
@@ -55,10 +59,13 @@ namespace sprokit
 class thread_per_process_scheduler::priv
 {
   public:
-    priv();
+    priv(thread_per_process_scheduler* sched);
     ~priv();
 
     void run_process(process_t const& process);
+    void run_chain(processes_t const& processes, edges_t const& links);
+
+    thread_per_process_scheduler* const q;
 
     boost::scoped_ptr<boost::thread_group> process_threads;
 
@@ -71,7 +78,7 @@ class thread_per_process_scheduler::priv
 thread_per_process_scheduler
 ::thread_per_process_scheduler(pipeline_t const& pipe, config_t const& config)
   : scheduler(pipe, config)
-  , d(new priv)
+  , d(new priv(this))
 {
   pipeline_t const p = pipeline();
   process::names_t const names = p->process_names();
@@ -106,8 +113,45 @@ ::_start()
 
   d->process_threads.reset(new boost::thread_group);
 
+  pipeline::chains_t const chains = p->fused_chains();
+  std::set<process::name_t> fused;
+
+  BOOST_FOREACH (process::names_t const& chain, chains)
+  {
+    processes_t processes;
+    edges_t links;
+
+    BOOST_FOREACH (process::name_t const& name, chain)
+    {
+      processes.push_back(p->process_by_name(name));
+      fused.insert(name);
+
+      if (name != chain.back())
+      {
+        // Processes within a chain have exactly one output edge.
+        edges_t const edges = p->output_edges_for_process(name);
+
+        links.push_back(edges.front());
+      }
+    }
+
+    // Only the chain's thread uses the edges within it, so they need no locks.
+    // The pipeline synchronizes them again when it is stopped.
+    BOOST_FOREACH (edge_t const& link, links)
+    {
+      link->set_synchronized(false);
+    }
+
+    d->process_threads->create_thread(boost::bind(&priv::run_chain, d.get(), processes, links));
+  }
+
   BOOST_FOREACH (process::name_t const& name, names)
   {
+    if (fused.count(name))
+    {
+      continue;
+    }
+
     process_t const process = pipeline()->process_by_name(name);
 
     d->process_threads->create_thread(boost::bind(&priv::run_process, d.get(), process));
@@ -143,8 +187,9 @@ ::_stop()
 }
 
 thread_per_process_scheduler::priv
-::priv()
-  : process_threads()
+::priv(thread_per_process_scheduler* sched)
+  : q(sched)
+  , process_threads()
   , mut()
 {
 }
@@ -155,6 +200,7 @@ thread_per_process_scheduler::priv
 }
 
 static config_t monitor_edge_config();
+static bool is_complete(edge_t const& monitor_edge);
 
 void
 thread_per_process_scheduler::priv
@@ -163,6 +209,7 @@ ::run_process(process_t const& process)
   config_t const edge_conf = monitor_edge_config();
 
   name_thread(process->name());
+  q->place_thread(process);
   edge_t monitor_edge = boost::make_shared<edge>(edge_conf);
 
   process->connect_output_port(process::port_heartbeat, monitor_edge);
@@ -177,21 +224,104 @@ ::run_process(process_t const& process)
 
     boost::this_thread::interruption_point();
 
+    SPROKIT_TRACE_SCOPE(trace_dispatch, "scheduler", "dispatch");
+
     process->step();
 
-    while (monitor_edge->has_data())
+    complete = is_complete(monitor_edge);
+  }
+}
+
+void
+thread_per_process_scheduler::priv
+::run_chain(processes_t const& processes, edges_t const& links)
+{
+  config_t const edge_conf = monitor_edge_config();
+
+  process_t const& head = processes.front();
+
+  name_thread(head->name());
+  q->place_thread(head);
+
+  size_t const count = processes.size();
+
+  edges_t monitor_edges;
+  std::vector<bool> complete(count, false);
+
+  BOOST_FOREACH (process_t const& process, processes)
+  {
+    edge_t const monitor_edge = boost::make_shared<edge>(edge_conf);
+
+    process->connect_output_port(process::port_heartbeat, monitor_edge);
+
+    monitor_edges.push_back(monitor_edge);
+  }
+
+  size_t remaining = count;
+
+  while (remaining)
+  {
+    shared_lock_t const lock(mut);
+
+    (void)lock;
+
+    boost::this_thread::interruption_point();
+
+    // Data is handed down the chain within a single pass. A process is
+    // skipped if stepping it would block on an edge which only this thread
+    // can service. The head is always stepped, so while it waits for input
+    // from outside the chain, nothing else in the chain runs.
+    for (size_t i = 0; i < count; ++i)
     {
-      edge_datum_t const edat = monitor_edge->get_datum();
-      datum_t const dat = edat.datum;
+      if (complete[i])
+      {
+        continue;
+      }
+
+      if (i && !links[i - 1]->has_data())
+      {
+        continue;
+      }
+
+      if ((i + 1 < count) && links[i]->full_of_data())
+      {
+        continue;
+      }
 
-      if (dat->type() == datum::complete)
       {
-        complete = true;
+        SPROKIT_TRACE_SCOPE(trace_dispatch, "scheduler", "dispatch");
+
+        processes[i]->step();
+      }
+
+      if (is_complete(monitor_edges[i]))
+      {
+        complete[i] = true;
+        --remaining;
       }
     }
   }
 }
 
+bool
+is_complete(edge_t const& monitor_edge)
+{
+  bool complete = false;
+
+  while (monitor_edge->has_data())
+  {
+    edge_datum_t const edat = monitor_edge->get_datum();
+    datum_t const dat = edat.datum;
+
+    if (dat->type() == datum::complete)
+    {
+      complete = true;
+    }
+  }
+
+  return complete;
+}
+
 config_t
 monitor_edge_config()
 {
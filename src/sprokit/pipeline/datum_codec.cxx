@@ -0,0 +1,431 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "datum_codec.h"
+
+#include "record.h"
+#include "stamp.h"
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/cstdint.hpp>
+
+#include <map>
+#include <sstream>
+#include <utility>
+
+/**
+ * \file datum_codec.cxx
+ *
+ * \brief Implementation of serializing \link sprokit::datum data\endlink.
+ */
+
+namespace sprokit
+{
+
+namespace
+{
+
+typedef std::pair<datum_codec::encoder_t, datum_codec::decoder_t> codec_t;
+typedef std::map<process::port_type_t, codec_t> codec_map_t;
+
+class codec_registry
+{
+  public:
+    codec_registry();
+    ~codec_registry();
+
+    boost::mutex mut;
+    codec_map_t codecs;
+};
+
+static codec_registry& registry();
+
+static datum_codec::bytes_t encode_integer(datum_t const& dat);
+static datum_t decode_integer(datum_codec::bytes_t const& bytes);
+static datum_codec::bytes_t encode_string(datum_t const& dat);
+static datum_t decode_string(datum_codec::bytes_t const& bytes);
+static datum_codec::bytes_t encode_record(datum_t const& dat);
+static datum_t decode_record(datum_codec::bytes_t const& bytes);
+
+// Fixed-width fields are written in little-endian order so that the framing
+// does not depend on the host.
+static void write_u64(datum_codec::bytes_t& bytes, uint64_t value);
+static uint64_t read_u64(datum_codec::bytes_t const& bytes, size_t& pos);
+
+// The type, increment, index, stream, origin flag and origin.
+static size_t const header_size = 1 + 8 + 8 + 8 + 1 + 8;
+
+}
+
+void
+datum_codec
+::register_codec(process::port_type_t const& type, encoder_t const& encoder, decoder_t const& decoder)
+{
+  codec_registry& reg = registry();
+
+  boost::mutex::scoped_lock const lock(reg.mut);
+
+  (void)lock;
+
+  reg.codecs[type] = codec_t(encoder, decoder);
+}
+
+bool
+datum_codec
+::has_codec(process::port_type_t const& type)
+{
+  codec_registry& reg = registry();
+
+  boost::mutex::scoped_lock const lock(reg.mut);
+
+  (void)lock;
+
+  return (0 != reg.codecs.count(type));
+}
+
+datum_codec::bytes_t
+datum_codec
+::encode(process::port_type_t const& type, edge_datum_t const& edat)
+{
+  datum_t const& dat = edat.datum;
+  stamp_t const& st = edat.stamp;
+
+  datum::type_t const dtype = dat->type();
+
+  bytes_t bytes;
+
+  bytes.reserve(header_size);
+
+  bytes.push_back(static_cast<char>(dtype));
+  write_u64(bytes, st->increment());
+  write_u64(bytes, st->index());
+  write_u64(bytes, st->stream());
+  bytes.push_back(st->has_origin() ? 1 : 0);
+  write_u64(bytes, st->origin());
+
+  switch (dtype)
+  {
+    case datum::data:
+      {
+        encoder_t encoder;
+
+        {
+          codec_registry& reg = registry();
+
+          boost::mutex::scoped_lock const lock(reg.mut);
+
+          (void)lock;
+
+          codec_map_t::const_iterator const i = reg.codecs.find(type);
+
+          if (i == reg.codecs.end())
+          {
+            throw no_datum_codec_exception(type);
+          }
+
+          encoder = i->second.first;
+        }
+
+        bytes += encoder(dat);
+      }
+
+      break;
+    case datum::error:
+      bytes += dat->get_error();
+      break;
+    case datum::empty:
+    case datum::invalid:
+    case datum::flush:
+    case datum::complete:
+    default:
+      break;
+  }
+
+  return bytes;
+}
+
+edge_datum_t
+datum_codec
+::decode(process::port_type_t const& type, bytes_t const& bytes)
+{
+  if (bytes.size() < header_size)
+  {
+    static std::string const reason = "The data is shorter than the header";
+
+    throw datum_decode_exception(reason);
+  }
+
+  size_t pos = 0;
+
+  datum::type_t const dtype = static_cast<datum::type_t>(bytes[pos++]);
+  stamp::increment_t const increment = read_u64(bytes, pos);
+  stamp::index_t const index = read_u64(bytes, pos);
+  stamp::stream_t const stream = read_u64(bytes, pos);
+  bool const has_origin = (0 != bytes[pos++]);
+  stamp::origin_t const origin = read_u64(bytes, pos);
+
+  bytes_t const payload = bytes.substr(pos);
+
+  stamp_t st = stamp::restored_stamp(increment, index, stream);
+
+  if (has_origin)
+  {
+    st = stamp::origin_stamp(st, origin);
+  }
+
+  datum_t dat;
+
+  switch (dtype)
+  {
+    case datum::data:
+      {
+        decoder_t decoder;
+
+        {
+          codec_registry& reg = registry();
+
+          boost::mutex::scoped_lock const lock(reg.mut);
+
+          (void)lock;
+
+          codec_map_t::const_iterator const i = reg.codecs.find(type);
+
+          if (i == reg.codecs.end())
+          {
+            throw no_datum_codec_exception(type);
+          }
+
+          decoder = i->second.second;
+        }
+
+        dat = decoder(payload);
+      }
+
+      break;
+    case datum::empty:
+      dat = datum::empty_datum();
+      break;
+    case datum::error:
+      dat = datum::error_datum(payload);
+      break;
+    case datum::flush:
+      dat = datum::flush_datum();
+      break;
+    case datum::complete:
+      dat = datum::complete_datum();
+      break;
+    case datum::invalid:
+    default:
+      {
+        static std::string const reason = "The datum type is not known";
+
+        throw datum_decode_exception(reason);
+      }
+  }
+
+  return edge_datum_t(dat, st);
+}
+
+void
+datum_codec
+::check_size(bytes_t const& bytes, size_t size)
+{
+  if (bytes.size() != size)
+  {
+    std::ostringstream sstr;
+
+    sstr << "Expected " << size << " bytes, "
+            "but received " << bytes.size();
+
+    throw datum_decode_exception(sstr.str());
+  }
+}
+
+datum_codec_exception
+::datum_codec_exception() SPROKIT_NOTHROW
+  : pipeline_exception()
+{
+}
+
+datum_codec_exception
+::~datum_codec_exception() SPROKIT_NOTHROW
+{
+}
+
+no_datum_codec_exception
+::no_datum_codec_exception(process::port_type_t const& type) SPROKIT_NOTHROW
+  : datum_codec_exception()
+  , m_type(type)
+{
+  std::ostringstream sstr;
+
+  sstr << "There is no codec for data "
+          "of the \'" << m_type << "\' type";
+
+  m_what = sstr.str();
+}
+
+no_datum_codec_exception
+::~no_datum_codec_exception() SPROKIT_NOTHROW
+{
+}
+
+datum_decode_exception
+::datum_decode_exception(std::string const& reason) SPROKIT_NOTHROW
+  : datum_codec_exception()
+  , m_reason(reason)
+{
+  std::ostringstream sstr;
+
+  sstr << "Failed to decode a datum: " << m_reason;
+
+  m_what = sstr.str();
+}
+
+datum_decode_exception
+::~datum_decode_exception() SPROKIT_NOTHROW
+{
+}
+
+namespace
+{
+
+codec_registry
+::codec_registry()
+  : mut()
+  , codecs()
+{
+  codecs["integer"] = codec_t(&encode_integer, &decode_integer);
+  codecs["string"] = codec_t(&encode_string, &decode_string);
+  codecs["record"] = codec_t(&encode_record, &decode_record);
+}
+
+codec_registry
+::~codec_registry()
+{
+}
+
+codec_registry&
+registry()
+{
+  static codec_registry reg;
+
+  return reg;
+}
+
+datum_codec::bytes_t
+encode_integer(datum_t const& dat)
+{
+  uint32_t const value = static_cast<uint32_t>(dat->get_datum<int32_t>());
+
+  datum_codec::bytes_t bytes;
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+
+  return bytes;
+}
+
+datum_t
+decode_integer(datum_codec::bytes_t const& bytes)
+{
+  if (bytes.size() != 4)
+  {
+    static std::string const reason = "An integer is not four bytes long";
+
+    throw datum_decode_exception(reason);
+  }
+
+  uint32_t value = 0;
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    uint32_t const byte = static_cast<unsigned char>(bytes[i]);
+
+    value |= (byte << (8 * i));
+  }
+
+  return datum::new_datum(static_cast<int32_t>(value));
+}
+
+datum_codec::bytes_t
+encode_string(datum_t const& dat)
+{
+  return dat->get_datum<std::string>();
+}
+
+datum_t
+decode_string(datum_codec::bytes_t const& bytes)
+{
+  return datum::new_datum(bytes);
+}
+
+datum_codec::bytes_t
+encode_record(datum_t const& dat)
+{
+  return dat->get_datum<record>().bytes();
+}
+
+datum_t
+decode_record(datum_codec::bytes_t const& bytes)
+{
+  return datum::new_datum(record(bytes));
+}
+
+void
+write_u64(datum_codec::bytes_t& bytes, uint64_t value)
+{
+  for (size_t i = 0; i < 8; ++i)
+  {
+    bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+uint64_t
+read_u64(datum_codec::bytes_t const& bytes, size_t& pos)
+{
+  uint64_t value = 0;
+
+  for (size_t i = 0; i < 8; ++i)
+  {
+    uint64_t const byte = static_cast<unsigned char>(bytes[pos++]);
+
+    value |= (byte << (8 * i));
+  }
+
+  return value;
+}
+
+}
+
+}
@@ -0,0 +1,247 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PIPELINE_DATUM_CODEC_H
+#define SPROKIT_PIPELINE_DATUM_CODEC_H
+
+#include "pipeline-config.h"
+
+#include "datum.h"
+#include "edge.h"
+#include "process.h"
+#include "types.h"
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <string>
+
+#include <cstring>
+
+/**
+ * \file datum_codec.h
+ *
+ * \brief Header for serializing \link sprokit::datum data\endlink.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class datum_codec datum_codec.h <sprokit/pipeline/datum_codec.h>
+ *
+ * \brief Serializes data so that it may leave the process.
+ *
+ * Payloads are encoded by codecs registered for a port type. Stamps and the
+ * type of a datum are encoded the same way for every port type, so only
+ * #datum::data datums need a codec. Codecs for the \c integer, \c string, and
+ * \c record (see \ref record) port types are always available.
+ *
+ * \ingroup base_classes
+ */
+class SPROKIT_PIPELINE_EXPORT datum_codec
+  : boost::noncopyable
+{
+  public:
+    /// The type for serialized data.
+    typedef std::string bytes_t;
+    /// The type of a function which serializes the payload of a datum.
+    typedef boost::function<bytes_t (datum_t const&)> encoder_t;
+    /// The type of a function which creates a datum from a serialized payload.
+    typedef boost::function<datum_t (bytes_t const&)> decoder_t;
+
+    /**
+     * \brief Register a codec for a port type.
+     *
+     * A codec registered for a type which already has one replaces it.
+     *
+     * \param type The port type the codec is for.
+     * \param encoder The function to serialize payloads with.
+     * \param decoder The function to deserialize payloads with.
+     */
+    static void register_codec(process::port_type_t const& type, encoder_t const& encoder, decoder_t const& decoder);
+    /**
+     * \brief Register a codec which copies the bytes of a type.
+     *
+     * \note The bytes are in host order.
+     *
+     * \param type The port type the codec is for.
+     */
+    template <typename T>
+    static void register_pod_codec(process::port_type_t const& type);
+    /**
+     * \brief Query whether a port type has a codec.
+     *
+     * \param type The port type to query.
+     *
+     * \returns True if data on \p type ports may be serialized, false otherwise.
+     */
+    static bool has_codec(process::port_type_t const& type);
+
+    /**
+     * \brief Serialize an edge datum.
+     *
+     * \throws no_datum_codec_exception Thrown when \p edat holds data and \p type has no codec.
+     *
+     * \param type The port type the datum is from.
+     * \param edat The edge datum to serialize.
+     *
+     * \returns The serialized edge datum.
+     */
+    static bytes_t encode(process::port_type_t const& type, edge_datum_t const& edat);
+    /**
+     * \brief Deserialize an edge datum.
+     *
+     * \throws no_datum_codec_exception Thrown when \p bytes holds data and \p type has no codec.
+     * \throws datum_decode_exception Thrown when \p bytes is malformed.
+     *
+     * \param type The port type the datum is for.
+     * \param bytes The serialized edge datum.
+     *
+     * \returns The edge datum.
+     */
+    static edge_datum_t decode(process::port_type_t const& type, bytes_t const& bytes);
+  private:
+    template <typename T>
+    static bytes_t encode_pod(datum_t const& dat);
+    template <typename T>
+    static datum_t decode_pod(bytes_t const& bytes);
+
+    static void check_size(bytes_t const& bytes, size_t size);
+};
+
+/**
+ * \class datum_codec_exception datum_codec.h <sprokit/pipeline/datum_codec.h>
+ *
+ * \brief The base class for all exceptions thrown from \ref datum_codec.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT datum_codec_exception
+  : public pipeline_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     */
+    datum_codec_exception() throw();
+    /**
+     * \brief Destructor.
+     */
+    virtual ~datum_codec_exception() throw();
+};
+
+/**
+ * \class no_datum_codec_exception datum_codec.h <sprokit/pipeline/datum_codec.h>
+ *
+ * \brief Thrown when data is serialized for a port type without a codec.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT no_datum_codec_exception
+  : public datum_codec_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param type The port type without a codec.
+     */
+    no_datum_codec_exception(process::port_type_t const& type) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~no_datum_codec_exception() throw();
+
+    /// The port type without a codec.
+    process::port_type_t const m_type;
+};
+
+/**
+ * \class datum_decode_exception datum_codec.h <sprokit/pipeline/datum_codec.h>
+ *
+ * \brief Thrown when serialized data is malformed.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT datum_decode_exception
+  : public datum_codec_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param reason The reason the data could not be decoded.
+     */
+    datum_decode_exception(std::string const& reason) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~datum_decode_exception() throw();
+
+    /// The reason the data could not be decoded.
+    std::string const m_reason;
+};
+
+template <typename T>
+void
+datum_codec
+::register_pod_codec(process::port_type_t const& type)
+{
+  register_codec(type, &encode_pod<T>, &decode_pod<T>);
+}
+
+template <typename T>
+datum_codec::bytes_t
+datum_codec
+::encode_pod(datum_t const& dat)
+{
+  T const value = dat->get_datum<T>();
+
+  return bytes_t(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template <typename T>
+datum_t
+datum_codec
+::decode_pod(bytes_t const& bytes)
+{
+  check_size(bytes, sizeof(T));
+
+  T value;
+
+  memcpy(&value, bytes.data(), sizeof(T));
+
+  return datum::new_datum(value);
+}
+
+}
+
+#endif // SPROKIT_PIPELINE_DATUM_CODEC_H
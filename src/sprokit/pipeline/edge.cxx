@@ -31,15 +31,36 @@
 #include "edge.h"
 #include "edge_exception.h"
 
+#include "datum_codec.h"
+#include "log.h"
+
 #include "stamp.h"
+#include "trace.h"
 #include "types.h"
 
+#include <boost/detail/atomic_count.hpp>
+#include <boost/foreach.hpp>
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 
+#include <algorithm>
 #include <deque>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
 
 /**
  * \file edge.cxx
@@ -50,6 +71,53 @@
 namespace sprokit
 {
 
+static logger const edge_log("edge");
+
+namespace
+{
+
+// A queue of serialized data in an unlinked temporary file. Writes and reads
+// go through buffers so that the file is touched in large chunks.
+class spill_file
+{
+  public:
+    typedef std::string bytes_t;
+
+    spill_file(std::string const& dir);
+    ~spill_file();
+
+    void push(bytes_t const& bytes);
+    void pop(bytes_t& bytes);
+    void clear();
+
+    size_t count() const;
+  private:
+    void open_file();
+    void flush_writes();
+    void write_bytes(char const* data, size_t size, off_t pos);
+    void read_bytes(char* dest, size_t size);
+    void compact();
+
+    typedef uint32_t length_t;
+
+    static size_t const chunk_size;
+    static off_t const compact_after;
+
+    std::string const dir;
+    int fd;
+    size_t records;
+    // Bytes in the file; everything before read_pos has been read.
+    off_t file_size;
+    off_t read_pos;
+    bytes_t rbuf;
+    size_t rbuf_pos;
+    // Bytes not yet written; everything before wbuf_pos has been read.
+    bytes_t wbuf;
+    size_t wbuf_pos;
+};
+
+}
+
 edge_datum_t
 ::edge_datum_t()
   : datum()
@@ -79,22 +147,61 @@ ::operator == (edge_datum_t const& rhs) const
 
 config::key_t const edge::config_dependency = config::key_t("_dependency");
 config::key_t const edge::config_capacity = config::key_t("capacity");
+config::key_t const edge::config_policy = config::key_t("policy");
+config::key_t const edge::config_spill_after = config::key_t("spill_after");
+config::key_t const edge::config_spill_dir = config::key_t("spill_dir");
+config::key_t const edge::config_type = config::key_t("_type");
 
 class edge::priv
 {
   public:
-    priv(bool depends_, size_t capacity_);
+    priv(bool depends_, size_t capacity_, policy_t policy_);
     ~priv();
 
     typedef boost::weak_ptr<process> process_ref_t;
 
     bool has_data() const;
     bool full_of_data() const;
+    bool is_ready(edge_wait_hook::wait_t what, size_t count) const;
     void complete_check() const;
+    bool make_room();
+
+    size_t count() const;
+    void enqueue(edge_datum_t const& datum);
+    void dequeue();
+    void fill_head(size_t size);
+    void clear();
+
+    static bool is_droppable(edge_datum_t const& edat);
+    static policy_t policy_from_string(config::value_t const& value);
+
+    template <typename Lock>
+    void wait_until(Lock& lock, edge const& e, edge_wait_hook::wait_t what, size_t count = 1);
+
+    void notify_observers(edge const& e, edge_observer::event_t event) const;
+
+    template <typename Lock>
+    void acquire(Lock& lock) const;
+    void notify(boost::condition_variable_any& cond) const;
 
     bool const depends;
     size_t const capacity;
+    policy_t const policy;
     bool downstream_complete;
+    size_t dropped;
+    size_t pushed;
+    size_t popped;
+
+    // Spilling keeps spill_after data in the head (q) and tail and writes
+    // the rest to disk. The head is refilled from the disk, then the tail.
+    size_t spill_after;
+    process::port_type_t type;
+    std::string spill_dir;
+    boost::scoped_ptr<spill_file> spill;
+
+    // When zero, the edge is only used from a single thread and no locking
+    // or signaling is done. It is read without a lock, so it is atomic.
+    boost::detail::atomic_count synchronized;
 
     process_ref_t upstream;
     process_ref_t downstream;
@@ -102,6 +209,7 @@ class edge::priv
     typedef std::deque<edge_datum_t> edge_queue_t;
 
     edge_queue_t q;
+    edge_queue_t tail;
 
     boost::condition_variable_any cond_have_data;
     boost::condition_variable_any cond_have_space;
@@ -114,6 +222,19 @@ class edge::priv
 
     mutable mutex_t mutex;
     mutable mutex_t complete_mutex;
+
+    // The number of data the reader is waiting for. Only accessed with an
+    // upgrade or unique lock on the mutex.
+    size_t data_wanted;
+    // The number of data at the front of the head which the reader has
+    // peeked at. The policy does not drop them so that the reader takes what
+    // it looked at. Only accessed with an upgrade or unique lock on the mutex.
+    size_t peeked;
+
+    typedef std::vector<edge_observer*> observers_t;
+
+    observers_t observers;
+    mutable boost::mutex observers_mutex;
 };
 
 edge
@@ -127,13 +248,39 @@ ::edge(config_t const& config)
 
   bool const depends = config->get_value<bool>(config_dependency, true);
   size_t const capacity = config->get_value<size_t>(config_capacity, 0);
+  config::value_t const policy = config->get_value<config::value_t>(config_policy, "block");
+  size_t const spill_after = config->get_value<size_t>(config_spill_after, 0);
 
   if (capacity != 0)
   {
-    std::cerr << "DEBUG - Edge capacity set to: " << capacity << std::endl;
+    SPROKIT_LOG_DEBUG(edge_log, "Edge capacity set to: " << capacity);
   }
 
-  d.reset(new priv(depends, capacity));
+  d.reset(new priv(depends, capacity, priv::policy_from_string(policy)));
+
+  if (spill_after)
+  {
+    d->spill_after = spill_after;
+    d->type = config->get_value<process::port_type_t>(config_type, process::port_type_t());
+    d->spill_dir = config->get_value<config::value_t>(config_spill_dir, config::value_t());
+
+    if (d->policy != policy_block)
+    {
+      throw edge_spill_exception("only edges which block when full may spill");
+    }
+
+    if (!datum_codec::has_codec(d->type))
+    {
+      throw edge_spill_exception("there is no codec for the \'" + d->type + "\' type");
+    }
+
+    if (d->spill_dir.empty())
+    {
+      char const* const tmpdir = getenv("TMPDIR");
+
+      d->spill_dir = (tmpdir ? tmpdir : "/tmp");
+    }
+  }
 }
 
 edge
@@ -152,9 +299,9 @@ bool
 edge
 ::has_data() const
 {
-  priv::shared_lock_t const lock(d->mutex);
+  priv::shared_lock_t lock(d->mutex, boost::defer_lock);
 
-  (void)lock;
+  d->acquire(lock);
 
   return d->has_data();
 }
@@ -163,9 +310,9 @@ bool
 edge
 ::full_of_data() const
 {
-  priv::shared_lock_t const lock(d->mutex);
+  priv::shared_lock_t lock(d->mutex, boost::defer_lock);
 
-  (void)lock;
+  d->acquire(lock);
 
   return d->full_of_data();
 }
@@ -174,11 +321,62 @@ size_t
 edge
 ::datum_count() const
 {
-  priv::shared_lock_t const lock(d->mutex);
+  priv::shared_lock_t lock(d->mutex, boost::defer_lock);
 
-  (void)lock;
+  d->acquire(lock);
+
+  return d->count();
+}
+
+edge::policy_t
+edge
+::policy() const
+{
+  return d->policy;
+}
+
+size_t
+edge
+::dropped_count() const
+{
+  priv::shared_lock_t lock(d->mutex, boost::defer_lock);
+
+  d->acquire(lock);
+
+  return d->dropped;
+}
+
+size_t
+edge
+::pushed_count() const
+{
+  priv::shared_lock_t lock(d->mutex, boost::defer_lock);
+
+  d->acquire(lock);
+
+  return d->pushed;
+}
 
-  return d->q.size();
+size_t
+edge
+::popped_count() const
+{
+  priv::shared_lock_t lock(d->mutex, boost::defer_lock);
+
+  d->acquire(lock);
+
+  return d->popped;
+}
+
+size_t
+edge
+::spilled_count() const
+{
+  priv::shared_lock_t lock(d->mutex, boost::defer_lock);
+
+  d->acquire(lock);
+
+  return (d->spill ? d->spill->count() : 0);
 }
 
 void
@@ -186,9 +384,9 @@ edge
 ::push_datum(edge_datum_t const& datum)
 {
   {
-    priv::shared_lock_t const lock(d->complete_mutex);
+    priv::shared_lock_t lock(d->complete_mutex, boost::defer_lock);
 
-    (void)lock;
+    d->acquire(lock);
 
     // If downstream process has marked itself as complete, do nothing
     if (d->downstream_complete)
@@ -197,24 +395,49 @@ ::push_datum(edge_datum_t const& datum)
     }
   }
 
+  bool data_wanted = false;
+
   {
-    priv::upgrade_lock_t lock(d->mutex);
+    priv::upgrade_lock_t lock(d->mutex, boost::defer_lock);
+
+    d->acquire(lock);
 
-    while (d->full_of_data())
+    if ((d->policy != policy_block) && priv::is_droppable(datum))
     {
-      d->cond_have_space.wait(lock);
+      priv::upgrade_to_unique_lock_t const write_lock(lock);
+
+      (void)write_lock;
+
+      if (!d->make_room())
+      {
+        return;
+      }
     }
 
+    d->wait_until(lock, *this, edge_wait_hook::wait_for_space);
+
     {
       priv::upgrade_to_unique_lock_t const write_lock(lock);
 
       (void)write_lock;
 
-      d->q.push_back(datum);
+      d->enqueue(datum);
+
+      if (datum.datum->type() == datum::data)
+      {
+        ++d->pushed;
+      }
+
+      data_wanted = (d->count() == d->data_wanted);
     }
   }
 
-  d->cond_have_data.notify_one();
+  d->notify(d->cond_have_data);
+
+  if (data_wanted)
+  {
+    d->notify_observers(*this, edge_observer::data_available);
+  }
 }
 
 edge_datum_t
@@ -224,29 +447,82 @@ ::get_datum()
   d->complete_check();
 
   edge_datum_t dat;
+  bool was_full = false;
 
   {
-    priv::upgrade_lock_t lock(d->mutex);
+    priv::upgrade_lock_t lock(d->mutex, boost::defer_lock);
+
+    d->acquire(lock);
+
+    d->wait_until(lock, *this, edge_wait_hook::wait_for_data);
 
-    while (!d->has_data())
     {
-      d->cond_have_data.wait(lock);
+      priv::upgrade_to_unique_lock_t const write_lock(lock);
+
+      (void)write_lock;
+
+      d->fill_head(1);
+
+      dat = d->q.front();
+
+      was_full = d->full_of_data();
+
+      d->dequeue();
     }
+  }
+
+  d->notify(d->cond_have_space);
 
-    dat = d->q.front();
+  if (was_full)
+  {
+    d->notify_observers(*this, edge_observer::space_available);
+  }
+
+  return dat;
+}
+
+edge_data_t
+edge
+::get_data(size_t n)
+{
+  d->complete_check();
+
+  edge_data_t data;
+  bool was_full = false;
+
+  {
+    priv::upgrade_lock_t lock(d->mutex, boost::defer_lock);
+
+    d->acquire(lock);
+
+    d->wait_until(lock, *this, edge_wait_hook::wait_for_data, n);
 
     {
       priv::upgrade_to_unique_lock_t const write_lock(lock);
 
       (void)write_lock;
 
-      d->q.pop_front();
+      d->fill_head(n);
+
+      data.assign(d->q.begin(), d->q.begin() + n);
+
+      was_full = d->full_of_data();
+
+      for (size_t i = 0; i < n; ++i)
+      {
+        d->dequeue();
+      }
     }
   }
 
-  d->cond_have_space.notify_one();
+  d->notify(d->cond_have_space);
 
-  return dat;
+  if (was_full)
+  {
+    d->notify_observers(*this, edge_observer::space_available);
+  }
+
+  return data;
 }
 
 edge_datum_t
@@ -255,11 +531,21 @@ ::peek_datum(size_t idx) const
 {
   d->complete_check();
 
-  priv::shared_lock_t lock(d->mutex);
+  // An upgrade lock is needed since waiting may update the wanted count.
+  priv::upgrade_lock_t lock(d->mutex, boost::defer_lock);
+
+  d->acquire(lock);
+
+  d->wait_until(lock, *this, edge_wait_hook::wait_for_data, idx + 1);
 
-  while (d->q.size() <= idx)
+  if ((d->q.size() <= idx) || (d->peeked <= idx))
   {
-    d->cond_have_data.wait(lock);
+    priv::upgrade_to_unique_lock_t const write_lock(lock);
+
+    (void)write_lock;
+
+    d->fill_head(idx + 1);
+    d->peeked = idx + 1;
   }
 
   return d->q.at(idx);
@@ -271,54 +557,117 @@ ::pop_datum()
 {
   d->complete_check();
 
+  bool was_full = false;
+
   {
-    priv::upgrade_lock_t lock(d->mutex);
+    priv::upgrade_lock_t lock(d->mutex, boost::defer_lock);
 
-    while (!d->has_data())
-    {
-      d->cond_have_data.wait(lock);
-    }
+    d->acquire(lock);
+
+    d->wait_until(lock, *this, edge_wait_hook::wait_for_data);
 
     {
       priv::upgrade_to_unique_lock_t const write_lock(lock);
 
       (void)write_lock;
 
-      d->q.pop_front();
+      was_full = d->full_of_data();
+
+      d->fill_head(1);
+      d->dequeue();
     }
   }
 
-  d->cond_have_space.notify_one();
+  d->notify(d->cond_have_space);
+
+  if (was_full)
+  {
+    d->notify_observers(*this, edge_observer::space_available);
+  }
 }
 
 void
 edge
 ::mark_downstream_as_complete()
 {
-  priv::unique_lock_t const complete_lock(d->complete_mutex);
-  priv::unique_lock_t const lock(d->mutex);
+  bool was_full = false;
 
-  (void)complete_lock;
-  (void)lock;
+  {
+    priv::unique_lock_t complete_lock(d->complete_mutex, boost::defer_lock);
+    priv::unique_lock_t lock(d->mutex, boost::defer_lock);
 
-  d->downstream_complete = true;
+    d->acquire(complete_lock);
+    d->acquire(lock);
 
-  while (!d->q.empty())
+    d->downstream_complete = true;
+
+    was_full = d->full_of_data();
+
+    d->clear();
+  }
+
+  d->notify(d->cond_have_space);
+
+  if (was_full)
   {
-    d->q.pop_front();
+    d->notify_observers(*this, edge_observer::space_available);
   }
+}
 
-  d->cond_have_space.notify_one();
+void
+edge
+::set_synchronized(bool sync)
+{
+  // Only one thread changes the flag, so checking it first does not race.
+  if (sync && !d->synchronized)
+  {
+    ++d->synchronized;
+  }
+  else if (!sync && d->synchronized)
+  {
+    --d->synchronized;
+  }
 }
 
 bool
 edge
-::is_downstream_complete() const
+::is_synchronized() const
+{
+  return (d->synchronized != 0);
+}
+
+void
+edge
+::add_observer(edge_observer* observer)
 {
-  priv::shared_lock_t const lock(d->complete_mutex);
+  boost::mutex::scoped_lock const lock(d->observers_mutex);
 
   (void)lock;
 
+  d->observers.push_back(observer);
+}
+
+void
+edge
+::remove_observer(edge_observer* observer)
+{
+  boost::mutex::scoped_lock const lock(d->observers_mutex);
+
+  (void)lock;
+
+  priv::observers_t& observers = d->observers;
+
+  observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+bool
+edge
+::is_downstream_complete() const
+{
+  priv::shared_lock_t lock(d->complete_mutex, boost::defer_lock);
+
+  d->acquire(lock);
+
   return d->downstream_complete;
 }
 
@@ -360,18 +709,75 @@ ::set_downstream_process(process_t process)
   d->downstream = process;
 }
 
+namespace
+{
+
+static void no_cleanup(edge_wait_hook* hook);
+
+static boost::thread_specific_ptr<edge_wait_hook> thread_hook(no_cleanup);
+
+}
+
+edge_wait_hook
+::edge_wait_hook()
+{
+}
+
+edge_wait_hook
+::~edge_wait_hook()
+{
+}
+
+void
+edge_wait_hook
+::install(edge_wait_hook* hook)
+{
+  thread_hook.reset(hook);
+}
+
+edge_wait_hook*
+edge_wait_hook
+::installed()
+{
+  return thread_hook.get();
+}
+
+edge_observer
+::edge_observer()
+{
+}
+
+edge_observer
+::~edge_observer()
+{
+}
+
 edge::priv
-::priv(bool depends_, size_t capacity_)
+::priv(bool depends_, size_t capacity_, policy_t policy_)
   : depends(depends_)
   , capacity(capacity_)
+  , policy(policy_)
   , downstream_complete(false)
+  , dropped(0)
+  , pushed(0)
+  , popped(0)
+  , spill_after(0)
+  , type()
+  , spill_dir()
+  , spill()
+  , synchronized(1)
   , upstream()
   , downstream()
   , q()
+  , tail()
   , cond_have_data()
   , cond_have_space()
   , mutex()
   , complete_mutex()
+  , data_wanted(1)
+  , peeked(0)
+  , observers()
+  , observers_mutex()
 {
 }
 
@@ -384,6 +790,7 @@ bool
 edge::priv
 ::has_data() const
 {
+  // The head is only empty when everything else is.
   return !q.empty();
 }
 
@@ -396,16 +803,33 @@ ::full_of_data() const
     return false;
   }
 
-  return (q.size() == capacity);
+  return (count() == capacity);
+}
+
+bool
+edge::priv
+::is_ready(edge_wait_hook::wait_t what, size_t count) const
+{
+  switch (what)
+  {
+    case edge_wait_hook::wait_for_data:
+      return (count <= this->count());
+    case edge_wait_hook::wait_for_space:
+      return !full_of_data();
+    default:
+      break;
+  }
+
+  return false;
 }
 
 void
 edge::priv
 ::complete_check() const
 {
-  shared_lock_t const lock(complete_mutex);
+  shared_lock_t lock(complete_mutex, boost::defer_lock);
 
-  (void)lock;
+  acquire(lock);
 
   if (downstream_complete)
   {
@@ -413,4 +837,560 @@ ::complete_check() const
   }
 }
 
+bool
+edge::priv
+::make_room()
+{
+  switch (policy)
+  {
+    case policy_drop_oldest:
+      if (full_of_data())
+      {
+        edge_queue_t::iterator const i = std::find_if(q.begin() + peeked, q.end(), is_droppable);
+
+        // Without anything to drop, the push blocks as usual.
+        if (i != q.end())
+        {
+          q.erase(i);
+          ++dropped;
+        }
+      }
+
+      break;
+    case policy_drop_newest:
+      if (full_of_data())
+      {
+        ++dropped;
+
+        return false;
+      }
+
+      break;
+    case policy_latest_only:
+      {
+        edge_queue_t::iterator const i = std::remove_if(q.begin() + peeked, q.end(), is_droppable);
+
+        dropped += std::distance(i, q.end());
+        q.erase(i, q.end());
+      }
+
+      break;
+    case policy_block:
+    default:
+      break;
+  }
+
+  return true;
+}
+
+size_t
+edge::priv
+::count() const
+{
+  return (q.size() + (spill ? spill->count() : 0) + tail.size());
+}
+
+void
+edge::priv
+::enqueue(edge_datum_t const& datum)
+{
+  bool const spilling = (!tail.empty() || (spill && spill->count()));
+
+  if (!spill_after || (!spilling && (q.size() < spill_after)))
+  {
+    q.push_back(datum);
+
+    return;
+  }
+
+  tail.push_back(datum);
+
+  if (tail.size() <= spill_after)
+  {
+    return;
+  }
+
+  if (!spill)
+  {
+    spill.reset(new spill_file(spill_dir));
+  }
+
+  spill->push(datum_codec::encode(type, tail.front()));
+  tail.pop_front();
+}
+
+void
+edge::priv
+::dequeue()
+{
+  if (q.front().datum->type() == datum::data)
+  {
+    ++popped;
+  }
+
+  q.pop_front();
+
+  if (peeked)
+  {
+    --peeked;
+  }
+
+  // Refill in batches so that the disk is not read for every datum.
+  if (spill_after && (q.size() < ((spill_after + 1) / 2)))
+  {
+    fill_head(spill_after);
+  }
+}
+
+void
+edge::priv
+::fill_head(size_t size)
+{
+  spill_file::bytes_t bytes;
+
+  while (q.size() < size)
+  {
+    if (spill && spill->count())
+    {
+      spill->pop(bytes);
+      q.push_back(datum_codec::decode(type, bytes));
+    }
+    else if (!tail.empty())
+    {
+      q.push_back(tail.front());
+      tail.pop_front();
+    }
+    else
+    {
+      break;
+    }
+  }
+}
+
+void
+edge::priv
+::clear()
+{
+  q.clear();
+  tail.clear();
+  peeked = 0;
+
+  if (spill)
+  {
+    spill->clear();
+  }
+}
+
+bool
+edge::priv
+::is_droppable(edge_datum_t const& edat)
+{
+  datum::type_t const type = edat.datum->type();
+
+  return ((type != datum::flush) &&
+          (type != datum::complete));
+}
+
+edge::policy_t
+edge::priv
+::policy_from_string(config::value_t const& value)
+{
+  if (value == "block")
+  {
+    return policy_block;
+  }
+  else if (value == "drop_oldest")
+  {
+    return policy_drop_oldest;
+  }
+  else if (value == "drop_newest")
+  {
+    return policy_drop_newest;
+  }
+  else if (value == "latest_only")
+  {
+    return policy_latest_only;
+  }
+
+  throw invalid_edge_policy_exception(value);
+}
+
+template <typename Lock>
+void
+edge::priv
+::wait_until(Lock& lock, edge const& e, edge_wait_hook::wait_t what, size_t count)
+{
+  if (is_ready(what, count))
+  {
+    return;
+  }
+
+  SPROKIT_TRACE_SCOPE(trace_wait, "edge", (what == edge_wait_hook::wait_for_data) ? "wait_for_data" : "wait_for_space");
+
+  bool const for_data = (what == edge_wait_hook::wait_for_data);
+  boost::condition_variable_any& cond = (for_data ? cond_have_data : cond_have_space);
+
+  // Observers are told about data once the edge holds as much as the reader
+  // is waiting for.
+  if (for_data)
+  {
+    data_wanted = count;
+  }
+
+  while (!is_ready(what, count))
+  {
+    // The hook may resume the caller on a different thread, so look it up on
+    // each pass.
+    edge_wait_hook* const hook = edge_wait_hook::installed();
+
+    // Whether the lock is held is checked rather than the synchronization
+    // flag since the flag may be flipped when the pipeline stops.
+    bool const locked = lock.owns_lock();
+
+    if (hook)
+    {
+      if (locked)
+      {
+        lock.unlock();
+      }
+
+      hook->wait(e, what, count);
+
+      if (locked)
+      {
+        lock.lock();
+      }
+    }
+    else if (locked)
+    {
+      cond.wait(lock);
+    }
+    else
+    {
+      // Nothing else can change the edge.
+      throw unsynchronized_edge_wait_exception();
+    }
+  }
+
+  if (for_data)
+  {
+    data_wanted = 1;
+  }
+}
+
+void
+edge::priv
+::notify_observers(edge const& e, edge_observer::event_t event) const
+{
+  boost::mutex::scoped_lock lock(observers_mutex, boost::defer_lock);
+
+  acquire(lock);
+
+  BOOST_FOREACH (edge_observer* const observer, observers)
+  {
+    observer->notify(e, event);
+  }
+}
+
+namespace
+{
+
+void
+no_cleanup(edge_wait_hook* /*hook*/)
+{
+}
+
+}
+
+template <typename Lock>
+void
+edge::priv
+::acquire(Lock& lock) const
+{
+  if (synchronized)
+  {
+    lock.lock();
+  }
+}
+
+void
+edge::priv
+::notify(boost::condition_variable_any& cond) const
+{
+  if (synchronized)
+  {
+    cond.notify_one();
+  }
+}
+
+size_t const spill_file::chunk_size = 64 * 1024;
+off_t const spill_file::compact_after = 16 * off_t(spill_file::chunk_size);
+
+spill_file
+::spill_file(std::string const& dir_)
+  : dir(dir_)
+  , fd(-1)
+  , records(0)
+  , file_size(0)
+  , read_pos(0)
+  , rbuf()
+  , rbuf_pos(0)
+  , wbuf()
+  , wbuf_pos(0)
+{
+}
+
+spill_file
+::~spill_file()
+{
+  if (fd != -1)
+  {
+    close(fd);
+  }
+}
+
+void
+spill_file
+::push(bytes_t const& bytes)
+{
+  if (std::numeric_limits<length_t>::max() < bytes.size())
+  {
+    throw edge_spill_exception("a datum is too large for its size prefix");
+  }
+
+  length_t const length = length_t(bytes.size());
+
+  wbuf.append(reinterpret_cast<char const*>(&length), sizeof(length));
+  wbuf.append(bytes);
+
+  ++records;
+
+  if (chunk_size <= (wbuf.size() - wbuf_pos))
+  {
+    flush_writes();
+  }
+}
+
+void
+spill_file
+::pop(bytes_t& bytes)
+{
+  length_t length;
+
+  read_bytes(reinterpret_cast<char*>(&length), sizeof(length));
+
+  bytes.resize(length);
+
+  if (length)
+  {
+    read_bytes(&bytes[0], length);
+  }
+
+  --records;
+
+  if (!records)
+  {
+    clear();
+  }
+  // An edge which never drains would otherwise grow the file without bound.
+  // Moving the unread bytes only once at least as many have been read keeps
+  // the copying to at most one extra write per byte.
+  else if ((compact_after <= read_pos) && ((file_size - read_pos) <= read_pos))
+  {
+    compact();
+  }
+}
+
+void
+spill_file
+::clear()
+{
+  records = 0;
+  read_pos = 0;
+  rbuf.clear();
+  rbuf_pos = 0;
+  wbuf.clear();
+  wbuf_pos = 0;
+
+  // Give the space back once everything has been read.
+  if (file_size && (ftruncate(fd, 0) != 0))
+  {
+    throw edge_spill_exception(std::string("truncate: ") + strerror(errno));
+  }
+
+  file_size = 0;
+}
+
+size_t
+spill_file
+::count() const
+{
+  return records;
+}
+
+void
+spill_file
+::open_file()
+{
+  std::string path_template = dir + "/sprokit-edge-XXXXXX";
+
+  fd = mkstemp(&path_template[0]);
+
+  if (fd == -1)
+  {
+    throw edge_spill_exception("create in " + dir + ": " + strerror(errno));
+  }
+
+  // Nothing else needs the file; it goes away when it is closed.
+  unlink(path_template.c_str());
+}
+
+void
+spill_file
+::flush_writes()
+{
+  if (fd == -1)
+  {
+    open_file();
+  }
+
+  // Bytes already read out of the buffer never need to touch the disk.
+  size_t const size = wbuf.size() - wbuf_pos;
+
+  write_bytes(wbuf.data() + wbuf_pos, size, file_size);
+
+  file_size += off_t(size);
+
+  wbuf.clear();
+  wbuf_pos = 0;
+}
+
+void
+spill_file
+::write_bytes(char const* data, size_t size, off_t pos)
+{
+  while (size)
+  {
+    ssize_t const written = pwrite(fd, data, size, pos);
+
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      throw edge_spill_exception(std::string("write: ") + strerror(errno));
+    }
+
+    data += written;
+    size -= size_t(written);
+    pos += off_t(written);
+  }
+}
+
+void
+spill_file
+::read_bytes(char* dest, size_t size)
+{
+  while (size)
+  {
+    if (rbuf_pos < rbuf.size())
+    {
+      size_t const avail = std::min(size, rbuf.size() - rbuf_pos);
+
+      memcpy(dest, rbuf.data() + rbuf_pos, avail);
+
+      dest += avail;
+      size -= avail;
+      rbuf_pos += avail;
+
+      continue;
+    }
+
+    if (read_pos < file_size)
+    {
+      size_t const want = std::min(chunk_size, size_t(file_size - read_pos));
+
+      rbuf.resize(want);
+      rbuf_pos = 0;
+
+      ssize_t const got = pread(fd, &rbuf[0], want, read_pos);
+
+      if (got <= 0)
+      {
+        if ((got < 0) && (errno == EINTR))
+        {
+          continue;
+        }
+
+        rbuf.clear();
+
+        throw edge_spill_exception(std::string("read: ") + ((got < 0) ? strerror(errno) : "unexpected end of file"));
+      }
+
+      rbuf.resize(size_t(got));
+      read_pos += off_t(got);
+
+      continue;
+    }
+
+    // Everything on disk has been read; the rest is still buffered.
+    size_t const avail = std::min(size, wbuf.size() - wbuf_pos);
+
+    if (!avail)
+    {
+      throw edge_spill_exception("read: unexpected end of data");
+    }
+
+    memcpy(dest, wbuf.data() + wbuf_pos, avail);
+
+    dest += avail;
+    size -= avail;
+    wbuf_pos += avail;
+  }
+}
+
+void
+spill_file
+::compact()
+{
+  off_t const unread = file_size - read_pos;
+  off_t moved = 0;
+  bytes_t buf;
+
+  // The destination trails the source by read_pos, which is at least a
+  // chunk, so no chunk overwrites bytes which have not been moved yet.
+  while (moved < unread)
+  {
+    size_t const want = std::min(chunk_size, size_t(unread - moved));
+
+    buf.resize(want);
+
+    ssize_t const got = pread(fd, &buf[0], want, read_pos + moved);
+
+    if (got <= 0)
+    {
+      if ((got < 0) && (errno == EINTR))
+      {
+        continue;
+      }
+
+      throw edge_spill_exception(std::string("read: ") + ((got < 0) ? strerror(errno) : "unexpected end of file"));
+    }
+
+    write_bytes(buf.data(), size_t(got), moved);
+
+    moved += off_t(got);
+  }
+
+  if (ftruncate(fd, unread) != 0)
+  {
+    throw edge_spill_exception(std::string("truncate: ") + strerror(errno));
+  }
+
+  file_size = unread;
+  read_pos = 0;
+}
+
 }
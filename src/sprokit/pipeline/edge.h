@@ -95,6 +95,106 @@ typedef std::vector<edge_datum_t> edge_data_t;
 /// A group of \link edge edges\endlink.
 typedef std::vector<edge_t> edges_t;
 
+/**
+ * \class edge_wait_hook edge.h <sprokit/pipeline/edge.h>
+ *
+ * \brief A hook to suspend the caller instead of blocking on an \ref edge.
+ *
+ * When a hook is installed for a thread, any operation on an edge from that
+ * thread which would otherwise block calls the hook with the edge unlocked
+ * instead and checks the edge again once the hook returns. This allows
+ * schedulers to switch to other work while a process waits for data or
+ * space.
+ */
+class SPROKIT_PIPELINE_EXPORT edge_wait_hook
+  : boost::noncopyable
+{
+  public:
+    /// The condition being waited on.
+    typedef enum
+    {
+      /// Waiting for data to be available on the edge.
+      wait_for_data,
+      /// Waiting for space to push data into the edge.
+      wait_for_space
+    } wait_t;
+
+    /**
+     * \brief Destructor.
+     */
+    virtual ~edge_wait_hook();
+
+    /**
+     * \brief Called instead of blocking on the edge.
+     *
+     * \param e The edge being waited on.
+     * \param what The condition being waited on.
+     * \param count The number of data needed when waiting for data.
+     */
+    virtual void wait(edge const& e, wait_t what, size_t count) = 0;
+
+    /**
+     * \brief Install a hook for the calling thread.
+     *
+     * \param hook The hook to use, or \c NULL to block normally.
+     */
+    static void install(edge_wait_hook* hook);
+    /**
+     * \brief The hook installed for the calling thread.
+     *
+     * \returns The installed hook, or \c NULL if there is none.
+     */
+    static edge_wait_hook* installed();
+  protected:
+    /**
+     * \brief Constructor.
+     */
+    edge_wait_hook();
+};
+
+/**
+ * \class edge_observer edge.h <sprokit/pipeline/edge.h>
+ *
+ * \brief An interface to be told when an \ref edge becomes usable.
+ *
+ * Observers are notified when an edge gains the data its reader is waiting
+ * for (normally going from empty to non-empty) and when a full edge gains
+ * space. Notifications are made from the thread modifying the edge after the
+ * edge has been unlocked, so it is safe to query the edge from within \ref
+ * notify, but it may have changed again by then.
+ */
+class SPROKIT_PIPELINE_EXPORT edge_observer
+  : boost::noncopyable
+{
+  public:
+    /// The transitions which are reported.
+    typedef enum
+    {
+      /// Data is available for the reader of the edge.
+      data_available,
+      /// Space is available for the writer of the edge.
+      space_available
+    } event_t;
+
+    /**
+     * \brief Destructor.
+     */
+    virtual ~edge_observer();
+
+    /**
+     * \brief Called when the edge changes.
+     *
+     * \param e The edge which changed.
+     * \param event The transition which happened.
+     */
+    virtual void notify(edge const& e, event_t event) = 0;
+  protected:
+    /**
+     * \brief Constructor.
+     */
+    edge_observer();
+};
+
 /**
  * \class edge edge.h <sprokit/pipeline/edge.h>
  *
@@ -106,6 +206,28 @@ class SPROKIT_PIPELINE_EXPORT edge
   : boost::noncopyable
 {
   public:
+    /**
+     * \brief How the edge handles data pushed into it while it is full.
+     *
+     * Only data, empty and error datums are ever dropped; flush and complete
+     * datums are always delivered, blocking if needed. Datums which have been
+     * looked at with \ref peek_datum are not dropped either, so the datum
+     * taken from the edge afterwards is the one which was looked at.
+     *
+     * \warning Dropping data may leave the inputs of a process out of sync.
+     */
+    typedef enum
+    {
+      /// Block until there is space.
+      policy_block,
+      /// Drop the oldest datum in the edge to make space.
+      policy_drop_oldest,
+      /// Drop the datum being pushed.
+      policy_drop_newest,
+      /// Drop everything in the edge so only the newest datum is kept.
+      policy_latest_only
+    } policy_t;
+
     /**
      * \brief Constructor.
      *
@@ -149,10 +271,47 @@ class SPROKIT_PIPELINE_EXPORT edge
      */
     size_t datum_count() const;
 
+    /**
+     * \brief Query how the edge handles data pushed into it while it is full.
+     *
+     * \returns The policy of the edge.
+     */
+    policy_t policy() const;
+    /**
+     * \brief Query how many data have been dropped by the policy of the edge.
+     *
+     * \returns The number of datums dropped.
+     */
+    size_t dropped_count() const;
+    /**
+     * \brief Query how many data have been pushed into the edge.
+     *
+     * Only datums of type \ref datum::data are counted.
+     *
+     * \returns The number of data pushed.
+     */
+    size_t pushed_count() const;
+    /**
+     * \brief Query how many data have been taken out of the edge.
+     *
+     * Only datums of type \ref datum::data are counted. Data dropped by the
+     * policy of the edge are never taken out of it.
+     *
+     * \returns The number of data popped.
+     */
+    size_t popped_count() const;
+    /**
+     * \brief Query how many data are spilled to disk.
+     *
+     * \returns The number of datums held on disk rather than in memory.
+     */
+    size_t spilled_count() const;
+
     /**
      * \brief Push a datum into the edge.
      *
-     * \note This call blocks if \c full_of_data is \c true.
+     * \note This call blocks if \c full_of_data is \c true, unless the policy
+     * of the edge allows a datum to be dropped instead.
      *
      * \postconds
      *
@@ -189,6 +348,34 @@ class SPROKIT_PIPELINE_EXPORT edge
      * \returns The next datum available from the edge.
      */
     edge_datum_t get_datum();
+    /**
+     * \brief Extract several data from the edge at once.
+     *
+     * The edge is locked once for all of the data rather than once per datum.
+     *
+     * \note This call blocks until \p n data are available, so \p n must not
+     * be more than the capacity of the edge.
+     *
+     * \throws datum_requested_after_complete Thrown if called after \ref mark_downstream_as_complete.
+     *
+     * \preconds
+     *
+     * \precond{<code>this->is_downstream_complete() == false</code>}
+     *
+     * \endpreconds
+     *
+     * \postconds
+     *
+     * \postcond{The edge has \p n less datum packets in it.}
+     * \postcond{The caller takes ownership of the returned datum packets.}
+     *
+     * \endpostconds
+     *
+     * \param n The number of data to extract.
+     *
+     * \returns The next \p n data available from the edge.
+     */
+    edge_data_t get_data(size_t n);
     /**
      * \brief Look at the next datum in the edge.
      *
@@ -285,10 +472,65 @@ class SPROKIT_PIPELINE_EXPORT edge
      */
     void set_downstream_process(process_t process);
 
+    /**
+     * \brief Set whether the edge guards itself against concurrent use.
+     *
+     * An unsynchronized edge takes no locks and signals no waiters. It may
+     * only be used when a single thread pushes into and pulls from it. Since
+     * nothing else can change it, an operation which would block throws
+     * instead unless an \ref edge_wait_hook is installed.
+     *
+     * The setting itself may be read from any thread, but it must only be
+     * changed from one thread at a time.
+     *
+     * \warning This must not be changed while data is flowing through the edge.
+     *
+     * \param sync Whether to synchronize access or not.
+     */
+    void set_synchronized(bool sync);
+    /**
+     * \brief Query whether the edge guards itself against concurrent use.
+     *
+     * \returns True if access to the edge is synchronized, false otherwise.
+     */
+    bool is_synchronized() const;
+
+    /**
+     * \brief Add an observer to be told about changes to the edge.
+     *
+     * \note The edge does not take ownership of \p observer; it must outlive
+     * its registration.
+     *
+     * \param observer The observer to add.
+     */
+    void add_observer(edge_observer* observer);
+    /**
+     * \brief Remove an observer from the edge.
+     *
+     * \param observer The observer to remove.
+     */
+    void remove_observer(edge_observer* observer);
+
     /// Configuration that indicates the edge implies an execution dependency between upstream and downstream.
     static config::key_t const config_dependency;
     /// Configuration for the maximum capacity of an edge.
     static config::key_t const config_capacity;
+    /// Configuration for how an edge handles data while full (\c block, \c drop_oldest, \c drop_newest or \c latest_only).
+    static config::key_t const config_policy;
+    /**
+     * \brief Configuration for the number of data kept in memory at each end of the edge.
+     *
+     * Data beyond that in the middle of the edge is written to a temporary
+     * file so that a consumer which falls behind does not block its producer
+     * (up to the capacity) or exhaust memory. The data must have a \ref
+     * datum_codec and the policy must be \c block. Each encoded datum must
+     * be smaller than 4 GiB. Zero (the default) keeps everything in memory.
+     */
+    static config::key_t const config_spill_after;
+    /// Configuration for the directory to spill data into (defaults to \c TMPDIR or \c /tmp).
+    static config::key_t const config_spill_dir;
+    /// Configuration for the port type of the data the edge carries.
+    static config::key_t const config_type;
   private:
     class SPROKIT_PIPELINE_NO_EXPORT priv;
     boost::scoped_ptr<priv> d;
@@ -68,6 +68,40 @@ null_edge_config_exception
 {
 }
 
+invalid_edge_policy_exception
+::invalid_edge_policy_exception(std::string const& policy) SPROKIT_NOTHROW
+  : edge_exception()
+  , m_policy(policy)
+{
+  std::ostringstream sstr;
+
+  sstr << "The edge policy \'" << m_policy << "\' is not known";
+
+  m_what = sstr.str();
+}
+
+invalid_edge_policy_exception
+::~invalid_edge_policy_exception() SPROKIT_NOTHROW
+{
+}
+
+edge_spill_exception
+::edge_spill_exception(std::string const& reason) SPROKIT_NOTHROW
+  : edge_exception()
+  , m_reason(reason)
+{
+  std::ostringstream sstr;
+
+  sstr << "Failed to spill an edge to disk: " << m_reason;
+
+  m_what = sstr.str();
+}
+
+edge_spill_exception
+::~edge_spill_exception() SPROKIT_NOTHROW
+{
+}
+
 datum_requested_after_complete
 ::datum_requested_after_complete() SPROKIT_NOTHROW
   : edge_exception()
@@ -85,6 +119,23 @@ datum_requested_after_complete
 {
 }
 
+unsynchronized_edge_wait_exception
+::unsynchronized_edge_wait_exception() SPROKIT_NOTHROW
+  : edge_exception()
+{
+  std::ostringstream sstr;
+
+  sstr << "An unsynchronized edge would have blocked, "
+          "but no other thread can change it";
+
+  m_what = sstr.str();
+}
+
+unsynchronized_edge_wait_exception
+::~unsynchronized_edge_wait_exception() SPROKIT_NOTHROW
+{
+}
+
 edge_connection_exception
 ::edge_connection_exception() SPROKIT_NOTHROW
   : edge_exception()
@@ -89,6 +89,58 @@ class SPROKIT_PIPELINE_EXPORT null_edge_config_exception
     ~null_edge_config_exception() throw();
 };
 
+/**
+ * \class invalid_edge_policy_exception edge_exception.h <sprokit/pipeline/edge_exception.h>
+ *
+ * \brief Thrown when an unknown policy is given to an \ref edge.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT invalid_edge_policy_exception
+  : public edge_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param policy The policy given.
+     */
+    invalid_edge_policy_exception(std::string const& policy) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~invalid_edge_policy_exception() throw();
+
+    /// The policy given.
+    std::string const m_policy;
+};
+
+/**
+ * \class edge_spill_exception edge_exception.h <sprokit/pipeline/edge_exception.h>
+ *
+ * \brief Thrown when an \ref edge cannot spill data to disk.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT edge_spill_exception
+  : public edge_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param reason The reason spilling failed.
+     */
+    edge_spill_exception(std::string const& reason) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~edge_spill_exception() throw();
+
+    /// The reason spilling failed.
+    std::string const m_reason;
+};
+
 /**
  * \class datum_requested_after_complete pipeline_exception.h <sprokit/pipeline/pipeline_exception.h>
  *
@@ -110,6 +162,27 @@ class SPROKIT_PIPELINE_EXPORT datum_requested_after_complete
     ~datum_requested_after_complete() throw();
 };
 
+/**
+ * \class unsynchronized_edge_wait_exception edge_exception.h <sprokit/pipeline/edge_exception.h>
+ *
+ * \brief Thrown when an unsynchronized \ref edge would need to block.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT unsynchronized_edge_wait_exception
+  : public edge_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     */
+    unsynchronized_edge_wait_exception() throw();
+    /**
+     * \brief Destructor.
+     */
+    ~unsynchronized_edge_wait_exception() throw();
+};
+
 /**
  * \class edge_connection_exception edge_exception.h <sprokit/pipeline/edge_exception.h>
  *
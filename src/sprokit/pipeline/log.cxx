@@ -0,0 +1,621 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "log.h"
+
+#include "utils.h"
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include <cstdlib>
+
+/**
+ * \file log.cxx
+ *
+ * \brief Implementation of leveled \link sprokit::logger logging\endlink.
+ */
+
+namespace sprokit
+{
+
+namespace
+{
+
+// Loggers are created during static initialization, so the state may not
+// depend on other statics.
+static char const* const sprokit_log_envvar = "SPROKIT_LOG_LEVEL";
+static logger::level_t const initial_level = logger::level_warn;
+static size_t const ring_capacity = 4096;
+static long const writer_interval_ms = 10;
+
+class record_t
+{
+  public:
+    logger::level_t level;
+    char const* subsystem;
+    std::string msg;
+};
+
+// A single-producer, single-consumer ring. The owning thread writes records
+// and the draining thread reads them; the counts are only ever incremented
+// and each is only incremented by one side.
+class thread_ring_t
+  : boost::noncopyable
+{
+  public:
+    thread_ring_t();
+    ~thread_ring_t();
+
+    void push(logger::level_t level, char const* subsystem, std::string const& msg);
+
+    std::vector<record_t> records;
+    boost::detail::atomic_count written;
+    boost::detail::atomic_count read;
+    boost::detail::atomic_count dropped;
+
+    // Only used by the draining thread.
+    long reported_dropped;
+    // Guarded by the state's mutex.
+    bool in_use;
+};
+typedef boost::shared_ptr<thread_ring_t> thread_ring_ptr_t;
+
+typedef std::map<std::string, logger::level_t> level_map_t;
+
+void parse_spec(std::string const& spec, logger::level_t& def, level_map_t& levels);
+logger::level_t parse_level(std::string const& name);
+void release_ring(thread_ring_t* ring);
+void flush_at_exit();
+
+}
+
+class logger_state
+{
+  public:
+    logger_state();
+
+    thread_ring_t* ring();
+
+    char const* intern(logger::subsystem_t const& subsystem);
+    logger::level_t level_for(char const* subsystem) const;
+
+    void add_logger(logger* log);
+    void remove_logger(logger* log);
+
+    void set_levels(logger::level_t def, level_map_t const& subsystem_levels);
+
+    static void set_level(logger* log, logger::level_t level);
+
+    void drain();
+    void emit(record_t const& rec) const;
+    void run_writer();
+
+    static logger_state& self();
+
+    typedef boost::mutex mutex_t;
+    typedef boost::unique_lock<mutex_t> lock_t;
+
+    // Guards the loggers, levels, and rings.
+    mutex_t mut;
+    // Serializes writing out messages.
+    mutex_t drain_mut;
+
+    std::set<std::string> subsystems;
+    std::set<logger*> loggers;
+
+    logger::level_t default_level;
+    level_map_t levels;
+
+    std::vector<thread_ring_ptr_t> rings;
+    boost::thread_specific_ptr<thread_ring_t> local_ring;
+
+    logger::handler_t handler;
+
+    bool writer_started;
+};
+
+logger
+::logger(subsystem_t const& subsystem)
+  : m_subsystem(logger_state::self().intern(subsystem))
+  , m_level(level_off)
+{
+  logger_state::self().add_logger(this);
+}
+
+logger
+::~logger()
+{
+  logger_state::self().remove_logger(this);
+}
+
+void
+logger
+::write(level_t level, std::string const& msg) const
+{
+  if (!enabled(level))
+  {
+    return;
+  }
+
+  logger_state::self().ring()->push(level, m_subsystem, msg);
+}
+
+void
+logger
+::configure(std::string const& spec)
+{
+  level_t def = initial_level;
+  level_map_t levels;
+
+  parse_spec(spec, def, levels);
+
+  logger_state::self().set_levels(def, levels);
+}
+
+void
+logger
+::set_handler(handler_t const& handler)
+{
+  logger_state& st = logger_state::self();
+
+  // Messages already queued go to the old handler.
+  st.drain();
+
+  logger_state::lock_t const lock(st.drain_mut);
+
+  (void)lock;
+
+  st.handler = handler;
+}
+
+void
+logger
+::flush()
+{
+  logger_state::self().drain();
+}
+
+char const*
+logger
+::level_name(level_t level)
+{
+  switch (level)
+  {
+    case level_trace:
+      return "trace";
+    case level_debug:
+      return "debug";
+    case level_info:
+      return "info";
+    case level_warn:
+      return "warn";
+    case level_error:
+      return "error";
+    case level_off:
+    default:
+      break;
+  }
+
+  return "off";
+}
+
+logger_state
+::logger_state()
+  : mut()
+  , drain_mut()
+  , subsystems()
+  , loggers()
+  , default_level(initial_level)
+  , levels()
+  , rings()
+  , local_ring(release_ring)
+  , handler()
+  , writer_started(false)
+{
+  envvar_value_t const spec = get_envvar(envvar_name_t(sprokit_log_envvar));
+
+  if (spec)
+  {
+    try
+    {
+      parse_spec(*spec, default_level, levels);
+    }
+    catch (std::runtime_error const& e)
+    {
+      // There is nowhere else to report this yet.
+      std::cerr << "WARN - log: ignoring " << sprokit_log_envvar << ": " << e.what() << std::endl;
+
+      default_level = initial_level;
+      levels.clear();
+    }
+  }
+}
+
+thread_ring_t*
+logger_state
+::ring()
+{
+  thread_ring_t* r = local_ring.get();
+
+  if (r)
+  {
+    return r;
+  }
+
+  lock_t const lock(mut);
+
+  (void)lock;
+
+  // Reuse the ring of a thread which has exited; anything left in it is
+  // still written out in order.
+  BOOST_FOREACH (thread_ring_ptr_t const& candidate, rings)
+  {
+    if (!candidate->in_use)
+    {
+      r = candidate.get();
+      break;
+    }
+  }
+
+  if (!r)
+  {
+    thread_ring_ptr_t const new_ring = boost::make_shared<thread_ring_t>();
+
+    rings.push_back(new_ring);
+    r = new_ring.get();
+  }
+
+  r->in_use = true;
+  local_ring.reset(r);
+
+  if (!writer_started)
+  {
+    boost::thread writer(boost::bind(&logger_state::run_writer, this));
+
+    writer.detach();
+
+    std::atexit(flush_at_exit);
+
+    writer_started = true;
+  }
+
+  return r;
+}
+
+char const*
+logger_state
+::intern(logger::subsystem_t const& subsystem)
+{
+  lock_t const lock(mut);
+
+  (void)lock;
+
+  return subsystems.insert(subsystem).first->c_str();
+}
+
+logger::level_t
+logger_state
+::level_for(char const* subsystem) const
+{
+  level_map_t::const_iterator const i = levels.find(subsystem);
+
+  if (i == levels.end())
+  {
+    return default_level;
+  }
+
+  return i->second;
+}
+
+void
+logger_state
+::add_logger(logger* log)
+{
+  lock_t const lock(mut);
+
+  (void)lock;
+
+  set_level(log, level_for(log->m_subsystem));
+  loggers.insert(log);
+}
+
+void
+logger_state
+::remove_logger(logger* log)
+{
+  lock_t const lock(mut);
+
+  (void)lock;
+
+  loggers.erase(log);
+}
+
+void
+logger_state
+::set_levels(logger::level_t def, level_map_t const& subsystem_levels)
+{
+  lock_t const lock(mut);
+
+  (void)lock;
+
+  default_level = def;
+  levels = subsystem_levels;
+
+  BOOST_FOREACH (logger* log, loggers)
+  {
+    set_level(log, level_for(log->m_subsystem));
+  }
+}
+
+void
+logger_state
+::set_level(logger* log, logger::level_t level)
+{
+  // The count can only be stepped; callers hold the mutex so only one
+  // thread moves it at a time.
+  long const target = static_cast<long>(level);
+
+  while (log->m_level < target)
+  {
+    ++log->m_level;
+  }
+
+  while (target < log->m_level)
+  {
+    --log->m_level;
+  }
+}
+
+void
+logger_state
+::drain()
+{
+  lock_t const drain_lock(drain_mut);
+
+  (void)drain_lock;
+
+  std::vector<thread_ring_ptr_t> to_drain;
+
+  {
+    lock_t const lock(mut);
+
+    (void)lock;
+
+    to_drain = rings;
+  }
+
+  BOOST_FOREACH (thread_ring_ptr_t const& r, to_drain)
+  {
+    size_t const written = static_cast<size_t>(static_cast<long>(r->written));
+    size_t read = static_cast<size_t>(static_cast<long>(r->read));
+
+    for (; read < written; ++read)
+    {
+      record_t& rec = r->records[read % r->records.size()];
+
+      emit(rec);
+
+      // Release the slot to the writing thread.
+      ++r->read;
+    }
+
+    long const dropped = r->dropped;
+
+    if (r->reported_dropped < dropped)
+    {
+      record_t rec;
+
+      rec.level = logger::level_warn;
+      rec.subsystem = "log";
+      rec.msg = "dropped messages because the queue was full: " + boost::lexical_cast<std::string>(dropped - r->reported_dropped);
+
+      emit(rec);
+
+      r->reported_dropped = dropped;
+    }
+  }
+}
+
+void
+logger_state
+::emit(record_t const& rec) const
+{
+  if (handler)
+  {
+    handler(rec.level, rec.subsystem, rec.msg);
+
+    return;
+  }
+
+  static char const* const names[] =
+    { "TRACE"
+    , "DEBUG"
+    , "INFO"
+    , "WARN"
+    , "ERROR"
+    , "OFF"
+    };
+
+  std::cerr << names[rec.level] << " - " << rec.subsystem << ": " << rec.msg << std::endl;
+}
+
+void
+logger_state
+::run_writer()
+{
+  name_thread("sprokit_log");
+
+  while (true)
+  {
+    drain();
+
+    boost::this_thread::sleep(boost::posix_time::milliseconds(writer_interval_ms));
+  }
+}
+
+logger_state&
+logger_state
+::self()
+{
+  // Never destroyed so that messages may be logged during static
+  // destruction and by threads which outlive it.
+  static logger_state* const st = new logger_state;
+
+  return *st;
+}
+
+namespace
+{
+
+thread_ring_t
+::thread_ring_t()
+  : records(ring_capacity)
+  , written(0)
+  , read(0)
+  , dropped(0)
+  , reported_dropped(0)
+  , in_use(false)
+{
+}
+
+thread_ring_t
+::~thread_ring_t()
+{
+}
+
+void
+thread_ring_t
+::push(logger::level_t level, char const* subsystem, std::string const& msg)
+{
+  size_t const w = static_cast<size_t>(static_cast<long>(written));
+  size_t const r = static_cast<size_t>(static_cast<long>(read));
+
+  // Never wait for the writer.
+  if (records.size() <= (w - r))
+  {
+    ++dropped;
+
+    return;
+  }
+
+  record_t& rec = records[w % records.size()];
+
+  rec.level = level;
+  rec.subsystem = subsystem;
+  rec.msg = msg;
+
+  // Publish the record only after it has been written.
+  ++written;
+}
+
+void
+parse_spec(std::string const& spec, logger::level_t& def, level_map_t& levels)
+{
+  typedef std::vector<std::string> parts_t;
+
+  parts_t parts;
+
+  boost::split(parts, spec, boost::is_any_of(","));
+
+  BOOST_FOREACH (std::string const& part, parts)
+  {
+    if (part.empty())
+    {
+      continue;
+    }
+
+    std::string::size_type const eq = part.find('=');
+
+    if (eq == std::string::npos)
+    {
+      def = parse_level(part);
+    }
+    else
+    {
+      levels[part.substr(0, eq)] = parse_level(part.substr(eq + 1));
+    }
+  }
+}
+
+logger::level_t
+parse_level(std::string const& name)
+{
+  for (int l = logger::level_trace; l <= logger::level_off; ++l)
+  {
+    logger::level_t const level = logger::level_t(l);
+
+    if (name == logger::level_name(level))
+    {
+      return level;
+    }
+  }
+
+  throw std::runtime_error("unknown log level: " + name);
+}
+
+void
+release_ring(thread_ring_t* ring)
+{
+  logger_state& st = logger_state::self();
+
+  logger_state::lock_t const lock(st.mut);
+
+  (void)lock;
+
+  ring->in_use = false;
+}
+
+void
+flush_at_exit()
+{
+  logger::flush();
+}
+
+}
+
+}
@@ -0,0 +1,227 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PIPELINE_LOG_H
+#define SPROKIT_PIPELINE_LOG_H
+
+#include "pipeline-config.h"
+
+#include <boost/detail/atomic_count.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <sstream>
+#include <string>
+
+/**
+ * \file log.h
+ *
+ * \brief Header for leveled \link sprokit::logger logging\endlink.
+ */
+
+#ifndef SPROKIT_LOG_MIN_LEVEL
+/**
+ * \def SPROKIT_LOG_MIN_LEVEL
+ *
+ * \brief The lowest level of messages which are compiled in.
+ *
+ * Messages logged with the macros below this level are removed by the
+ * compiler. The build sets it from the \c SPROKIT_LOG_MIN_LEVEL option.
+ */
+#define SPROKIT_LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * \def SPROKIT_LOG_ENABLED
+ *
+ * \brief Check whether a logger would write messages at a level.
+ *
+ * Use this to guard building messages which cannot be written as a single
+ * stream expression.
+ *
+ * \param log The logger to check.
+ * \param level The level to check.
+ */
+#define SPROKIT_LOG_ENABLED(log, level) \
+  ((SPROKIT_LOG_MIN_LEVEL <= (level)) && (log).enabled(level))
+
+/**
+ * \def SPROKIT_LOG
+ *
+ * \brief Log a message.
+ *
+ * The message is only formatted if the logger is enabled for \p level.
+ *
+ * \param log The logger to write to.
+ * \param level The level of the message.
+ * \param msg The message as a stream expression.
+ */
+#define SPROKIT_LOG(log, level, msg)                 \
+  do                                                 \
+  {                                                  \
+    if (SPROKIT_LOG_ENABLED(log, level))             \
+    {                                                \
+      std::ostringstream sprokit_log_ostr;           \
+      sprokit_log_ostr << msg;                       \
+      (log).write(level, sprokit_log_ostr.str());    \
+    }                                                \
+  } while (false)
+
+#define SPROKIT_LOG_TRACE(log, msg) SPROKIT_LOG(log, sprokit::logger::level_trace, msg)
+#define SPROKIT_LOG_DEBUG(log, msg) SPROKIT_LOG(log, sprokit::logger::level_debug, msg)
+#define SPROKIT_LOG_INFO(log, msg) SPROKIT_LOG(log, sprokit::logger::level_info, msg)
+#define SPROKIT_LOG_WARN(log, msg) SPROKIT_LOG(log, sprokit::logger::level_warn, msg)
+#define SPROKIT_LOG_ERROR(log, msg) SPROKIT_LOG(log, sprokit::logger::level_error, msg)
+
+namespace sprokit
+{
+
+/**
+ * \class logger log.h <sprokit/pipeline/log.h>
+ *
+ * \brief Writes leveled messages for a subsystem.
+ *
+ * Each logger has a level below which its messages are dropped. Levels come
+ * from the \c SPROKIT_LOG_LEVEL environment variable, which holds a default
+ * level optionally followed by per-subsystem levels (e.g.,
+ * <code>warn,edge=debug</code>). The default level is \c warn.
+ *
+ * Messages are written asynchronously: each thread queues its messages in
+ * its own ring buffer without taking a lock and a background thread writes
+ * them out. When a ring is full, messages are dropped rather than blocking
+ * the caller; the number dropped is reported with the next messages written.
+ *
+ * \ingroup base_classes
+ */
+class SPROKIT_PIPELINE_EXPORT logger
+  : boost::noncopyable
+{
+  public:
+    /// The severity of a message.
+    typedef enum
+    {
+      /// Detailed information for following execution.
+      level_trace,
+      /// Information useful when debugging.
+      level_debug,
+      /// Information about normal operation.
+      level_info,
+      /// Something unexpected which was recovered from.
+      level_warn,
+      /// Something failed.
+      level_error,
+      /// No messages are written.
+      level_off
+    } level_t;
+
+    /// The type for the name of a subsystem.
+    typedef std::string subsystem_t;
+    /// The type for a function which writes out messages.
+    typedef boost::function<void (level_t, subsystem_t const&, std::string const&)> handler_t;
+
+    /**
+     * \brief Constructor.
+     *
+     * \param subsystem The name of the subsystem messages are from.
+     */
+    explicit logger(subsystem_t const& subsystem);
+    /**
+     * \brief Destructor.
+     */
+    ~logger();
+
+    /**
+     * \brief Query whether messages at a level are written.
+     *
+     * \param level The level to check.
+     *
+     * \returns True if messages at \p level are written, false otherwise.
+     */
+    bool enabled(level_t level) const;
+    /**
+     * \brief Queue a message to be written.
+     *
+     * \param level The level of the message.
+     * \param msg The message.
+     */
+    void write(level_t level, std::string const& msg) const;
+
+    /**
+     * \brief Set the levels of loggers.
+     *
+     * Uses the same format as the \c SPROKIT_LOG_LEVEL environment
+     * variable. Subsystems which are not mentioned use the default level.
+     *
+     * \throws std::runtime_error Thrown if \p spec is malformed.
+     *
+     * \param spec The levels to use.
+     */
+    static void configure(std::string const& spec);
+    /**
+     * \brief Set the function which writes out messages.
+     *
+     * The handler is called from the background thread. An empty handler
+     * writes messages to \c std::cerr.
+     *
+     * \param handler The function to write messages with.
+     */
+    static void set_handler(handler_t const& handler);
+    /**
+     * \brief Write out all queued messages before returning.
+     */
+    static void flush();
+
+    /**
+     * \brief Get the name of a level.
+     *
+     * \param level The level to name.
+     *
+     * \returns The name of \p level.
+     */
+    static char const* level_name(level_t level);
+  private:
+    friend class logger_state;
+
+    char const* const m_subsystem;
+    // Changed by configure while other threads check it, so it is atomic.
+    boost::detail::atomic_count m_level;
+};
+
+inline
+bool
+logger
+::enabled(level_t level) const
+{
+  return (static_cast<long>(m_level) <= level);
+}
+
+}
+
+#endif // SPROKIT_PIPELINE_LOG_H
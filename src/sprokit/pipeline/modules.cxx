@@ -33,6 +33,7 @@
 #if defined(_WIN32) || defined(_WIN64)
 #include <sprokit/pipeline/module-paths.h>
 #endif
+#include "log.h"
 #include "utils.h"
 
 #include <sprokit/pipeline_util/path.h>
@@ -52,7 +53,6 @@
 #endif
 
 #include <cstddef>
-#include <iostream>
 
 /**
  * \file modules.cxx
@@ -91,6 +91,8 @@ static module_path_t const default_module_dirs = module_path_t(DEFAULT_MODULE_PA
 static envvar_name_t const sprokit_module_envvar = envvar_name_t("SPROKIT_MODULE_PATH");
 static lib_suffix_t const library_suffix = lib_suffix_t(LIBRARY_SUFFIX);
 
+static logger const modules_log("modules");
+
 void
 load_known_modules()
 {
@@ -191,12 +193,11 @@ load_from_module(module_path_t const& path)
 
   if (!library)
   {
-    /// \todo Log an error. Also have system dependent way of getting error.
+    /// \todo Have system dependent way of getting error.
     // This is important because libraries used by these modules can cause failure if
     // they are not found.
-    std::cerr << "ERROR - Unable to load module: " << path
-              << "  (" << dlerror() << ")"
-              << std::endl;
+    SPROKIT_LOG_ERROR(modules_log, "Unable to load module: " << path
+                                   << "  (" << dlerror() << ")");
     return;
   }
 
@@ -226,8 +227,7 @@ load_from_module(module_path_t const& path)
 
   if (process_registrar)
   {
-    /// \todo Log info that we have loaded processes.
-    std::cerr << "INFO - Processes from module " << path << " loaded\n";
+    SPROKIT_LOG_INFO(modules_log, "Processes from module " << path << " loaded");
 
     (*process_registrar)();
     functions_found = true;
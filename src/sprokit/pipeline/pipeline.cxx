@@ -32,10 +32,14 @@
 #include "pipeline_exception.h"
 
 #include "edge.h"
+#include "log.h"
 #include "process_exception.h"
 #include "process_cluster.h"
+#include "trace.h"
 
+#include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/split.hpp>
 #include <boost/graph/directed_graph.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/math/common_factor_rt.hpp>
@@ -43,6 +47,7 @@
 #include <boost/foreach.hpp>
 #include <boost/function.hpp>
 #include <boost/functional.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 
 #include <functional>
@@ -66,6 +71,8 @@
 namespace sprokit
 {
 
+static logger const pipeline_log("pipeline");
+
 class pipeline::priv
 {
   public:
@@ -123,8 +130,14 @@ class pipeline::priv
     void check_for_dag() const;
     void initialize_processes();
     void check_port_frequencies() const;
+    void fuse_process_chains();
+    void setup_admission_control();
+
+    bool is_fusible(process::connection_t const& connection) const;
+    process::names_t admission_names(config_t const& conf, config::key_t const& key) const;
 
     void ensure_setup() const;
+    void set_synchronized_edges(bool sync);
 
     pipeline* const q;
     config_t const config;
@@ -146,6 +159,24 @@ class pipeline::priv
 
     shared_port_map_t connected_shared_ports;
 
+    chains_t fused_chains;
+
+    edges_t admission_edges;
+
+    setup_timings_t setup_timings;
+
+    // Records the time taken by a setup phase, even if it fails.
+    class phase_timer
+    {
+      public:
+        phase_timer(setup_timings_t& timings_, setup_phase_t const& phase_);
+        ~phase_timer();
+
+        setup_timings_t& timings;
+        setup_phase_t const phase;
+        trace::timestamp_t const start;
+    };
+
     bool setup;
     bool setup_in_progress;
     bool setup_successful;
@@ -183,6 +214,12 @@ class pipeline::priv
     static config::key_t const config_edge;
     static config::key_t const config_edge_type;
     static config::key_t const config_edge_conn;
+    static config::key_t const config_fuse_chains;
+    static config::key_t const config_node;
+    static config::key_t const config_admission;
+    static config::key_t const config_admission_window;
+    static config::key_t const config_admission_sources;
+    static config::key_t const config_admission_sinks;
     static config::key_t const upstream_subblock;
     static config::key_t const downstream_subblock;
 };
@@ -190,6 +227,12 @@ class pipeline::priv
 config::key_t const pipeline::priv::config_edge = config::key_t("_edge");
 config::key_t const pipeline::priv::config_edge_type = config::key_t("_edge_by_type");
 config::key_t const pipeline::priv::config_edge_conn = config::key_t("_edge_by_conn");
+config::key_t const pipeline::priv::config_fuse_chains = config::key_t("_fuse_chains");
+config::key_t const pipeline::priv::config_node = config::key_t("_node");
+config::key_t const pipeline::priv::config_admission = config::key_t("_admission");
+config::key_t const pipeline::priv::config_admission_window = config::key_t("max_in_flight");
+config::key_t const pipeline::priv::config_admission_sources = config::key_t("sources");
+config::key_t const pipeline::priv::config_admission_sinks = config::key_t("sinks");
 config::key_t const pipeline::priv::upstream_subblock = config::key_t("up");
 config::key_t const pipeline::priv::downstream_subblock = config::key_t("down");
 
@@ -436,7 +479,15 @@ ::setup_pipeline()
     throw pipeline_duplicate_setup_exception();
   }
 
-  d->check_for_processes();
+  d->setup_timings.clear();
+
+  {
+    priv::phase_timer const timer(d->setup_timings, "check_for_processes");
+
+    (void)timer;
+
+    d->check_for_processes();
+  }
 
   // There's no turning back after this (processes are modified and may not be
   // able to be added/removed without compromising the checks after this point).
@@ -444,18 +495,31 @@ ::setup_pipeline()
   d->setup_in_progress = true;
   d->setup_successful = false;
 
+  SPROKIT_TRACE_SCOPE(trace_setup, "setup", "setup_pipeline");
+
+#define SETUP_PHASE(phase)                                      \
+  do                                                            \
+  {                                                             \
+    SPROKIT_TRACE_SCOPE(trace_phase, "setup", #phase);          \
+    priv::phase_timer const timer(d->setup_timings, #phase);    \
+    (void)timer;                                                \
+    d->phase();                                                 \
+  } while (false)
+
   try
   {
-    d->map_cluster_connections();
-    d->configure_processes();
-    d->check_for_data_dep_ports();
-    d->propagate_pinned_types();
-    d->check_for_untyped_ports();
-    d->make_connections();
-    d->check_for_required_ports();
-    d->check_for_dag();
-    d->initialize_processes();
-    d->check_port_frequencies();
+    SETUP_PHASE(map_cluster_connections);
+    SETUP_PHASE(configure_processes);
+    SETUP_PHASE(check_for_data_dep_ports);
+    SETUP_PHASE(propagate_pinned_types);
+    SETUP_PHASE(check_for_untyped_ports);
+    SETUP_PHASE(make_connections);
+    SETUP_PHASE(check_for_required_ports);
+    SETUP_PHASE(check_for_dag);
+    SETUP_PHASE(initialize_processes);
+    SETUP_PHASE(check_port_frequencies);
+    SETUP_PHASE(fuse_process_chains);
+    SETUP_PHASE(setup_admission_control);
   }
   catch (...)
   {
@@ -463,6 +527,8 @@ ::setup_pipeline()
     throw;
   }
 
+#undef SETUP_PHASE
+
   d->setup_in_progress = false;
   d->setup_successful = true;
 }
@@ -511,6 +577,8 @@ ::reset()
   d->untyped_connections.clear();
   d->type_pinnings.clear();
   d->connected_shared_ports.clear();
+  d->fused_chains.clear();
+  d->admission_edges.clear();
 
   d->setup_in_progress = true;
 
@@ -1027,6 +1095,45 @@ ::output_edges_for_port(process::name_t const& name, process::port_t const& port
   return edges;
 }
 
+pipeline::chains_t
+pipeline
+::fused_chains() const
+{
+  d->ensure_setup();
+
+  return d->fused_chains;
+}
+
+edges_t
+pipeline
+::admission_edges() const
+{
+  d->ensure_setup();
+
+  return d->admission_edges;
+}
+
+pipeline::setup_timings_t
+pipeline
+::setup_timings() const
+{
+  if (!d->setup)
+  {
+    throw pipeline_not_setup_exception();
+  }
+
+  return d->setup_timings;
+}
+
+void
+pipeline
+::run_single_threaded()
+{
+  d->ensure_setup();
+
+  d->set_synchronized_edges(false);
+}
+
 void
 pipeline
 ::start()
@@ -1047,6 +1154,8 @@ ::stop()
     throw std::logic_error(reason);
   }
 
+  d->set_synchronized_edges(true);
+
   d->running = false;
 }
 
@@ -1062,16 +1171,24 @@ ::priv(pipeline* pipe, config_t conf)
   , data_dep_connections()
   , untyped_connections()
   , type_pinnings()
+  , connected_shared_ports()
+  , fused_chains()
+  , admission_edges()
+  , setup_timings()
   , setup(false)
   , setup_in_progress(false)
   , setup_successful(false)
   , running(false)
 {
-  /// \todo Debug log config
-  std::stringstream msg;
-  msg << "DEBUG - pipeline config:\n";
-  config->print(msg);
-  std::cerr << msg;
+  if (SPROKIT_LOG_ENABLED(pipeline_log, logger::level_debug))
+  {
+    std::ostringstream msg;
+
+    msg << "pipeline config:\n";
+    config->print(msg);
+
+    pipeline_log.write(logger::level_debug, msg.str());
+  }
 }
 
 pipeline::priv
@@ -1079,6 +1196,20 @@ pipeline::priv
 {
 }
 
+pipeline::priv::phase_timer
+::phase_timer(setup_timings_t& timings_, setup_phase_t const& phase_)
+  : timings(timings_)
+  , phase(phase_)
+  , start(trace::now())
+{
+}
+
+pipeline::priv::phase_timer
+::~phase_timer()
+{
+  timings.push_back(setup_timing_t(phase, trace::now() - start));
+}
+
 void
 pipeline::priv
 ::check_duplicate_name(process::name_t const& name)
@@ -1569,10 +1700,26 @@ ::propagate_pinned_types()
                downstream_name, downstream_port);
   }
 
-  if (!type_pinnings.empty())
+  if (type_pinnings.empty())
   {
-    propagate_pinned_types();
+    return;
+  }
+
+  // Pinning a type from a port which accepts any type changes nothing. Once no
+  // pinning makes progress, the connections are left untyped.
+  if (type_pinnings == pinnings)
+  {
+    BOOST_FOREACH (type_pinning_t const& pinning, type_pinnings)
+    {
+      untyped_connections.push_back(pinning.first);
+    }
+
+    type_pinnings.clear();
+
+    return;
   }
+
+  propagate_pinned_types();
 }
 
 void
@@ -1591,6 +1738,12 @@ ::make_connections()
 {
   size_t const len = connections.size();
 
+  // Extracting a subblock scans the entire pipeline configuration, so only
+  // do it once rather than for every edge.
+  config_t const edge_defaults = config->subblock(priv::config_edge);
+  config_t const type_config = config->subblock(priv::config_edge_type);
+  config_t const conn_config = config->subblock(priv::config_edge_conn);
+
   for (size_t i = 0; i < len; ++i)
   {
     process::connection_t const& connection = connections[i];
@@ -1609,16 +1762,17 @@ ::make_connections()
     process::port_info_t const down_info = down_proc->input_port_info(downstream_port);
     process::port_flags_t const& down_flags = down_info->flags;
 
-    // Extract the "_edge:" subblock from the supplied config.
+    // Start from the "_edge:" subblock from the supplied config.
     // This supplies the default or most general config values.
     // The edge type config will be merged in to override defaults for this edge.
     // Then the connection based congit will be merged to override.
-    config_t edge_config = config->subblock(priv::config_edge);
+    config_t const edge_config = config::empty_config();
+
+    edge_config->merge_config(edge_defaults);
 
     // Configure the edge based on its type.
     {
       process::port_type_t const& down_type = down_info->type;
-      config_t const type_config = config->subblock(priv::config_edge_type);
       config_t const edge_type_config = type_config->subblock(down_type);
 
       edge_config->merge_config(edge_type_config);
@@ -1631,7 +1785,6 @@ ::make_connections()
 
     // Configure the edge based on the connected ports.
     {
-      config_t const conn_config = config->subblock(priv::config_edge_conn);
       config_t const up_config = conn_config->subblock(upstream_name + config::block_sep + upstream_subblock + config::block_sep + upstream_port);
       config_t const down_config = conn_config->subblock(downstream_name + config::block_sep + downstream_subblock + config::block_sep + downstream_port);
 
@@ -1645,15 +1798,33 @@ ::make_connections()
 
       edge_config->set_value(edge::config_dependency, (has_nodep ? "false" : "true"));
       edge_config->mark_read_only(edge::config_dependency);
+
+      // Special types (such as "any") say nothing about the data; the other
+      // end of the edge may know more.
+      process::port_type_t type = down_info->type;
+
+      if (type.empty() || (type[0] == '_'))
+      {
+        type = up_proc->output_port_info(upstream_port)->type;
+      }
+
+      edge_config->set_value(edge::config_type, type);
+      edge_config->mark_read_only(edge::config_type);
     }
 
-    /// \todo log edge config
-    std::stringstream msg;
-    msg << "DEBUG - edge config for "
-        << upstream_name << "." << upstream_port << " -> " << downstream_name << "." << downstream_port
-        << "\n";
-    edge_config->print(msg);
-    std::cerr << msg;
+    // Printing the configuration of every edge is expensive for large
+    // pipelines, so only do it when it will be written.
+    if (SPROKIT_LOG_ENABLED(pipeline_log, logger::level_debug))
+    {
+      std::ostringstream msg;
+
+      msg << "edge config for "
+          << upstream_name << "." << upstream_port << " -> " << downstream_name << "." << downstream_port
+          << "\n";
+      edge_config->print(msg);
+
+      pipeline_log.write(logger::level_debug, msg.str());
+    }
 
     edge_t const e = boost::make_shared<edge>(edge_config);
 
@@ -1673,14 +1844,53 @@ ::check_for_required_ports() const
 {
   typedef std::set<process::name_t> name_set_t;
   typedef std::queue<process::name_t> name_queue_t;
+  typedef std::set<process::port_addr_t> port_addr_set_t;
+  typedef std::map<process::name_t, name_set_t> neighbor_map_t;
+
+  // Index the connections once; querying the pipeline for each process is
+  // linear in the number of connections.
+  port_addr_set_t connected_inputs;
+  port_addr_set_t connected_outputs;
+  neighbor_map_t neighbors;
+
+  BOOST_FOREACH (edge_map_t::value_type const& edge_index, edge_map)
+  {
+    process::connection_t const& connection = connections[edge_index.first];
+
+    connected_outputs.insert(connection.first);
+    connected_inputs.insert(connection.second);
+  }
+
+  BOOST_FOREACH (process::connection_t const& connection, connections)
+  {
+    process::name_t const& upstream_name = connection.first.first;
+    process::name_t const& downstream_name = connection.second.first;
+
+    neighbors[upstream_name].insert(downstream_name);
+    neighbors[downstream_name].insert(upstream_name);
+  }
 
   name_set_t procs;
 
   {
     name_queue_t to_visit;
 
-    // Traverse the pipeline starting with a process.
-    to_visit.push(process_map.begin()->first);
+    // A partition of a pipeline may be split into pieces which are only
+    // joined through other nodes, so each piece is checked on its own.
+    bool const partition = config->has_value(config_node);
+
+    if (partition)
+    {
+      BOOST_FOREACH (process_map_t::value_type const& process_entry, process_map)
+      {
+        to_visit.push(process_entry.first);
+      }
+    }
+    else
+    {
+      // Traverse the pipeline starting with a process.
+      to_visit.push(process_map.begin()->first);
+    }
 
     // While we have processes to visit yet.
     while (!to_visit.empty())
@@ -1710,7 +1920,7 @@ ::check_for_required_ports() const
 
           if (port_flags.count(process::flag_required))
           {
-            if (!q->input_edge_for_port(cur_proc, port))
+            if (!connected_inputs.count(process::port_addr_t(cur_proc, port)))
             {
               static std::string const reason = "The input port has the required flag";
 
@@ -1728,7 +1938,7 @@ ::check_for_required_ports() const
 
           if (port_flags.count(process::flag_required))
           {
-            if (q->output_edges_for_port(cur_proc, port).empty())
+            if (!connected_outputs.count(process::port_addr_t(cur_proc, port)))
             {
               static std::string const reason = "The output port has the required flag";
 
@@ -1738,20 +1948,15 @@ ::check_for_required_ports() const
         }
       }
 
-      processes_t connected_procs;
+      // Mark all processes upstream and downstream for visitation.
+      neighbor_map_t::const_iterator const n = neighbors.find(cur_proc);
 
-      // Find all processes upstream of the current process.
-      processes_t const upstream_procs = q->upstream_for_process(cur_proc);
-      connected_procs.insert(connected_procs.end(), upstream_procs.begin(), upstream_procs.end());
-
-      // Find all processes downstream of the current process.
-      processes_t const downstream_procs = q->downstream_for_process(cur_proc);
-      connected_procs.insert(connected_procs.end(), downstream_procs.begin(), downstream_procs.end());
-
-      // Mark all connected processes for visitation.
-      BOOST_FOREACH (process_t const& proc, connected_procs)
+      if (n != neighbors.end())
       {
-        to_visit.push(proc->name());
+        BOOST_FOREACH (process::name_t const& neighbor, n->second)
+        {
+          to_visit.push(neighbor);
+        }
       }
     }
   }
@@ -1770,12 +1975,19 @@ ::check_for_dag() const
   typedef boost::graph_traits<pipeline_graph_t>::vertex_descriptor vertex_t;
   typedef std::deque<vertex_t> vertices_t;
   typedef std::map<process::name_t, vertex_t> vertex_map_t;
+  typedef std::map<process::port_addr_t, process::port_addr_t> sender_map_t;
 
   pipeline_graph_t graph;
 
   // Create the graph.
   {
     vertex_map_t vertex_map;
+    sender_map_t senders;
+
+    BOOST_FOREACH (process::connection_t const& connection, connections)
+    {
+      senders.insert(std::make_pair(connection.second, connection.first));
+    }
 
     process::names_t const names = q->process_names();
 
@@ -1795,14 +2007,14 @@ ::check_for_dag() const
 
       BOOST_FOREACH (process::port_t const& port, iports)
       {
-        process::port_addr_t const sender = q->sender_for_port(name, port);
+        sender_map_t::const_iterator const sender = senders.find(process::port_addr_t(name, port));
 
-        if (sender == process::port_addr_t())
+        if (sender == senders.end())
         {
           continue;
         }
 
-        process::name_t const& sender_name = sender.first;
+        process::name_t const& sender_name = sender->second.first;
 
         process::port_info_t const info = proc->input_port_info(port);
         process::port_flags_t const& flags = info->flags;
@@ -1869,6 +2081,8 @@ ::check_port_frequencies() const
   process_frequency_map_t freq_map;
 
   std::queue<process::connection_t> unchecked_connections;
+  // The number of connections put back since the last one was checked.
+  size_t deferred_connections = 0;
 
   BOOST_FOREACH (process::connection_t const& connection, connections)
   {
@@ -1880,6 +2094,10 @@ ::check_port_frequencies() const
     process::connection_t const connection = unchecked_connections.front();
     unchecked_connections.pop();
 
+    // Every connection left has been put back without anything being checked,
+    // so it is in a piece of a partitioned pipeline not seen yet.
+    bool const new_piece = (unchecked_connections.size() < deferred_connections);
+
     process::port_addr_t const& upstream_addr = connection.first;
     process::port_addr_t const& downstream_addr = connection.second;
 
@@ -1900,6 +2118,8 @@ ::check_port_frequencies() const
     {
       /// \todo Issue a warning that the edge frequency cannot be validated.
 
+      deferred_connections = 0;
+
       continue;
     }
 
@@ -1911,7 +2131,7 @@ ::check_port_frequencies() const
 
     if (!up_in_map && !down_in_map)
     {
-      if (freq_map.empty())
+      if (freq_map.empty() || new_piece)
       {
         // Seed the frequency map at 1-to-1 based on the upstream process.
         freq_map[upstream_name] = base_freq;
@@ -1968,7 +2188,12 @@ ::check_port_frequencies() const
     else
     {
       unchecked_connections.push(connection);
+      ++deferred_connections;
+
+      continue;
     }
+
+    deferred_connections = 0;
   }
 
   process::frequency_component_t freq_gcd = process::frequency_component_t(1);
@@ -1994,6 +2219,293 @@ ::check_port_frequencies() const
   }
 }
 
+void
+pipeline::priv
+::fuse_process_chains()
+{
+  fused_chains.clear();
+
+  bool const fuse = config->get_value<bool>(config_fuse_chains, false);
+
+  if (!fuse)
+  {
+    return;
+  }
+
+  typedef std::map<process::name_t, size_t> connection_count_t;
+  typedef std::map<process::name_t, process::name_t> link_map_t;
+
+  connection_count_t output_count;
+  connection_count_t input_count;
+
+  BOOST_FOREACH (process::connection_t const& connection, connections)
+  {
+    process::name_t const& upstream_name = connection.first.first;
+    process::name_t const& downstream_name = connection.second.first;
+
+    ++output_count[upstream_name];
+    ++input_count[downstream_name];
+  }
+
+  link_map_t next;
+  link_map_t prev;
+
+  // A connection may be fused only if it is the sole output of its upstream
+  // process and the sole input of its downstream process (no fan-out or
+  // fan-in).
+  BOOST_FOREACH (process::connection_t const& connection, connections)
+  {
+    process::name_t const& upstream_name = connection.first.first;
+    process::name_t const& downstream_name = connection.second.first;
+
+    if ((output_count[upstream_name] != 1) ||
+        (input_count[downstream_name] != 1))
+    {
+      continue;
+    }
+
+    if (!is_fusible(connection))
+    {
+      continue;
+    }
+
+    next[upstream_name] = downstream_name;
+    prev[downstream_name] = upstream_name;
+  }
+
+  // Walk each chain from its head. Links which form a cycle have no head and
+  // are left alone.
+  BOOST_FOREACH (link_map_t::value_type const& link, next)
+  {
+    process::name_t const& head = link.first;
+
+    if (prev.count(head))
+    {
+      continue;
+    }
+
+    process::names_t chain;
+    process::name_t cur = head;
+
+    chain.push_back(cur);
+
+    while (next.count(cur))
+    {
+      cur = next[cur];
+      chain.push_back(cur);
+    }
+
+    fused_chains.push_back(chain);
+  }
+}
+
+void
+pipeline::priv
+::setup_admission_control()
+{
+  admission_edges.clear();
+
+  config_t const admission_config = config->subblock(config_admission);
+
+  size_t const window = admission_config->get_value<size_t>(config_admission_window, 0);
+
+  if (!window)
+  {
+    return;
+  }
+
+  process::names_t const sources = admission_names(admission_config, config_admission_sources);
+  process::names_t const sinks = admission_names(admission_config, config_admission_sinks);
+
+  if (sources.empty())
+  {
+    static std::string const reason = "No sources were given";
+
+    throw invalid_admission_exception(reason);
+  }
+
+  if (sinks.empty())
+  {
+    static std::string const reason = "No sinks were given";
+
+    throw invalid_admission_exception(reason);
+  }
+
+  typedef std::map<process::name_t, process::names_t> downstream_map_t;
+  typedef std::set<process::name_t> name_set_t;
+
+  downstream_map_t downstream_map;
+
+  BOOST_FOREACH (process::connection_t const& connection, connections)
+  {
+    process::name_t const& upstream_name = connection.first.first;
+    process::name_t const& downstream_name = connection.second.first;
+
+    downstream_map[upstream_name].push_back(downstream_name);
+  }
+
+  name_set_t admitted_sinks;
+
+  BOOST_FOREACH (process::name_t const& source, sources)
+  {
+    process_t const source_proc = q->process_by_name(source);
+
+    name_set_t reached;
+    std::queue<process::name_t> to_visit;
+
+    to_visit.push(source);
+
+    while (!to_visit.empty())
+    {
+      process::name_t const cur = to_visit.front();
+      to_visit.pop();
+
+      BOOST_FOREACH (process::name_t const& next, downstream_map[cur])
+      {
+        if (reached.insert(next).second)
+        {
+          to_visit.push(next);
+        }
+      }
+    }
+
+    BOOST_FOREACH (process::name_t const& sink, sinks)
+    {
+      process_t const sink_proc = q->process_by_name(sink);
+
+      if (!reached.count(sink))
+      {
+        continue;
+      }
+
+      // An edge carries tokens from a source to each sink it feeds. The
+      // source pushes tokens before each step and the sink pops them after
+      // each step, so a full edge blocks the source. Sinks which step at a
+      // different rate than the source release tokens in proportion so that
+      // the window stays measured in source steps.
+      process::port_frequency_t const ratio = sink_proc->core_frequency() / source_proc->core_frequency();
+      size_t const push_tokens = static_cast<size_t>(ratio.numerator());
+      size_t const pop_tokens = static_cast<size_t>(ratio.denominator());
+      size_t const capacity = window * push_tokens;
+
+      if (capacity < pop_tokens)
+      {
+        std::string const reason = "The window is too small for the sink \'" + sink + "\' "
+                                   "to consume a step's worth of data from "
+                                   "the source \'" + source + "\'";
+
+        throw invalid_admission_exception(reason);
+      }
+
+      config_t const edge_config = config::empty_config();
+
+      edge_config->set_value(edge::config_capacity, boost::lexical_cast<config::value_t>(capacity));
+
+      edge_t const e = boost::make_shared<edge>(edge_config);
+
+      source_proc->add_admission_gate(e, push_tokens);
+      sink_proc->add_admission_release(e, pop_tokens);
+
+      admission_edges.push_back(e);
+      admitted_sinks.insert(sink);
+    }
+  }
+
+  BOOST_FOREACH (process::name_t const& sink, sinks)
+  {
+    if (!admitted_sinks.count(sink))
+    {
+      std::string const reason = "The sink \'" + sink + "\' is not "
+                                 "downstream of any of the sources";
+
+      throw invalid_admission_exception(reason);
+    }
+  }
+}
+
+process::names_t
+pipeline::priv
+::admission_names(config_t const& conf, config::key_t const& key) const
+{
+  config::value_t const value = conf->get_value<config::value_t>(key, config::value_t());
+
+  process::names_t names;
+
+  boost::split(names, value, boost::is_any_of(" \t"), boost::token_compress_on);
+
+  process::names_t::iterator const i = std::remove(names.begin(), names.end(), process::name_t());
+  names.erase(i, names.end());
+
+  return names;
+}
+
+bool
+pipeline::priv
+::is_fusible(process::connection_t const& connection) const
+{
+  static process::port_frequency_t const base_freq = process::port_frequency_t(1, 1);
+
+  process::port_addr_t const& upstream_addr = connection.first;
+  process::port_addr_t const& downstream_addr = connection.second;
+
+  process::name_t const& upstream_name = upstream_addr.first;
+  process::port_t const& upstream_port = upstream_addr.second;
+  process::name_t const& downstream_name = downstream_addr.first;
+  process::port_t const& downstream_port = downstream_addr.second;
+
+  process_t const up_proc = q->process_by_name(upstream_name);
+  process_t const down_proc = q->process_by_name(downstream_name);
+
+  process::port_info_t const up_info = up_proc->output_port_info(upstream_port);
+  process::port_info_t const down_info = down_proc->input_port_info(downstream_port);
+
+  // The processes must step in lock-step so that each step of the upstream
+  // process feeds exactly one step of the downstream process.
+  if ((up_info->frequency != base_freq) ||
+      (down_info->frequency != base_freq))
+  {
+    return false;
+  }
+
+  // Edges which do not imply a dependency are used for feedback loops.
+  if (down_info->flags.count(process::flag_input_nodep))
+  {
+    return false;
+  }
+
+  // Processes which manage their own input or output synchronization may not
+  // produce or consume a datum on every step. Processes without reentrancy
+  // are fine since each process in a chain is only ever stepped by one
+  // thread.
+  process::properties_t const up_props = up_proc->properties();
+  process::properties_t const down_props = down_proc->properties();
+
+  if (up_props.count(process::property_unsync_output) ||
+      down_props.count(process::property_unsync_input))
+  {
+    return false;
+  }
+
+  return true;
+}
+
+void
+pipeline::priv
+::set_synchronized_edges(bool sync)
+{
+  BOOST_FOREACH (edge_map_t::value_type const& edge_index, edge_map)
+  {
+    edge_t const& e = edge_index.second;
+
+    e->set_synchronized(sync);
+  }
+
+  BOOST_FOREACH (edge_t const& e, admission_edges)
+  {
+    e->set_synchronized(sync);
+  }
+}
+
 void
 pipeline::priv
 ::ensure_setup() const
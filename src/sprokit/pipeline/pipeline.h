@@ -36,6 +36,7 @@
 #include "process.h"
 #include "types.h"
 
+#include <boost/cstdint.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/scoped_ptr.hpp>
 
@@ -211,7 +212,7 @@ class SPROKIT_PIPELINE_EXPORT pipeline
      * \throws pipeline_duplicate_setup_exception Thrown when called after a previous successful setup.
      * \throws no_processes_exception Thrown when there are no processes in the pipeline.
      * \throws missing_connection_exception Thrown when there is a required port that is not connected in the pipeline.
-     * \throws orphaned_processes_exception Thrown when there is a subgraph which is not connected to another subgraph.
+     * \throws orphaned_processes_exception Thrown when there is a subgraph which is not connected to another subgraph and the pipeline is not a partition (the \c _node configuration is not set).
      * \throws untyped_data_dependent_exception Thrown when a data-dependent port type is not set after initialization.
      * \throws connection_dependent_type_exception Thrown when a connection creates a port type problem in the pipeline.
      * \throws connection_dependent_type_cascade_exception Thrown when a data-dependent port type creates a problem in the pipeline.
@@ -464,6 +465,78 @@ class SPROKIT_PIPELINE_EXPORT pipeline
      * \returns All edges that carry data from \p name's \p port.
      */
     edges_t output_edges_for_port(process::name_t const& name, process::port_t const& port) const;
+
+    /// Processes which are run as a single unit, ordered from upstream to downstream.
+    typedef std::vector<process::names_t> chains_t;
+
+    /// The type for the name of a setup phase.
+    typedef std::string setup_phase_t;
+    /// The type for the duration of a setup phase (in nanoseconds).
+    typedef uint64_t setup_duration_t;
+    /// The type for the time taken by a setup phase.
+    typedef std::pair<setup_phase_t, setup_duration_t> setup_timing_t;
+    /// The type for the time taken by each setup phase.
+    typedef std::vector<setup_timing_t> setup_timings_t;
+
+    /**
+     * \brief Chains of processes which may be fused into a single unit.
+     *
+     * Fusion is enabled with the \c _fuse_chains pipeline configuration. A
+     * chain is a sequence of processes connected one-to-one with ports at a
+     * frequency of 1 where no process fans out or in within the chain and no
+     * process manages its own synchronization of the connecting ports.
+     * Schedulers may run the processes of a chain in turn on a single thread
+     * and stop synchronizing the edges between them; the edges still exist
+     * and may be inspected as usual. Such a thread steps the rest of the
+     * chain only when the head returns, so a head waiting for input stalls
+     * the processes after it even if they have data of their own queued.
+     *
+     * \throws pipeline_not_setup_exception Thrown when the pipeline has not been setup.
+     * \throws pipeline_not_ready_exception Thrown when the pipeline has not been setup successfully.
+     *
+     * \returns The chains of processes found during setup.
+     */
+    chains_t fused_chains() const;
+
+    /**
+     * \brief Edges which limit how much data is in flight.
+     *
+     * These are created from the \c _admission pipeline configuration and are
+     * not connected to any port. Processes push to and pop from them around
+     * each step, so schedulers which track edges to wake blocked processes
+     * must track these as well.
+     *
+     * \throws pipeline_not_setup_exception Thrown when the pipeline has not been setup.
+     * \throws pipeline_not_ready_exception Thrown when the pipeline has not been setup successfully.
+     *
+     * \returns The edges used for admission control.
+     */
+    edges_t admission_edges() const;
+
+    /**
+     * \brief How long each phase of the setup took.
+     *
+     * Phases are listed in the order they ran. If the setup failed, the
+     * phase which failed is the last one listed.
+     *
+     * \throws pipeline_not_setup_exception Thrown when the pipeline has not been setup.
+     *
+     * \returns The time taken by each phase of \ref setup_pipeline.
+     */
+    setup_timings_t setup_timings() const;
+
+    /**
+     * \brief Declare that the current run drives all processes from one thread.
+     *
+     * Schedulers which step every process from a single thread should call
+     * this from \ref scheduler::_start before any process is stepped. The
+     * edges of the pipeline then skip all locking. The edges are synchronized
+     * again when the pipeline is stopped.
+     *
+     * \throws pipeline_not_setup_exception Thrown when the pipeline has not been setup.
+     * \throws pipeline_not_ready_exception Thrown when the pipeline has not been setup successfully.
+     */
+    void run_single_threaded();
   private:
     friend class scheduler;
     SPROKIT_PIPELINE_NO_EXPORT void start();
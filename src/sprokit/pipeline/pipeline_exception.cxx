@@ -534,6 +534,23 @@ frequency_mismatch_exception
 {
 }
 
+invalid_admission_exception
+::invalid_admission_exception(std::string const& reason) SPROKIT_NOTHROW
+  : pipeline_setup_exception()
+  , m_reason(reason)
+{
+  std::ostringstream sstr;
+
+  sstr << "Admission control is misconfigured: " << m_reason;
+
+  m_what = sstr.str();
+}
+
+invalid_admission_exception
+::~invalid_admission_exception() SPROKIT_NOTHROW
+{
+}
+
 reset_running_pipeline_exception
 ::reset_running_pipeline_exception() SPROKIT_NOTHROW
 {
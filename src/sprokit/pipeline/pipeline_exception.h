@@ -748,6 +748,32 @@ class SPROKIT_PIPELINE_EXPORT frequency_mismatch_exception
     process::port_frequency_t const m_downstream_port_frequency;
 };
 
+/**
+ * \class invalid_admission_exception pipeline_exception.h <sprokit/pipeline/pipeline_exception.h>
+ *
+ * \brief Thrown when admission control for a \ref pipeline is misconfigured.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT invalid_admission_exception
+  : public pipeline_setup_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param reason The reason the configuration is invalid.
+     */
+    invalid_admission_exception(std::string const& reason) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~invalid_admission_exception() throw();
+
+    /// The reason the configuration is invalid.
+    std::string const m_reason;
+};
+
 /**
  * \class reset_running_pipeline_exception pipeline_exception.h <sprokit/pipeline/pipeline_exception.h>
  *
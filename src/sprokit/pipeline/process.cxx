@@ -35,18 +35,22 @@
 #include "datum.h"
 #include "edge.h"
 #include "stamp.h"
+#include "trace.h"
 #include "types.h"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/assign/ptr_map_inserter.hpp>
 #include <boost/ptr_container/ptr_map.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <algorithm>
 #include <map>
 #include <utility>
 
@@ -63,11 +67,14 @@ process::property_t const process::property_no_threads = property_t("_no_thread"
 process::property_t const process::property_no_reentrancy = property_t("_no_reentrant");
 process::property_t const process::property_unsync_input = property_t("_unsync_input");
 process::property_t const process::property_unsync_output = property_t("_unsync_output");
+process::property_t const process::property_batch = property_t("_batch");
 
 process::port_t const process::port_heartbeat = port_t("_heartbeat");
 
 config::key_t const process::config_name = config::key_t("_name");
 config::key_t const process::config_type = config::key_t("_type");
+config::key_t const process::config_placement = config::key_t("_placement");
+config::key_t const process::config_max_batch = config::key_t("_max_batch");
 
 process::port_type_t const process::type_any = port_type_t("_any");
 process::port_type_t const process::type_none = port_type_t("_none");
@@ -138,6 +145,8 @@ class process::priv
     void connect_output_port(port_t const& port, edge_t const& edge);
 
     datum_t check_required_input();
+    void note_input_stamp(stamp_t const& st);
+    size_t batch_size() const;
     void grab_from_input_edges();
     void push_to_output_edges(datum_t const& dat) const;
     bool required_outputs_done() const;
@@ -145,6 +154,8 @@ class process::priv
     name_t name;
     type_t type;
 
+    trace::label_t trace_label;
+
     typedef std::map<port_t, port_info_t> port_map_t;
     typedef std::map<config::key_t, conf_info_t> conf_map_t;
 
@@ -169,8 +180,13 @@ class process::priv
         output_port_info_t();
         ~output_port_info_t();
 
+        typedef std::map<sprokit::stamp::stream_t, stamp_t> stream_stamps_t;
+
         edges_t edges;
+        // The next stamp for the default stream.
         stamp_t stamp;
+        // The next stamps for other streams; each stream counts separately.
+        stream_stamps_t stream_stamps;
     };
 
     typedef boost::ptr_map<port_t, input_port_info_t> input_edge_map_t;
@@ -189,6 +205,47 @@ class process::priv
 
     typedef boost::optional<port_frequency_t> core_frequency_t;
 
+    typedef boost::optional<stamp::origin_t> origin_t;
+
+    // Keeps _reconfigure from running concurrently with _step. A step may
+    // suspend while waiting on an edge and resume on another thread (e.g.,
+    // under a coroutine scheduler), so no lock is held across it; running
+    // steps are counted instead.
+    class step_gate_t
+    {
+      public:
+        step_gate_t();
+        ~step_gate_t();
+
+        void enter_step();
+        void leave_step();
+        void enter_reconfigure();
+        void leave_reconfigure();
+      private:
+        boost::mutex mut;
+        boost::condition_variable cond;
+        size_t steps;
+        bool reconfiguring;
+    };
+
+    class step_scope_t
+    {
+      public:
+        step_scope_t(step_gate_t& gate_);
+        ~step_scope_t();
+      private:
+        step_gate_t& gate;
+    };
+
+    class reconfigure_scope_t
+    {
+      public:
+        reconfigure_scope_t(step_gate_t& gate_);
+        ~reconfigure_scope_t();
+      private:
+        step_gate_t& gate;
+    };
+
     tag_t port_flow_tag_name(port_type_t const& port_type) const;
     void check_tag(tag_t const& tag);
 
@@ -205,7 +262,11 @@ class process::priv
     mutable mutex_t output_edges_mut;
 
     process* const q;
-    config_t conf;
+
+    config_t current_config() const;
+    void publish_config(config_t const& new_conf);
+
+    static config_t copy_config(config_t const& conf);
 
     typedef std::set<port_t> port_set_t;
 
@@ -231,12 +292,40 @@ class process::priv
 
     stamp_t stamp_for_inputs;
 
-    mutex_t reconfigure_mut;
+    // Whether _step_batch may be used and how many sets of inputs it may get.
+    bool batchable;
+    size_t max_batch;
+
+    static size_t const default_max_batch;
+
+    // Admission control: tokens are pushed into each gate before stepping
+    // and popped from each release after stepping. The counts per step
+    // balance the core frequencies of the source and the sink.
+    typedef std::pair<edge_t, size_t> admission_edge_t;
+    typedef std::vector<admission_edge_t> admission_edges_t;
+
+    admission_edges_t admission_gates;
+    admission_edges_t admission_releases;
+    edge_datum_t admission_token;
+
+    // The earliest origin of the data grabbed during the current step.
+    origin_t origin_for_inputs;
+    // The stream of the data grabbed during the current step.
+    stamp::stream_t stream_for_inputs;
+
+    // The current configuration snapshot. Reconfiguration never modifies a
+    // published snapshot; it publishes a new one instead. Only access it
+    // through current_config() and publish_config().
+    config_t conf;
+
+    step_gate_t step_gate;
+    mutex_t config_write_mut;
 
     static config::value_t const default_name;
 };
 
 config::value_t const process::priv::default_name = "(unnamed)";
+size_t const process::priv::default_max_batch = 64;
 
 void
 process
@@ -273,6 +362,26 @@ ::init()
 
   _init();
 
+  d->max_batch = d->current_config()->get_value<size_t>(config_max_batch, priv::default_max_batch);
+  d->batchable = (0 != properties().count(property_batch)) && (1 < d->max_batch);
+
+  // Other frequencies change how many inputs make up a set.
+  BOOST_FOREACH (priv::port_map_t::value_type const& iport, d->input_ports)
+  {
+    if (iport.second->frequency != port_frequency_t(1))
+    {
+      d->batchable = false;
+    }
+  }
+
+  BOOST_FOREACH (priv::port_map_t::value_type const& oport, d->output_ports)
+  {
+    if (oport.second->frequency != port_frequency_t(1))
+    {
+      d->batchable = false;
+    }
+  }
+
   d->initialized = true;
 }
 
@@ -297,6 +406,8 @@ ::step()
     throw uninitialized_exception(d->name);
   }
 
+  SPROKIT_TRACE_SCOPE(trace_step, "step", d->trace_label);
+
   /// \todo Make reentrant.
   /// \todo Are there any pre-_step actions?
 
@@ -309,28 +420,72 @@ ::step()
   }
   else
   {
-    datum_t const dat = d->check_required_input();
+    size_t const batch = d->batch_size();
+
+    // Wait for room in the admission window before letting more data in.
+    BOOST_FOREACH (priv::admission_edge_t const& gate, d->admission_gates)
+    {
+      for (size_t i = 0; i < gate.second; ++i)
+      {
+        gate.first->push_datum(d->admission_token);
+      }
+    }
+
+    datum_t const dat = (1 < batch) ? datum_t() : d->check_required_input();
+
+    if (1 < batch)
+    {
+      priv::step_scope_t const scope(d->step_gate);
+
+      (void)scope;
+
+      SPROKIT_TRACE_SCOPE(trace_substep, "_step_batch", d->trace_label);
 
-    if (dat)
+      _step_batch(batch);
+    }
+    else if (dat)
     {
       d->grab_from_input_edges();
       d->push_to_output_edges(dat);
 
-      complete = (dat->type() == datum::complete);
+      // Only the end of the default stream ends the process; other streams
+      // end independently of each other.
+      complete = (dat->type() == datum::complete) &&
+                 (d->stream_for_inputs == stamp::default_stream);
     }
     else
     {
-      // We don't want to reconfigure while the subclass is running. Since the
-      // base class shouldn't be messed with while configuring, we only need to
-      // lock around the base class _step method call.
-      priv::shared_lock_t const lock(d->reconfigure_mut);
+      // Configuration values are read from immutable snapshots, so this
+      // only keeps the subclass' _reconfigure from running concurrently with
+      // its _step; building and publishing the new snapshot happens outside
+      // of it.
+      priv::step_scope_t const scope(d->step_gate);
 
-      (void)lock;
+      (void)scope;
+
+      SPROKIT_TRACE_SCOPE(trace_substep, "_step", d->trace_label);
 
       _step();
     }
 
     d->stamp_for_inputs = stamp_t();
+    d->origin_for_inputs = priv::origin_t();
+    d->stream_for_inputs = stamp::default_stream;
+
+    // A process which completed within its step has already closed its
+    // release edges, so there is nothing left to release.
+    if (!d->is_complete)
+    {
+      BOOST_FOREACH (priv::admission_edge_t const& release, d->admission_releases)
+      {
+        size_t const tokens = batch * release.second;
+
+        for (size_t i = 0; i < tokens; ++i)
+        {
+          release.first->pop_datum();
+        }
+      }
+    }
   }
 
   /// \todo Are there any post-_step actions?
@@ -481,12 +636,13 @@ process
 ::available_tunable_config()
 {
   config::keys_t const all_keys = available_config();
+  config_t const conf = d->current_config();
   config::keys_t keys;
 
   BOOST_FOREACH (config::key_t const& key, all_keys)
   {
     // Read-only parameters aren't tunable.
-    if (d->conf->is_read_only(key))
+    if (conf->is_read_only(key))
     {
       continue;
     }
@@ -523,6 +679,13 @@ ::type() const
   return d->type;
 }
 
+config_t
+process
+::placement_config() const
+{
+  return d->current_config()->subblock(config_placement);
+}
+
 process
 ::process(config_t const& config)
   : d()
@@ -545,6 +708,7 @@ ::process(config_t const& config)
 
   d->name = config_value<name_t>(config_name);
   d->type = config_value<type_t>(config_type);
+  d->trace_label = trace::intern(d->name);
 
   declare_output_port(
     port_heartbeat,
@@ -576,6 +740,8 @@ process
 ::_reset()
 {
   d->input_edges.clear();
+  d->admission_gates.clear();
+  d->admission_releases.clear();
 
   {
     priv::unique_lock_t lock(d->output_edges_mut);
@@ -587,6 +753,7 @@ ::_reset()
 
   d->configured = false;
   d->initialized = false;
+  d->is_complete = false;
   d->core_frequency.reset();
 }
 
@@ -602,6 +769,16 @@ ::_step()
 {
 }
 
+void
+process
+::_step_batch(size_t n)
+{
+  for (size_t i = 0; i < n; ++i)
+  {
+    _step();
+  }
+}
+
 void
 process
 ::_reconfigure(config_t const& /*conf*/)
@@ -688,7 +865,9 @@ ::_set_input_port_type(port_t const& port, port_type_t const& new_type)
 
     if (!tag.empty())
     {
-      ports_t const& iports = d->input_flow_tag_ports[tag];
+      // Querying a port may declare more ports with the tag, so the lists
+      // are copied rather than walked in place.
+      ports_t const iports = d->input_flow_tag_ports[tag];
 
       BOOST_FOREACH (port_t const& iport, iports)
       {
@@ -702,7 +881,7 @@ ::_set_input_port_type(port_t const& port, port_type_t const& new_type)
           iport_info->frequency);
       }
 
-      ports_t const& oports = d->output_flow_tag_ports[tag];
+      ports_t const oports = d->output_flow_tag_ports[tag];
 
       BOOST_FOREACH (port_t const& oport, oports)
       {
@@ -759,7 +938,9 @@ ::_set_output_port_type(port_t const& port, port_type_t const& new_type)
 
     if (!tag.empty())
     {
-      ports_t const& iports = d->input_flow_tag_ports[tag];
+      // Querying a port may declare more ports with the tag, so the lists
+      // are copied rather than walked in place.
+      ports_t const iports = d->input_flow_tag_ports[tag];
 
       BOOST_FOREACH (port_t const& iport, iports)
       {
@@ -773,7 +954,7 @@ ::_set_output_port_type(port_t const& port, port_type_t const& new_type)
           iport_info->frequency);
       }
 
-      ports_t const& oports = d->output_flow_tag_ports[tag];
+      ports_t const oports = d->output_flow_tag_ports[tag];
 
       BOOST_FOREACH (port_t const& oport, oports)
       {
@@ -1147,6 +1328,12 @@ ::mark_process_as_complete()
 
     edge->mark_downstream_as_complete();
   }
+
+  // Sources must not wait on a window which is never drained again.
+  BOOST_FOREACH (priv::admission_edge_t const& release, d->admission_releases)
+  {
+    release.first->mark_downstream_as_complete();
+  }
 }
 
 bool
@@ -1227,6 +1414,28 @@ ::peek_at_datum_on_port(port_t const& port, size_t idx) const
   return edat.datum;
 }
 
+size_t
+process
+::count_on_port(port_t const& port) const
+{
+  if (!d->input_ports.count(port))
+  {
+    throw no_such_port_exception(d->name, port);
+  }
+
+  priv::input_edge_map_t::const_iterator const e = d->input_edges.find(port);
+
+  if (e == d->input_edges.end())
+  {
+    return 0;
+  }
+
+  priv::input_port_info_t const& info = *e->second;
+  edge_t const& edge = info.edge;
+
+  return edge->datum_count();
+}
+
 edge_datum_t
 process
 ::grab_from_port(port_t const& port) const
@@ -1248,7 +1457,57 @@ ::grab_from_port(port_t const& port) const
   priv::input_port_info_t const& info = *e->second;
   edge_t const& edge = info.edge;
 
-  return edge->get_datum();
+  edge_datum_t const edat = edge->get_datum();
+
+  d->note_input_stamp(edat.stamp);
+
+  return edat;
+}
+
+edge_data_t
+process
+::grab_batch_from_port(port_t const& port, size_t n) const
+{
+  if (!d->input_ports.count(port))
+  {
+    throw no_such_port_exception(d->name, port);
+  }
+
+  priv::input_edge_map_t::const_iterator const e = d->input_edges.find(port);
+
+  if (e == d->input_edges.end())
+  {
+    static std::string const reason = "Data was requested from the port";
+
+    throw missing_connection_exception(d->name, port, reason);
+  }
+
+  priv::input_port_info_t const& info = *e->second;
+  edge_t const& edge = info.edge;
+
+  edge_data_t const data = edge->get_data(n);
+
+  BOOST_FOREACH (edge_datum_t const& edat, data)
+  {
+    d->note_input_stamp(edat.stamp);
+  }
+
+  return data;
+}
+
+stamp::stream_t
+process
+::input_stream() const
+{
+  return d->stream_for_inputs;
+}
+
+bool
+process
+::is_final_complete(edge_datum_t const& edat)
+{
+  return ((edat.datum->type() == datum::complete) &&
+          (!edat.stamp || (edat.stamp->stream() == stamp::default_stream)));
 }
 
 datum_t
@@ -1299,6 +1558,13 @@ ::push_to_port(port_t const& port, edge_datum_t const& dat) const
 void
 process
 ::push_datum_to_port(port_t const& port, datum_t const& dat) const
+{
+  push_datum_to_stream(port, d->stream_for_inputs, dat);
+}
+
+void
+process
+::push_datum_to_stream(port_t const& port, stamp::stream_t stream, datum_t const& dat) const
 {
   if (!d->output_ports.count(port))
   {
@@ -1338,11 +1604,51 @@ ::push_datum_to_port(port_t const& port, datum_t const& dat) const
 
       (void)port_write_lock;
 
-      push_stamp = port_stamp;
-      port_stamp = stamp::incremented_stamp(port_stamp);
+      if (stream == stamp::default_stream)
+      {
+        push_stamp = port_stamp;
+        port_stamp = stamp::incremented_stamp(port_stamp);
+      }
+      else
+      {
+        // Indices within a stream only depend on the data in that stream so
+        // that stamps from branches which interleave streams differently
+        // still line up.
+        priv::output_port_info_t::stream_stamps_t& stream_stamps = info.stream_stamps;
+        priv::output_port_info_t::stream_stamps_t::iterator i = stream_stamps.find(stream);
+
+        if (i == stream_stamps.end())
+        {
+          stamp_t const first = stamp::stream_stamp(stamp::new_stamp(port_stamp->increment()), stream);
+
+          i = stream_stamps.insert(std::make_pair(stream, first)).first;
+        }
+
+        push_stamp = i->second;
+
+        // Nothing follows the end of a stream.
+        if (dat->type() == datum::complete)
+        {
+          stream_stamps.erase(i);
+        }
+        else
+        {
+          i->second = stamp::incremented_stamp(i->second);
+        }
+      }
     }
   }
 
+  if (d->origin_for_inputs)
+  {
+    push_stamp = stamp::origin_stamp(push_stamp, *d->origin_for_inputs);
+  }
+  // Data from processes without inputs enters the pipeline here.
+  else if (d->input_edges.empty() && (port != port_heartbeat))
+  {
+    push_stamp = stamp::origin_stamp(push_stamp, stamp::now());
+  }
+
   push_to_port(port, edge_datum_t(dat, push_stamp));
 }
 
@@ -1350,7 +1656,7 @@ config_t
 process
 ::get_config() const
 {
-  return d->conf;
+  return d->current_config();
 }
 
 void
@@ -1402,9 +1708,11 @@ ::config_value_raw(config::key_t const& key) const
     throw unknown_configuration_value_exception(d->name, key);
   }
 
-  if (d->conf->has_value(key))
+  config_t const conf = d->current_config();
+
+  if (conf->has_value(key))
   {
-    return d->conf->get_value<config::value_t>(key);
+    return conf->get_value<config::value_t>(key);
   }
 
   conf_info_t const& info = i->second;
@@ -1449,6 +1757,32 @@ ::set_core_frequency(port_frequency_t const& frequency)
   d->make_output_stamps();
 }
 
+process::port_frequency_t
+process
+::core_frequency() const
+{
+  if (!d->core_frequency)
+  {
+    return port_frequency_t(1);
+  }
+
+  return *d->core_frequency;
+}
+
+void
+process
+::add_admission_gate(edge_t const& edge, size_t tokens)
+{
+  d->admission_gates.push_back(priv::admission_edge_t(edge, tokens));
+}
+
+void
+process
+::add_admission_release(edge_t const& edge, size_t tokens)
+{
+  d->admission_releases.push_back(priv::admission_edge_t(edge, tokens));
+}
+
 void
 process
 ::reconfigure(config_t const& conf)
@@ -1467,9 +1801,15 @@ ::reconfigure(config_t const& conf)
     return;
   }
 
+  // Only one writer may build a new snapshot at a time; readers are never
+  // blocked by this.
+  priv::unique_lock_t write_lock(d->config_write_mut);
+
   config::keys_t const process_keys = available_config();
   config::keys_t const tunable_keys = available_tunable_config();
 
+  config_t const new_conf = priv::copy_config(d->current_config());
+
   BOOST_FOREACH (config::key_t const& key, new_keys)
   {
     bool const for_process = (0 != std::count(process_keys.begin(), process_keys.end(), key));
@@ -1486,13 +1826,17 @@ ::reconfigure(config_t const& conf)
 
     config::value_t const value = conf->get_value<config::value_t>(key);
 
-    d->conf->set_value(key, value);
+    new_conf->set_value(key, value);
   }
 
+  d->publish_config(new_conf);
+
+  write_lock.unlock();
+
   // Prevent stepping while reconfiguring a process.
-  priv::unique_lock_t const lock(d->reconfigure_mut);
+  priv::reconfigure_scope_t const scope(d->step_gate);
 
-  (void)lock;
+  (void)scope;
 
   _reconfigure(conf);
 }
@@ -1522,8 +1866,12 @@ ::reconfigure_with_provides(config_t const& conf)
   // only called by process_cluster and it only sets values which are mapped to
   // this process by it. This allows cluster parameters to be tunable and
   // provided as read-only to the process.
+  priv::unique_lock_t write_lock(d->config_write_mut);
+
+  config_t const old_conf = d->current_config();
+
   config::keys_t const process_keys = available_config();
-  config::keys_t const current_keys = d->conf->available_values();
+  config::keys_t const current_keys = old_conf->available_values();
 
   typedef std::set<config::key_t> key_set_t;
 
@@ -1536,13 +1884,13 @@ ::reconfigure_with_provides(config_t const& conf)
 
   BOOST_FOREACH (config::key_t const& key, all_keys)
   {
-    bool const has_old_value = d->conf->has_value(key);
+    bool const has_old_value = old_conf->has_value(key);
     bool const for_process = (0 != std::count(process_keys.begin(), process_keys.end(), key));
 
     if (has_old_value)
     {
       // Pass the value down as-is.
-      config::value_t const value = d->conf->get_value<config::value_t>(key);
+      config::value_t const value = old_conf->get_value<config::value_t>(key);
 
       new_conf->set_value(key, value);
     }
@@ -1570,18 +1918,20 @@ ::reconfigure_with_provides(config_t const& conf)
 
     // Preserve read-only flags so that a future reconfigure doesn't trigger any
     // issues.
-    if (d->conf->is_read_only(key) || conf->is_read_only(key))
+    if (old_conf->is_read_only(key) || conf->is_read_only(key))
     {
       new_conf->mark_read_only(key);
     }
   }
 
-  d->conf = new_conf;
+  d->publish_config(new_conf);
+
+  write_lock.unlock();
 
   // Prevent stepping while reconfiguring a process.
-  priv::unique_lock_t const lock(d->reconfigure_mut);
+  priv::reconfigure_scope_t const scope(d->step_gate);
 
-  (void)lock;
+  (void)scope;
 
   _reconfigure(conf);
 }
@@ -1590,13 +1940,13 @@ process::priv
 ::priv(process* proc, config_t const& c)
   : name()
   , type()
+  , trace_label()
   , input_ports()
   , output_ports()
   , config_keys()
   , input_edges()
   , output_edges()
   , q(proc)
-  , conf(c)
   , static_inputs()
   , required_inputs()
   , required_outputs()
@@ -1612,6 +1962,16 @@ ::priv(process* proc, config_t const& c)
   , is_complete(false)
   , check_input_level(check_valid)
   , stamp_for_inputs()
+  , batchable(false)
+  , max_batch(default_max_batch)
+  , admission_gates()
+  , admission_releases()
+  , admission_token(datum::empty_datum(), stamp::new_stamp(1))
+  , origin_for_inputs()
+  , stream_for_inputs(stamp::default_stream)
+  , conf(c)
+  , step_gate()
+  , config_write_mut()
 {
 }
 
@@ -1620,6 +1980,146 @@ process::priv
 {
 }
 
+process::priv::step_gate_t
+::step_gate_t()
+  : mut()
+  , cond()
+  , steps(0)
+  , reconfiguring(false)
+{
+}
+
+process::priv::step_gate_t
+::~step_gate_t()
+{
+}
+
+void
+process::priv::step_gate_t
+::enter_step()
+{
+  boost::unique_lock<boost::mutex> lock(mut);
+
+  while (reconfiguring)
+  {
+    cond.wait(lock);
+  }
+
+  ++steps;
+}
+
+void
+process::priv::step_gate_t
+::leave_step()
+{
+  boost::unique_lock<boost::mutex> const lock(mut);
+
+  (void)lock;
+
+  --steps;
+
+  if (!steps)
+  {
+    cond.notify_all();
+  }
+}
+
+void
+process::priv::step_gate_t
+::enter_reconfigure()
+{
+  boost::unique_lock<boost::mutex> lock(mut);
+
+  while (reconfiguring)
+  {
+    cond.wait(lock);
+  }
+
+  // New steps wait from here on, so a busy process cannot starve this.
+  reconfiguring = true;
+
+  while (steps)
+  {
+    cond.wait(lock);
+  }
+}
+
+void
+process::priv::step_gate_t
+::leave_reconfigure()
+{
+  boost::unique_lock<boost::mutex> const lock(mut);
+
+  (void)lock;
+
+  reconfiguring = false;
+
+  cond.notify_all();
+}
+
+process::priv::step_scope_t
+::step_scope_t(step_gate_t& gate_)
+  : gate(gate_)
+{
+  gate.enter_step();
+}
+
+process::priv::step_scope_t
+::~step_scope_t()
+{
+  gate.leave_step();
+}
+
+process::priv::reconfigure_scope_t
+::reconfigure_scope_t(step_gate_t& gate_)
+  : gate(gate_)
+{
+  gate.enter_reconfigure();
+}
+
+process::priv::reconfigure_scope_t
+::~reconfigure_scope_t()
+{
+  gate.leave_reconfigure();
+}
+
+config_t
+process::priv
+::current_config() const
+{
+  return boost::atomic_load(&conf);
+}
+
+void
+process::priv
+::publish_config(config_t const& new_conf)
+{
+  boost::atomic_store(&conf, new_conf);
+}
+
+config_t
+process::priv
+::copy_config(config_t const& conf)
+{
+  config_t const new_conf = config::empty_config();
+
+  config::keys_t const keys = conf->available_values();
+
+  BOOST_FOREACH (config::key_t const& key, keys)
+  {
+    config::value_t const value = conf->get_value<config::value_t>(key);
+
+    new_conf->set_value(key, value);
+
+    if (conf->is_read_only(key))
+    {
+      new_conf->mark_read_only(key);
+    }
+  }
+
+  return new_conf;
+}
+
 void
 process::priv
 ::run_heartbeat()
@@ -1746,6 +2246,7 @@ ::check_required_input()
     // Save the stamp for the inputs.
     edge_datum_t const& edat = first_data[0];
     stamp_for_inputs = edat.stamp;
+    stream_for_inputs = stamp_for_inputs->stream();
   }
 
   if (check_input_level < check_valid)
@@ -1784,6 +2285,97 @@ ::check_required_input()
   return datum_t();
 }
 
+void
+process::priv
+::note_input_stamp(stamp_t const& st)
+{
+  if (!st)
+  {
+    return;
+  }
+
+  // Outputs inherit the earliest origin of the inputs they derive from.
+  if (st->has_origin())
+  {
+    stamp::origin_t const origin = st->origin();
+
+    if (!origin_for_inputs || (origin < *origin_for_inputs))
+    {
+      origin_for_inputs = origin;
+    }
+  }
+
+  stream_for_inputs = st->stream();
+}
+
+size_t
+process::priv
+::batch_size() const
+{
+  // Tokens for the admission window are taken for one set of inputs at a time.
+  if (!batchable ||
+      !admission_gates.empty() ||
+      (check_input_level < check_sync) ||
+      required_inputs.empty())
+  {
+    return 1;
+  }
+
+  edges_t iedges;
+  size_t n = max_batch;
+
+  BOOST_FOREACH (port_t const& port, required_inputs)
+  {
+    input_edge_map_t::const_iterator const i = input_edges.find(port);
+
+    if (i == input_edges.end())
+    {
+      continue;
+    }
+
+    input_port_info_t const& info = *i->second;
+    edge_t const& iedge = info.edge;
+
+    n = std::min(n, iedge->datum_count());
+    iedges.push_back(iedge);
+  }
+
+  if (iedges.empty() || !n)
+  {
+    return 1;
+  }
+
+  // Only ordinary, synchronized data is batched. Anything else is left for
+  // the checks of a single step. A batch stays within one stream so that
+  // outputs are pushed to the stream of their inputs.
+  stamp::stream_t const stream = iedges[0]->peek_datum(0).stamp->stream();
+
+  for (size_t j = 0; j < n; ++j)
+  {
+    edge_data_t data;
+
+    BOOST_FOREACH (edge_t const& iedge, iedges)
+    {
+      edge_datum_t const edat = iedge->peek_datum(j);
+
+      if ((edat.datum->type() != datum::data) ||
+          (edat.stamp->stream() != stream))
+      {
+        return std::max(j, size_t(1));
+      }
+
+      data.push_back(edat);
+    }
+
+    if (!edge_data_info(data)->in_sync)
+    {
+      return std::max(j, size_t(1));
+    }
+  }
+
+  return std::max(n, size_t(1));
+}
+
 void
 process::priv
 ::grab_from_input_edges()
@@ -1978,6 +2570,7 @@ ::make_output_stamps()
       stamp_t& stamp = oinfo.stamp;
 
       stamp = stamp::new_stamp(port_increment);
+      oinfo.stream_stamps.clear();
     }
   }
 
@@ -1999,6 +2592,7 @@ process::priv::output_port_info_t
 ::output_port_info_t()
   : edges()
   , stamp()
+  , stream_stamps()
 {
 }
 
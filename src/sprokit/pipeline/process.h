@@ -36,6 +36,7 @@
 #include "edge.h"
 #include "config.h"
 #include "datum.h"
+#include "stamp.h"
 #include "types.h"
 
 #include <boost/cstdint.hpp>
@@ -311,6 +312,10 @@ class SPROKIT_PIPELINE_EXPORT process
     /**
      * \brief Step through one iteration of the process.
      *
+     * A process with the \ref property_batch property is handed every set of
+     * inputs which is already queued (up to \ref config_max_batch of them) at
+     * once through \ref _step_batch.
+     *
      * \preconds
      *
      * \precond{\c this was initialized}
@@ -490,6 +495,13 @@ class SPROKIT_PIPELINE_EXPORT process
      */
     type_t type() const;
 
+    /**
+     * \brief Query for the thread placement requested for the process.
+     *
+     * \returns The \ref config_placement block of the process' configuration.
+     */
+    config_t placement_config() const;
+
     /// A property which indicates that the process cannot be run in a thread of its own.
     static property_t const property_no_threads;
     /// A property which indicates that the process is not reentrant.
@@ -498,6 +510,8 @@ class SPROKIT_PIPELINE_EXPORT process
     static property_t const property_unsync_input;
     /// A property which indicates that the output of the process is not synchronized.
     static property_t const property_unsync_output;
+    /// A property which indicates that the process handles several sets of inputs in \ref _step_batch.
+    static property_t const property_batch;
 
     /// The name of the heartbeat port.
     static port_t const port_heartbeat;
@@ -506,6 +520,10 @@ class SPROKIT_PIPELINE_EXPORT process
     static config::key_t const config_name;
     /// The name of the configuration value for the type.
     static config::key_t const config_type;
+    /// The name of the configuration block for requesting thread placement.
+    static config::key_t const config_placement;
+    /// The name of the configuration value for the most sets of inputs handed to \ref _step_batch.
+    static config::key_t const config_max_batch;
 
     /// A type which means that the type of the data is irrelevant.
     static port_type_t const type_any;
@@ -680,11 +698,36 @@ class SPROKIT_PIPELINE_EXPORT process
      */
     virtual void _step();
 
+    /**
+     * \brief Method where subclass data processing occurs for several sets of inputs.
+     *
+     * This is only called for processes with the \ref property_batch property
+     * instead of \c _step() when \p n sets of ordinary, synchronized data are
+     * already queued on every required input port. Each port must be grabbed
+     * from \p n times and each output port pushed to \p n times. Data on
+     * ports with a frequency other than one is never batched. Outputs are
+     * pushed to the stream of the inputs, so a batch never spans streams; it
+     * ends at the first set of inputs from another stream.
+     *
+     * \note Outputs carry the earliest origin of all of the inputs of the batch.
+     *
+     * \note Batching is disabled while the process has admission gates since
+     * their tokens are taken for one set of inputs at a time.
+     *
+     * The default implementation calls \c _step() \p n times. Overrides may
+     * use \ref grab_batch_from_port to take the inputs with one lock.
+     *
+     * \param n The number of sets of inputs to process.
+     */
+    virtual void _step_batch(size_t n);
+
     /**
      * \brief Runtime configuration for subclasses.
      *
      * This method is called after the process is initially configured
-     * and started. A config block with updated values is supplied.
+     * and started. A config block with updated values is supplied. The new
+     * values have already been published by the time this is called, so
+     * \ref config_value returns them.
      *
      * \params conf The configuration block to apply.
      */
@@ -960,6 +1003,17 @@ class SPROKIT_PIPELINE_EXPORT process
      * \returns The datum available on the port.
      */
     datum_t peek_at_datum_on_port(port_t const& port, size_t idx = 0) const;
+    /**
+     * \brief Query how many data are waiting on a port.
+     *
+     * \note Only the process may remove data from its ports, so at least this
+     * many data may be grabbed from \p port without blocking.
+     *
+     * \param port The port to look at.
+     *
+     * \returns The number of data queued on the port.
+     */
+    size_t count_on_port(port_t const& port) const;
     /**
      * \brief Grab an edge datum packet from a port.
      *
@@ -969,6 +1023,18 @@ class SPROKIT_PIPELINE_EXPORT process
      * \returns The datum available on the port.
      */
     edge_datum_t grab_from_port(port_t const& port) const;
+    /**
+     * \brief Grab several edge datum packets from a port at once.
+     *
+     * Meant for \ref _step_batch: the edge is locked once for all of the
+     * data rather than once per datum.
+     *
+     * \param port The port to get data from.
+     * \param n The number of data to get.
+     *
+     * \returns The next \p n data available on the port.
+     */
+    edge_data_t grab_batch_from_port(port_t const& port, size_t n) const;
 
     /**
      * \brief Grab a datum packet from a port.
@@ -982,6 +1048,26 @@ class SPROKIT_PIPELINE_EXPORT process
      */
     datum_t grab_datum_from_port(port_t const& port) const;
 
+    /**
+     * \brief The stream of the data grabbed during the current step.
+     *
+     * \returns The stream of the inputs, or \ref stamp::default_stream if
+     * nothing has been grabbed yet.
+     */
+    stamp::stream_t input_stream() const;
+
+    /**
+     * \brief Check whether a datum ends all input to a process.
+     *
+     * A complete datum only ends the stream it is part of; the process
+     * itself is complete once the default stream ends.
+     *
+     * \param edat The edge datum to check.
+     *
+     * \returns True if \p edat is a complete datum on the default stream.
+     */
+    static bool is_final_complete(edge_datum_t const& edat);
+
     /**
      * \brief Grab a datum from a port as a certain type.
      *
@@ -1030,11 +1116,25 @@ class SPROKIT_PIPELINE_EXPORT process
     /**
      * \brief Output a datum packet on a port.
      *
+     * The stamp of the datum carries the earliest origin of the data grabbed
+     * during the current step. When the process has no connected inputs, the
+     * origin is the current time instead. The datum is part of the same
+     * stream as the inputs.
+     *
      * \param port The port to push to.
      * \param dat The datum to push.
      */
     void push_datum_to_port(port_t const& port, datum_t const& dat) const;
 
+    /**
+     * \brief Output a datum packet on a port as part of a stream.
+     *
+     * \param port The port to push to.
+     * \param stream The stream the datum is part of.
+     * \param dat The datum to push.
+     */
+    void push_datum_to_stream(port_t const& port, stamp::stream_t stream, datum_t const& dat) const;
+
     /**
      * \brief Output a result on a port.
      * \todo explain why use this instead of push_to_port
@@ -1048,6 +1148,9 @@ class SPROKIT_PIPELINE_EXPORT process
     /**
      * \brief The configuration for the process.
      *
+     * The returned block is a snapshot; a reconfigure of the process
+     * publishes a new block rather than modifying the one returned here.
+     *
      * \returns The whole configuration for the process.
      */
     config_t get_config() const;
@@ -1057,7 +1160,9 @@ class SPROKIT_PIPELINE_EXPORT process
      *
      * This method returns the configuration value associated with the
      * specified key.  The return value is typed based on the template
-     * parameter.
+     * parameter. The value is read from the current configuration
+     * snapshot without locking, so it is safe to call from \ref _step
+     * while the process is being reconfigured.
      *
      * \throws no_such_configuration_key_exception Thrown if \p key
      * was not declared for the process.
@@ -1079,7 +1184,10 @@ class SPROKIT_PIPELINE_EXPORT process
      * not synchronized, an error datum is pushed to all output ports and all
      * input ports will be grabbed from based on the relative frequency of the
      * ports. If this behavior is not wanted, it must be manually handled. The
-     * default is that it is enabled.
+     * default is that it is enabled. Inputs are matched in the order they
+     * arrive rather than by stream, so when the required inputs carry several
+     * streams, every input must interleave them in the same order; otherwise
+     * the inputs are not synchronized.
      *
      * If set to \ref check_valid, the input ports which are marked as
      * \flag{required} are guaranteed to have valid data available. When the
@@ -1109,7 +1217,10 @@ class SPROKIT_PIPELINE_EXPORT process
 
     friend class pipeline;
     SPROKIT_PIPELINE_NO_EXPORT void set_core_frequency(port_frequency_t const& frequency);
+    SPROKIT_PIPELINE_NO_EXPORT port_frequency_t core_frequency() const;
     SPROKIT_PIPELINE_NO_EXPORT void reconfigure(config_t const& conf);
+    SPROKIT_PIPELINE_NO_EXPORT void add_admission_gate(edge_t const& edge, size_t tokens);
+    SPROKIT_PIPELINE_NO_EXPORT void add_admission_release(edge_t const& edge, size_t tokens);
 
     friend class process_cluster;
     SPROKIT_PIPELINE_NO_EXPORT void reconfigure_with_provides(config_t const& conf);
@@ -32,6 +32,7 @@
 #include "process_registry_exception.h"
 
 #include "config.h"
+#include "log.h"
 #include "process.h"
 #include "types.h"
 
@@ -68,6 +69,7 @@ class process_registry::priv
 };
 
 static process_registry_t reg_self = process_registry_t();
+static logger const registry_log("process_registry");
 
 process_registry
 ::~process_registry()
@@ -78,8 +80,8 @@ void
 process_registry
 ::register_process(process::type_t const& type, description_t const& desc, process_ctor_t ctor)
 {
-  /// \todo Log debug registering process
-  std::cerr <<"DEBUG - Registering process: " << type << " (" << desc << ")\n";
+  SPROKIT_LOG_DEBUG(registry_log, "Registering process: " << type << " (" << desc << ")");
+
   if (!ctor)
   {
     throw null_process_ctor_exception(type);
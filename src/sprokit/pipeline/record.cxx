@@ -0,0 +1,98 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "record.h"
+
+#include <boost/make_shared.hpp>
+
+/**
+ * \file record.cxx
+ *
+ * \brief Implementation of \link sprokit::record binary records\endlink.
+ */
+
+namespace sprokit
+{
+
+record
+::record()
+  : m_data(NULL)
+  , m_size(0)
+  , m_owner()
+{
+}
+
+record
+::record(char const* data, size_t size, owner_t const& owner)
+  : m_data(data)
+  , m_size(size)
+  , m_owner(owner)
+{
+}
+
+record
+::record(std::string const& bytes)
+  : m_data(NULL)
+  , m_size(bytes.size())
+  , m_owner()
+{
+  boost::shared_ptr<std::string const> const copy = boost::make_shared<std::string>(bytes);
+
+  m_data = copy->data();
+  m_owner = copy;
+}
+
+record
+::~record()
+{
+}
+
+char const*
+record
+::data() const
+{
+  return m_data;
+}
+
+size_t
+record
+::size() const
+{
+  return m_size;
+}
+
+std::string
+record
+::bytes() const
+{
+  return std::string(m_data, m_size);
+}
+
+}
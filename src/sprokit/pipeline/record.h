@@ -0,0 +1,120 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PIPELINE_RECORD_H
+#define SPROKIT_PIPELINE_RECORD_H
+
+#include "pipeline-config.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+
+#include <cstddef>
+
+/**
+ * \file record.h
+ *
+ * \brief Header for \link sprokit::record binary records\endlink.
+ */
+
+namespace sprokit
+{
+
+/**
+ * \class record record.h <sprokit/pipeline/record.h>
+ *
+ * \brief An opaque run of bytes.
+ *
+ * A record does not necessarily own its bytes. It may instead point into a
+ * larger buffer (e.g., a memory-mapped file) and hold a reference to whatever
+ * keeps that buffer alive. Copying a record never copies its bytes.
+ *
+ * Records are passed on ports of the \c record type, which always has a \ref
+ * datum_codec.
+ *
+ * \ingroup base_classes
+ */
+class SPROKIT_PIPELINE_EXPORT record
+{
+  public:
+    /// The type for the object which keeps the bytes alive.
+    typedef boost::shared_ptr<void const> owner_t;
+
+    /**
+     * \brief Constructor for an empty record.
+     */
+    record();
+    /**
+     * \brief Constructor for a record which refers to bytes owned elsewhere.
+     *
+     * \param data The first byte of the record.
+     * \param size The number of bytes in the record.
+     * \param owner Keeps \p data valid for as long as the record exists.
+     */
+    record(char const* data, size_t size, owner_t const& owner);
+    /**
+     * \brief Constructor for a record which owns a copy of its bytes.
+     *
+     * \param bytes The bytes of the record.
+     */
+    explicit record(std::string const& bytes);
+    /**
+     * \brief Destructor.
+     */
+    ~record();
+
+    /**
+     * \brief The bytes of the record.
+     *
+     * \returns The first byte of the record.
+     */
+    char const* data() const;
+    /**
+     * \brief The size of the record.
+     *
+     * \returns The number of bytes in the record.
+     */
+    size_t size() const;
+    /**
+     * \brief Copy the bytes of the record.
+     *
+     * \returns The bytes of the record.
+     */
+    std::string bytes() const;
+  private:
+    char const* m_data;
+    size_t m_size;
+    owner_t m_owner;
+};
+
+}
+
+#endif // SPROKIT_PIPELINE_RECORD_H
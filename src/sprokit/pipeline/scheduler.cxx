@@ -31,13 +31,23 @@
 #include "scheduler.h"
 #include "scheduler_exception.h"
 
+#include "config.h"
+#include "log.h"
 #include "pipeline.h"
+#include "process.h"
+#include "utils.h"
 
 #include <boost/thread/locks.hpp>
 #ifndef BOOST_NO_HAVE_REVERSE_LOCK
 #include <boost/thread/reverse_lock.hpp>
 #endif
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/foreach.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
 
 /**
  * \file scheduler.cxx
@@ -48,19 +58,43 @@
 namespace sprokit
 {
 
+static logger const scheduler_log("scheduler");
+
+config::key_t const scheduler::config_cpus = config::key_t("cpus");
+config::key_t const scheduler::config_numa_node = config::key_t("numa_node");
+config::key_t const scheduler::config_nice = config::key_t("nice");
+
 class scheduler::priv
 {
   public:
-    priv(scheduler* sched, pipeline_t const& pipe);
+    priv(scheduler* sched, pipeline_t const& pipe, config_t const& conf);
     ~priv();
 
     void stop();
 
+    class placement_t
+    {
+      public:
+        placement_t();
+        ~placement_t();
+
+        void apply() const;
+
+        boost::optional<processors_t> procs;
+        boost::optional<thread_nice_t> nice;
+    };
+    typedef std::map<process::name_t, placement_t> placement_map_t;
+
+    static placement_t resolve_placement(config_t const& conf);
+
     scheduler* const q;
     pipeline_t const p;
     bool paused;
     bool running;
 
+    placement_t placement;
+    placement_map_t process_placements;
+
     typedef boost::shared_mutex mutex_t;
     typedef boost::upgrade_lock<mutex_t> upgrade_lock_t;
     typedef boost::unique_lock<mutex_t> unique_lock_t;
@@ -91,7 +125,7 @@ ::scheduler(pipeline_t const& pipe, config_t const& config)
     throw null_scheduler_pipeline_exception();
   }
 
-  d.reset(new priv(this, pipe));
+  d.reset(new priv(this, pipe, config));
 }
 
 void
@@ -228,6 +262,27 @@ ::shutdown()
   }
 }
 
+void
+scheduler
+::place_thread(process_t const& proc) const
+{
+  if (proc)
+  {
+    priv::placement_map_t::const_iterator const i = d->process_placements.find(proc->name());
+
+    if (i != d->process_placements.end())
+    {
+      priv::placement_t const& placement = i->second;
+
+      placement.apply();
+
+      return;
+    }
+  }
+
+  d->placement.apply();
+}
+
 pipeline_t
 scheduler
 ::pipeline() const
@@ -236,13 +291,37 @@ ::pipeline() const
 }
 
 scheduler::priv
-::priv(scheduler* sched, pipeline_t const& pipe)
+::priv(scheduler* sched, pipeline_t const& pipe, config_t const& conf)
   : q(sched)
   , p(pipe)
   , paused(false)
   , running(false)
+  , placement()
+  , process_placements()
   , mut()
 {
+  placement = resolve_placement(conf);
+
+  process::names_t const names = p->process_names();
+
+  BOOST_FOREACH (process::name_t const& name, names)
+  {
+    process_t const proc = p->process_by_name(name);
+    config_t const proc_placement = proc->placement_config();
+
+    if (proc_placement->available_values().empty())
+    {
+      continue;
+    }
+
+    // Per-process settings override the scheduler-wide defaults.
+    config_t const merged = config::empty_config();
+
+    merged->merge_config(conf);
+    merged->merge_config(proc_placement);
+
+    process_placements[name] = resolve_placement(merged);
+  }
 }
 
 scheduler::priv
@@ -270,4 +349,94 @@ ::stop()
   running = false;
 }
 
+scheduler::priv::placement_t
+scheduler::priv
+::resolve_placement(config_t const& conf)
+{
+  placement_t placement;
+
+  if (conf->has_value(config_cpus))
+  {
+    config::value_t const value = conf->get_value<config::value_t>(config_cpus);
+
+    placement.procs = parse_processor_list(value);
+
+    if (!placement.procs)
+    {
+      throw bad_configuration_cast_exception(config_cpus, value, "processor list",
+                                             "the processor list is malformed");
+    }
+  }
+
+  if (conf->has_value(config_numa_node))
+  {
+    unsigned int const node = conf->get_value<unsigned int>(config_numa_node);
+    boost::optional<processors_t> const node_procs = numa_node_processors(node);
+
+    if (!node_procs)
+    {
+      SPROKIT_LOG_WARN(scheduler_log, "NUMA node " << node << " is not available; "
+                       "not restricting threads to it");
+    }
+    else if (placement.procs)
+    {
+      processors_t procs;
+
+      std::set_intersection(placement.procs->begin(), placement.procs->end(),
+                            node_procs->begin(), node_procs->end(),
+                            std::inserter(procs, procs.begin()));
+
+      // Pinning to no processors would fail anyway; keep the processor list.
+      if (procs.empty())
+      {
+        SPROKIT_LOG_WARN(scheduler_log, "None of the requested processors are on NUMA node " << node << "; "
+                         "ignoring the NUMA node");
+      }
+      else
+      {
+        placement.procs = procs;
+      }
+    }
+    else
+    {
+      placement.procs = node_procs;
+    }
+  }
+
+  if (conf->has_value(config_nice))
+  {
+    placement.nice = conf->get_value<thread_nice_t>(config_nice);
+  }
+
+  return placement;
+}
+
+scheduler::priv::placement_t
+::placement_t()
+  : procs()
+  , nice()
+{
+}
+
+scheduler::priv::placement_t
+::~placement_t()
+{
+}
+
+void
+scheduler::priv::placement_t
+::apply() const
+{
+  if (procs && !pin_thread(*procs))
+  {
+    SPROKIT_LOG_WARN(scheduler_log, "Failed to pin a thread to " << procs->size() << " processor(s) "
+                     "starting at " << (procs->empty() ? 0 : *procs->begin()));
+  }
+
+  if (nice && !nice_thread(*nice))
+  {
+    SPROKIT_LOG_WARN(scheduler_log, "Failed to set the niceness of a thread to " << *nice);
+  }
+}
+
 }
@@ -33,6 +33,7 @@
 
 #include "pipeline-config.h"
 
+#include "config.h"
 #include "types.h"
 
 #include <boost/noncopyable.hpp>
@@ -52,6 +53,19 @@ namespace sprokit
  *
  * \brief The base class for execution strategies on a \ref pipeline.
  *
+ * \section placement Thread placement
+ *
+ * Schedulers may pin the threads they create using \ref place_thread. The
+ * scheduler configuration provides the defaults for every thread and the \c
+ * _placement block of a process' configuration overrides them for threads
+ * which only run that process.
+ *
+ * \configs
+ *
+ * \config{cpus} The processors threads may run on (e.g., \c 0-3,8).
+ * \config{numa_node} The NUMA node threads should run on. Combined with \c cpus, the intersection is used.
+ * \config{nice} The niceness for threads.
+ *
  * \ingroup base_classes
  */
 class SPROKIT_PIPELINE_EXPORT scheduler
@@ -93,6 +107,13 @@ class SPROKIT_PIPELINE_EXPORT scheduler
      * \throws stop_before_start_exception Thrown when the scheduler has not been started.
      */
     void stop();
+
+    /// Configuration for the processors threads may run on.
+    static config::key_t const config_cpus;
+    /// Configuration for the NUMA node threads should run on.
+    static config::key_t const config_numa_node;
+    /// Configuration for the niceness of threads.
+    static config::key_t const config_nice;
   protected:
     /**
      * \brief Constructor.
@@ -137,6 +158,16 @@ class SPROKIT_PIPELINE_EXPORT scheduler
      */
     void shutdown();
 
+    /**
+     * \brief Apply the configured placement to the calling thread.
+     *
+     * \note Failures to apply the placement are not fatal; the thread runs
+     * wherever the operating system puts it.
+     *
+     * \param proc The process the thread is dedicated to, or \c NULL if the thread runs many processes.
+     */
+    void place_thread(process_t const& proc = process_t()) const;
+
     /**
      * \brief The pipeline that should be run.
      *
@@ -213,4 +213,21 @@ stop_before_start_exception
 {
 }
 
+step_failed_exception
+::step_failed_exception(std::string const& reason) SPROKIT_NOTHROW
+  : scheduler_exception()
+  , m_reason(reason)
+{
+  std::ostringstream sstr;
+
+  sstr << "A process failed while being stepped: " << m_reason;
+
+  m_what = sstr.str();
+}
+
+step_failed_exception
+::~step_failed_exception() SPROKIT_NOTHROW
+{
+}
+
 }
@@ -280,6 +280,32 @@ class SPROKIT_PIPELINE_EXPORT stop_before_start_exception
     ~stop_before_start_exception() throw();
 };
 
+/**
+ * \class step_failed_exception scheduler_exception.h <sprokit/pipeline/scheduler_exception.h>
+ *
+ * \brief Thrown when waiting on a scheduler after a process failed to step.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_EXPORT step_failed_exception
+  : public scheduler_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param reason The description of the failure.
+     */
+    step_failed_exception(std::string const& reason) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~step_failed_exception() throw();
+
+    /// The description of the failure.
+    std::string const m_reason;
+};
+
 }
 
 #endif // SPROKIT_PIPELINE_SCHEDULER_EXCEPTION_H
@@ -30,6 +30,8 @@
 
 #include "stamp.h"
 
+#include "trace.h"
+
 #include <stdexcept>
 
 /**
@@ -41,11 +43,13 @@
 namespace sprokit
 {
 
+stamp::stream_t const stamp::default_stream = 0;
+
 stamp_t
 stamp
 ::new_stamp(increment_t increment)
 {
-  return stamp_t(new stamp(increment, 0));
+  return stamp_t(new stamp(increment, 0, default_stream));
 }
 
 stamp_t
@@ -59,27 +63,129 @@ ::incremented_stamp(stamp_t const& st)
     throw std::runtime_error(reason);
   }
 
-  return stamp_t(new stamp(st->m_increment, st->m_index + st->m_increment));
+  return stamp_t(new stamp(st->m_increment, st->m_index + st->m_increment, st->m_stream));
+}
+
+stamp_t
+stamp
+::origin_stamp(stamp_t const& st, origin_t origin)
+{
+  if (!st)
+  {
+    static const std::string reason = "A NULL stamp cannot be given an origin";
+
+    throw std::runtime_error(reason);
+  }
+
+  return stamp_t(new stamp(st->m_increment, st->m_index, st->m_stream, origin));
+}
+
+stamp_t
+stamp
+::stream_stamp(stamp_t const& st, stream_t stream)
+{
+  if (!st)
+  {
+    static const std::string reason = "A NULL stamp cannot be put into a stream";
+
+    throw std::runtime_error(reason);
+  }
+
+  if (st->m_has_origin)
+  {
+    return stamp_t(new stamp(st->m_increment, st->m_index, stream, st->m_origin));
+  }
+
+  return stamp_t(new stamp(st->m_increment, st->m_index, stream));
+}
+
+stamp_t
+stamp
+::restored_stamp(increment_t increment, index_t index, stream_t stream)
+{
+  return stamp_t(new stamp(increment, index, stream));
+}
+
+stamp::origin_t
+stamp
+::now()
+{
+  // Origins use the trace clock so that latencies line up with traces.
+  return trace::now();
+}
+
+bool
+stamp
+::has_origin() const
+{
+  return m_has_origin;
+}
+
+stamp::increment_t
+stamp
+::increment() const
+{
+  return m_increment;
+}
+
+stamp::index_t
+stamp
+::index() const
+{
+  return m_index;
+}
+
+stamp::origin_t
+stamp
+::origin() const
+{
+  return m_origin;
+}
+
+stamp::stream_t
+stamp
+::stream() const
+{
+  return m_stream;
 }
 
 bool
 stamp
 ::operator == (stamp const& st) const
 {
-  return (m_index == st.m_index);
+  return ((m_stream == st.m_stream) &&
+          (m_index == st.m_index));
 }
 
 bool
 stamp
 ::operator <  (stamp const& st) const
 {
+  if (m_stream != st.m_stream)
+  {
+    return (m_stream < st.m_stream);
+  }
+
   return (m_index < st.m_index);
 }
 
 stamp
-::stamp(increment_t increment, index_t index)
+::stamp(increment_t increment, index_t index, stream_t stream)
+  : m_increment(increment)
+  , m_index(index)
+  , m_stream(stream)
+  , m_has_origin(false)
+  , m_origin(0)
+{
+}
+
+stamp
+::stamp(increment_t increment, index_t index, stream_t stream, origin_t origin)
   : m_increment(increment)
   , m_index(index)
+  , m_stream(stream)
+  , m_has_origin(true)
+  , m_origin(origin)
 {
 }
 
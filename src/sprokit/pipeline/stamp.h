@@ -53,6 +53,15 @@ namespace sprokit
  *
  * \brief A class to timestamp data in a \ref pipeline.
  *
+ * A stamp may also carry an origin: the time at which the data it is
+ * attached to (or the earliest data it was derived from) entered the
+ * pipeline. The origin does not take part in comparisons.
+ *
+ * A stamp also belongs to a stream so that a single pipeline may carry many
+ * independent streams of data. Stamps are only equal when they are in the
+ * same stream and stamps in lower streams order before those in higher
+ * streams. Unless set otherwise, stamps are in the \ref default_stream.
+ *
  * \ingroup base_classes
  */
 class SPROKIT_PIPELINE_EXPORT stamp
@@ -64,6 +73,15 @@ class SPROKIT_PIPELINE_EXPORT stamp
   public:
     /// The type for an increment size.
     typedef uint64_t increment_t;
+    /// The type for the position of a stamp.
+    typedef uint64_t index_t;
+    /// The type for an origin time (in nanoseconds).
+    typedef uint64_t origin_t;
+    /// The type for the identifier of a stream.
+    typedef uint64_t stream_t;
+
+    /// The stream for data which is not split into streams.
+    static stream_t const default_stream;
 
     /**
      * \brief Create a new stamp.
@@ -79,13 +97,82 @@ class SPROKIT_PIPELINE_EXPORT stamp
      * \returns A stamp that is greater than \p st.
      */
     static stamp_t incremented_stamp(stamp_t const& st);
+    /**
+     * \brief Create a copy of a stamp with an origin.
+     *
+     * \param st The stamp to copy.
+     * \param origin The origin for the new stamp.
+     *
+     * \returns A stamp equal to \p st with its origin set to \p origin.
+     */
+    static stamp_t origin_stamp(stamp_t const& st, origin_t origin);
+    /**
+     * \brief Create a copy of a stamp in a stream.
+     *
+     * \param st The stamp to copy.
+     * \param stream The stream for the new stamp.
+     *
+     * \returns A stamp with the index and origin of \p st in \p stream.
+     */
+    static stamp_t stream_stamp(stamp_t const& st, stream_t stream);
+    /**
+     * \brief Recreate a stamp from its parts.
+     *
+     * This is meant for transports which carry stamps outside of the process.
+     *
+     * \param increment The step increment of the stamp.
+     * \param index The index of the stamp.
+     * \param stream The stream of the stamp.
+     *
+     * \returns A stamp with the given increment and index.
+     */
+    static stamp_t restored_stamp(increment_t increment, index_t index, stream_t stream = default_stream);
+
+    /**
+     * \brief The current time.
+     *
+     * \returns The current time on the monotonic clock used for origins (the
+     * same clock as \ref trace::now).
+     */
+    static origin_t now();
+
+    /**
+     * \brief Query for the step increment of the stamp.
+     *
+     * \returns The step increment of the stamp.
+     */
+    increment_t increment() const;
+    /**
+     * \brief Query for the index of the stamp.
+     *
+     * \returns The index of the stamp.
+     */
+    index_t index() const;
+    /**
+     * \brief Query whether the stamp has an origin.
+     *
+     * \returns True if the stamp has an origin, false otherwise.
+     */
+    bool has_origin() const;
+    /**
+     * \brief Query for the origin of the stamp.
+     *
+     * \returns The origin of the stamp, or \c 0 if it does not have one.
+     */
+    origin_t origin() const;
+    /**
+     * \brief Query for the stream of the stamp.
+     *
+     * \returns The stream the stamp belongs to.
+     */
+    stream_t stream() const;
 
     /**
      * \brief Compare two stamps for equality.
      *
      * \param st The stamp to compare to.
      *
-     * \returns True if \p st and \c *this have the same value, false otherwise.
+     * \returns True if \p st and \c *this have the same value and stream, false otherwise.
      */
     bool operator == (stamp const& st) const;
     /**
@@ -97,12 +184,14 @@ class SPROKIT_PIPELINE_EXPORT stamp
      */
     bool operator <  (stamp const& st) const;
   private:
-    typedef uint64_t index_t;
-
-    SPROKIT_PIPELINE_NO_EXPORT stamp(increment_t increment, index_t index);
+    SPROKIT_PIPELINE_NO_EXPORT stamp(increment_t increment, index_t index, stream_t stream);
+    SPROKIT_PIPELINE_NO_EXPORT stamp(increment_t increment, index_t index, stream_t stream, origin_t origin);
 
     increment_t const m_increment;
     index_t const m_index;
+    stream_t const m_stream;
+    bool const m_has_origin;
+    origin_t const m_origin;
 };
 
 }
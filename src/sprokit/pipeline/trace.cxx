@@ -0,0 +1,412 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "trace.h"
+
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/foreach.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <set>
+#include <vector>
+
+/**
+ * \file trace.cxx
+ *
+ * \brief Implementation of execution \link sprokit::trace tracing\endlink.
+ */
+
+namespace sprokit
+{
+
+trace::capacity_t const trace::default_capacity = 65536;
+
+boost::detail::atomic_count trace::is_enabled(0);
+
+namespace
+{
+
+class event_t
+{
+  public:
+    trace::label_t category;
+    trace::label_t name;
+    trace::timestamp_t start;
+    trace::timestamp_t end;
+};
+
+class thread_buffer_t
+  : boost::noncopyable
+{
+  public:
+    thread_buffer_t(size_t id_, trace::capacity_t capacity);
+    ~thread_buffer_t();
+
+    void record(event_t const& event);
+
+    size_t const id;
+    std::string name;
+
+    std::vector<event_t> events;
+    boost::detail::atomic_count written;
+};
+typedef boost::shared_ptr<thread_buffer_t> thread_buffer_ptr_t;
+
+class trace_state_t
+{
+  public:
+    trace_state_t();
+
+    thread_buffer_t* buffer();
+
+    typedef boost::mutex mutex_t;
+    typedef boost::unique_lock<mutex_t> lock_t;
+
+    mutex_t mut;
+
+    trace::capacity_t capacity;
+    trace::timestamp_t base;
+
+    std::vector<thread_buffer_ptr_t> buffers;
+    std::set<std::string> labels;
+
+    // The buffers are owned by the state so that they may be written out
+    // after their threads exit.
+    boost::thread_specific_ptr<thread_buffer_t> local_buffer;
+};
+
+trace_state_t& state();
+void write_json_string(std::ostream& ostr, char const* str);
+void write_json_time(std::ostream& ostr, trace::timestamp_t time);
+void no_cleanup(thread_buffer_t* buffer);
+
+}
+
+void
+trace
+::enable(capacity_t capacity)
+{
+  trace_state_t& st = state();
+
+  {
+    trace_state_t::lock_t const lock(st.mut);
+
+    (void)lock;
+
+    st.capacity = std::max(capacity, capacity_t(1));
+
+    if (!st.base)
+    {
+      st.base = now();
+    }
+
+    if (!is_enabled)
+    {
+      ++is_enabled;
+    }
+  }
+}
+
+void
+trace
+::disable()
+{
+  trace_state_t& st = state();
+
+  trace_state_t::lock_t const lock(st.mut);
+
+  (void)lock;
+
+  if (is_enabled)
+  {
+    --is_enabled;
+  }
+}
+
+trace::label_t
+trace
+::intern(std::string const& str)
+{
+  trace_state_t& st = state();
+
+  trace_state_t::lock_t const lock(st.mut);
+
+  (void)lock;
+
+  return st.labels.insert(str).first->c_str();
+}
+
+void
+trace
+::name_thread(std::string const& name)
+{
+  if (!enabled())
+  {
+    return;
+  }
+
+  trace_state_t& st = state();
+  thread_buffer_t* const buffer = st.buffer();
+
+  trace_state_t::lock_t const lock(st.mut);
+
+  (void)lock;
+
+  buffer->name = name;
+}
+
+trace::timestamp_t
+trace
+::now()
+{
+  typedef boost::chrono::steady_clock clock_t;
+
+  clock_t::duration const since_epoch = clock_t::now().time_since_epoch();
+
+  return boost::chrono::duration_cast<boost::chrono::nanoseconds>(since_epoch).count();
+}
+
+void
+trace
+::complete(label_t category, label_t name, timestamp_t start)
+{
+  event_t event;
+
+  event.category = category;
+  event.name = name;
+  event.start = start;
+  event.end = now();
+
+  state().buffer()->record(event);
+}
+
+void
+trace
+::write_chrome_trace(std::ostream& ostr)
+{
+  trace_state_t& st = state();
+
+  trace_state_t::lock_t const lock(st.mut);
+
+  (void)lock;
+
+  ostr << "{\"traceEvents\":[";
+
+  bool first = true;
+
+  BOOST_FOREACH (thread_buffer_ptr_t const& buffer, st.buffers)
+  {
+    if (!buffer->name.empty())
+    {
+      ostr << (first ? "\n" : ",\n");
+      first = false;
+
+      ostr << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->id
+           << ",\"args\":{\"name\":";
+      write_json_string(ostr, buffer->name.c_str());
+      ostr << "}}";
+    }
+
+    size_t const written = static_cast<size_t>(static_cast<long>(buffer->written));
+    size_t const capacity = buffer->events.size();
+    size_t const count = std::min(written, capacity);
+
+    for (size_t i = written - count; i < written; ++i)
+    {
+      event_t const& event = buffer->events[i % capacity];
+
+      // Events from before the trace was enabled have no sensible offset.
+      if (event.start < st.base)
+      {
+        continue;
+      }
+
+      ostr << (first ? "\n" : ",\n");
+      first = false;
+
+      ostr << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id << ",\"cat\":";
+      write_json_string(ostr, event.category);
+      ostr << ",\"name\":";
+      write_json_string(ostr, event.name);
+      ostr << ",\"ts\":";
+      write_json_time(ostr, event.start - st.base);
+      ostr << ",\"dur\":";
+      write_json_time(ostr, event.end - event.start);
+      ostr << "}";
+    }
+  }
+
+  ostr << "\n],\"displayTimeUnit\":\"ns\"}" << std::endl;
+}
+
+namespace
+{
+
+thread_buffer_t
+::thread_buffer_t(size_t id_, trace::capacity_t capacity)
+  : id(id_)
+  , name()
+  , events(capacity)
+  , written(0)
+{
+}
+
+thread_buffer_t
+::~thread_buffer_t()
+{
+}
+
+void
+thread_buffer_t
+::record(event_t const& event)
+{
+  size_t const idx = static_cast<size_t>(static_cast<long>(written));
+
+  events[idx % events.size()] = event;
+
+  // Publish the event only after it has been written.
+  ++written;
+}
+
+trace_state_t
+::trace_state_t()
+  : mut()
+  , capacity(trace::default_capacity)
+  , base(0)
+  , buffers()
+  , labels()
+  , local_buffer(no_cleanup)
+{
+}
+
+thread_buffer_t*
+trace_state_t
+::buffer()
+{
+  thread_buffer_t* buf = local_buffer.get();
+
+  if (buf)
+  {
+    return buf;
+  }
+
+  lock_t const lock(mut);
+
+  (void)lock;
+
+  thread_buffer_ptr_t const new_buffer = boost::make_shared<thread_buffer_t>(buffers.size() + 1, capacity);
+
+  buffers.push_back(new_buffer);
+  buf = new_buffer.get();
+
+  local_buffer.reset(buf);
+
+  return buf;
+}
+
+trace_state_t&
+state()
+{
+  // Never destroyed so that threads outliving static destruction may still
+  // record events safely.
+  static trace_state_t* const st = new trace_state_t;
+
+  return *st;
+}
+
+void
+write_json_string(std::ostream& ostr, char const* str)
+{
+  ostr << '\"';
+
+  for (char const* c = str; *c; ++c)
+  {
+    unsigned char const ch = static_cast<unsigned char>(*c);
+
+    switch (ch)
+    {
+      case '\"':
+        ostr << "\\\"";
+        break;
+      case '\\':
+        ostr << "\\\\";
+        break;
+      case '\n':
+        ostr << "\\n";
+        break;
+      case '\t':
+        ostr << "\\t";
+        break;
+      default:
+        if (ch < 0x20)
+        {
+          std::ios::fmtflags const flags = ostr.flags();
+
+          ostr << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<unsigned int>(ch);
+          ostr.flags(flags);
+        }
+        else
+        {
+          ostr << *c;
+        }
+        break;
+    }
+  }
+
+  ostr << '\"';
+}
+
+void
+write_json_time(std::ostream& ostr, trace::timestamp_t time)
+{
+  // The format uses microseconds; keep the nanoseconds as a fraction.
+  char const fill = ostr.fill('0');
+
+  ostr << (time / 1000) << '.' << std::setw(3) << (time % 1000);
+
+  ostr.fill(fill);
+}
+
+void
+no_cleanup(thread_buffer_t* /*buffer*/)
+{
+}
+
+}
+
+}
@@ -0,0 +1,230 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPROKIT_PIPELINE_TRACE_H
+#define SPROKIT_PIPELINE_TRACE_H
+
+#include "pipeline-config.h"
+
+#include <boost/detail/atomic_count.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <iosfwd>
+#include <string>
+
+#include <cstddef>
+
+/**
+ * \file trace.h
+ *
+ * \brief Header for execution \link sprokit::trace tracing\endlink.
+ */
+
+#ifdef SPROKIT_ENABLE_TRACING
+/**
+ * \def SPROKIT_TRACE_SCOPE
+ *
+ * \brief Trace the rest of the enclosing scope.
+ *
+ * Expands to nothing unless \c SPROKIT_ENABLE_TRACING is defined when the
+ * code is compiled.
+ *
+ * \param var The name of the scope variable.
+ * \param category The category of the event.
+ * \param name The name of the event.
+ */
+#define SPROKIT_TRACE_SCOPE(var, category, name) \
+  sprokit::trace::scope const var(category, name); \
+  (void)var
+#else
+#define SPROKIT_TRACE_SCOPE(var, category, name)
+#endif
+
+namespace sprokit
+{
+
+/**
+ * \class trace trace.h <sprokit/pipeline/trace.h>
+ *
+ * \brief Records timed events for inspecting pipeline execution.
+ *
+ * Each thread records into its own fixed-size ring buffer, so recording an
+ * event never takes a lock; once a buffer is full, the oldest events are
+ * overwritten. Threads named with \ref name_thread use that name in the
+ * output.
+ *
+ * Events are recorded as complete events (a start time and a duration) when
+ * their scope ends, so they always pair up even if the ring has wrapped.
+ *
+ * \note Buffers are read without synchronization with the recording threads.
+ * Only write a trace once the threads being traced are done (e.g., after
+ * \ref scheduler::wait returns).
+ *
+ * \ingroup base_classes
+ */
+class SPROKIT_PIPELINE_EXPORT trace
+  : boost::noncopyable
+{
+  public:
+    /// The type for event categories and names.
+    typedef char const* label_t;
+    /// The type for timestamps (in nanoseconds).
+    typedef uint64_t timestamp_t;
+    /// The type for the number of events kept per thread.
+    typedef size_t capacity_t;
+
+    /// The default number of events kept per thread.
+    static capacity_t const default_capacity;
+
+    /**
+     * \brief Start recording events.
+     *
+     * \param capacity The number of events to keep for each thread.
+     */
+    static void enable(capacity_t capacity = default_capacity);
+    /**
+     * \brief Stop recording events.
+     *
+     * Events already recorded are kept.
+     */
+    static void disable();
+    /**
+     * \brief Query whether events are being recorded.
+     *
+     * \returns True if events are being recorded, false otherwise.
+     */
+    static bool enabled();
+
+    /**
+     * \brief Get a label which lives as long as the program.
+     *
+     * Labels are stored by pointer, so dynamic strings must be interned
+     * before being used for events.
+     *
+     * \param str The string to intern.
+     *
+     * \returns A label with the same contents as \p str.
+     */
+    static label_t intern(std::string const& str);
+
+    /**
+     * \brief Set the name of the calling thread in the trace.
+     *
+     * \param name The name of the thread.
+     */
+    static void name_thread(std::string const& name);
+
+    /**
+     * \brief The current time.
+     *
+     * \returns The current time on a monotonic clock.
+     */
+    static timestamp_t now();
+    /**
+     * \brief Record an event which started at \p start and ends now.
+     *
+     * \param category The category of the event.
+     * \param name The name of the event.
+     * \param start When the event started.
+     */
+    static void complete(label_t category, label_t name, timestamp_t start);
+
+    /**
+     * \brief Write the recorded events in the Chrome trace event format.
+     *
+     * The output can be loaded into \c chrome://tracing or Perfetto.
+     *
+     * \param ostr The stream to write to.
+     */
+    static void write_chrome_trace(std::ostream& ostr);
+
+    /**
+     * \class scope trace.h <sprokit/pipeline/trace.h>
+     *
+     * \brief Records an event for the lifetime of the object.
+     */
+    class SPROKIT_PIPELINE_EXPORT scope
+      : boost::noncopyable
+    {
+      public:
+        /**
+         * \brief Constructor.
+         *
+         * \param category The category of the event.
+         * \param name The name of the event.
+         */
+        scope(label_t category, label_t name);
+        /**
+         * \brief Destructor.
+         */
+        ~scope();
+      private:
+        label_t const m_category;
+        label_t const m_name;
+        bool const m_active;
+        timestamp_t const m_start;
+    };
+  private:
+    // Non-zero while tracing is enabled; read by every traced thread.
+    static boost::detail::atomic_count is_enabled;
+};
+
+inline
+bool
+trace
+::enabled()
+{
+  return (is_enabled != 0);
+}
+
+inline
+trace::scope
+::scope(label_t category, label_t name)
+  : m_category(category)
+  , m_name(name)
+  , m_active(trace::enabled())
+  , m_start(m_active ? trace::now() : 0)
+{
+}
+
+inline
+trace::scope
+::~scope()
+{
+  if (m_active)
+  {
+    trace::complete(m_category, m_name, m_start);
+  }
+}
+
+}
+
+#endif // SPROKIT_PIPELINE_TRACE_H
@@ -30,6 +30,8 @@
 
 #include "utils.h"
 
+#include "trace.h"
+
 #include <cxxabi.h>
 
 #ifdef HAVE_PTHREAD_NAMING
@@ -48,6 +50,7 @@
 
 #ifdef __linux__
 #define NAME_THREAD_USING_PRCTL
+#define PLACE_THREAD_USING_LINUX
 #define ABI_DEMANGLE_SYMBOL
 #endif
 
@@ -70,6 +73,25 @@
 #include <sys/prctl.h>
 #endif
 
+#ifdef PLACE_THREAD_USING_LINUX
+#include <fstream>
+#include <sstream>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <vector>
+
 #if defined(_WIN32) || defined(_WIN64)
 #include <boost/scoped_array.hpp>
 
@@ -107,6 +129,8 @@ static bool name_thread_win32(thread_name_t const& name);
 bool
 name_thread(thread_name_t const& name)
 {
+  trace::name_thread(name);
+
   bool ret = false;
 
 #ifdef NAME_THREAD_USING_PRCTL
@@ -140,6 +164,143 @@ name_thread(thread_name_t const& name)
   return ret;
 }
 
+bool
+pin_thread(processors_t const& procs)
+{
+  if (procs.empty())
+  {
+    return false;
+  }
+
+#ifdef PLACE_THREAD_USING_LINUX
+  cpu_set_t cpus;
+
+  CPU_ZERO(&cpus);
+
+  BOOST_FOREACH (unsigned int const proc, procs)
+  {
+    if (CPU_SETSIZE <= proc)
+    {
+      return false;
+    }
+
+    CPU_SET(proc, &cpus);
+  }
+
+  int const ret = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+  return (ret == 0);
+#else
+  return false;
+#endif
+}
+
+bool
+nice_thread(thread_nice_t nice)
+{
+#ifdef PLACE_THREAD_USING_LINUX
+  // Linux applies the niceness to the thread ID rather than the whole process.
+  pid_t const tid = static_cast<pid_t>(syscall(SYS_gettid));
+
+  int const ret = setpriority(PRIO_PROCESS, static_cast<id_t>(tid), nice);
+
+  return (ret == 0);
+#else
+  (void)nice;
+
+  return false;
+#endif
+}
+
+#ifdef PLACE_THREAD_USING_LINUX
+static unsigned int const processor_limit = CPU_SETSIZE;
+#else
+static unsigned int const processor_limit = 1024;
+#endif
+
+boost::optional<processors_t>
+parse_processor_list(std::string const& list)
+{
+  typedef std::vector<std::string> parts_t;
+
+  std::string const trimmed = boost::trim_copy(list);
+
+  if (trimmed.empty())
+  {
+    return boost::none;
+  }
+
+  parts_t ranges;
+
+  boost::split(ranges, trimmed, boost::is_any_of(","));
+
+  processors_t procs;
+
+  BOOST_FOREACH (std::string const& range, ranges)
+  {
+    parts_t bounds;
+
+    boost::split(bounds, range, boost::is_any_of("-"));
+
+    if (bounds.size() != 1 && bounds.size() != 2)
+    {
+      return boost::none;
+    }
+
+    unsigned int first;
+    unsigned int last;
+
+    try
+    {
+      first = boost::lexical_cast<unsigned int>(boost::trim_copy(bounds[0]));
+      last = boost::lexical_cast<unsigned int>(boost::trim_copy(bounds.back()));
+    }
+    catch (boost::bad_lexical_cast const&)
+    {
+      return boost::none;
+    }
+
+    // Processors which cannot be pinned to are rejected here; this also
+    // keeps huge ranges from being expanded.
+    if ((last < first) || (processor_limit <= last))
+    {
+      return boost::none;
+    }
+
+    for (unsigned int proc = first; proc <= last; ++proc)
+    {
+      procs.insert(proc);
+    }
+  }
+
+  return procs;
+}
+
+boost::optional<processors_t>
+numa_node_processors(unsigned int node)
+{
+#ifdef PLACE_THREAD_USING_LINUX
+  std::ostringstream sstr;
+
+  sstr << "/sys/devices/system/node/node" << node << "/cpulist";
+
+  std::ifstream fin(sstr.str().c_str());
+
+  std::string list;
+
+  if (!std::getline(fin, list))
+  {
+    return boost::none;
+  }
+
+  return parse_processor_list(list);
+#else
+  (void)node;
+
+  return boost::none;
+#endif
+}
+
 envvar_value_t
 get_envvar(envvar_name_t const& name)
 {
@@ -35,6 +35,7 @@
 
 #include <boost/optional.hpp>
 
+#include <set>
 #include <string>
 #include <typeinfo>
 
@@ -50,6 +51,11 @@ namespace sprokit
 /// The type for the name of a thread.
 typedef std::string thread_name_t;
 
+/// The type for a set of processor indices.
+typedef std::set<unsigned int> processors_t;
+/// The type for the niceness of a thread.
+typedef int thread_nice_t;
+
 /// The type for an environment variable name.
 typedef std::string envvar_name_t;
 /// The type of an environment variable value.
@@ -71,6 +77,53 @@ typedef boost::optional<std::string> envvar_value_t;
  */
 SPROKIT_PIPELINE_EXPORT bool name_thread(thread_name_t const& name);
 
+/**
+ * \brief Restrict the thread that the function was called from to processors.
+ *
+ * \note This is only implemented on Linux.
+ *
+ * \param procs The processors the thread may run on.
+ *
+ * \returns True if the affinity was successfully set, false otherwise.
+ */
+SPROKIT_PIPELINE_EXPORT bool pin_thread(processors_t const& procs);
+
+/**
+ * \brief Set the niceness of the thread that the function was called from.
+ *
+ * \note This is only implemented on Linux where niceness is per-thread.
+ * Lowering the niceness usually requires extra privileges.
+ *
+ * \param nice The niceness for the thread.
+ *
+ * \returns True if the niceness was successfully set, false otherwise.
+ */
+SPROKIT_PIPELINE_EXPORT bool nice_thread(thread_nice_t nice);
+
+/**
+ * \brief Parse a processor list.
+ *
+ * The format is the one used by the Linux kernel: comma-separated indices or
+ * inclusive ranges (e.g., \c 0-3,8,10-11). Indices beyond what a thread may
+ * be pinned to (\c CPU_SETSIZE on Linux) make the list malformed.
+ *
+ * \param list The list to parse.
+ *
+ * \returns The processors in the list, \c NULL if the list is malformed.
+ */
+SPROKIT_PIPELINE_EXPORT boost::optional<processors_t> parse_processor_list(std::string const& list);
+
+/**
+ * \brief Query the processors which belong to a NUMA node.
+ *
+ * \note This is only implemented on Linux.
+ *
+ * \param node The NUMA node to query.
+ *
+ * \returns The processors on the node, \c NULL if it could not be determined.
+ */
+SPROKIT_PIPELINE_EXPORT boost::optional<processors_t> numa_node_processors(unsigned int node);
+
 /**
  * \brief Retrieve the value of an environment variable.
  *
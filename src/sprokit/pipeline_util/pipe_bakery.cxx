@@ -57,6 +57,7 @@
 #include <boost/graph/topological_sort.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
@@ -81,6 +82,19 @@ namespace
 {
 
 static config::key_t const config_pipeline_key = config::key_t("_pipeline");
+static config::key_t const config_nodes_key = config::key_t("_nodes");
+static config::key_t const config_types_key = config::key_t("_types");
+static config::key_t const config_node_key = config::key_t("_node");
+static config::key_t const config_address_key = config::key_t("address");
+static config::key_t const config_type_key = config::key_t("type");
+
+static process::type_t const type_send = process::type_t("socket_output");
+static process::type_t const type_receive = process::type_t("socket_input");
+static process::port_t const port_send = process::port_t("send");
+static process::port_t const port_receive = process::port_t("receive");
+
+static std::string const address_tcp = std::string("tcp:");
+static std::string const address_unix = std::string("unix:");
 
 static config_flag_t const flag_read_only = config_flag_t("ro");
 static config_flag_t const flag_append = config_flag_t("append");
@@ -350,6 +364,74 @@ extract_configuration(pipe_blocks const& blocks)
   return extract_configuration_from_decls(configs);
 }
 
+class node_collector
+  : public boost::static_visitor<>
+{
+  public:
+    node_collector();
+    ~node_collector();
+
+    void operator () (config_pipe_block const& config_block);
+    void operator () (process_pipe_block const& process_block);
+    void operator () (connect_pipe_block const& connect_block);
+
+    typedef std::map<process::name_t, boost::optional<node_t> > node_map_t;
+
+    node_map_t m_nodes;
+};
+
+class node_partitioner
+  : public boost::static_visitor<>
+{
+  public:
+    node_partitioner(node_t const& node, node_collector::node_map_t const& nodes, config_t const& node_addresses, config_t const& remote_types);
+    ~node_partitioner();
+
+    void operator () (config_pipe_block const& config_block);
+    void operator () (process_pipe_block const& process_block);
+    void operator () (connect_pipe_block const& connect_block);
+
+    pipe_blocks m_blocks;
+  private:
+    node_t const& node_of(process::name_t const& name) const;
+    config::value_t address_of(node_t const& node) const;
+
+    node_t const m_node;
+    node_collector::node_map_t const m_nodes;
+    config_t const m_addresses;
+    config_t const m_types;
+    size_t m_remote_count;
+};
+
+pipe_blocks
+partition_pipe_blocks(pipe_blocks const& blocks, node_t const& node)
+{
+  node_collector collector;
+
+  std::for_each(blocks.begin(), blocks.end(), boost::apply_visitor(collector));
+
+  config_t const conf = extract_configuration(blocks);
+  config_t const addresses = conf->subblock(config_pipeline_key + config::block_sep + config_nodes_key);
+  config_t const types = conf->subblock(config_pipeline_key + config::block_sep + config_types_key);
+
+  node_partitioner partitioner(node, collector.m_nodes, addresses, types);
+
+  std::for_each(blocks.begin(), blocks.end(), boost::apply_visitor(partitioner));
+
+  // Let the pipeline know that it is only a part of the whole.
+  config_pipe_block node_block;
+  config_value_t node_value;
+
+  node_block.key.push_back(config_pipeline_key);
+  node_value.key.key_path.push_back(config_node_key);
+  node_value.value = node;
+  node_block.values.push_back(node_value);
+
+  partitioner.m_blocks.push_back(node_block);
+
+  return partitioner.m_blocks;
+}
+
 class provider_dereferencer
   : public boost::static_visitor<bakery_base::config_reference_t>
 {
@@ -1505,4 +1587,220 @@ ::operator () (bakery_base::provider_request_t const& request) const
   return (m_provider == provider);
 }
 
+
+node_collector
+::node_collector()
+  : m_nodes()
+{
+}
+
+node_collector
+::~node_collector()
+{
+}
+
+void
+node_collector
+::operator () (config_pipe_block const& /*config_block*/)
+{
+}
+
+void
+node_collector
+::operator () (process_pipe_block const& process_block)
+{
+  m_nodes[process_block.name] = process_block.node;
+}
+
+void
+node_collector
+::operator () (connect_pipe_block const& /*connect_block*/)
+{
+}
+
+node_partitioner
+::node_partitioner(node_t const& node, node_collector::node_map_t const& nodes, config_t const& node_addresses, config_t const& remote_types)
+  : m_blocks()
+  , m_node(node)
+  , m_nodes(nodes)
+  , m_addresses(node_addresses)
+  , m_types(remote_types)
+  , m_remote_count(0)
+{
+}
+
+node_partitioner
+::~node_partitioner()
+{
+}
+
+void
+node_partitioner
+::operator () (config_pipe_block const& config_block)
+{
+  // Every node sees all of the configuration.
+  m_blocks.push_back(config_block);
+}
+
+void
+node_partitioner
+::operator () (process_pipe_block const& process_block)
+{
+  if (node_of(process_block.name) != m_node)
+  {
+    return;
+  }
+
+  process_pipe_block local_block = process_block;
+
+  local_block.node.reset();
+
+  m_blocks.push_back(local_block);
+}
+
+void
+node_partitioner
+::operator () (connect_pipe_block const& connect_block)
+{
+  node_t const& upstream_node = node_of(connect_block.from.first);
+  node_t const& downstream_node = node_of(connect_block.to.first);
+
+  if (upstream_node == downstream_node)
+  {
+    if (upstream_node == m_node)
+    {
+      m_blocks.push_back(connect_block);
+    }
+
+    return;
+  }
+
+  // Every node numbers the connections between nodes the same way since they
+  // all read the same blocks.
+  size_t const index = m_remote_count++;
+
+  if ((upstream_node != m_node) && (downstream_node != m_node))
+  {
+    return;
+  }
+
+  std::string const index_str = boost::lexical_cast<std::string>(index);
+
+  config::value_t const base_address = address_of(downstream_node);
+  config::value_t address;
+
+  if (boost::starts_with(base_address, address_unix))
+  {
+    address = base_address + "." + index_str;
+  }
+  else
+  {
+    size_t const port_pos = base_address.rfind(':');
+    unsigned int port;
+
+    try
+    {
+      port = boost::lexical_cast<unsigned int>(base_address.substr(port_pos + 1));
+    }
+    catch (boost::bad_lexical_cast const&)
+    {
+      throw invalid_node_address_exception(downstream_node, base_address);
+    }
+
+    address = base_address.substr(0, port_pos + 1) + boost::lexical_cast<std::string>(port + index);
+  }
+
+  config_value_t address_value;
+
+  address_value.key.key_path.push_back(config_address_key);
+  address_value.value = address;
+
+  process_pipe_block transport_block;
+  connect_pipe_block transport_connect;
+
+  transport_block.config_values.push_back(address_value);
+
+  if (upstream_node == m_node)
+  {
+    transport_block.name = process::name_t("_send_" + index_str);
+    transport_block.type = type_send;
+
+    transport_connect.from = connect_block.from;
+    transport_connect.to = process::port_addr_t(transport_block.name, port_send);
+  }
+  else
+  {
+    transport_block.name = process::name_t("_recv_" + index_str);
+    transport_block.type = type_receive;
+
+    // Nothing on this node may pin the type of the data.
+    config::key_t const type_key = connect_block.from.first + "." + connect_block.from.second;
+
+    if (m_types->has_value(type_key))
+    {
+      config_value_t type_value;
+
+      type_value.key.key_path.push_back(config_type_key);
+      type_value.value = m_types->get_value<config::value_t>(type_key);
+
+      transport_block.config_values.push_back(type_value);
+    }
+
+    transport_connect.from = process::port_addr_t(transport_block.name, port_receive);
+    transport_connect.to = connect_block.to;
+  }
+
+  m_blocks.push_back(transport_block);
+  m_blocks.push_back(transport_connect);
+}
+
+node_t const&
+node_partitioner
+::node_of(process::name_t const& name) const
+{
+  node_collector::node_map_t::const_iterator const i = m_nodes.find(name);
+
+  if ((i == m_nodes.end()) || !i->second)
+  {
+    throw unassigned_process_exception(name);
+  }
+
+  return *i->second;
+}
+
+config::value_t
+node_partitioner
+::address_of(node_t const& node) const
+{
+  if (!m_addresses->has_value(node))
+  {
+    throw missing_node_address_exception(node);
+  }
+
+  config::value_t const address = m_addresses->get_value<config::value_t>(node);
+
+  if (boost::starts_with(address, address_unix))
+  {
+    if (address.size() == address_unix.size())
+    {
+      throw invalid_node_address_exception(node, address);
+    }
+  }
+  else if (boost::starts_with(address, address_tcp))
+  {
+    size_t const port_pos = address.rfind(':');
+
+    if (port_pos < address_tcp.size())
+    {
+      throw invalid_node_address_exception(node, address);
+    }
+  }
+  else
+  {
+    throw invalid_node_address_exception(node, address);
+  }
+
+  return address;
+}
+
 }
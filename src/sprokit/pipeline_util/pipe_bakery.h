@@ -147,6 +147,32 @@ cluster_info_t SPROKIT_PIPELINE_UTIL_EXPORT bake_cluster_blocks(cluster_blocks c
  */
 SPROKIT_PIPELINE_UTIL_EXPORT config_t extract_configuration(pipe_blocks const& blocks);
 
+/**
+ * \brief Extract the part of a pipeline which runs on a node.
+ *
+ * Every process must be assigned to a node. Connections between processes on
+ * different nodes are replaced with a \c socket_output process on the sending
+ * node and a \c socket_input process on the receiving node. The receiving
+ * node listens on the address given by \c _pipeline:_nodes:<node>. The n-th
+ * connection between nodes (in declaration order) uses the given TCP port plus
+ * n, or the given Unix socket path with a \c .n suffix.
+ *
+ * When nothing on the receiving node determines the type of the data, it may
+ * be given as \c _pipeline:_types:<process>.<port> for the sending port. The
+ * resulting blocks set \c _pipeline:_node so that the pieces of the partition
+ * need not be connected to each other.
+ *
+ * \throws unassigned_process_exception Thrown when a process is not assigned to a node.
+ * \throws missing_node_address_exception Thrown when a node which receives data has no address.
+ * \throws invalid_node_address_exception Thrown when the address of a node is malformed.
+ *
+ * \param blocks The blocks of the whole pipeline.
+ * \param node The node to extract.
+ *
+ * \returns The blocks for the processes on \p node.
+ */
+SPROKIT_PIPELINE_UTIL_EXPORT pipe_blocks partition_pipe_blocks(pipe_blocks const& blocks, node_t const& node);
+
 }
 
 #endif // SPROKIT_PIPELINE_UTIL_PIPE_BAKERY_H
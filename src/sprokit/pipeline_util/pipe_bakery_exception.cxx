@@ -256,4 +256,62 @@ unrecognized_system_index_exception
 {
 }
 
+
+unassigned_process_exception
+::unassigned_process_exception(process::name_t const& name) SPROKIT_NOTHROW
+  : pipe_bakery_exception()
+  , m_name(name)
+{
+  std::stringstream sstr;
+
+  sstr << "The \'" << m_name << "\' process "
+          "is not assigned to a node";
+
+  m_what = sstr.str();
+}
+
+unassigned_process_exception
+::~unassigned_process_exception() SPROKIT_NOTHROW
+{
+}
+
+missing_node_address_exception
+::missing_node_address_exception(node_t const& node) SPROKIT_NOTHROW
+  : pipe_bakery_exception()
+  , m_node(node)
+{
+  std::stringstream sstr;
+
+  sstr << "The \'" << m_node << "\' node "
+          "receives data from another node, "
+          "but does not have an address";
+
+  m_what = sstr.str();
+}
+
+missing_node_address_exception
+::~missing_node_address_exception() SPROKIT_NOTHROW
+{
+}
+
+invalid_node_address_exception
+::invalid_node_address_exception(node_t const& node, config::value_t const& address) SPROKIT_NOTHROW
+  : pipe_bakery_exception()
+  , m_node(node)
+  , m_address(address)
+{
+  std::stringstream sstr;
+
+  sstr << "The address of the \'" << m_node << "\' node "
+          "(\'" << m_address << "\') is not of the form "
+          "\'tcp:HOST:PORT\' or \'unix:PATH\'";
+
+  m_what = sstr.str();
+}
+
+invalid_node_address_exception
+::~invalid_node_address_exception() SPROKIT_NOTHROW
+{
+}
+
 }
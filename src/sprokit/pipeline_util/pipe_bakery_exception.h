@@ -355,6 +355,88 @@ class SPROKIT_PIPELINE_UTIL_EXPORT unrecognized_system_index_exception
     config::value_t const m_index;
 };
 
+
+/**
+ * \class unassigned_process_exception pipe_bakery_exception.h <sprokit/pipeline_util/pipe_bakery_exception.h>
+ *
+ * \brief The exception thrown when a partitioned pipeline has a process without a node.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_UTIL_EXPORT unassigned_process_exception
+  : public pipe_bakery_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param name The name of the process.
+     */
+    unassigned_process_exception(process::name_t const& name) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~unassigned_process_exception() throw();
+
+    /// The name of the process.
+    process::name_t const m_name;
+};
+
+/**
+ * \class missing_node_address_exception pipe_bakery_exception.h <sprokit/pipeline_util/pipe_bakery_exception.h>
+ *
+ * \brief The exception thrown when a node receives data but has no address.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_UTIL_EXPORT missing_node_address_exception
+  : public pipe_bakery_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param node The node without an address.
+     */
+    missing_node_address_exception(node_t const& node) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~missing_node_address_exception() throw();
+
+    /// The node without an address.
+    node_t const m_node;
+};
+
+/**
+ * \class invalid_node_address_exception pipe_bakery_exception.h <sprokit/pipeline_util/pipe_bakery_exception.h>
+ *
+ * \brief The exception thrown when the address of a node is malformed.
+ *
+ * \ingroup exceptions
+ */
+class SPROKIT_PIPELINE_UTIL_EXPORT invalid_node_address_exception
+  : public pipe_bakery_exception
+{
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param node The node.
+     * \param address The address given for the node.
+     */
+    invalid_node_address_exception(node_t const& node, config::value_t const& address) throw();
+    /**
+     * \brief Destructor.
+     */
+    ~invalid_node_address_exception() throw();
+
+    /// The node.
+    node_t const m_node;
+    /// The address given for the node.
+    config::value_t const m_address;
+};
+
 }
 
 #endif // SPROKIT_PIPELINE_UTIL_PIPE_BAKERY_EXCEPTION_H
@@ -61,6 +61,9 @@ typedef std::vector<config_flag_t> config_flags_t;
 /// The type for a configuration provider.
 typedef token_t config_provider_t;
 
+/// The type for the name of a node a process is assigned to.
+typedef token_t node_t;
+
 /**
  * \struct config_key_options_t pipe_declaration_types.h <sprokit/pipeline_util/pipe_declaration_types.h>
  *
@@ -127,6 +130,8 @@ struct process_pipe_block
   process::name_t name;
   /// The type of the process.
   process::type_t type;
+  /// The node the process runs on (if assigned).
+  boost::optional<node_t> node;
   /// Associated configuration values.
   config_values_t config_values;
 };
@@ -82,6 +82,7 @@ BOOST_FUSION_ADAPT_STRUCT(
   sprokit::process_pipe_block,
   (sprokit::process::name_t, name)
   (sprokit::process::type_t, type)
+  (boost::optional<sprokit::node_t>, node)
   (sprokit::config_values_t, config_values)
 )
 
@@ -137,6 +138,7 @@ static token_t const from_name = token_t("from");
 static token_t const to_name = token_t("to");
 static token_t const type_token = token_t("::");
 static token_t const description_token = token_t(":#");
+static token_t const node_token = token_t("@");
 
 static token_t const config_path_separator = token_t(config::block_sep);
 static token_t const port_separator = token_t(".");
@@ -187,6 +189,9 @@ class common_grammar
 
     qi::rule<Iterator, process::name_t()> process_name;
 
+    qi::rule<Iterator, node_t()> node_name;
+    qi::rule<Iterator, node_t()> node_decl;
+
     qi::rule<Iterator, process_pipe_block()> process_block;
 
     qi::rule<Iterator, process::port_t()> port_name;
@@ -323,6 +328,8 @@ ::common_grammar()
   , type_name()
   , type_decl()
   , process_name()
+  , node_name()
+  , node_decl()
   , process_block()
   , port_name()
   , port_addr()
@@ -474,6 +481,20 @@ ::common_grammar()
      (  decl_component
      );
 
+  node_name.name("node-name");
+  node_name %=
+     (  decl_part
+     );
+
+  node_decl.name("node-decl");
+  node_decl %=
+     (  opt_whitespace
+     >> qi::lit(node_token)
+     >  whitespace
+     >  node_name
+     >  line_end
+     );
+
   process_block.name("process-block-spec");
   process_block %=
      (  opt_whitespace
@@ -484,6 +505,7 @@ ::common_grammar()
      >  opt_whitespace
      >  type_decl
      >  line_end
+     > -node_decl
      >  partial_config_value_decls
      );
 
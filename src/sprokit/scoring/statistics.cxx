@@ -30,14 +30,15 @@
 
 #include "statistics.h"
 
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics/count.hpp>
-#include <boost/accumulators/statistics/max.hpp>
-#include <boost/accumulators/statistics/mean.hpp>
-#include <boost/accumulators/statistics/median.hpp>
-#include <boost/accumulators/statistics/min.hpp>
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/variance.hpp>
+#include <boost/foreach.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+
+#include <cmath>
 
 /**
  * \file statistics.cxx
@@ -45,34 +46,59 @@
  * \brief Implementation of a statistics class.
  */
 
-namespace ba = boost::accumulators;
-
 namespace sprokit
 {
 
+static bool is_nan(statistics::data_point_t pt);
+
 class statistics::priv
 {
   public:
-    priv();
+    priv(bool keep_data_);
     ~priv();
 
-    typedef ba::accumulator_set<data_point_t, ba::stats
-      < ba::tag::count
-      , ba::tag::sum
-      , ba::tag::min
-      , ba::tag::max
-      , ba::tag::mean
-      , ba::tag::median(ba::with_p_square_quantile)
-      , ba::tag::variance(ba::lazy)
-      > > stats_t;
-
-    stats_t acc;
+    void add_moments(count_t n, data_point_t n_sum, data_point_t n_min, data_point_t n_max, double n_mean, double n_m2);
+    void add_to_bins(data_point_t pt);
+    void collapse_bins();
+
+    double bin_value(bool negative, int bin) const;
+
+    static int bin_for(data_point_t magnitude);
+    static data_point_t bin_limit(int bin);
+
+    // Bins are keyed by the logarithm of the magnitude of the samples; a bin
+    // holds magnitudes in (gamma^(bin - 1), gamma^bin].
+    typedef std::map<int, count_t> bins_t;
+
+    bool const keep_data;
     data_points_t data;
+
+    count_t count;
+    data_point_t sum;
+    data_point_t min;
+    data_point_t max;
+    double mean;
+    // The sum of the squared differences from the mean.
+    double m2;
+
+    bins_t positive;
+    bins_t negative;
+    count_t zeros;
+
+    static double const relative_accuracy;
+    static double const gamma;
+    static double const log_gamma;
+    static size_t const max_bins;
 };
 
+double const statistics::priv::relative_accuracy = 0.01;
+double const statistics::priv::gamma = (1 + relative_accuracy) / (1 - relative_accuracy);
+double const statistics::priv::log_gamma = std::log(gamma);
+size_t const statistics::priv::max_bins = 2048;
+
 statistics
-::statistics(data_points_t const& pts)
-  : d(new priv)
+::statistics(data_points_t const& pts, bool keep_data)
+  : d(new priv(keep_data))
 {
   add_points(pts);
 }
@@ -86,16 +112,116 @@ void
 statistics
 ::add_point(data_point_t pt)
 {
-  d->acc(pt);
-  d->data.push_back(pt);
+  // NaN is not ordered, so it has no place in the quantiles and would poison
+  // the moments.
+  if (is_nan(pt))
+  {
+    return;
+  }
+
+  d->add_moments(1, pt, pt, pt, pt, 0);
+  d->add_to_bins(pt);
+  d->collapse_bins();
+
+  if (d->keep_data)
+  {
+    d->data.push_back(pt);
+  }
 }
 
 void
 statistics
 ::add_points(data_points_t const& pts)
 {
-  d->acc = std::for_each(pts.begin(), pts.end(), d->acc);
-  d->data.insert(d->data.end(), pts.begin(), pts.begin());
+  size_t const n = pts.size();
+
+  if (!n)
+  {
+    return;
+  }
+
+  if (std::find_if(pts.begin(), pts.end(), is_nan) != pts.end())
+  {
+    data_points_t kept;
+
+    kept.reserve(n);
+    std::remove_copy_if(pts.begin(), pts.end(), std::back_inserter(kept), is_nan);
+
+    add_points(kept);
+
+    return;
+  }
+
+  // The moments of the batch are computed in simple loops which the compiler
+  // may vectorize and then merged in all at once.
+  data_point_t const* const values = &pts[0];
+  data_point_t n_sum = 0;
+  data_point_t n_min = values[0];
+  data_point_t n_max = values[0];
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    n_sum += values[i];
+    n_min = std::min(n_min, values[i]);
+    n_max = std::max(n_max, values[i]);
+  }
+
+  double const n_mean = n_sum / n;
+  double n_m2 = 0;
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    double const diff = values[i] - n_mean;
+
+    n_m2 += diff * diff;
+  }
+
+  d->add_moments(n, n_sum, n_min, n_max, n_mean, n_m2);
+
+  BOOST_FOREACH (data_point_t const& pt, pts)
+  {
+    d->add_to_bins(pt);
+  }
+
+  d->collapse_bins();
+
+  if (d->keep_data)
+  {
+    d->data.insert(d->data.end(), pts.begin(), pts.end());
+  }
+}
+
+void
+statistics
+::merge(statistics const& other)
+{
+  priv const& o = *other.d;
+
+  if (!o.count)
+  {
+    return;
+  }
+
+  d->add_moments(o.count, o.sum, o.min, o.max, o.mean, o.m2);
+
+  BOOST_FOREACH (priv::bins_t::value_type const& bin, o.positive)
+  {
+    d->positive[bin.first] += bin.second;
+  }
+
+  BOOST_FOREACH (priv::bins_t::value_type const& bin, o.negative)
+  {
+    d->negative[bin.first] += bin.second;
+  }
+
+  d->zeros += o.zeros;
+
+  d->collapse_bins();
+
+  if (d->keep_data)
+  {
+    d->data.insert(d->data.end(), o.data.begin(), o.data.end());
+  }
 }
 
 statistics::data_points_t
@@ -109,28 +235,28 @@ size_t
 statistics
 ::count() const
 {
-  return ba::count(d->acc);
+  return d->count;
 }
 
 statistics::data_point_t
 statistics
 ::sum() const
 {
-  return ba::sum(d->acc);
+  return d->sum;
 }
 
 statistics::data_point_t
 statistics
 ::minimum() const
 {
-  return ba::min(d->acc);
+  return d->min;
 }
 
 statistics::data_point_t
 statistics
 ::maximum() const
 {
-  return ba::max(d->acc);
+  return d->max;
 }
 
 statistics::data_point_t
@@ -144,21 +270,112 @@ double
 statistics
 ::mean() const
 {
-  return ba::mean(d->acc);
+  return d->mean;
 }
 
 double
 statistics
 ::median() const
 {
-  return ba::median(d->acc);
+  return quantile(0.5);
+}
+
+double
+statistics
+::quantile(double q) const
+{
+  count_t total = d->zeros;
+
+  BOOST_FOREACH (priv::bins_t::value_type const& bin, d->positive)
+  {
+    total += bin.second;
+  }
+
+  BOOST_FOREACH (priv::bins_t::value_type const& bin, d->negative)
+  {
+    total += bin.second;
+  }
+
+  if (!total)
+  {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  q = std::min(1.0, std::max(0.0, q));
+
+  // The rank of the sample at the quantile, counting from zero.
+  double const rank = q * (total - 1);
+  count_t seen = 0;
+  double value = d->max;
+
+  // Negative samples come first, largest magnitudes first.
+  for (priv::bins_t::const_reverse_iterator i = d->negative.rbegin(); i != d->negative.rend(); ++i)
+  {
+    seen += i->second;
+
+    if (rank < seen)
+    {
+      value = d->bin_value(true, i->first);
+      break;
+    }
+  }
+
+  if (seen <= rank)
+  {
+    seen += d->zeros;
+
+    if (rank < seen)
+    {
+      value = 0;
+    }
+  }
+
+  if (seen <= rank)
+  {
+    BOOST_FOREACH (priv::bins_t::value_type const& bin, d->positive)
+    {
+      seen += bin.second;
+
+      if (rank < seen)
+      {
+        value = d->bin_value(false, bin.first);
+        break;
+      }
+    }
+  }
+
+  return std::min(double(d->max), std::max(double(d->min), value));
+}
+
+statistics::histogram_t
+statistics
+::histogram() const
+{
+  histogram_t hist;
+
+  for (priv::bins_t::const_reverse_iterator i = d->negative.rbegin(); i != d->negative.rend(); ++i)
+  {
+    hist.push_back(bin_t(-priv::bin_limit(i->first - 1), i->second));
+  }
+
+  if (d->zeros)
+  {
+    hist.push_back(bin_t(0, d->zeros));
+  }
+
+  BOOST_FOREACH (priv::bins_t::value_type const& bin, d->positive)
+  {
+    hist.push_back(bin_t(priv::bin_limit(bin.first), bin.second));
+  }
+
+  return hist;
 }
 
 double
 statistics
 ::variance() const
 {
-  return ba::variance(d->acc);
+  return (d->m2 / d->count);
 }
 
 double
@@ -169,9 +386,18 @@ ::standard_deviation() const
 }
 
 statistics::priv
-::priv()
-  : acc()
+::priv(bool keep_data_)
+  : keep_data(keep_data_)
   , data()
+  , count(0)
+  , sum(0)
+  , min(std::numeric_limits<data_point_t>::max())
+  , max(-std::numeric_limits<data_point_t>::max())
+  , mean(0)
+  , m2(0)
+  , positive()
+  , negative()
+  , zeros(0)
 {
 }
 
@@ -180,4 +406,93 @@ statistics::priv
 {
 }
 
+void
+statistics::priv
+::add_moments(count_t n, data_point_t n_sum, data_point_t n_min, data_point_t n_max, double n_mean, double n_m2)
+{
+  count_t const total = count + n;
+  double const delta = n_mean - mean;
+
+  // Combine the moments of the two sets (Chan et al.).
+  mean += delta * n / total;
+  m2 += n_m2 + delta * delta * count * n / total;
+
+  count = total;
+  sum += n_sum;
+  min = std::min(min, n_min);
+  max = std::max(max, n_max);
+}
+
+void
+statistics::priv
+::add_to_bins(data_point_t pt)
+{
+  data_point_t const magnitude = std::fabs(pt);
+
+  if (magnitude < std::numeric_limits<data_point_t>::min())
+  {
+    ++zeros;
+  }
+  else if (pt < 0)
+  {
+    ++negative[bin_for(magnitude)];
+  }
+  else
+  {
+    ++positive[bin_for(magnitude)];
+  }
+}
+
+void
+statistics::priv
+::collapse_bins()
+{
+  // Keep the memory bounded by folding the bins of the smallest magnitudes
+  // together; the tails of the distribution keep their accuracy.
+  while (max_bins < (positive.size() + negative.size()))
+  {
+    bins_t& bins = (negative.size() < positive.size()) ? positive : negative;
+
+    bins_t::iterator const smallest = bins.begin();
+    bins_t::iterator next = smallest;
+
+    ++next;
+
+    next->second += smallest->second;
+    bins.erase(smallest);
+  }
+}
+
+double
+statistics::priv
+::bin_value(bool negative_bin, int bin) const
+{
+  // The middle of the bin in terms of relative error.
+  double const value = 2 * bin_limit(bin) / (gamma + 1);
+
+  return (negative_bin ? -value : value);
+}
+
+int
+statistics::priv
+::bin_for(data_point_t magnitude)
+{
+  data_point_t const limited = std::min(magnitude, std::numeric_limits<data_point_t>::max());
+
+  return int(std::ceil(std::log(limited) / log_gamma));
+}
+
+statistics::data_point_t
+statistics::priv
+::bin_limit(int bin)
+{
+  return std::pow(gamma, bin);
+}
+
+bool
+is_nan(statistics::data_point_t pt)
+{
+  return boost::math::isnan(pt);
+}
+
 }
@@ -36,6 +36,7 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <utility>
 #include <vector>
 
 /**
@@ -51,6 +52,13 @@ namespace sprokit
  * \class statistics statistics.h <sprokit/scoring/statistics.h>
  *
  * \brief Statistics about a sample set.
+ *
+ * Quantiles are estimated from a histogram with logarithmically sized bins,
+ * so their relative error is bounded and the memory used does not grow with
+ * the number of samples. Instances are not thread-safe; accumulate into one
+ * instance per thread and \ref merge them instead.
+ *
+ * NaN samples are ignored since they have no place in an ordering.
  */
 class SPROKIT_SCORING_EXPORT statistics
 {
@@ -59,13 +67,20 @@ class SPROKIT_SCORING_EXPORT statistics
     typedef double data_point_t;
     /// A collection of samples.
     typedef std::vector<data_point_t> data_points_t;
+    /// The count of samples in a bin.
+    typedef size_t count_t;
+    /// A bin of a histogram: the largest value in the bin and its count.
+    typedef std::pair<data_point_t, count_t> bin_t;
+    /// A histogram of the samples.
+    typedef std::vector<bin_t> histogram_t;
 
     /**
      * \brief Constructor.
      *
      * \param pts The initial data sample.
+     * \param keep_data Whether to keep all of the samples for \ref data.
      */
-    explicit statistics(data_points_t const& pts = data_points_t());
+    explicit statistics(data_points_t const& pts = data_points_t(), bool keep_data = false);
     /**
      * \brief Destructor.
      */
@@ -83,11 +98,19 @@ class SPROKIT_SCORING_EXPORT statistics
      * \param pts The data samples.
      */
     void add_points(data_points_t const& pts);
+    /**
+     * \brief Add the samples from another set to the set.
+     *
+     * \param other The statistics to merge.
+     */
+    void merge(statistics const& other);
 
     /**
      * \brief Query for the raw data.
      *
-     * \returns The collection of all the data samples.
+     * \note The samples are only kept when requested at construction.
+     *
+     * \returns The collection of all the data samples, or an empty collection if they are not kept.
      */
     data_points_t data() const;
 
@@ -133,6 +156,27 @@ class SPROKIT_SCORING_EXPORT statistics
      * \returns The median of the data.
      */
     double median() const;
+    /**
+     * \brief Query for a quantile of the data.
+     *
+     * The estimate is within one percent of the true value as long as the
+     * histogram needs no more than its 2048 bins. For data of one sign, this
+     * holds while the largest and smallest nonzero magnitudes are less than a
+     * factor of about 10^17 apart; data of both signs share the bins. Beyond
+     * that, the bins of the smallest magnitudes are folded together and
+     * quantiles which fall among them lose the bound.
+     *
+     * \param q The quantile to query, between 0 and 1.
+     *
+     * \returns The estimated value of the quantile.
+     */
+    double quantile(double q) const;
+    /**
+     * \brief Query for a histogram of the data.
+     *
+     * \returns The non-empty bins in increasing order.
+     */
+    histogram_t histogram() const;
     /**
      * \brief Query for the variance of the data.
      *
@@ -261,6 +261,8 @@ pipeline_run_options()
 
   desc.add_options()
     ("scheduler,S", boost::program_options::value<sprokit::scheduler_registry::type_t>()->value_name("TYPE"), "scheduler type")
+    ("trace", boost::program_options::value<sprokit::path_t>()->value_name("FILE"), "write a Chrome trace of the run to FILE")
+    ("setup-timings", "print how long each phase of setting up the pipeline took")
   ;
 
   return desc;
@@ -0,0 +1,772 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <sprokit/tools/pipeline_builder.h>
+#include <sprokit/tools/tool_io.h>
+#include <sprokit/tools/tool_main.h>
+#include <sprokit/tools/tool_usage.h>
+
+#include <sprokit/pipeline_util/path.h>
+#include <sprokit/pipeline_util/pipe_bakery.h>
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/modules.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/scheduler.h>
+#include <sprokit/pipeline/scheduler_registry.h>
+#include <sprokit/pipeline/trace.h>
+
+#include <boost/program_options/value_semantic.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Runs a pipeline repeatedly under different schedulers and edge capacities
+// and reports how quickly it moved data through its sinks.
+
+typedef std::vector<sprokit::scheduler_registry::type_t> scheduler_types_t;
+typedef std::vector<size_t> capacities_t;
+
+static sprokit::config::key_t const scheduler_block = sprokit::config::key_t("_scheduler");
+static sprokit::config::key_t const edge_capacity_key = sprokit::config::key_t("_pipeline:_edge:capacity");
+
+class measurement
+{
+  public:
+    measurement();
+    ~measurement();
+
+    uint64_t wall_ns;
+    size_t datums;
+    double cpu_utilization;
+};
+typedef std::vector<measurement> measurements_t;
+
+class bench_result
+{
+  public:
+    bench_result();
+    ~bench_result();
+
+    uint64_t median_wall_ns() const;
+    uint64_t min_wall_ns() const;
+    uint64_t max_wall_ns() const;
+    double datums_per_sec() const;
+    double cpu_utilization() const;
+
+    sprokit::scheduler_registry::type_t scheduler_type;
+    // Empty when the capacities given in the pipeline are used.
+    std::string capacity;
+    sprokit::process::names_t sinks;
+    measurements_t measurements;
+    // The peak of the process which ran only this configuration.
+    long peak_rss_kb;
+};
+typedef std::vector<bench_result> bench_results_t;
+
+static boost::program_options::options_description pipe_bench_options();
+static bench_result run_isolated(sprokit::pipe_blocks const& blocks, sprokit::scheduler_registry::type_t const& scheduler_type,
+                                 boost::program_options::variables_map const& vm);
+static bench_result run_benchmark(sprokit::pipe_blocks const& blocks, sprokit::scheduler_registry::type_t const& scheduler_type,
+                                  boost::program_options::variables_map const& vm);
+static sprokit::process::names_t find_sinks(sprokit::pipeline_t const& pipe, boost::program_options::variables_map const& vm);
+static size_t count_sink_data(sprokit::pipeline_t const& pipe, sprokit::process::names_t const& sinks);
+static uint64_t cpu_time_ns();
+static std::string encode_result(bench_result const& result);
+static bench_result decode_result(std::string const& str);
+static void write_all(int fd, std::string const& str);
+static void write_table(std::ostream& ostr, bench_results_t const& results);
+static void write_json(std::ostream& ostr, bench_results_t const& results, boost::program_options::variables_map const& vm);
+static std::string json_string(std::string const& str);
+
+int
+sprokit_tool_main(int argc, char const* argv[])
+{
+  sprokit::load_known_modules();
+
+  boost::program_options::options_description desc;
+  desc
+    .add(sprokit::tool_common_options())
+    .add(sprokit::pipeline_common_options())
+    .add(sprokit::pipeline_input_options())
+    .add(pipe_bench_options());
+
+  boost::program_options::variables_map const vm = sprokit::tool_parse(argc, argv, desc, "");
+
+  if (!vm.count("pipeline"))
+  {
+    std::cerr << "Error: The \'pipeline\' option is required" << std::endl;
+
+    sprokit::tool_usage(EXIT_FAILURE, desc);
+  }
+
+  if (!vm["iterations"].as<size_t>())
+  {
+    std::cerr << "Error: At least one iteration must be measured" << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  scheduler_types_t scheduler_types;
+
+  if (vm.count("scheduler"))
+  {
+    scheduler_types = vm["scheduler"].as<scheduler_types_t>();
+  }
+  else
+  {
+    scheduler_types.push_back(sprokit::scheduler_registry::default_type);
+  }
+
+  capacities_t capacities;
+
+  if (vm.count("capacity"))
+  {
+    capacities = vm["capacity"].as<capacities_t>();
+  }
+
+  bench_results_t results;
+
+  BOOST_FOREACH (sprokit::scheduler_registry::type_t const& scheduler_type, scheduler_types)
+  {
+    if (capacities.empty())
+    {
+      sprokit::pipeline_builder const builder(vm, desc);
+
+      results.push_back(run_isolated(builder.blocks(), scheduler_type, vm));
+
+      continue;
+    }
+
+    BOOST_FOREACH (size_t const capacity, capacities)
+    {
+      std::string const capacity_str = boost::lexical_cast<std::string>(capacity);
+
+      // Edges are created when the pipeline is baked, so each capacity needs
+      // its own pipeline.
+      sprokit::pipeline_builder builder(vm, desc);
+
+      builder.add_setting(edge_capacity_key + "=" + capacity_str);
+
+      bench_result result = run_isolated(builder.blocks(), scheduler_type, vm);
+
+      result.capacity = capacity_str;
+
+      results.push_back(result);
+    }
+  }
+
+  write_table(std::cout, results);
+
+  if (vm.count("json"))
+  {
+    sprokit::path_t const opath = vm["json"].as<sprokit::path_t>();
+
+    sprokit::ostream_t const ostr = sprokit::open_ostream(opath);
+
+    write_json(*ostr, results, vm);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+boost::program_options::options_description
+pipe_bench_options()
+{
+  boost::program_options::options_description desc("Benchmark options");
+
+  desc.add_options()
+    ("scheduler,S", boost::program_options::value<scheduler_types_t>()->value_name("TYPE"), "scheduler type to measure (may be repeated)")
+    ("capacity", boost::program_options::value<capacities_t>()->value_name("COUNT"), "edge capacity to measure (may be repeated)")
+    ("warmup,w", boost::program_options::value<size_t>()->value_name("COUNT")->default_value(1), "the number of runs to discard before measuring")
+    ("iterations,k", boost::program_options::value<size_t>()->value_name("COUNT")->default_value(5), "the number of runs to measure")
+    ("sink", boost::program_options::value<sprokit::process::names_t>()->value_name("NAME"), "a process whose input is counted (may be repeated; defaults to processes without outputs)")
+    ("json", boost::program_options::value<sprokit::path_t>()->value_name("FILE"), "also write the results as JSON to FILE")
+  ;
+
+  return desc;
+}
+
+bench_result
+run_isolated(sprokit::pipe_blocks const& blocks, sprokit::scheduler_registry::type_t const& scheduler_type,
+             boost::program_options::variables_map const& vm)
+{
+  // The peak resident set size of a process only ever grows, so each
+  // configuration runs in its own process to get a peak of its own.
+  int fds[2];
+
+  if (pipe(fds) < 0)
+  {
+    throw std::runtime_error("Unable to create a pipe for the benchmark");
+  }
+
+  std::cout.flush();
+  std::cerr.flush();
+
+  pid_t const pid = fork();
+
+  if (pid < 0)
+  {
+    close(fds[0]);
+    close(fds[1]);
+
+    throw std::runtime_error("Unable to start a process for the benchmark");
+  }
+
+  if (!pid)
+  {
+    close(fds[0]);
+
+    int ret = EXIT_SUCCESS;
+
+    try
+    {
+      write_all(fds[1], encode_result(run_benchmark(blocks, scheduler_type, vm)));
+    }
+    catch (std::exception const& e)
+    {
+      std::cerr << "Error: " << e.what() << std::endl;
+
+      ret = EXIT_FAILURE;
+    }
+
+    // Skip the destructors and exit handlers which belong to the parent.
+    _exit(ret);
+  }
+
+  close(fds[1]);
+
+  std::string output;
+  char buf[4096];
+
+  while (true)
+  {
+    ssize_t const nread = read(fds[0], buf, sizeof(buf));
+
+    if (nread < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      break;
+    }
+
+    if (!nread)
+    {
+      break;
+    }
+
+    output.append(buf, nread);
+  }
+
+  close(fds[0]);
+
+  int status;
+  rusage usage;
+
+  while (wait4(pid, &status, 0, &usage) < 0)
+  {
+    if (errno != EINTR)
+    {
+      throw std::runtime_error("Unable to wait for the benchmark process");
+    }
+  }
+
+  if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+  {
+    throw std::runtime_error("The benchmark using the \'" + scheduler_type + "\' scheduler failed");
+  }
+
+  bench_result result = decode_result(output);
+
+  result.scheduler_type = scheduler_type;
+
+  // Linux reports kilobytes.
+  result.peak_rss_kb = usage.ru_maxrss;
+
+  return result;
+}
+
+bench_result
+run_benchmark(sprokit::pipe_blocks const& blocks, sprokit::scheduler_registry::type_t const& scheduler_type,
+              boost::program_options::variables_map const& vm)
+{
+  sprokit::pipeline_t const pipe = sprokit::bake_pipe_blocks(blocks);
+  sprokit::config_t const conf = sprokit::extract_configuration(blocks);
+
+  if (!pipe)
+  {
+    throw std::runtime_error("Unable to bake pipeline");
+  }
+
+  sprokit::config_t const scheduler_config = conf->subblock(scheduler_block + sprokit::config::block_sep + scheduler_type);
+  sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+  size_t const warmup = vm["warmup"].as<size_t>();
+  size_t const iterations = vm["iterations"].as<size_t>();
+
+  bench_result result;
+
+  result.scheduler_type = scheduler_type;
+
+  for (size_t i = 0; i < (warmup + iterations); ++i)
+  {
+    // Reuse the pipeline rather than baking it again for every run.
+    if (i)
+    {
+      pipe->reset();
+    }
+
+    pipe->setup_pipeline();
+
+    if (!i)
+    {
+      result.sinks = find_sinks(pipe, vm);
+    }
+
+    sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipe, scheduler_config);
+
+    uint64_t const cpu_start = cpu_time_ns();
+    sprokit::trace::timestamp_t const start = sprokit::trace::now();
+
+    scheduler->start();
+    scheduler->wait();
+
+    sprokit::trace::timestamp_t const end = sprokit::trace::now();
+    uint64_t const cpu_end = cpu_time_ns();
+
+    if (i < warmup)
+    {
+      continue;
+    }
+
+    measurement m;
+
+    m.wall_ns = end - start;
+    m.datums = count_sink_data(pipe, result.sinks);
+    m.cpu_utilization = (m.wall_ns ? (double(cpu_end - cpu_start) / m.wall_ns) : 0.0);
+
+    result.measurements.push_back(m);
+  }
+
+  return result;
+}
+
+sprokit::process::names_t
+find_sinks(sprokit::pipeline_t const& pipe, boost::program_options::variables_map const& vm)
+{
+  sprokit::process::names_t const names = pipe->process_names();
+
+  if (vm.count("sink"))
+  {
+    sprokit::process::names_t const sinks = vm["sink"].as<sprokit::process::names_t>();
+
+    BOOST_FOREACH (sprokit::process::name_t const& sink, sinks)
+    {
+      if (std::find(names.begin(), names.end(), sink) == names.end())
+      {
+        throw std::runtime_error("The sink \'" + sink + "\' is not a process in the pipeline");
+      }
+    }
+
+    return sinks;
+  }
+
+  sprokit::process::names_t sinks;
+
+  BOOST_FOREACH (sprokit::process::name_t const& name, names)
+  {
+    if (pipe->output_edges_for_process(name).empty())
+    {
+      sinks.push_back(name);
+    }
+  }
+
+  return sinks;
+}
+
+size_t
+count_sink_data(sprokit::pipeline_t const& pipe, sprokit::process::names_t const& sinks)
+{
+  size_t count = 0;
+
+  BOOST_FOREACH (sprokit::process::name_t const& sink, sinks)
+  {
+    sprokit::edges_t const edges = pipe->input_edges_for_process(sink);
+
+    // Data dropped by the edge never reach the sink.
+    BOOST_FOREACH (sprokit::edge_t const& e, edges)
+    {
+      count += e->popped_count();
+    }
+  }
+
+  return count;
+}
+
+uint64_t
+cpu_time_ns()
+{
+  rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+
+  uint64_t const user_ns = uint64_t(usage.ru_utime.tv_sec) * 1000000000 + uint64_t(usage.ru_utime.tv_usec) * 1000;
+  uint64_t const sys_ns = uint64_t(usage.ru_stime.tv_sec) * 1000000000 + uint64_t(usage.ru_stime.tv_usec) * 1000;
+
+  return (user_ns + sys_ns);
+}
+
+std::string
+encode_result(bench_result const& result)
+{
+  std::ostringstream sstr;
+
+  sstr << std::setprecision(17);
+
+  // Process names do not contain whitespace.
+  BOOST_FOREACH (sprokit::process::name_t const& sink, result.sinks)
+  {
+    sstr << "sink " << sink << "\n";
+  }
+
+  BOOST_FOREACH (measurement const& m, result.measurements)
+  {
+    sstr << "run " << m.wall_ns << " " << m.datums << " " << m.cpu_utilization << "\n";
+  }
+
+  return sstr.str();
+}
+
+bench_result
+decode_result(std::string const& str)
+{
+  bench_result result;
+
+  std::istringstream sstr(str);
+  std::string kind;
+
+  while (sstr >> kind)
+  {
+    if (kind == "sink")
+    {
+      sprokit::process::name_t sink;
+
+      sstr >> sink;
+
+      result.sinks.push_back(sink);
+    }
+    else if (kind == "run")
+    {
+      measurement m;
+
+      sstr >> m.wall_ns >> m.datums >> m.cpu_utilization;
+
+      result.measurements.push_back(m);
+    }
+    else
+    {
+      break;
+    }
+
+    if (!sstr)
+    {
+      break;
+    }
+  }
+
+  if (result.measurements.empty())
+  {
+    throw std::runtime_error("The benchmark process did not report any runs");
+  }
+
+  return result;
+}
+
+void
+write_all(int fd, std::string const& str)
+{
+  char const* data = str.data();
+  size_t left = str.size();
+
+  while (left)
+  {
+    ssize_t const written = write(fd, data, left);
+
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      throw std::runtime_error("Unable to report the benchmark results");
+    }
+
+    data += written;
+    left -= written;
+  }
+}
+
+void
+write_table(std::ostream& ostr, bench_results_t const& results)
+{
+  ostr << std::left
+       << std::setw(24) << "scheduler"
+       << std::setw(10) << "capacity"
+       << std::right
+       << std::setw(12) << "median_ms"
+       << std::setw(12) << "min_ms"
+       << std::setw(12) << "max_ms"
+       << std::setw(14) << "datums/s"
+       << std::setw(8) << "cpu"
+       << std::setw(14) << "peak_rss_kb"
+       << std::endl;
+
+  BOOST_FOREACH (bench_result const& result, results)
+  {
+    ostr << std::left
+         << std::setw(24) << result.scheduler_type
+         << std::setw(10) << (result.capacity.empty() ? std::string("-") : result.capacity)
+         << std::right << std::fixed << std::setprecision(3)
+         << std::setw(12) << (result.median_wall_ns() / 1e6)
+         << std::setw(12) << (result.min_wall_ns() / 1e6)
+         << std::setw(12) << (result.max_wall_ns() / 1e6)
+         << std::setprecision(0)
+         << std::setw(14) << result.datums_per_sec()
+         << std::setprecision(2)
+         << std::setw(8) << result.cpu_utilization()
+         << std::setw(14) << result.peak_rss_kb
+         << std::endl;
+  }
+}
+
+void
+write_json(std::ostream& ostr, bench_results_t const& results, boost::program_options::variables_map const& vm)
+{
+  sprokit::path_t const pipe_path = vm["pipeline"].as<sprokit::path_t>();
+
+  ostr << "{\"pipeline\": " << json_string(pipe_path.string<std::string>())
+       << ", \"warmup\": " << vm["warmup"].as<size_t>()
+       << ", \"iterations\": " << vm["iterations"].as<size_t>()
+       << ", \"results\": [";
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    bench_result const& result = results[i];
+
+    ostr << (i ? ", " : "")
+         << "{\"scheduler\": " << json_string(result.scheduler_type)
+         << ", \"capacity\": " << (result.capacity.empty() ? std::string("null") : result.capacity)
+         << ", \"sinks\": [";
+
+    for (size_t j = 0; j < result.sinks.size(); ++j)
+    {
+      ostr << (j ? ", " : "") << json_string(result.sinks[j]);
+    }
+
+    ostr << "], \"runs\": [";
+
+    for (size_t j = 0; j < result.measurements.size(); ++j)
+    {
+      measurement const& m = result.measurements[j];
+
+      ostr << (j ? ", " : "")
+           << "{\"wall_ns\": " << m.wall_ns
+           << ", \"datums\": " << m.datums
+           << ", \"cpu_utilization\": " << m.cpu_utilization
+           << "}";
+    }
+
+    ostr << "], \"median_wall_ns\": " << result.median_wall_ns()
+         << ", \"datums_per_sec\": " << result.datums_per_sec()
+         << ", \"cpu_utilization\": " << result.cpu_utilization()
+         << ", \"peak_rss_kb\": " << result.peak_rss_kb
+         << "}";
+  }
+
+  ostr << "]}" << std::endl;
+}
+
+std::string
+json_string(std::string const& str)
+{
+  std::string escaped = "\"";
+
+  BOOST_FOREACH (char const ch, str)
+  {
+    switch (ch)
+    {
+      case '\"':
+        escaped += "\\\"";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      case '\t':
+        escaped += "\\t";
+        break;
+      default:
+        escaped += ch;
+        break;
+    }
+  }
+
+  escaped += "\"";
+
+  return escaped;
+}
+
+measurement
+::measurement()
+  : wall_ns(0)
+  , datums(0)
+  , cpu_utilization(0.0)
+{
+}
+
+measurement
+::~measurement()
+{
+}
+
+bench_result
+::bench_result()
+  : scheduler_type()
+  , capacity()
+  , sinks()
+  , measurements()
+  , peak_rss_kb(0)
+{
+}
+
+bench_result
+::~bench_result()
+{
+}
+
+uint64_t
+bench_result
+::median_wall_ns() const
+{
+  std::vector<uint64_t> walls;
+
+  BOOST_FOREACH (measurement const& m, measurements)
+  {
+    walls.push_back(m.wall_ns);
+  }
+
+  std::sort(walls.begin(), walls.end());
+
+  return walls[walls.size() / 2];
+}
+
+uint64_t
+bench_result
+::min_wall_ns() const
+{
+  uint64_t wall = measurements[0].wall_ns;
+
+  BOOST_FOREACH (measurement const& m, measurements)
+  {
+    wall = std::min(wall, m.wall_ns);
+  }
+
+  return wall;
+}
+
+uint64_t
+bench_result
+::max_wall_ns() const
+{
+  uint64_t wall = measurements[0].wall_ns;
+
+  BOOST_FOREACH (measurement const& m, measurements)
+  {
+    wall = std::max(wall, m.wall_ns);
+  }
+
+  return wall;
+}
+
+double
+bench_result
+::datums_per_sec() const
+{
+  uint64_t wall_ns = 0;
+  size_t datums = 0;
+
+  BOOST_FOREACH (measurement const& m, measurements)
+  {
+    wall_ns += m.wall_ns;
+    datums += m.datums;
+  }
+
+  return (wall_ns ? (datums * 1e9 / wall_ns) : 0.0);
+}
+
+double
+bench_result
+::cpu_utilization() const
+{
+  double total = 0.0;
+
+  BOOST_FOREACH (measurement const& m, measurements)
+  {
+    total += m.cpu_utilization;
+  }
+
+  return (total / measurements.size());
+}
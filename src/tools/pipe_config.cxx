@@ -210,6 +210,11 @@ ::operator () (sprokit::process_pipe_block const& process_block)
   m_ostr << "process " << name << std::endl;
   m_ostr << "  :: " << type << std::endl;
 
+  if (process_block.node)
+  {
+    m_ostr << "  @ " << *process_block.node << std::endl;
+  }
+
   key_printer const printer(m_ostr);
 
   std::for_each(values.begin(), values.end(), printer);
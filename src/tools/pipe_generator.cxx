@@ -0,0 +1,388 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <sprokit/tools/pipeline_builder.h>
+#include <sprokit/tools/tool_io.h>
+#include <sprokit/tools/tool_main.h>
+#include <sprokit/tools/tool_usage.h>
+
+#include <sprokit/pipeline_util/path.h>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options/value_semantic.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdlib>
+
+// Generates synthetic pipelines for measuring how setup scales with the size
+// and shape of the graph.
+
+typedef std::string port_addr_t;
+typedef std::vector<port_addr_t> port_addrs_t;
+
+class generator
+{
+  public:
+    generator(std::ostream& ostr_, size_t cluster_depth_);
+    ~generator();
+
+    port_addr_t source();
+    port_addr_t node(port_addrs_t const& inputs);
+    void sink(port_addrs_t const& inputs);
+
+    size_t count;
+  private:
+    std::string next_name(std::string const& prefix);
+    void connect(port_addr_t const& from, std::string const& to);
+
+    std::ostream& ostr;
+    size_t const cluster_depth;
+    size_t index;
+};
+
+static bool write_clusters(sprokit::path_t const& dir, size_t depth);
+static boost::program_options::options_description pipe_generator_options();
+
+int
+sprokit_tool_main(int argc, char const* argv[])
+{
+  boost::program_options::options_description desc;
+  desc
+    .add(sprokit::tool_common_options())
+    .add(pipe_generator_options())
+    .add(sprokit::pipeline_output_options());
+
+  boost::program_options::variables_map const vm = sprokit::tool_parse(argc, argv, desc, "");
+
+  size_t const processes = vm["processes"].as<size_t>();
+  size_t const width = vm["width"].as<size_t>();
+  size_t const fan_in = vm["fan-in"].as<size_t>();
+  size_t const fan_out = vm["fan-out"].as<size_t>();
+  size_t const cluster_depth = vm["cluster-depth"].as<size_t>();
+
+  if (!width || !fan_in || !fan_out)
+  {
+    std::cerr << "Error: The width, fan-in, and fan-out must be positive" << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  if (cluster_depth)
+  {
+    sprokit::path_t const cluster_dir = vm["cluster-dir"].as<sprokit::path_t>();
+
+    if (!write_clusters(cluster_dir, cluster_depth))
+    {
+      std::cerr << "Error: Failed to write the cluster files to " << cluster_dir << std::endl;
+
+      return EXIT_FAILURE;
+    }
+  }
+
+  sprokit::path_t const opath = vm["output"].as<sprokit::path_t>();
+
+  sprokit::ostream_t const ostr = sprokit::open_ostream(opath);
+
+  generator gen(*ostr, cluster_depth);
+
+  port_addrs_t layer;
+  port_addrs_t terminals;
+  std::vector<bool> consumed;
+
+  for (size_t i = 0; i < width; ++i)
+  {
+    layer.push_back(gen.source());
+  }
+
+  consumed.resize(layer.size(), false);
+
+  while (gen.count < processes)
+  {
+    size_t const prev_width = layer.size();
+    // Round up so that every node in the previous layer has a consumer.
+    size_t const next_width = (prev_width * fan_out + fan_in - 1) / fan_in;
+
+    port_addrs_t next_layer;
+
+    for (size_t j = 0; (j < next_width) && (gen.count < processes); ++j)
+    {
+      size_t const first = (j * prev_width) / next_width;
+      port_addrs_t inputs;
+
+      for (size_t k = 0; k < fan_in; ++k)
+      {
+        size_t const idx = (first + k) % prev_width;
+
+        inputs.push_back(layer[idx]);
+        consumed[idx] = true;
+      }
+
+      next_layer.push_back(gen.node(inputs));
+    }
+
+    // Outputs left over from a partial layer still need to be sunk.
+    for (size_t i = 0; i < prev_width; ++i)
+    {
+      if (!consumed[i])
+      {
+        terminals.push_back(layer[i]);
+      }
+    }
+
+    layer.swap(next_layer);
+    consumed.assign(layer.size(), false);
+  }
+
+  terminals.insert(terminals.end(), layer.begin(), layer.end());
+
+  gen.sink(terminals);
+
+  return EXIT_SUCCESS;
+}
+
+boost::program_options::options_description
+pipe_generator_options()
+{
+  boost::program_options::options_description desc("Generator options");
+
+  desc.add_options()
+    ("processes,n", boost::program_options::value<size_t>()->value_name("COUNT")->default_value(100), "the number of processes to place between the sources and the sinks")
+    ("width,w", boost::program_options::value<size_t>()->value_name("COUNT")->default_value(4), "the number of sources")
+    ("fan-in,i", boost::program_options::value<size_t>()->value_name("COUNT")->default_value(1), "the number of upstream processes feeding each node")
+    ("fan-out,f", boost::program_options::value<size_t>()->value_name("COUNT")->default_value(1), "the number of downstream processes fed by each node")
+    ("cluster-depth,d", boost::program_options::value<size_t>()->value_name("DEPTH")->default_value(0), "how deeply to nest each node within clusters")
+    ("cluster-dir,C", boost::program_options::value<sprokit::path_t>()->value_name("DIR")->default_value("."), "where to write the cluster files (add it to SPROKIT_CLUSTER_PATH)")
+  ;
+
+  return desc;
+}
+
+static std::string pass_cluster_name(size_t depth);
+static std::string mult_cluster_name(size_t depth);
+
+bool
+write_clusters(sprokit::path_t const& dir, size_t depth)
+{
+  boost::system::error_code ec;
+
+  boost::filesystem::create_directories(dir, ec);
+
+  for (size_t d = 1; d <= depth; ++d)
+  {
+    bool const innermost = (d == 1);
+
+    {
+      std::string const name = pass_cluster_name(d);
+      sprokit::path_t const path = dir / (name + ".cluster");
+      boost::filesystem::ofstream fout(path);
+
+      fout << "cluster " << name << std::endl;
+      fout << "  :# A generated pass-through cluster." << std::endl;
+      fout << "  :# The input." << std::endl;
+      fout << "  imap from input" << std::endl;
+      fout << "       to   inner." << (innermost ? "pass" : "input") << std::endl;
+      fout << "  :# The output." << std::endl;
+      fout << "  omap from inner." << (innermost ? "pass" : "output") << std::endl;
+      fout << "       to   output" << std::endl;
+      fout << std::endl;
+      fout << "process inner" << std::endl;
+      fout << "  :: " << (innermost ? std::string("pass") : pass_cluster_name(d - 1)) << std::endl;
+
+      if (!fout.good())
+      {
+        return false;
+      }
+    }
+
+    {
+      std::string const name = mult_cluster_name(d);
+      sprokit::path_t const path = dir / (name + ".cluster");
+      boost::filesystem::ofstream fout(path);
+
+      fout << "cluster " << name << std::endl;
+      fout << "  :# A generated multiplication cluster." << std::endl;
+      fout << "  :# The left operand." << std::endl;
+      fout << "  imap from left" << std::endl;
+      fout << "       to   inner." << (innermost ? "factor1" : "left") << std::endl;
+      fout << "  :# The right operand." << std::endl;
+      fout << "  imap from right" << std::endl;
+      fout << "       to   inner." << (innermost ? "factor2" : "right") << std::endl;
+      fout << "  :# The product." << std::endl;
+      fout << "  omap from inner." << (innermost ? "product" : "output") << std::endl;
+      fout << "       to   output" << std::endl;
+      fout << std::endl;
+      fout << "process inner" << std::endl;
+      fout << "  :: " << (innermost ? std::string("multiplication") : mult_cluster_name(d - 1)) << std::endl;
+
+      if (!fout.good())
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+std::string
+pass_cluster_name(size_t depth)
+{
+  return "gen_pass_" + boost::lexical_cast<std::string>(depth);
+}
+
+std::string
+mult_cluster_name(size_t depth)
+{
+  return "gen_mult_" + boost::lexical_cast<std::string>(depth);
+}
+
+generator
+::generator(std::ostream& ostr_, size_t cluster_depth_)
+  : count(0)
+  , ostr(ostr_)
+  , cluster_depth(cluster_depth_)
+  , index(0)
+{
+}
+
+generator
+::~generator()
+{
+}
+
+port_addr_t
+generator
+::source()
+{
+  std::string const name = next_name("source");
+
+  ostr << "process " << name << std::endl;
+  ostr << "  :: numbers" << std::endl;
+  ostr << std::endl;
+
+  return name + ".number";
+}
+
+port_addr_t
+generator
+::node(port_addrs_t const& inputs)
+{
+  // Nodes with multiple inputs are built from a chain of multiplications.
+  if (inputs.size() == 1)
+  {
+    std::string const name = next_name("pass");
+    bool const clustered = (0 < cluster_depth);
+
+    ostr << "process " << name << std::endl;
+    ostr << "  :: " << (clustered ? pass_cluster_name(cluster_depth) : std::string("pass")) << std::endl;
+    ostr << std::endl;
+
+    connect(inputs[0], name + (clustered ? ".input" : ".pass"));
+
+    ++count;
+
+    return name + (clustered ? ".output" : ".pass");
+  }
+
+  port_addr_t output = inputs[0];
+
+  for (size_t i = 1; i < inputs.size(); ++i)
+  {
+    std::string const name = next_name("mult");
+    bool const clustered = (0 < cluster_depth);
+
+    ostr << "process " << name << std::endl;
+    ostr << "  :: " << (clustered ? mult_cluster_name(cluster_depth) : std::string("multiplication")) << std::endl;
+    ostr << std::endl;
+
+    connect(output, name + (clustered ? ".left" : ".factor1"));
+    connect(inputs[i], name + (clustered ? ".right" : ".factor2"));
+
+    ++count;
+
+    output = name + (clustered ? ".output" : ".product");
+  }
+
+  return output;
+}
+
+void
+generator
+::sink(port_addrs_t const& inputs)
+{
+  // Join every output into a single sink so that independent columns still
+  // form one connected pipeline.
+  port_addr_t input = inputs[0];
+
+  for (size_t i = 1; i < inputs.size(); ++i)
+  {
+    std::string const name = next_name("join");
+
+    ostr << "process " << name << std::endl;
+    ostr << "  :: multiplication" << std::endl;
+    ostr << std::endl;
+
+    connect(input, name + ".factor1");
+    connect(inputs[i], name + ".factor2");
+
+    input = name + ".product";
+  }
+
+  std::string const name = next_name("sink");
+
+  ostr << "process " << name << std::endl;
+  ostr << "  :: sink" << std::endl;
+  ostr << std::endl;
+
+  connect(input, name + ".sink");
+}
+
+std::string
+generator
+::next_name(std::string const& prefix)
+{
+  return prefix + boost::lexical_cast<std::string>(index++);
+}
+
+void
+generator
+::connect(port_addr_t const& from, std::string const& to)
+{
+  ostr << "connect from " << from << std::endl;
+  ostr << "        to   " << to << std::endl;
+  ostr << std::endl;
+}
@@ -29,24 +29,72 @@
  */
 
 #include <sprokit/tools/pipeline_builder.h>
+#include <sprokit/tools/tool_io.h>
 #include <sprokit/tools/tool_main.h>
 #include <sprokit/tools/tool_usage.h>
 
 #include <sprokit/pipeline_util/path.h>
+#include <sprokit/pipeline_util/pipe_bakery.h>
+#include <sprokit/pipeline_util/pipe_declaration_types.h>
 
 #include <sprokit/pipeline/config.h>
 #include <sprokit/pipeline/modules.h>
 #include <sprokit/pipeline/scheduler.h>
 #include <sprokit/pipeline/scheduler_registry.h>
 #include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/process_cluster.h>
+#include <sprokit/pipeline/stamp.h>
+#include <sprokit/pipeline/trace.h>
 
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/value_semantic.hpp>
 #include <boost/program_options/variables_map.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+#include <exception>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
 
+#include <cerrno>
 #include <cstdlib>
+#include <cstring>
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 static sprokit::config::key_t const scheduler_block = sprokit::config::key_t("_scheduler");
+static std::string const quit_command = std::string("quit");
+
+static boost::program_options::options_description partition_options();
+static boost::program_options::options_description server_options();
+static sprokit::scheduler_t create_scheduler(sprokit::pipeline_t const& pipe, sprokit::config_t const& conf,
+                                             boost::program_options::variables_map const& vm);
+static int run_pipeline(sprokit::pipeline_builder const& builder, boost::program_options::variables_map const& vm,
+                        std::string const& trace_suffix);
+static int run_partitions(boost::program_options::variables_map const& vm);
+static int run_server(sprokit::pipeline_builder const& builder, boost::program_options::variables_map const& vm);
+static sprokit::config_t tunable_values(sprokit::pipeline_t const& pipe, sprokit::config_t const& conf);
+static void add_tunable_values(sprokit::config_t const& tunables, sprokit::process_t const& proc,
+                               sprokit::config_t const& conf);
+static std::string run_job(sprokit::pipeline_t const& pipe, sprokit::config_t const& conf,
+                           sprokit::config_t const& tunables, boost::program_options::variables_map const& vm,
+                           std::string const& job);
+static bool read_line(int fd, std::string& buffer, std::string& line);
+static void setup_pipeline(sprokit::pipeline_t const& pipe, boost::program_options::variables_map const& vm);
+static void print_setup_timings(sprokit::pipeline_t const& pipe);
+static bool write_all(int fd, std::string const& str);
 
 int
 sprokit_tool_main(int argc, char const* argv[])
@@ -58,24 +106,64 @@ sprokit_tool_main(int argc, char const* argv[])
     .add(sprokit::tool_common_options())
     .add(sprokit::pipeline_common_options())
     .add(sprokit::pipeline_input_options())
-    .add(sprokit::pipeline_run_options());
+    .add(sprokit::pipeline_run_options())
+    .add(partition_options())
+    .add(server_options());
 
   boost::program_options::variables_map const vm = sprokit::tool_parse(argc, argv, desc, "");
 
-  sprokit::pipeline_builder const builder(vm, desc);
+  if (vm.count("partition"))
+  {
+    if (vm.count("pipeline"))
+    {
+      std::cerr << "Error: The pipeline and partition options are exclusive" << std::endl;
 
-  sprokit::pipeline_t const pipe = builder.pipeline();
-  sprokit::config_t const conf = builder.config();
+      return EXIT_FAILURE;
+    }
 
-  if (!pipe)
-  {
-    std::cerr << "Error: Unable to bake pipeline" << std::endl;
+    return run_partitions(vm);
+  }
 
-    return EXIT_FAILURE;
+  sprokit::pipeline_builder const builder(vm, desc);
+
+  if (vm.count("server"))
+  {
+    return run_server(builder, vm);
   }
 
-  pipe->setup_pipeline();
+  return run_pipeline(builder, vm, std::string());
+}
+
+boost::program_options::options_description
+partition_options()
+{
+  boost::program_options::options_description desc("Partition options");
 
+  desc.add_options()
+    ("partition,P", boost::program_options::value<sprokit::paths_t>()->value_name("FILE"), "run FILE as a partition in its own process (may be repeated)")
+    ("node,N", boost::program_options::value<sprokit::node_t>()->value_name("NAME"), "run only the processes assigned to the NAME node")
+  ;
+
+  return desc;
+}
+
+boost::program_options::options_description
+server_options()
+{
+  boost::program_options::options_description desc("Server options");
+
+  desc.add_options()
+    ("server", "keep the pipeline set up and run jobs read from standard input, one per line")
+    ("socket", boost::program_options::value<sprokit::path_t>()->value_name("PATH"), "with --server, read jobs from connections to a Unix socket at PATH instead")
+  ;
+
+  return desc;
+}
+
+sprokit::scheduler_t
+create_scheduler(sprokit::pipeline_t const& pipe, sprokit::config_t const& conf,
+                 boost::program_options::variables_map const& vm)
+{
   sprokit::scheduler_registry::type_t scheduler_type = sprokit::scheduler_registry::default_type;
 
   if (vm.count("scheduler"))
@@ -87,7 +175,48 @@ sprokit_tool_main(int argc, char const* argv[])
 
   sprokit::scheduler_registry_t reg = sprokit::scheduler_registry::self();
 
-  sprokit::scheduler_t scheduler = reg->create_scheduler(scheduler_type, pipe, scheduler_config);
+  return reg->create_scheduler(scheduler_type, pipe, scheduler_config);
+}
+
+int
+run_pipeline(sprokit::pipeline_builder const& builder, boost::program_options::variables_map const& vm,
+             std::string const& trace_suffix)
+{
+  sprokit::pipe_blocks blocks = builder.blocks();
+
+  if (vm.count("node"))
+  {
+    sprokit::node_t const node = vm["node"].as<sprokit::node_t>();
+
+    blocks = sprokit::partition_pipe_blocks(blocks, node);
+  }
+
+  sprokit::pipeline_t const pipe = sprokit::bake_pipe_blocks(blocks);
+  sprokit::config_t const conf = sprokit::extract_configuration(blocks);
+
+  if (!pipe)
+  {
+    std::cerr << "Error: Unable to bake pipeline" << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  sprokit::ostream_t trace_ostr;
+
+  if (vm.count("trace"))
+  {
+    sprokit::path_t trace_path = vm["trace"].as<sprokit::path_t>();
+
+    trace_path += trace_suffix;
+
+    trace_ostr = sprokit::open_ostream(trace_path);
+
+    sprokit::trace::enable();
+  }
+
+  setup_pipeline(pipe, vm);
+
+  sprokit::scheduler_t const scheduler = create_scheduler(pipe, conf, vm);
 
   if (!scheduler)
   {
@@ -99,5 +228,441 @@ sprokit_tool_main(int argc, char const* argv[])
   scheduler->start();
   scheduler->wait();
 
+  if (trace_ostr)
+  {
+    sprokit::trace::disable();
+    sprokit::trace::write_chrome_trace(*trace_ostr);
+  }
+
   return EXIT_SUCCESS;
 }
+
+int
+run_partitions(boost::program_options::variables_map const& vm)
+{
+  sprokit::paths_t const partitions = vm["partition"].as<sprokit::paths_t>();
+
+  std::vector<pid_t> children;
+
+  // Each partition gets its own process so that a failure in one does not
+  // take the others down with it. Partitions talk to each other through
+  // transport processes (e.g., shm_input and shm_output).
+  for (size_t i = 0; i < partitions.size(); ++i)
+  {
+    pid_t const pid = fork();
+
+    if (pid < 0)
+    {
+      std::cerr << "Error: Unable to start a process for the partition "
+                   "\'" << partitions[i] << "\'" << std::endl;
+
+      std::for_each(children.begin(), children.end(), boost::bind(&kill, _1, SIGTERM));
+
+      return EXIT_FAILURE;
+    }
+
+    if (!pid)
+    {
+      sprokit::pipeline_builder builder;
+
+      {
+        sprokit::istream_t const istr = sprokit::open_istream(partitions[i]);
+
+        builder.load_pipeline(*istr);
+      }
+
+      builder.load_from_options(vm);
+
+      std::string const trace_suffix = "." + boost::lexical_cast<std::string>(i);
+
+      return run_pipeline(builder, vm, trace_suffix);
+    }
+
+    children.push_back(pid);
+  }
+
+  int ret = EXIT_SUCCESS;
+
+  while (!children.empty())
+  {
+    int status;
+
+    pid_t const pid = wait(&status);
+
+    if (pid < 0)
+    {
+      break;
+    }
+
+    children.erase(std::remove(children.begin(), children.end(), pid), children.end());
+
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+    {
+      if (ret == EXIT_SUCCESS)
+      {
+        std::cerr << "Error: A partition failed; stopping the others" << std::endl;
+
+        // The other partitions would block on a peer which is gone.
+        std::for_each(children.begin(), children.end(), boost::bind(&kill, _1, SIGTERM));
+      }
+
+      ret = EXIT_FAILURE;
+    }
+  }
+
+  return ret;
+}
+
+int
+run_server(sprokit::pipeline_builder const& builder, boost::program_options::variables_map const& vm)
+{
+  sprokit::pipe_blocks const blocks = builder.blocks();
+
+  sprokit::pipeline_t const pipe = sprokit::bake_pipe_blocks(blocks);
+  sprokit::config_t const conf = sprokit::extract_configuration(blocks);
+
+  if (!pipe)
+  {
+    std::cerr << "Error: Unable to bake pipeline" << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  // Set the pipeline up once so that problems with it are found before any
+  // jobs are accepted.
+  setup_pipeline(pipe, vm);
+
+  // Each job starts from the tunable values the pipeline was set up with.
+  sprokit::config_t const tunables = tunable_values(pipe, conf);
+
+  if (!vm.count("socket"))
+  {
+    std::string line;
+
+    while (std::getline(std::cin, line) && (line != quit_command))
+    {
+      std::cout << run_job(pipe, conf, tunables, vm, line) << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  sprokit::path_t const socket_path = vm["socket"].as<sprokit::path_t>();
+  std::string const socket_str = socket_path.string<std::string>();
+
+  sockaddr_un addr;
+
+  if (sizeof(addr.sun_path) <= socket_str.size())
+  {
+    std::cerr << "Error: The socket path is too long: " << socket_str << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_str.c_str(), sizeof(addr.sun_path) - 1);
+
+  int const listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+  if (listen_fd < 0)
+  {
+    std::cerr << "Error: Unable to create a socket: " << strerror(errno) << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  unlink(addr.sun_path);
+
+  if ((bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) ||
+      (listen(listen_fd, SOMAXCONN) < 0))
+  {
+    std::cerr << "Error: Unable to listen on the socket " << socket_str << ": " << strerror(errno) << std::endl;
+
+    close(listen_fd);
+
+    return EXIT_FAILURE;
+  }
+
+  bool quit = false;
+
+  // Jobs share the one pipeline, so connections are served one at a time.
+  while (!quit)
+  {
+    int const fd = accept(listen_fd, NULL, NULL);
+
+    if (fd < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      std::cerr << "Error: Unable to accept a connection: " << strerror(errno) << std::endl;
+
+      break;
+    }
+
+    std::string buffer;
+    std::string line;
+
+    while (read_line(fd, buffer, line))
+    {
+      if (line == quit_command)
+      {
+        quit = true;
+
+        break;
+      }
+
+      if (!write_all(fd, run_job(pipe, conf, tunables, vm, line) + "\n"))
+      {
+        break;
+      }
+    }
+
+    close(fd);
+  }
+
+  close(listen_fd);
+  unlink(addr.sun_path);
+
+  return (quit ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+sprokit::config_t
+tunable_values(sprokit::pipeline_t const& pipe, sprokit::config_t const& conf)
+{
+  sprokit::config_t const tunables = sprokit::config::empty_config();
+
+  sprokit::process::names_t const process_names = pipe->process_names();
+  sprokit::process::names_t const cluster_names = pipe->cluster_names();
+
+  BOOST_FOREACH (sprokit::process::name_t const& name, process_names)
+  {
+    // Only top-level processes are reconfigured by the pipeline.
+    if (pipe->parent_cluster(name).empty())
+    {
+      add_tunable_values(tunables, pipe->process_by_name(name), conf);
+    }
+  }
+
+  BOOST_FOREACH (sprokit::process::name_t const& name, cluster_names)
+  {
+    if (pipe->parent_cluster(name).empty())
+    {
+      add_tunable_values(tunables, pipe->cluster_by_name(name), conf);
+    }
+  }
+
+  return tunables;
+}
+
+void
+add_tunable_values(sprokit::config_t const& tunables, sprokit::process_t const& proc, sprokit::config_t const& conf)
+{
+  sprokit::process::name_t const name = proc->name();
+  sprokit::config_t const proc_conf = conf->subblock_view(name);
+  sprokit::config::keys_t const keys = proc->available_tunable_config();
+
+  BOOST_FOREACH (sprokit::config::key_t const& key, keys)
+  {
+    // Values not given in the pipeline fall back to the process' default.
+    sprokit::config::value_t const value = (proc_conf->has_value(key) ?
+      proc_conf->get_value<sprokit::config::value_t>(key) :
+      proc->config_info(key)->def);
+
+    tunables->set_value(name + sprokit::config::block_sep + key, value);
+  }
+}
+
+std::string
+run_job(sprokit::pipeline_t const& pipe, sprokit::config_t const& conf,
+        sprokit::config_t const& tunables, boost::program_options::variables_map const& vm,
+        std::string const& job)
+{
+  static size_t job_count = 0;
+
+  std::string const job_id = boost::lexical_cast<std::string>(job_count++);
+
+  try
+  {
+    // A job is a set of settings in the same form as the --setting option.
+    std::vector<std::string> settings;
+
+    boost::split(settings, job, boost::is_space(), boost::token_compress_on);
+
+    // Settings from earlier jobs are undone by starting from the original
+    // tunable values.
+    sprokit::config_t const overrides = sprokit::config::empty_config();
+
+    overrides->merge_config(tunables);
+
+    BOOST_FOREACH (std::string const& setting, settings)
+    {
+      if (setting.empty())
+      {
+        continue;
+      }
+
+      size_t const split_pos = setting.find('=');
+
+      if (split_pos == std::string::npos)
+      {
+        return "error " + job_id + " The setting \'" + setting + "\' does not contain a \'=\'";
+      }
+
+      overrides->set_value(setting.substr(0, split_pos), setting.substr(split_pos + 1));
+    }
+
+    sprokit::stamp::origin_t const start = sprokit::stamp::now();
+
+    // Only tunable values are changed. The processes read them again when the
+    // pipeline is set up.
+    pipe->reconfigure(overrides);
+    pipe->reset();
+    pipe->setup_pipeline();
+
+    sprokit::stamp::origin_t const setup_done = sprokit::stamp::now();
+
+    sprokit::scheduler_t const scheduler = create_scheduler(pipe, conf, vm);
+
+    if (!scheduler)
+    {
+      return "error " + job_id + " Unable to create scheduler";
+    }
+
+    scheduler->start();
+    scheduler->wait();
+
+    sprokit::stamp::origin_t const run_done = sprokit::stamp::now();
+
+    std::ostringstream sstr;
+
+    sstr << "ok " << job_id
+         << " setup_ns=" << (setup_done - start)
+         << " run_ns=" << (run_done - setup_done);
+
+    return sstr.str();
+  }
+  catch (std::exception const& e)
+  {
+    std::string reason = e.what();
+
+    // Keep the reply on one line.
+    std::replace(reason.begin(), reason.end(), '\n', ' ');
+
+    return "error " + job_id + " " + reason;
+  }
+}
+
+bool
+read_line(int fd, std::string& buffer, std::string& line)
+{
+  while (true)
+  {
+    size_t const pos = buffer.find('\n');
+
+    if (pos != std::string::npos)
+    {
+      line = buffer.substr(0, pos);
+      buffer.erase(0, pos + 1);
+
+      return true;
+    }
+
+    char chunk[4096];
+
+    ssize_t const count = read(fd, chunk, sizeof(chunk));
+
+    if (count < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      return false;
+    }
+
+    if (!count)
+    {
+      return false;
+    }
+
+    buffer.append(chunk, count);
+  }
+}
+
+bool
+write_all(int fd, std::string const& str)
+{
+  size_t written = 0;
+
+  while (written < str.size())
+  {
+    // A client which has gone away must not kill the server with SIGPIPE.
+    ssize_t const count = send(fd, str.data() + written, str.size() - written, MSG_NOSIGNAL);
+
+    if (count < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      return false;
+    }
+
+    written += count;
+  }
+
+  return true;
+}
+
+void
+setup_pipeline(sprokit::pipeline_t const& pipe, boost::program_options::variables_map const& vm)
+{
+  if (!vm.count("setup-timings"))
+  {
+    pipe->setup_pipeline();
+
+    return;
+  }
+
+  try
+  {
+    pipe->setup_pipeline();
+  }
+  catch (...)
+  {
+    // The timings are most interesting when the setup fails.
+    if (pipe->is_setup())
+    {
+      print_setup_timings(pipe);
+    }
+
+    throw;
+  }
+
+  print_setup_timings(pipe);
+}
+
+void
+print_setup_timings(sprokit::pipeline_t const& pipe)
+{
+  sprokit::pipeline::setup_timings_t const timings = pipe->setup_timings();
+  sprokit::pipeline::setup_duration_t total = 0;
+
+  // Written to stderr so that it does not mix with server replies.
+  std::cerr << "# phase ns" << std::endl;
+
+  BOOST_FOREACH (sprokit::pipeline::setup_timing_t const& timing, timings)
+  {
+    std::cerr << timing.first << " " << timing.second << std::endl;
+
+    total += timing.second;
+  }
+
+  std::cerr << "total " << total << std::endl;
+}
@@ -0,0 +1,256 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <test_common.h>
+
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/datum_codec.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/record.h>
+#include <sprokit/pipeline/stamp.h>
+
+#include <boost/make_shared.hpp>
+
+#include <string>
+
+#include <cstring>
+
+#define TEST_ARGS ()
+
+DECLARE_TEST_MAP();
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(1);
+
+  testname_t const testname = argv[1];
+
+  RUN_TEST(testname);
+}
+
+static sprokit::edge_datum_t round_trip(sprokit::process::port_type_t const& type, sprokit::edge_datum_t const& edat);
+
+IMPLEMENT_TEST(integer)
+{
+  sprokit::process::port_type_t const type = sprokit::process::port_type_t("integer");
+  int const value = -12345;
+
+  sprokit::stamp_t const st = sprokit::stamp::new_stamp(2);
+  sprokit::edge_datum_t const edat(sprokit::datum::new_datum(value), sprokit::stamp::incremented_stamp(st));
+
+  sprokit::edge_datum_t const out = round_trip(type, edat);
+
+  if (out.datum->type() != sprokit::datum::data)
+  {
+    TEST_ERROR("The datum type was not kept");
+  }
+
+  if (out.datum->get_datum<int>() != value)
+  {
+    TEST_ERROR("The value was not kept");
+  }
+
+  if (*out.stamp != *edat.stamp)
+  {
+    TEST_ERROR("The stamp was not kept");
+  }
+
+  if (out.stamp->increment() != edat.stamp->increment())
+  {
+    TEST_ERROR("The stamp increment was not kept");
+  }
+}
+
+IMPLEMENT_TEST(string)
+{
+  sprokit::process::port_type_t const type = sprokit::process::port_type_t("string");
+  std::string const value = std::string("a\0b", 3);
+
+  sprokit::edge_datum_t const edat(sprokit::datum::new_datum(value), sprokit::stamp::new_stamp(1));
+
+  sprokit::edge_datum_t const out = round_trip(type, edat);
+
+  if (out.datum->get_datum<std::string>() != value)
+  {
+    TEST_ERROR("The value was not kept");
+  }
+}
+
+IMPLEMENT_TEST(record)
+{
+  sprokit::process::port_type_t const type = sprokit::process::port_type_t("record");
+  boost::shared_ptr<std::string const> const buffer = boost::make_shared<std::string>(std::string("xa\0by", 5));
+
+  // The record refers to the middle of a buffer it does not own.
+  sprokit::record const rec(buffer->data() + 1, 3, buffer);
+
+  sprokit::edge_datum_t const edat(sprokit::datum::new_datum(rec), sprokit::stamp::new_stamp(1));
+
+  sprokit::edge_datum_t const out = round_trip(type, edat);
+
+  if (out.datum->get_datum<sprokit::record>().bytes() != std::string("a\0b", 3))
+  {
+    TEST_ERROR("The bytes were not kept");
+  }
+}
+
+IMPLEMENT_TEST(origin)
+{
+  sprokit::process::port_type_t const type = sprokit::process::port_type_t("integer");
+  sprokit::stamp::origin_t const origin = sprokit::stamp::origin_t(1234567890);
+
+  sprokit::stamp_t const st = sprokit::stamp::origin_stamp(sprokit::stamp::new_stamp(1), origin);
+  sprokit::edge_datum_t const edat(sprokit::datum::new_datum(1), st);
+
+  sprokit::edge_datum_t const out = round_trip(type, edat);
+
+  if (!out.stamp->has_origin())
+  {
+    TEST_ERROR("The origin was lost");
+  }
+  else if (out.stamp->origin() != origin)
+  {
+    TEST_ERROR("The origin was not kept");
+  }
+}
+
+IMPLEMENT_TEST(stream)
+{
+  sprokit::process::port_type_t const type = sprokit::process::port_type_t("integer");
+  sprokit::stamp::stream_t const stream = sprokit::stamp::stream_t(42);
+
+  sprokit::stamp_t const st = sprokit::stamp::stream_stamp(sprokit::stamp::new_stamp(1), stream);
+  sprokit::edge_datum_t const edat(sprokit::datum::new_datum(1), st);
+
+  sprokit::edge_datum_t const out = round_trip(type, edat);
+
+  if (out.stamp->stream() != stream)
+  {
+    TEST_ERROR("The stream was not kept");
+  }
+  else if (*out.stamp != *st)
+  {
+    TEST_ERROR("The stamp was not kept");
+  }
+}
+
+IMPLEMENT_TEST(special_datums)
+{
+  // Special datums do not need a codec for the type.
+  sprokit::process::port_type_t const type = sprokit::process::port_type_t("_no_codec");
+  sprokit::stamp_t const st = sprokit::stamp::new_stamp(1);
+
+  sprokit::edge_datum_t const complete = round_trip(type, sprokit::edge_datum_t(sprokit::datum::complete_datum(), st));
+
+  if (complete.datum->type() != sprokit::datum::complete)
+  {
+    TEST_ERROR("A complete datum was not kept");
+  }
+
+  std::string const message = "an error";
+
+  sprokit::edge_datum_t const error = round_trip(type, sprokit::edge_datum_t(sprokit::datum::error_datum(message), st));
+
+  if (error.datum->type() != sprokit::datum::error)
+  {
+    TEST_ERROR("An error datum was not kept");
+  }
+
+  if (error.datum->get_error() != message)
+  {
+    TEST_ERROR("The error message was not kept");
+  }
+}
+
+IMPLEMENT_TEST(pod_codec)
+{
+  sprokit::process::port_type_t const type = sprokit::process::port_type_t("_test_double");
+  double const value = 3.25;
+
+  sprokit::datum_codec::register_pod_codec<double>(type);
+
+  if (!sprokit::datum_codec::has_codec(type))
+  {
+    TEST_ERROR("A registered codec is not available");
+  }
+
+  sprokit::edge_datum_t const edat(sprokit::datum::new_datum(value), sprokit::stamp::new_stamp(1));
+
+  sprokit::edge_datum_t const out = round_trip(type, edat);
+
+  double const out_value = out.datum->get_datum<double>();
+
+  // The codec copies bytes, so the bits must match exactly.
+  if (memcmp(&out_value, &value, sizeof(double)))
+  {
+    TEST_ERROR("The value was not kept");
+  }
+}
+
+IMPLEMENT_TEST(no_codec)
+{
+  sprokit::process::port_type_t const type = sprokit::process::port_type_t("_no_codec");
+
+  sprokit::edge_datum_t const edat(sprokit::datum::new_datum(1), sprokit::stamp::new_stamp(1));
+
+  EXPECT_EXCEPTION(sprokit::no_datum_codec_exception,
+                   sprokit::datum_codec::encode(type, edat),
+                   "encoding data without a codec");
+}
+
+IMPLEMENT_TEST(truncated)
+{
+  sprokit::process::port_type_t const type = sprokit::process::port_type_t("integer");
+
+  sprokit::edge_datum_t const edat(sprokit::datum::new_datum(1), sprokit::stamp::new_stamp(1));
+
+  sprokit::datum_codec::bytes_t bytes = sprokit::datum_codec::encode(type, edat);
+
+  bytes.resize(bytes.size() - 1);
+
+  EXPECT_EXCEPTION(sprokit::datum_decode_exception,
+                   sprokit::datum_codec::decode(type, bytes),
+                   "decoding truncated data");
+
+  bytes.resize(4);
+
+  EXPECT_EXCEPTION(sprokit::datum_decode_exception,
+                   sprokit::datum_codec::decode(type, bytes),
+                   "decoding a truncated header");
+}
+
+sprokit::edge_datum_t
+round_trip(sprokit::process::port_type_t const& type, sprokit::edge_datum_t const& edat)
+{
+  sprokit::datum_codec::bytes_t const bytes = sprokit::datum_codec::encode(type, edat);
+
+  return sprokit::datum_codec::decode(type, bytes);
+}
@@ -158,6 +158,67 @@ IMPLEMENT_TEST(push_datum)
   }
 }
 
+IMPLEMENT_TEST(pushed_count)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat = sprokit::datum::new_datum(0);
+  sprokit::datum_t const complete_dat = sprokit::datum::complete_datum();
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp));
+  edge->push_datum(sprokit::edge_datum_t(complete_dat, stamp));
+
+  edge->pop_datum();
+
+  if (edge->pushed_count() != 2)
+  {
+    TEST_ERROR("An edge did not count the data pushed into it");
+  }
+}
+
+IMPLEMENT_TEST(popped_count)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_capacity, "2");
+  config->set_value(sprokit::edge::config_policy, "drop_oldest");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::datum_t const dat = sprokit::datum::new_datum(0);
+  sprokit::datum_t const complete_dat = sprokit::datum::complete_datum();
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp));
+
+  edge->get_datum();
+  edge->pop_datum();
+
+  edge->push_datum(sprokit::edge_datum_t(complete_dat, stamp));
+
+  edge->pop_datum();
+
+  if (edge->pushed_count() != 3)
+  {
+    TEST_ERROR("An edge did not count the data pushed into it");
+  }
+
+  if (edge->popped_count() != 2)
+  {
+    TEST_ERROR("An edge counted data dropped by its policy as popped");
+  }
+}
+
 IMPLEMENT_TEST(peek_datum)
 {
   sprokit::config_t const config = sprokit::config::empty_config();
@@ -487,3 +548,558 @@ push_datum(sprokit::edge_t edge, sprokit::edge_datum_t edat)
     TEST_ERROR("A datum was pushed into a full edge");
   }
 }
+
+class counting_observer
+  : public sprokit::edge_observer
+{
+  public:
+    counting_observer();
+    ~counting_observer();
+
+    void notify(sprokit::edge const& e, event_t event);
+
+    size_t data_count;
+    size_t space_count;
+};
+
+IMPLEMENT_TEST(observers)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::config::value_t const value_capacity = boost::lexical_cast<sprokit::config::value_t>(2);
+
+  config->set_value(sprokit::edge::config_capacity, value_capacity);
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  counting_observer observer;
+
+  edge->add_observer(&observer);
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  sprokit::edge_datum_t const edat = sprokit::edge_datum_t(dat, stamp);
+
+  edge->push_datum(edat);
+
+  if (observer.data_count != 1)
+  {
+    TEST_ERROR("The observer was not notified when "
+               "data was pushed into an empty edge");
+  }
+
+  edge->push_datum(edat);
+
+  if (observer.data_count != 1)
+  {
+    TEST_ERROR("The observer was notified when "
+               "data was pushed into a non-empty edge");
+  }
+
+  edge->pop_datum();
+
+  if (observer.space_count != 1)
+  {
+    TEST_ERROR("The observer was not notified when "
+               "data was removed from a full edge");
+  }
+
+  edge->get_datum();
+
+  if (observer.space_count != 1)
+  {
+    TEST_ERROR("The observer was notified when "
+               "data was removed from a non-full edge");
+  }
+
+  edge->remove_observer(&observer);
+
+  edge->push_datum(edat);
+
+  if (observer.data_count != 1)
+  {
+    TEST_ERROR("The observer was notified after being removed");
+  }
+}
+
+IMPLEMENT_TEST(get_data)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+  sprokit::stamp_t const stamp3 = sprokit::stamp::incremented_stamp(stamp2);
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp1));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp2));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp3));
+
+  sprokit::edge_data_t const data = edge->get_data(2);
+
+  if (data.size() != 2)
+  {
+    TEST_ERROR("Getting several data from an edge did not return them all");
+  }
+  else if ((*data[0].stamp != *stamp1) ||
+           (*data[1].stamp != *stamp2))
+  {
+    TEST_ERROR("Getting several data from an edge returned them out of order");
+  }
+
+  if (edge->datum_count() != 1)
+  {
+    TEST_ERROR("Getting several data from an edge did not remove them");
+  }
+}
+
+IMPLEMENT_TEST(invalid_policy)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_policy, "unknown");
+
+  EXPECT_EXCEPTION(sprokit::invalid_edge_policy_exception,
+                   boost::make_shared<sprokit::edge>(config),
+                   "when passing an unknown policy to an edge");
+}
+
+IMPLEMENT_TEST(policy_drop_oldest)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_capacity, "2");
+  config->set_value(sprokit::edge::config_policy, "drop_oldest");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+  sprokit::stamp_t const stamp3 = sprokit::stamp::incremented_stamp(stamp2);
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp1));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp2));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp3));
+
+  if (edge->datum_count() != 2)
+  {
+    TEST_ERROR("A dropping edge grew beyond its capacity");
+  }
+
+  if (edge->dropped_count() != 1)
+  {
+    TEST_ERROR("A dropping edge did not count a dropped datum");
+  }
+
+  sprokit::edge_datum_t const edat = edge->get_datum();
+
+  if (*edat.stamp != *stamp2)
+  {
+    TEST_ERROR("An edge dropping the oldest datum did not drop the oldest datum");
+  }
+}
+
+IMPLEMENT_TEST(policy_drop_newest)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_capacity, "2");
+  config->set_value(sprokit::edge::config_policy, "drop_newest");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+  sprokit::stamp_t const stamp3 = sprokit::stamp::incremented_stamp(stamp2);
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp1));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp2));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp3));
+
+  if (edge->dropped_count() != 1)
+  {
+    TEST_ERROR("A dropping edge did not count a dropped datum");
+  }
+
+  edge->pop_datum();
+
+  sprokit::edge_datum_t const edat = edge->get_datum();
+
+  if (*edat.stamp != *stamp2)
+  {
+    TEST_ERROR("An edge dropping the newest datum did not drop the newest datum");
+  }
+}
+
+IMPLEMENT_TEST(policy_latest_only)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_policy, "latest_only");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::datum_t const flush_dat = sprokit::datum::flush_datum();
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+  sprokit::stamp_t const stamp3 = sprokit::stamp::incremented_stamp(stamp2);
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp1));
+  edge->push_datum(sprokit::edge_datum_t(flush_dat, stamp2));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp3));
+
+  if (edge->datum_count() != 2)
+  {
+    TEST_ERROR("An edge keeping the latest datum kept the wrong number of data");
+  }
+
+  if (edge->dropped_count() != 1)
+  {
+    TEST_ERROR("An edge keeping the latest datum did not count a dropped datum");
+  }
+
+  sprokit::edge_datum_t const edat = edge->get_datum();
+
+  if (edat.datum->type() != sprokit::datum::flush)
+  {
+    TEST_ERROR("An edge keeping the latest datum dropped a flush datum");
+  }
+}
+
+IMPLEMENT_TEST(policy_drop_oldest_peeked)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_capacity, "2");
+  config->set_value(sprokit::edge::config_policy, "drop_oldest");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+  sprokit::stamp_t const stamp3 = sprokit::stamp::incremented_stamp(stamp2);
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp1));
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp2));
+
+  sprokit::edge_datum_t const peeked = edge->peek_datum();
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp3));
+
+  if (edge->dropped_count() != 1)
+  {
+    TEST_ERROR("A dropping edge did not count a dropped datum");
+  }
+
+  sprokit::edge_datum_t const edat = edge->get_datum();
+
+  if (!(edat == peeked))
+  {
+    TEST_ERROR("An edge dropping the oldest datum dropped a datum which was peeked at");
+  }
+
+  sprokit::edge_datum_t const next = edge->get_datum();
+
+  if (*next.stamp != *stamp3)
+  {
+    TEST_ERROR("An edge dropping the oldest datum did not drop the oldest unpeeked datum");
+  }
+}
+
+IMPLEMENT_TEST(policy_latest_only_peeked)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_policy, "latest_only");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t const stamp1 = sprokit::stamp::new_stamp(inc);
+  sprokit::stamp_t const stamp2 = sprokit::stamp::incremented_stamp(stamp1);
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp1));
+
+  sprokit::edge_datum_t const peeked = edge->peek_datum();
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp2));
+
+  if (edge->datum_count() != 2)
+  {
+    TEST_ERROR("An edge keeping the latest datum dropped a datum which was peeked at");
+  }
+
+  sprokit::edge_datum_t const edat = edge->get_datum();
+
+  if (!(edat == peeked))
+  {
+    TEST_ERROR("An edge keeping the latest datum did not give the peeked datum first");
+  }
+
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp1));
+
+  if (edge->dropped_count() != 1)
+  {
+    TEST_ERROR("An edge keeping the latest datum kept a datum after the peeked one was taken");
+  }
+}
+
+IMPLEMENT_TEST(spill)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_spill_after, "2");
+  config->set_value(sprokit::edge::config_type, "integer");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t stamp = sprokit::stamp::new_stamp(inc);
+
+  // Enough data to go through the disk and not only the write buffer.
+  int32_t const count = 20000;
+  int32_t expect = 0;
+
+  for (int32_t i = 0; i < count; ++i)
+  {
+    edge->push_datum(sprokit::edge_datum_t(sprokit::datum::new_datum(i), stamp));
+    stamp = sprokit::stamp::incremented_stamp(stamp);
+
+    // Drain some data while pushing so that reads and writes interleave.
+    if ((i % 3) == 0)
+    {
+      sprokit::edge_datum_t const edat = edge->get_datum();
+
+      if (edat.datum->get_datum<int32_t>() != expect++)
+      {
+        TEST_ERROR("A spilling edge returned data out of order");
+      }
+    }
+  }
+
+  edge->push_datum(sprokit::edge_datum_t(sprokit::datum::complete_datum(), stamp));
+
+  if (edge->datum_count() != size_t(count - expect + 1))
+  {
+    TEST_ERROR("A spilling edge did not count the data it holds");
+  }
+
+  if (!edge->spilled_count())
+  {
+    TEST_ERROR("An edge did not spill data beyond its threshold");
+  }
+
+  if (edge->peek_datum(3).datum->get_datum<int32_t>() != (expect + 3))
+  {
+    TEST_ERROR("A spilling edge peeked at the wrong datum");
+  }
+
+  for (; expect < count; ++expect)
+  {
+    sprokit::edge_datum_t const edat = edge->get_datum();
+
+    if (edat.datum->get_datum<int32_t>() != expect)
+    {
+      TEST_ERROR("A spilling edge returned data out of order");
+
+      break;
+    }
+  }
+
+  if (edge->get_datum().datum->type() != sprokit::datum::complete)
+  {
+    TEST_ERROR("A spilling edge did not keep a complete datum");
+  }
+
+  if (edge->datum_count() || edge->spilled_count())
+  {
+    TEST_ERROR("A drained spilling edge still holds data");
+  }
+}
+
+IMPLEMENT_TEST(spill_steady_backlog)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_spill_after, "2");
+  config->set_value(sprokit::edge::config_type, "integer");
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t stamp = sprokit::stamp::new_stamp(inc);
+
+  // An edge which never drains has its spill file compacted several times
+  // along the way; the data must come through it unchanged.
+  int32_t const backlog = 5000;
+  int32_t const count = 200000;
+  int32_t expect = 0;
+
+  for (int32_t i = 0; i < count; ++i)
+  {
+    edge->push_datum(sprokit::edge_datum_t(sprokit::datum::new_datum(i), stamp));
+    stamp = sprokit::stamp::incremented_stamp(stamp);
+
+    if (i < backlog)
+    {
+      continue;
+    }
+
+    sprokit::edge_datum_t const edat = edge->get_datum();
+
+    if (edat.datum->get_datum<int32_t>() != expect++)
+    {
+      TEST_ERROR("A spilling edge returned data out of order");
+
+      return;
+    }
+  }
+
+  if (edge->datum_count() != size_t(backlog))
+  {
+    TEST_ERROR("A spilling edge did not count the data it holds");
+  }
+
+  for (; expect < count; ++expect)
+  {
+    sprokit::edge_datum_t const edat = edge->get_datum();
+
+    if (edat.datum->get_datum<int32_t>() != expect)
+    {
+      TEST_ERROR("A spilling edge returned data out of order");
+
+      break;
+    }
+  }
+
+  if (edge->datum_count() || edge->spilled_count())
+  {
+    TEST_ERROR("A drained spilling edge still holds data");
+  }
+}
+
+IMPLEMENT_TEST(spill_dropping_policy)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_spill_after, "2");
+  config->set_value(sprokit::edge::config_type, "integer");
+  config->set_value(sprokit::edge::config_capacity, "4");
+  config->set_value(sprokit::edge::config_policy, "drop_oldest");
+
+  EXPECT_EXCEPTION(sprokit::edge_spill_exception,
+                   boost::make_shared<sprokit::edge>(config),
+                   "creating a spilling edge which drops data");
+}
+
+IMPLEMENT_TEST(spill_no_codec)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value(sprokit::edge::config_spill_after, "2");
+  config->set_value(sprokit::edge::config_type, "no_such_type");
+
+  EXPECT_EXCEPTION(sprokit::edge_spill_exception,
+                   boost::make_shared<sprokit::edge>(config),
+                   "creating a spilling edge for a type without a codec");
+}
+
+IMPLEMENT_TEST(unsynchronized)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  if (!edge->is_synchronized())
+  {
+    TEST_ERROR("A new edge is not synchronized");
+  }
+
+  edge->set_synchronized(false);
+
+  if (edge->is_synchronized())
+  {
+    TEST_ERROR("An edge did not become unsynchronized");
+  }
+
+  sprokit::datum_t const dat = sprokit::datum::empty_datum();
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  sprokit::edge_datum_t const edat = sprokit::edge_datum_t(dat, stamp);
+
+  edge->push_datum(edat);
+
+  if (!edge->has_data())
+  {
+    TEST_ERROR("An unsynchronized edge does not have data after a push");
+  }
+
+  sprokit::edge_datum_t const get_edat = edge->get_datum();
+
+  if (*get_edat.stamp != *stamp)
+  {
+    TEST_ERROR("An unsynchronized edge modified a stamp");
+  }
+
+  if (edge->datum_count())
+  {
+    TEST_ERROR("An unsynchronized edge did not remove a datum on a get");
+  }
+}
+
+IMPLEMENT_TEST(unsynchronized_wait)
+{
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  sprokit::edge_t const edge = boost::make_shared<sprokit::edge>(config);
+
+  edge->set_synchronized(false);
+
+  EXPECT_EXCEPTION(sprokit::unsynchronized_edge_wait_exception,
+                   edge->get_datum(),
+                   "getting data from an empty unsynchronized edge");
+}
+
+counting_observer
+::counting_observer()
+  : data_count(0)
+  , space_count(0)
+{
+}
+
+counting_observer
+::~counting_observer()
+{
+}
+
+void
+counting_observer
+::notify(sprokit::edge const& /*e*/, event_t event)
+{
+  switch (event)
+  {
+    case data_available:
+      ++data_count;
+      break;
+    case space_available:
+      ++space_count;
+      break;
+    default:
+      break;
+  }
+}
@@ -0,0 +1,226 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <test_common.h>
+
+#include <sprokit/pipeline/log.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define TEST_ARGS ()
+
+DECLARE_TEST_MAP();
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(1);
+
+  testname_t const testname = argv[1];
+
+  RUN_TEST(testname);
+}
+
+class message_t
+{
+  public:
+    sprokit::logger::level_t level;
+    sprokit::logger::subsystem_t subsystem;
+    std::string msg;
+};
+typedef std::vector<message_t> messages_t;
+
+static messages_t messages;
+
+static void capture(sprokit::logger::level_t level, sprokit::logger::subsystem_t const& subsystem, std::string const& msg);
+static bool was_logged(std::string const& msg);
+static void log_many(sprokit::logger const* log, size_t count);
+
+IMPLEMENT_TEST(levels)
+{
+  sprokit::logger::set_handler(capture);
+  sprokit::logger::configure("info");
+
+  sprokit::logger const log("test");
+
+  SPROKIT_LOG_DEBUG(log, "debug message");
+  SPROKIT_LOG_INFO(log, "info message " << 1);
+  SPROKIT_LOG_ERROR(log, "error message");
+
+  sprokit::logger::flush();
+
+  if (was_logged("debug message"))
+  {
+    TEST_ERROR("A message below the level was written");
+  }
+
+  if (!was_logged("info message 1"))
+  {
+    TEST_ERROR("A message at the level was not written");
+  }
+
+  if (!was_logged("error message"))
+  {
+    TEST_ERROR("A message above the level was not written");
+  }
+
+  if (messages.size() == 2)
+  {
+    if ((messages[0].level != sprokit::logger::level_info) ||
+        (messages[0].subsystem != "test"))
+    {
+      TEST_ERROR("A message was written with the wrong level or subsystem");
+    }
+  }
+  else
+  {
+    TEST_ERROR("Unexpected messages were written");
+  }
+}
+
+IMPLEMENT_TEST(subsystem_levels)
+{
+  sprokit::logger::set_handler(capture);
+
+  sprokit::logger const quiet("quiet");
+  sprokit::logger const loud("loud");
+
+  // Existing loggers pick up new levels.
+  sprokit::logger::configure("error,loud=trace");
+
+  SPROKIT_LOG_WARN(quiet, "quiet message");
+  SPROKIT_LOG_TRACE(loud, "loud message");
+
+  sprokit::logger::flush();
+
+  if (was_logged("quiet message"))
+  {
+    TEST_ERROR("A subsystem did not use the default level");
+  }
+
+#if SPROKIT_LOG_MIN_LEVEL <= 0
+  if (!was_logged("loud message"))
+  {
+    TEST_ERROR("A subsystem did not use its own level");
+  }
+#endif
+}
+
+IMPLEMENT_TEST(disabled_not_formatted)
+{
+  sprokit::logger::configure("off");
+
+  sprokit::logger const log("test");
+
+  size_t formatted = 0;
+
+  SPROKIT_LOG_ERROR(log, "message " << ++formatted);
+
+  if (formatted)
+  {
+    TEST_ERROR("A message was formatted while its logger was disabled");
+  }
+}
+
+IMPLEMENT_TEST(bad_spec)
+{
+  EXPECT_EXCEPTION(std::runtime_error,
+                   sprokit::logger::configure("warn,edge=loud"),
+                   "configuring with an unknown level");
+}
+
+IMPLEMENT_TEST(threads)
+{
+  sprokit::logger::set_handler(capture);
+  sprokit::logger::configure("info");
+
+  sprokit::logger const log("test");
+
+  size_t const num_threads = 4;
+  size_t const count = 500;
+
+  boost::thread_group threads;
+
+  for (size_t i = 0; i < num_threads; ++i)
+  {
+    threads.create_thread(boost::bind(log_many, &log, count));
+  }
+
+  threads.join_all();
+
+  sprokit::logger::flush();
+
+  if (messages.size() != (num_threads * count))
+  {
+    TEST_ERROR("Expected " << (num_threads * count) << " messages, "
+               "but " << messages.size() << " were written");
+  }
+}
+
+void
+capture(sprokit::logger::level_t level, sprokit::logger::subsystem_t const& subsystem, std::string const& msg)
+{
+  message_t message;
+
+  message.level = level;
+  message.subsystem = subsystem;
+  message.msg = msg;
+
+  messages.push_back(message);
+}
+
+bool
+was_logged(std::string const& msg)
+{
+  for (messages_t::const_iterator i = messages.begin(); i != messages.end(); ++i)
+  {
+    if (i->msg == msg)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void
+log_many(sprokit::logger const* log, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    SPROKIT_LOG_INFO(*log, "message " << i);
+  }
+}
@@ -41,6 +41,8 @@
 #include <sprokit/pipeline/scheduler.h>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 
 #define TEST_ARGS ()
@@ -1014,6 +1016,34 @@ IMPLEMENT_TEST(setup_pipeline_untyped_connection)
                    "an untyped connection exists in the pipeline");
 }
 
+IMPLEMENT_TEST(setup_pipeline_untyped_connection_any)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("flow_dependent");
+  sprokit::process::type_t const proc_type2 = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_name = sprokit::process::name_t("up");
+  sprokit::process::name_t const proc_name2 = sprokit::process::name_t("down");
+
+  sprokit::process_t const process = create_process(proc_type, proc_name);
+  sprokit::process_t const process2 = create_process(proc_type2, proc_name2);
+
+  sprokit::pipeline_t const pipeline = create_pipeline();
+
+  pipeline->add_process(process);
+  pipeline->add_process(process2);
+
+  sprokit::process::port_t const port_name = sprokit::process::port_t("output");
+  sprokit::process::port_t const port_name2 = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_name, port_name,
+                    proc_name2, port_name2);
+
+  // A port which accepts any type cannot pin a flow-dependent type.
+  EXPECT_EXCEPTION(sprokit::untyped_connection_exception,
+                   pipeline->setup_pipeline(),
+                   "a flow-dependent port is only connected to a port which accepts any type");
+}
+
 IMPLEMENT_TEST(setup_pipeline_missing_required_input_connection)
 {
   sprokit::process::type_t const proc_type = sprokit::process::type_t("take_string");
@@ -1358,6 +1388,136 @@ IMPLEMENT_TEST(setup_pipeline_frequency_synchronized_fork)
   pipeline->setup_pipeline();
 }
 
+IMPLEMENT_TEST(setup_pipeline_fused_chains)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typep = sprokit::process::type_t("pass");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("duplicate");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namep1 = sprokit::process::name_t("pass1");
+  sprokit::process::name_t const proc_namep2 = sprokit::process::name_t("pass2");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("duplicate");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processp1 = create_process(proc_typep, proc_namep1);
+  sprokit::process_t const processp2 = create_process(proc_typep, proc_namep2);
+  sprokit::process_t const processt = create_process(proc_typet, proc_namet);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value("_fuse_chains", "true");
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(config);
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processp1);
+  pipeline->add_process(processp2);
+  pipeline->add_process(processt);
+  pipeline->add_process(processd);
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_namepi = sprokit::process::port_t("pass");
+  sprokit::process::port_t const port_namepo = sprokit::process::port_t("pass");
+  sprokit::process::port_t const port_nameti = sprokit::process::port_t("input");
+  sprokit::process::port_t const port_nameto = sprokit::process::port_t("duplicate");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_namep1, port_namepi);
+  pipeline->connect(proc_namep1, port_namepo,
+                    proc_namep2, port_namepi);
+  pipeline->connect(proc_namep2, port_namepo,
+                    proc_namet, port_nameti);
+  pipeline->connect(proc_namet, port_nameto,
+                    proc_named, port_named);
+
+  pipeline->setup_pipeline();
+
+  sprokit::pipeline::chains_t const chains = pipeline->fused_chains();
+
+  if (chains.size() != 1)
+  {
+    TEST_ERROR("Expected one fused chain, found " << chains.size());
+  }
+
+  sprokit::process::names_t expected;
+
+  expected.push_back(proc_nameu);
+  expected.push_back(proc_namep1);
+  expected.push_back(proc_namep2);
+  expected.push_back(proc_namet);
+
+  if (!chains.empty() && (chains[0] != expected))
+  {
+    TEST_ERROR("The fused chain is not the linear section of the pipeline");
+  }
+
+  // Connections within a chain must still be introspectable.
+  if (!pipeline->edge_for_connection(proc_namep1, port_namepo,
+                                     proc_namep2, port_namepi))
+  {
+    TEST_ERROR("The edge within a fused chain is not available");
+  }
+}
+
+IMPLEMENT_TEST(setup_pipeline_admission_unreachable_sink)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typej = sprokit::process::type_t("multiplication");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu1 = sprokit::process::name_t("upstream1");
+  sprokit::process::name_t const proc_nameu2 = sprokit::process::name_t("upstream2");
+  sprokit::process::name_t const proc_namej = sprokit::process::name_t("join");
+  sprokit::process::name_t const proc_named1 = sprokit::process::name_t("downstream1");
+  sprokit::process::name_t const proc_named2 = sprokit::process::name_t("downstream2");
+
+  sprokit::process_t const processu1 = create_process(proc_typeu, proc_nameu1);
+  sprokit::process_t const processu2 = create_process(proc_typeu, proc_nameu2);
+  sprokit::process_t const processj = create_process(proc_typej, proc_namej);
+  sprokit::process_t const processd1 = create_process(proc_typed, proc_named1);
+  sprokit::process_t const processd2 = create_process(proc_typed, proc_named2);
+
+  sprokit::config_t const config = sprokit::config::empty_config();
+
+  config->set_value("_admission:max_in_flight", "4");
+  config->set_value("_admission:sources", proc_nameu1);
+  config->set_value("_admission:sinks", proc_named1 + " " + proc_named2);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(config);
+
+  pipeline->add_process(processu1);
+  pipeline->add_process(processu2);
+  pipeline->add_process(processj);
+  pipeline->add_process(processd1);
+  pipeline->add_process(processd2);
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_namej1 = sprokit::process::port_t("factor1");
+  sprokit::process::port_t const port_namej2 = sprokit::process::port_t("factor2");
+  sprokit::process::port_t const port_namejo = sprokit::process::port_t("product");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  // The pipeline is connected, but the second sink is only fed by the
+  // second upstream, which is not a source.
+  pipeline->connect(proc_nameu1, port_nameu,
+                    proc_namej, port_namej1);
+  pipeline->connect(proc_nameu2, port_nameu,
+                    proc_namej, port_namej2);
+  pipeline->connect(proc_namej, port_namejo,
+                    proc_named1, port_named);
+  pipeline->connect(proc_nameu2, port_nameu,
+                    proc_named2, port_named);
+
+  EXPECT_EXCEPTION(sprokit::invalid_admission_exception,
+                   pipeline->setup_pipeline(),
+                   "setting up admission control for a sink not fed by a source");
+}
+
 IMPLEMENT_TEST(setup_pipeline_duplicate)
 {
   sprokit::process::type_t const proc_type = sprokit::process::type_t("orphan");
@@ -1475,6 +1635,66 @@ IMPLEMENT_TEST(setup_pipeline)
   pipeline->setup_pipeline();
 }
 
+IMPLEMENT_TEST(setup_timings)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipeline = create_pipeline();
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processd);
+
+  pipeline->connect(proc_nameu, sprokit::process::port_t("number"),
+                    proc_named, sprokit::process::port_t("sink"));
+
+  EXPECT_EXCEPTION(sprokit::pipeline_not_setup_exception,
+                   pipeline->setup_timings(),
+                   "getting setup timings before setup");
+
+  pipeline->setup_pipeline();
+
+  sprokit::pipeline::setup_timings_t const timings = pipeline->setup_timings();
+
+  if (timings.empty())
+  {
+    TEST_ERROR("No setup timings were recorded");
+
+    return;
+  }
+
+  if (timings.front().first != "check_for_processes")
+  {
+    TEST_ERROR("The first setup phase was not checking for processes: " << timings.front().first);
+  }
+
+  if (timings.back().first != "setup_admission_control")
+  {
+    TEST_ERROR("The last setup phase was not setting up admission control: " << timings.back().first);
+  }
+
+  bool found = false;
+
+  BOOST_FOREACH (sprokit::pipeline::setup_timing_t const& timing, timings)
+  {
+    if (timing.first == "make_connections")
+    {
+      found = true;
+    }
+  }
+
+  if (!found)
+  {
+    TEST_ERROR("The time taken to make connections was not recorded");
+  }
+}
+
 static sprokit::scheduler_t create_scheduler(sprokit::pipeline_t const& pipe);
 
 IMPLEMENT_TEST(start_before_setup)
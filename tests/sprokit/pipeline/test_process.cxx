@@ -31,13 +31,17 @@
 #include <test_common.h>
 
 #include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
 #include <sprokit/pipeline/edge.h>
 #include <sprokit/pipeline/modules.h>
 #include <sprokit/pipeline/pipeline.h>
 #include <sprokit/pipeline/process.h>
 #include <sprokit/pipeline/process_exception.h>
 #include <sprokit/pipeline/process_registry.h>
+#include <sprokit/pipeline/stamp.h>
 
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 
 #define TEST_ARGS ()
@@ -860,6 +864,559 @@ IMPLEMENT_TEST(reconfigure_extra_parameters)
   pipeline->reconfigure(new_conf);
 }
 
+IMPLEMENT_TEST(reconfigure_publishes_snapshot)
+{
+  sprokit::process::type_t const proc_type = sprokit::process::type_t("expect");
+  sprokit::process::name_t const proc_name = sprokit::process::name_t("name");
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  sprokit::config::key_t const key_tunable = sprokit::config::key_t("tunable");
+  sprokit::config::key_t const key_expect = sprokit::config::key_t("expect");
+
+  sprokit::config::value_t const tunable_value = sprokit::config::value_t("old_value");
+  sprokit::config::value_t const tuned_value = sprokit::config::value_t("new_value");
+
+  conf->set_value(key_tunable, tunable_value);
+  conf->set_value(key_expect, tuned_value);
+  conf->set_value(sprokit::process::config_name, proc_name);
+
+  sprokit::process_t const expect = create_process(proc_type, proc_name, conf);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipeline->add_process(expect);
+  pipeline->setup_pipeline();
+
+  sprokit::config_t const new_conf = sprokit::config::empty_config();
+
+  new_conf->set_value(proc_name + sprokit::config::block_sep + key_tunable, tuned_value);
+
+  pipeline->reconfigure(new_conf);
+
+  sprokit::config::value_t const value = conf->get_value<sprokit::config::value_t>(key_tunable);
+
+  if (value != tunable_value)
+  {
+    TEST_ERROR("Reconfiguring a process modified a previously published "
+               "configuration block");
+  }
+}
+
+IMPLEMENT_TEST(step_batch)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typem = sprokit::process::type_t("multiplication");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namem = sprokit::process::name_t("multiply");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  size_t const batch = 5;
+
+  sprokit::config_t const confm = sprokit::config::empty_config();
+
+  confm->set_value(sprokit::process::config_max_batch, boost::lexical_cast<sprokit::config::value_t>(batch));
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processm = create_process(proc_typem, proc_namem, confm);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processm);
+  pipeline->add_process(processd);
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_namem1 = sprokit::process::port_t("factor1");
+  sprokit::process::port_t const port_namem2 = sprokit::process::port_t("factor2");
+  sprokit::process::port_t const port_namemo = sprokit::process::port_t("product");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_namem, port_namem1);
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_namem, port_namem2);
+  pipeline->connect(proc_namem, port_namemo,
+                    proc_named, port_named);
+
+  pipeline->setup_pipeline();
+
+  // Queue more inputs than the process is allowed to take at once.
+  for (size_t i = 0; i < (batch + 2); ++i)
+  {
+    processu->step();
+  }
+
+  processm->step();
+
+  sprokit::edge_t const edge = pipeline->edge_for_connection(proc_namem, port_namemo,
+                                                             proc_named, port_named);
+
+  size_t const count = edge->datum_count();
+
+  if (count != batch)
+  {
+    TEST_ERROR("A batch step did not process the expected number of "
+               "inputs: expected " << batch << ", got " << count);
+  }
+}
+
+IMPLEMENT_TEST(step_batch_sink)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  size_t const count = 10;
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processd);
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_named, port_named);
+
+  pipeline->setup_pipeline();
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    processu->step();
+  }
+
+  sprokit::edge_t const edge = pipeline->edge_for_connection(proc_nameu, port_nameu,
+                                                             proc_named, port_named);
+
+  // Without batching, each datum would take a step of its own, and with it
+  // the locks for the step and the edge.
+  processd->step();
+
+  if (edge->popped_count() != count)
+  {
+    TEST_ERROR("A single step of the sink did not take all of the queued "
+               "data: expected " << count << ", got " << edge->popped_count());
+  }
+}
+
+IMPLEMENT_TEST(reset_after_complete)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::config_t const confu = sprokit::config::empty_config();
+
+  sprokit::config::key_t const key_end = sprokit::config::key_t("end");
+
+  confu->set_value(key_end, "1");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, confu);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processd);
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_named, port_named);
+
+  pipeline->setup_pipeline();
+
+  // Run the process until it completes.
+  processu->step();
+  processu->step();
+
+  pipeline->reset();
+  pipeline->setup_pipeline();
+
+  processu->step();
+
+  sprokit::edge_t const edge = pipeline->edge_for_connection(proc_nameu, port_nameu,
+                                                             proc_named, port_named);
+
+  if (!edge->datum_count())
+  {
+    TEST_ERROR("A process which completed before a reset did not run again");
+  }
+  else if (edge->peek_datum().datum->type() != sprokit::datum::data)
+  {
+    TEST_ERROR("A process which completed before a reset did not push data");
+  }
+}
+
+IMPLEMENT_TEST(stream_complete)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typep = sprokit::process::type_t("pass");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namep = sprokit::process::name_t("pass");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processp = create_process(proc_typep, proc_namep);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processp);
+  pipeline->add_process(processd);
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_namep = sprokit::process::port_t("pass");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_namep, port_namep);
+  pipeline->connect(proc_namep, port_namep,
+                    proc_named, port_named);
+
+  pipeline->setup_pipeline();
+
+  sprokit::edge_t const iedge = pipeline->edge_for_connection(proc_nameu, port_nameu,
+                                                              proc_namep, port_namep);
+  sprokit::edge_t const oedge = pipeline->edge_for_connection(proc_namep, port_namep,
+                                                              proc_named, port_named);
+
+  sprokit::stamp::stream_t const stream = sprokit::stamp::stream_t(5);
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(1);
+
+  iedge->push_datum(sprokit::edge_datum_t(sprokit::datum::complete_datum(),
+                                          sprokit::stamp::stream_stamp(stamp, stream)));
+  iedge->push_datum(sprokit::edge_datum_t(sprokit::datum::new_datum(1), stamp));
+
+  processp->step();
+  processp->step();
+
+  if (oedge->datum_count() != 2)
+  {
+    TEST_ERROR("The end of a stream ended the process");
+  }
+  else
+  {
+    sprokit::edge_datum_t const first = oedge->peek_datum(0);
+    sprokit::edge_datum_t const second = oedge->peek_datum(1);
+
+    if (first.datum->type() != sprokit::datum::complete)
+    {
+      TEST_ERROR("The end of a stream was not forwarded");
+    }
+    else if (first.stamp->stream() != stream)
+    {
+      TEST_ERROR("The end of a stream was forwarded to a different stream");
+    }
+
+    if (second.datum->type() != sprokit::datum::data)
+    {
+      TEST_ERROR("Data after the end of a stream was not passed on");
+    }
+    else if (second.stamp->stream() != sprokit::stamp::default_stream)
+    {
+      TEST_ERROR("Data was pushed to the stream of earlier data");
+    }
+  }
+}
+
+IMPLEMENT_TEST(stream_stamps)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typep = sprokit::process::type_t("pass");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namep = sprokit::process::name_t("pass");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processp = create_process(proc_typep, proc_namep);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processp);
+  pipeline->add_process(processd);
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_namep = sprokit::process::port_t("pass");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_namep, port_namep);
+  pipeline->connect(proc_namep, port_namep,
+                    proc_named, port_named);
+
+  pipeline->setup_pipeline();
+
+  sprokit::edge_t const iedge = pipeline->edge_for_connection(proc_nameu, port_nameu,
+                                                              proc_namep, port_namep);
+  sprokit::edge_t const oedge = pipeline->edge_for_connection(proc_namep, port_namep,
+                                                              proc_named, port_named);
+
+  sprokit::stamp::stream_t const stream = sprokit::stamp::stream_t(5);
+  size_t const per_stream = 3;
+
+  sprokit::stamp_t stamp = sprokit::stamp::new_stamp(1);
+
+  // Interleave two streams.
+  for (size_t i = 0; i < per_stream; ++i)
+  {
+    iedge->push_datum(sprokit::edge_datum_t(sprokit::datum::new_datum(1),
+                                            sprokit::stamp::stream_stamp(stamp, stream)));
+    iedge->push_datum(sprokit::edge_datum_t(sprokit::datum::new_datum(1), stamp));
+
+    stamp = sprokit::stamp::incremented_stamp(stamp);
+  }
+
+  for (size_t i = 0; i < 2 * per_stream; ++i)
+  {
+    processp->step();
+  }
+
+  if (oedge->datum_count() != 2 * per_stream)
+  {
+    TEST_ERROR("Not all of the data was passed on");
+
+    return;
+  }
+
+  sprokit::stamp_t expect = sprokit::stamp::new_stamp(1);
+
+  // Each stream is numbered on its own, so a stream does not skip indices
+  // used by the other.
+  for (size_t i = 0; i < per_stream; ++i)
+  {
+    sprokit::edge_datum_t const in_stream = oedge->peek_datum(2 * i);
+    sprokit::edge_datum_t const in_default = oedge->peek_datum(2 * i + 1);
+
+    if (*in_stream.stamp != *sprokit::stamp::stream_stamp(expect, stream))
+    {
+      TEST_ERROR("The stamp of datum " << i << " in the stream "
+                 "does not follow the earlier data in the stream");
+    }
+
+    if (*in_default.stamp != *expect)
+    {
+      TEST_ERROR("The stamp of datum " << i << " in the default stream "
+                 "does not follow the earlier data in the stream");
+    }
+
+    expect = sprokit::stamp::incremented_stamp(expect);
+  }
+}
+
+IMPLEMENT_TEST(stream_order_inputs)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typem = sprokit::process::type_t("multiplication");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu1 = sprokit::process::name_t("upstream1");
+  sprokit::process::name_t const proc_nameu2 = sprokit::process::name_t("upstream2");
+  sprokit::process::name_t const proc_namem = sprokit::process::name_t("multiply");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_namef1 = sprokit::process::port_t("factor1");
+  sprokit::process::port_t const port_namef2 = sprokit::process::port_t("factor2");
+  sprokit::process::port_t const port_namep = sprokit::process::port_t("product");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  sprokit::stamp::stream_t const stream = sprokit::stamp::stream_t(5);
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(1);
+
+  sprokit::edge_datum_t const in_stream = sprokit::edge_datum_t(sprokit::datum::new_datum(int32_t(2)),
+                                                                sprokit::stamp::stream_stamp(stamp, stream));
+  sprokit::edge_datum_t const in_default = sprokit::edge_datum_t(sprokit::datum::new_datum(int32_t(3)), stamp);
+
+  // Inputs are matched in the order they arrive, not by stream.
+  bool const same_orders[] = {true, false};
+
+  BOOST_FOREACH (bool const same_order, same_orders)
+  {
+    sprokit::process_t const processu1 = create_process(proc_typeu, proc_nameu1);
+    sprokit::process_t const processu2 = create_process(proc_typeu, proc_nameu2);
+    sprokit::process_t const processm = create_process(proc_typem, proc_namem);
+    sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+    sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+    pipeline->add_process(processu1);
+    pipeline->add_process(processu2);
+    pipeline->add_process(processm);
+    pipeline->add_process(processd);
+
+    pipeline->connect(proc_nameu1, port_nameu,
+                      proc_namem, port_namef1);
+    pipeline->connect(proc_nameu2, port_nameu,
+                      proc_namem, port_namef2);
+    pipeline->connect(proc_namem, port_namep,
+                      proc_named, port_named);
+
+    pipeline->setup_pipeline();
+
+    sprokit::edge_t const iedge1 = pipeline->edge_for_connection(proc_nameu1, port_nameu,
+                                                                 proc_namem, port_namef1);
+    sprokit::edge_t const iedge2 = pipeline->edge_for_connection(proc_nameu2, port_nameu,
+                                                                 proc_namem, port_namef2);
+    sprokit::edge_t const oedge = pipeline->edge_for_connection(proc_namem, port_namep,
+                                                                proc_named, port_named);
+
+    iedge1->push_datum(in_stream);
+    iedge1->push_datum(in_default);
+
+    iedge2->push_datum(same_order ? in_stream : in_default);
+    iedge2->push_datum(same_order ? in_default : in_stream);
+
+    processm->step();
+    processm->step();
+
+    if (oedge->datum_count() != 2)
+    {
+      TEST_ERROR("The process did not push a result for each set of inputs");
+
+      continue;
+    }
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+      sprokit::edge_datum_t const edat = oedge->peek_datum(i);
+      sprokit::datum::type_t const type = edat.datum->type();
+
+      if (same_order && (type != sprokit::datum::data))
+      {
+        TEST_ERROR("Inputs with streams in the same order were not matched");
+      }
+      else if (!same_order && (type != sprokit::datum::error))
+      {
+        TEST_ERROR("Inputs with streams in different orders were matched");
+      }
+    }
+
+    if (same_order)
+    {
+      sprokit::edge_datum_t const first = oedge->peek_datum(0);
+
+      if ((first.stamp->stream() != stream) ||
+          (first.datum->get_datum<int32_t>() != 4))
+      {
+        TEST_ERROR("The product of the inputs in a stream is incorrect");
+      }
+    }
+  }
+}
+
+IMPLEMENT_TEST(distribute_stream_complete)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typedist = sprokit::process::type_t("distribute");
+  sprokit::process::type_t const proc_typecoll = sprokit::process::type_t("collate");
+  sprokit::process::type_t const proc_typed = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namedist = sprokit::process::name_t("distribute");
+  sprokit::process::name_t const proc_namecoll = sprokit::process::name_t("collate");
+  sprokit::process::name_t const proc_named = sprokit::process::name_t("downstream");
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_status = sprokit::process::port_t("status/test");
+  sprokit::process::port_t const port_src = sprokit::process::port_t("src/test");
+  sprokit::process::port_t const port_dist_a = sprokit::process::port_t("dist/test/a");
+  sprokit::process::port_t const port_dist_b = sprokit::process::port_t("dist/test/b");
+  sprokit::process::port_t const port_coll_a = sprokit::process::port_t("coll/test/a");
+  sprokit::process::port_t const port_coll_b = sprokit::process::port_t("coll/test/b");
+  sprokit::process::port_t const port_res = sprokit::process::port_t("res/test");
+  sprokit::process::port_t const port_named = sprokit::process::port_t("sink");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processdist = create_process(proc_typedist, proc_namedist);
+  sprokit::process_t const processcoll = create_process(proc_typecoll, proc_namecoll);
+  sprokit::process_t const processd = create_process(proc_typed, proc_named);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(sprokit::config::empty_config());
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processdist);
+  pipeline->add_process(processcoll);
+  pipeline->add_process(processd);
+
+  // The ports for a tag only exist once its status port is connected.
+  pipeline->connect(proc_namedist, port_status,
+                    proc_namecoll, port_status);
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_namedist, port_src);
+  pipeline->connect(proc_namedist, port_dist_a,
+                    proc_namecoll, port_coll_a);
+  pipeline->connect(proc_namedist, port_dist_b,
+                    proc_namecoll, port_coll_b);
+  pipeline->connect(proc_namecoll, port_res,
+                    proc_named, port_named);
+
+  pipeline->setup_pipeline();
+
+  sprokit::edge_t const iedge = pipeline->edge_for_connection(proc_nameu, port_nameu,
+                                                              proc_namedist, port_src);
+  sprokit::edge_t const oedge = pipeline->edge_for_connection(proc_namecoll, port_res,
+                                                              proc_named, port_named);
+
+  sprokit::stamp::stream_t const stream = sprokit::stamp::stream_t(5);
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(1);
+
+  iedge->push_datum(sprokit::edge_datum_t(sprokit::datum::new_datum(int32_t(1)),
+                                          sprokit::stamp::stream_stamp(stamp, stream)));
+  iedge->push_datum(sprokit::edge_datum_t(sprokit::datum::complete_datum(),
+                                          sprokit::stamp::stream_stamp(sprokit::stamp::incremented_stamp(stamp), stream)));
+  iedge->push_datum(sprokit::edge_datum_t(sprokit::datum::new_datum(int32_t(2)), stamp));
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    processdist->step();
+    processcoll->step();
+  }
+
+  if (oedge->datum_count() != 3)
+  {
+    TEST_ERROR("Not all of the data was collated: " << oedge->datum_count() << " of 3");
+
+    return;
+  }
+
+  sprokit::edge_datum_t const end = oedge->peek_datum(1);
+  sprokit::edge_datum_t const last = oedge->peek_datum(2);
+
+  if ((end.datum->type() != sprokit::datum::complete) ||
+      (end.stamp->stream() != stream))
+  {
+    TEST_ERROR("The end of a stream was not passed through");
+  }
+
+  if ((last.datum->type() != sprokit::datum::data) ||
+      (last.stamp->stream() != sprokit::stamp::default_stream) ||
+      (last.datum->get_datum<int32_t>() != 2))
+  {
+    TEST_ERROR("Data after the end of a stream was not passed through");
+  }
+}
+
 sprokit::process_t
 create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t const& conf)
 {
@@ -31,18 +31,25 @@
 #include <test_common.h>
 
 #include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/edge.h>
 #include <sprokit/pipeline/modules.h>
 #include <sprokit/pipeline/pipeline.h>
 #include <sprokit/pipeline/process.h>
 #include <sprokit/pipeline/process_registry.h>
 #include <sprokit/pipeline/scheduler.h>
+#include <sprokit/pipeline/scheduler_exception.h>
 #include <sprokit/pipeline/scheduler_registry.h>
 
 #include <boost/cstdint.hpp>
+#include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #define TEST_ARGS (sprokit::scheduler_registry::type_t const& scheduler_type)
 
@@ -623,6 +630,800 @@ IMPLEMENT_TEST(frequency_pipeline)
   }
 }
 
+IMPLEMENT_TEST(fused_pipeline)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typep = sprokit::process::type_t("pass");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("print_number");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namep1 = sprokit::process::name_t("pass1");
+  sprokit::process::name_t const proc_namep2 = sprokit::process::name_t("pass2");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  std::string const output_path = "test-run-fused_pipeline-" + scheduler_type + "-print_number.txt";
+
+  int32_t const start_value = 10;
+  int32_t const end_value = 200;
+
+  {
+    sprokit::config_t const configu = sprokit::config::empty_config();
+
+    sprokit::config::key_t const start_key = sprokit::config::key_t("start");
+    sprokit::config::value_t const start_num = boost::lexical_cast<sprokit::config::value_t>(start_value);
+    sprokit::config::key_t const end_key = sprokit::config::key_t("end");
+    sprokit::config::value_t const end_num = boost::lexical_cast<sprokit::config::value_t>(end_value);
+
+    configu->set_value(start_key, start_num);
+    configu->set_value(end_key, end_num);
+
+    sprokit::config_t const configt = sprokit::config::empty_config();
+
+    sprokit::config::key_t const output_key = sprokit::config::key_t("output");
+    sprokit::config::value_t const output_value = sprokit::config::value_t(output_path);
+
+    configt->set_value(output_key, output_value);
+
+    sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+    sprokit::process_t const processp1 = create_process(proc_typep, proc_namep1);
+    sprokit::process_t const processp2 = create_process(proc_typep, proc_namep2);
+    sprokit::process_t const processt = create_process(proc_typet, proc_namet, configt);
+
+    sprokit::config_t const pipe_config = sprokit::config::empty_config();
+
+    // Use small edges so that the chain has to hand data off as it goes.
+    pipe_config->set_value("_fuse_chains", "true");
+    pipe_config->set_value("_edge:capacity", "1");
+
+    sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(pipe_config);
+
+    pipeline->add_process(processu);
+    pipeline->add_process(processp1);
+    pipeline->add_process(processp2);
+    pipeline->add_process(processt);
+
+    sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+    sprokit::process::port_t const port_namep = sprokit::process::port_t("pass");
+    sprokit::process::port_t const port_namet = sprokit::process::port_t("number");
+
+    pipeline->connect(proc_nameu, port_nameu,
+                      proc_namep1, port_namep);
+    pipeline->connect(proc_namep1, port_namep,
+                      proc_namep2, port_namep);
+    pipeline->connect(proc_namep2, port_namep,
+                      proc_namet, port_namet);
+
+    pipeline->setup_pipeline();
+
+    sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+    sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline);
+
+    scheduler->start();
+
+    // The chain runs on one thread, so the edges within it need no locks.
+    if ((scheduler_type == "thread_per_process") &&
+        pipeline->edge_for_connection(proc_namep1, port_namep,
+                                      proc_namep2, port_namep)->is_synchronized())
+    {
+      TEST_ERROR("An edge within a fused chain is still synchronized");
+    }
+
+    scheduler->wait();
+  }
+
+  std::ifstream fin(output_path.c_str());
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the output file");
+  }
+
+  std::string line;
+
+  for (int32_t i = start_value; i < end_value; ++i)
+  {
+    if (!std::getline(fin, line))
+    {
+      TEST_ERROR("Failed to read a line from the file");
+    }
+
+    if (sprokit::config::value_t(line) != boost::lexical_cast<sprokit::config::value_t>(i))
+    {
+      TEST_ERROR("Did not get expected value: "
+                 "Expected: " << i << " "
+                 "Received: " << line);
+    }
+  }
+
+  if (std::getline(fin, line))
+  {
+    TEST_ERROR("More results than expected in the file");
+  }
+
+  if (!fin.eof())
+  {
+    TEST_ERROR("Not at end of file");
+  }
+}
+
+IMPLEMENT_TEST(admission_pipeline)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typep = sprokit::process::type_t("pass");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("print_number");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namep1 = sprokit::process::name_t("pass1");
+  sprokit::process::name_t const proc_namep2 = sprokit::process::name_t("pass2");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  std::string const output_path = "test-run-admission_pipeline-" + scheduler_type + "-print_number.txt";
+
+  int32_t const start_value = 10;
+  int32_t const end_value = 200;
+
+  {
+    sprokit::config_t const configu = sprokit::config::empty_config();
+
+    sprokit::config::key_t const start_key = sprokit::config::key_t("start");
+    sprokit::config::value_t const start_num = boost::lexical_cast<sprokit::config::value_t>(start_value);
+    sprokit::config::key_t const end_key = sprokit::config::key_t("end");
+    sprokit::config::value_t const end_num = boost::lexical_cast<sprokit::config::value_t>(end_value);
+
+    configu->set_value(start_key, start_num);
+    configu->set_value(end_key, end_num);
+
+    sprokit::config_t const configt = sprokit::config::empty_config();
+
+    sprokit::config::key_t const output_key = sprokit::config::key_t("output");
+    sprokit::config::value_t const output_value = sprokit::config::value_t(output_path);
+
+    configt->set_value(output_key, output_value);
+
+    sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+    sprokit::process_t const processp1 = create_process(proc_typep, proc_namep1);
+    sprokit::process_t const processp2 = create_process(proc_typep, proc_namep2);
+    sprokit::process_t const processt = create_process(proc_typet, proc_namet, configt);
+
+    sprokit::config_t const pipe_config = sprokit::config::empty_config();
+
+    // Only allow a single number between the source and the sink at a time.
+    pipe_config->set_value("_admission:max_in_flight", "1");
+    pipe_config->set_value("_admission:sources", proc_nameu);
+    pipe_config->set_value("_admission:sinks", proc_namet);
+
+    sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(pipe_config);
+
+    pipeline->add_process(processu);
+    pipeline->add_process(processp1);
+    pipeline->add_process(processp2);
+    pipeline->add_process(processt);
+
+    sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+    sprokit::process::port_t const port_namep = sprokit::process::port_t("pass");
+    sprokit::process::port_t const port_namet = sprokit::process::port_t("number");
+
+    pipeline->connect(proc_nameu, port_nameu,
+                      proc_namep1, port_namep);
+    pipeline->connect(proc_namep1, port_namep,
+                      proc_namep2, port_namep);
+    pipeline->connect(proc_namep2, port_namep,
+                      proc_namet, port_namet);
+
+    pipeline->setup_pipeline();
+
+    sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+    sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline);
+
+    scheduler->start();
+    scheduler->wait();
+  }
+
+  std::ifstream fin(output_path.c_str());
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the output file");
+  }
+
+  std::string line;
+
+  for (int32_t i = start_value; i < end_value; ++i)
+  {
+    if (!std::getline(fin, line))
+    {
+      TEST_ERROR("Failed to read a line from the file");
+    }
+
+    if (sprokit::config::value_t(line) != boost::lexical_cast<sprokit::config::value_t>(i))
+    {
+      TEST_ERROR("Did not get expected value: "
+                 "Expected: " << i << " "
+                 "Received: " << line);
+    }
+  }
+
+  if (std::getline(fin, line))
+  {
+    TEST_ERROR("More results than expected in the file");
+  }
+
+  if (!fin.eof())
+  {
+    TEST_ERROR("Not at end of file");
+  }
+}
+IMPLEMENT_TEST(admission_frequency_pipeline)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typef = sprokit::process::type_t("duplicate");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("print_number");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namef = sprokit::process::name_t("duplicate");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  std::string const output_path = "test-run-admission_frequency_pipeline-" + scheduler_type + "-print_number.txt";
+
+  int32_t const start_value = 10;
+  int32_t const end_value = 200;
+
+  size_t const copies = 2;
+
+  {
+    sprokit::config_t const configu = sprokit::config::empty_config();
+
+    sprokit::config::key_t const start_key = sprokit::config::key_t("start");
+    sprokit::config::value_t const start_num = boost::lexical_cast<sprokit::config::value_t>(start_value);
+    sprokit::config::key_t const end_key = sprokit::config::key_t("end");
+    sprokit::config::value_t const end_num = boost::lexical_cast<sprokit::config::value_t>(end_value);
+
+    configu->set_value(start_key, start_num);
+    configu->set_value(end_key, end_num);
+
+    sprokit::config_t const configf = sprokit::config::empty_config();
+
+    sprokit::config::key_t const copies_key = sprokit::config::key_t("copies");
+    sprokit::config::value_t const copies_value = boost::lexical_cast<sprokit::config::value_t>(copies - 1);
+
+    configf->set_value(copies_key, copies_value);
+
+    sprokit::config_t const configt = sprokit::config::empty_config();
+
+    sprokit::config::key_t const output_key = sprokit::config::key_t("output");
+    sprokit::config::value_t const output_value = sprokit::config::value_t(output_path);
+
+    configt->set_value(output_key, output_value);
+
+    sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+    sprokit::process_t const processf = create_process(proc_typef, proc_namef, configf);
+    sprokit::process_t const processt = create_process(proc_typet, proc_namet, configt);
+
+    sprokit::config_t const pipe_config = sprokit::config::empty_config();
+
+    // The sink steps twice for every step of the source; a window counting
+    // steps rather than source data would deadlock here.
+    pipe_config->set_value("_admission:max_in_flight", "1");
+    pipe_config->set_value("_admission:sources", proc_nameu);
+    pipe_config->set_value("_admission:sinks", proc_namet);
+
+    sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(pipe_config);
+
+    pipeline->add_process(processu);
+    pipeline->add_process(processf);
+    pipeline->add_process(processt);
+
+    sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+    sprokit::process::port_t const port_namefi = sprokit::process::port_t("input");
+    sprokit::process::port_t const port_namefo = sprokit::process::port_t("duplicate");
+    sprokit::process::port_t const port_namet = sprokit::process::port_t("number");
+
+    pipeline->connect(proc_nameu, port_nameu,
+                      proc_namef, port_namefi);
+    pipeline->connect(proc_namef, port_namefo,
+                      proc_namet, port_namet);
+
+    pipeline->setup_pipeline();
+
+    sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+    sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline);
+
+    scheduler->start();
+    scheduler->wait();
+  }
+
+  std::ifstream fin(output_path.c_str());
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the output file");
+  }
+
+  std::string line;
+
+  for (int32_t i = start_value; i < end_value; ++i)
+  {
+    for (size_t j = 0; j < copies; ++j)
+    {
+      if (!std::getline(fin, line))
+      {
+        TEST_ERROR("Failed to read a line from the file");
+      }
+
+      if (sprokit::config::value_t(line) != boost::lexical_cast<sprokit::config::value_t>(i))
+      {
+        TEST_ERROR("Did not get expected value: "
+                   "Expected: " << i << " "
+                   "Received: " << line);
+      }
+    }
+  }
+
+  if (std::getline(fin, line))
+  {
+    TEST_ERROR("More results than expected in the file");
+  }
+
+  if (!fin.eof())
+  {
+    TEST_ERROR("Not at end of file");
+  }
+}
+
+IMPLEMENT_TEST(admission_sink_pipeline)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typep = sprokit::process::type_t("pass");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namep = sprokit::process::name_t("pass");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  int32_t const start_value = 10;
+  int32_t const end_value = 200;
+
+  sprokit::config_t const configu = sprokit::config::empty_config();
+
+  sprokit::config::key_t const start_key = sprokit::config::key_t("start");
+  sprokit::config::value_t const start_num = boost::lexical_cast<sprokit::config::value_t>(start_value);
+  sprokit::config::key_t const end_key = sprokit::config::key_t("end");
+  sprokit::config::value_t const end_num = boost::lexical_cast<sprokit::config::value_t>(end_value);
+
+  configu->set_value(start_key, start_num);
+  configu->set_value(end_key, end_num);
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+  sprokit::process_t const processp = create_process(proc_typep, proc_namep);
+  sprokit::process_t const processt = create_process(proc_typet, proc_namet);
+
+  sprokit::config_t const pipe_config = sprokit::config::empty_config();
+
+  // The sink completes within its own step, after which its window must not
+  // be released again.
+  pipe_config->set_value("_admission:max_in_flight", "2");
+  pipe_config->set_value("_admission:sources", proc_nameu);
+  pipe_config->set_value("_admission:sinks", proc_namet);
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(pipe_config);
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processp);
+  pipeline->add_process(processt);
+
+  sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+  sprokit::process::port_t const port_namep = sprokit::process::port_t("pass");
+  sprokit::process::port_t const port_namet = sprokit::process::port_t("sink");
+
+  pipeline->connect(proc_nameu, port_nameu,
+                    proc_namep, port_namep);
+  pipeline->connect(proc_namep, port_namep,
+                    proc_namet, port_namet);
+
+  pipeline->setup_pipeline();
+
+  sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+  sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline);
+
+  scheduler->start();
+  scheduler->wait();
+
+  sprokit::edge_t const edge = pipeline->input_edge_for_port(proc_namet, port_namet);
+
+  if (edge->popped_count() != size_t(end_value - start_value))
+  {
+    TEST_ERROR("The sink did not receive every number: "
+               "Expected: " << (end_value - start_value) << " "
+               "Received: " << edge->popped_count());
+  }
+}
+
+IMPLEMENT_TEST(latency_pipeline)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  std::string const output_path = "test-run-latency_pipeline-" + scheduler_type + "-latency.txt";
+
+  size_t const count = 100;
+
+  {
+    sprokit::config_t const configu = sprokit::config::empty_config();
+
+    configu->set_value("end", boost::lexical_cast<sprokit::config::value_t>(count));
+
+    sprokit::config_t const configt = sprokit::config::empty_config();
+
+    configt->set_value("latency_output", output_path);
+
+    sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+    sprokit::process_t const processt = create_process(proc_typet, proc_namet, configt);
+
+    sprokit::pipeline_t const pipeline = create_pipeline();
+
+    pipeline->add_process(processu);
+    pipeline->add_process(processt);
+
+    pipeline->connect(proc_nameu, sprokit::process::port_t("number"),
+                      proc_namet, sprokit::process::port_t("sink"));
+
+    pipeline->setup_pipeline();
+
+    sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+    sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline);
+
+    scheduler->start();
+    scheduler->wait();
+  }
+
+  std::ifstream fin(output_path.c_str());
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the latency file");
+
+    return;
+  }
+
+  std::string line;
+
+  // The summary: port count min p50 p90 p99 max.
+  std::getline(fin, line);
+  std::getline(fin, line);
+
+  std::istringstream summary(line);
+
+  std::string port;
+  size_t summary_count = 0;
+  uint64_t quantiles[5] = {0, 0, 0, 0, 0};
+
+  summary >> port >> summary_count;
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    summary >> quantiles[i];
+  }
+
+  if (!summary || (port != "sink"))
+  {
+    TEST_ERROR("The latency summary is malformed: " << line);
+  }
+
+  if (summary_count != count)
+  {
+    TEST_ERROR("Expected " << count << " latencies, "
+               "but " << summary_count << " were recorded");
+  }
+
+  for (size_t i = 1; i < 5; ++i)
+  {
+    if (quantiles[i] < quantiles[i - 1])
+    {
+      TEST_ERROR("The latency quantiles are not in order: " << line);
+    }
+  }
+
+  // The histogram: port bucket_limit count.
+  std::getline(fin, line);
+
+  size_t bucket_total = 0;
+  uint64_t last_limit = 0;
+
+  while (std::getline(fin, line))
+  {
+    std::istringstream bucket(line);
+
+    uint64_t limit = 0;
+    size_t bucket_count = 0;
+
+    bucket >> port >> limit >> bucket_count;
+
+    if (!bucket || (limit < last_limit))
+    {
+      TEST_ERROR("The latency histogram is malformed: " << line);
+    }
+
+    last_limit = limit;
+    bucket_total += bucket_count;
+  }
+
+  if (bucket_total != count)
+  {
+    TEST_ERROR("The latency histogram holds " << bucket_total << " latencies, "
+               "not " << count);
+  }
+
+  if (last_limit < quantiles[4])
+  {
+    TEST_ERROR("The largest latency is beyond the last bucket");
+  }
+}
+
+IMPLEMENT_TEST(shared_pool_pipelines)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("print_number");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  size_t const num_pipelines = 4;
+
+  int32_t const start_value = 10;
+  int32_t const end_value = 20;
+
+  std::vector<std::string> output_paths;
+
+  {
+    std::vector<sprokit::scheduler_t> schedulers;
+
+    for (size_t i = 0; i < num_pipelines; ++i)
+    {
+      std::string const output_path = "test-run-shared_pool_pipelines-" + scheduler_type + "-" +
+                                      boost::lexical_cast<std::string>(i) + "-print_number.txt";
+
+      output_paths.push_back(output_path);
+
+      sprokit::config_t const configu = sprokit::config::empty_config();
+
+      sprokit::config::key_t const start_key = sprokit::config::key_t("start");
+      sprokit::config::value_t const start_num = boost::lexical_cast<sprokit::config::value_t>(start_value);
+      sprokit::config::key_t const end_key = sprokit::config::key_t("end");
+      sprokit::config::value_t const end_num = boost::lexical_cast<sprokit::config::value_t>(end_value);
+
+      configu->set_value(start_key, start_num);
+      configu->set_value(end_key, end_num);
+
+      sprokit::config_t const configt = sprokit::config::empty_config();
+
+      sprokit::config::key_t const output_key = sprokit::config::key_t("output");
+      sprokit::config::value_t const output_value = sprokit::config::value_t(output_path);
+
+      configt->set_value(output_key, output_value);
+
+      sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+      sprokit::process_t const processt = create_process(proc_typet, proc_namet, configt);
+
+      sprokit::pipeline_t const pipeline = create_pipeline();
+
+      pipeline->add_process(processu);
+      pipeline->add_process(processt);
+
+      sprokit::process::port_t const port_nameu = sprokit::process::port_t("number");
+      sprokit::process::port_t const port_namet = sprokit::process::port_t("number");
+
+      pipeline->connect(proc_nameu, port_nameu,
+                        proc_namet, port_namet);
+
+      pipeline->setup_pipeline();
+
+      sprokit::config_t const sched_config = sprokit::config::empty_config();
+
+      sched_config->set_value("shared_pool", "true");
+      sched_config->set_value("weight", boost::lexical_cast<sprokit::config::value_t>(i + 1));
+
+      sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+      sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline, sched_config);
+
+      schedulers.push_back(scheduler);
+    }
+
+    // Pausing one pipeline must not hold up the others.
+    schedulers[0]->start();
+    schedulers[0]->pause();
+
+    for (size_t i = 1; i < num_pipelines; ++i)
+    {
+      schedulers[i]->start();
+    }
+
+    for (size_t i = 1; i < num_pipelines; ++i)
+    {
+      schedulers[i]->wait();
+    }
+
+    schedulers[0]->resume();
+    schedulers[0]->wait();
+  }
+
+  BOOST_FOREACH (std::string const& output_path, output_paths)
+  {
+    std::ifstream fin(output_path.c_str());
+
+    if (!fin.good())
+    {
+      TEST_ERROR("Could not open the output file");
+    }
+
+    std::string line;
+
+    for (int32_t i = start_value; i < end_value; ++i)
+    {
+      if (!std::getline(fin, line))
+      {
+        TEST_ERROR("Failed to read a line from the file");
+      }
+
+      if (sprokit::config::value_t(line) != boost::lexical_cast<sprokit::config::value_t>(i))
+      {
+        TEST_ERROR("Did not get expected value: "
+                   "Expected: " << i << " "
+                   "Received: " << line);
+      }
+    }
+
+    if (std::getline(fin, line))
+    {
+      TEST_ERROR("More results than expected in the file");
+    }
+  }
+}
+
+IMPLEMENT_TEST(shared_pool_stop)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const proc_typet = sprokit::process::type_t("sink");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namet = sprokit::process::name_t("terminal");
+
+  sprokit::config_t const configu = sprokit::config::empty_config();
+
+  configu->set_value("end", "100000000");
+
+  sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+  sprokit::process_t const processt = create_process(proc_typet, proc_namet);
+
+  // Small edges keep tasks suspended in the middle of their steps.
+  sprokit::config_t const pipe_config = sprokit::config::empty_config();
+
+  pipe_config->set_value("_edge:capacity", "1");
+
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>(pipe_config);
+
+  pipeline->add_process(processu);
+  pipeline->add_process(processt);
+
+  pipeline->connect(proc_nameu, sprokit::process::port_t("number"),
+                    proc_namet, sprokit::process::port_t("sink"));
+
+  pipeline->setup_pipeline();
+
+  sprokit::config_t const sched_config = sprokit::config::empty_config();
+
+  sched_config->set_value("shared_pool", "true");
+  // Pool workers apply the placement of the pipeline they run.
+  sched_config->set_value(sprokit::scheduler::config_cpus, "0");
+
+  sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+  sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline, sched_config);
+
+  scheduler->start();
+  scheduler->stop();
+
+  // The pool must still run other pipelines.
+  sprokit::process_t const processu2 = create_process(proc_typeu, proc_nameu);
+  sprokit::process_t const processt2 = create_process(proc_typet, proc_namet);
+
+  sprokit::pipeline_t const pipeline2 = create_pipeline();
+
+  pipeline2->add_process(processu2);
+  pipeline2->add_process(processt2);
+
+  pipeline2->connect(proc_nameu, sprokit::process::port_t("number"),
+                     proc_namet, sprokit::process::port_t("sink"));
+
+  pipeline2->setup_pipeline();
+
+  sprokit::scheduler_t const scheduler2 = reg->create_scheduler(scheduler_type, pipeline2, sched_config);
+
+  scheduler2->start();
+  scheduler2->wait();
+}
+
+class throw_in_step_process
+  : public sprokit::process
+{
+  public:
+    throw_in_step_process(sprokit::config_t const& conf);
+    ~throw_in_step_process();
+  protected:
+    void _step();
+};
+
+IMPLEMENT_TEST(step_exception)
+{
+  sprokit::process::type_t const proc_typeu = sprokit::process::type_t("numbers");
+
+  sprokit::process::name_t const proc_nameu = sprokit::process::name_t("upstream");
+  sprokit::process::name_t const proc_namex = sprokit::process::name_t("thrower");
+
+  // Each mode is run with more workers than tasks so that idle workers of
+  // the coroutine scheduler would wait forever if the failure did not wake
+  // them. Other schedulers ignore these settings.
+  char const* const shared_modes[] = {"false", "true"};
+
+  BOOST_FOREACH (char const* const shared, shared_modes)
+  {
+    sprokit::config_t const configu = sprokit::config::empty_config();
+
+    configu->set_value("end", "1000000");
+
+    sprokit::config_t const configx = sprokit::config::empty_config();
+
+    configx->set_value(sprokit::process::config_name, proc_namex);
+
+    sprokit::process_t const processu = create_process(proc_typeu, proc_nameu, configu);
+    sprokit::process_t const processx = boost::make_shared<throw_in_step_process>(configx);
+
+    sprokit::pipeline_t const pipeline = create_pipeline();
+
+    pipeline->add_process(processu);
+    pipeline->add_process(processx);
+
+    pipeline->connect(proc_nameu, sprokit::process::port_t("number"),
+                      proc_namex, sprokit::process::port_t("input"));
+
+    pipeline->setup_pipeline();
+
+    sprokit::config_t const sched_config = sprokit::config::empty_config();
+
+    sched_config->set_value("num_threads", "4");
+    sched_config->set_value("shared_pool", shared);
+
+    sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+    sprokit::scheduler_t const scheduler = reg->create_scheduler(scheduler_type, pipeline, sched_config);
+
+    scheduler->start();
+
+    // The failure must be reported with its message, whatever its type.
+    try
+    {
+      scheduler->wait();
+
+      TEST_ERROR("Did not get an exception when waiting on a pipeline with a process which throws");
+    }
+    catch (sprokit::step_failed_exception const& e)
+    {
+      if (e.m_reason != "step failed")
+      {
+        TEST_ERROR("The failure of the step was not reported: " << e.what());
+      }
+    }
+  }
+}
+
 sprokit::process_t
 create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config)
 {
@@ -639,3 +1440,26 @@ create_pipeline()
 {
   return boost::make_shared<sprokit::pipeline>();
 }
+
+throw_in_step_process
+::throw_in_step_process(sprokit::config_t const& conf)
+  : sprokit::process(conf)
+{
+  declare_input_port(
+    port_t("input"),
+    type_any,
+    port_flags_t(),
+    port_description_t("Ignored."));
+}
+
+throw_in_step_process
+::~throw_in_step_process()
+{
+}
+
+void
+throw_in_step_process
+::_step()
+{
+  throw std::runtime_error("step failed");
+}
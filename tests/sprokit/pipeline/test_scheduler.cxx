@@ -243,6 +243,81 @@ IMPLEMENT_TEST(restart)
   sched->start();
 }
 
+IMPLEMENT_TEST(malformed_cpus)
+{
+  sprokit::load_known_modules();
+
+  static sprokit::process::type_t const type = sprokit::process::type_t("orphan");
+  static sprokit::process::name_t const name = sprokit::process::name_t("name");
+
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+  sprokit::process_t const proc = reg->create_process(type, name);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>();
+
+  pipe->add_process(proc);
+  pipe->setup_pipeline();
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value(sprokit::scheduler::config_cpus, "3-1");
+
+  EXPECT_EXCEPTION(sprokit::bad_configuration_cast_exception,
+                   boost::make_shared<null_scheduler>(pipe, conf),
+                   "creating a scheduler with a malformed processor list");
+}
+
+IMPLEMENT_TEST(out_of_range_cpus)
+{
+  sprokit::load_known_modules();
+
+  static sprokit::process::type_t const type = sprokit::process::type_t("orphan");
+  static sprokit::process::name_t const name = sprokit::process::name_t("name");
+
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+  sprokit::process_t const proc = reg->create_process(type, name);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>();
+
+  pipe->add_process(proc);
+  pipe->setup_pipeline();
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  // The upper bound used to never end the range loop.
+  conf->set_value(sprokit::scheduler::config_cpus, "0-4294967295");
+
+  EXPECT_EXCEPTION(sprokit::bad_configuration_cast_exception,
+                   boost::make_shared<null_scheduler>(pipe, conf),
+                   "creating a scheduler with a processor beyond the limit");
+}
+
+IMPLEMENT_TEST(malformed_process_cpus)
+{
+  sprokit::load_known_modules();
+
+  static sprokit::process::type_t const type = sprokit::process::type_t("orphan");
+  static sprokit::process::name_t const name = sprokit::process::name_t("name");
+
+  sprokit::config_t const proc_conf = sprokit::config::empty_config();
+
+  proc_conf->set_value(sprokit::process::config_placement + sprokit::config::block_sep + sprokit::scheduler::config_cpus, "0,a");
+
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+  sprokit::process_t const proc = reg->create_process(type, name, proc_conf);
+
+  sprokit::pipeline_t const pipe = boost::make_shared<sprokit::pipeline>();
+
+  pipe->add_process(proc);
+  pipe->setup_pipeline();
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  EXPECT_EXCEPTION(sprokit::bad_configuration_cast_exception,
+                   boost::make_shared<null_scheduler>(pipe, conf),
+                   "creating a scheduler with a malformed processor list for a process");
+}
+
 sprokit::scheduler_t
 create_scheduler(sprokit::scheduler_registry::type_t const& type)
 {
@@ -0,0 +1,196 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <test_common.h>
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/modules.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/process_registry.h>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+
+#include <string>
+#include <vector>
+
+#define TEST_ARGS ()
+
+DECLARE_TEST_MAP();
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(1);
+
+  testname_t const testname = argv[1];
+
+  RUN_TEST(testname);
+}
+
+static sprokit::process_t create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config = sprokit::config::empty_config());
+static sprokit::pipeline_t create_pipeline();
+static sprokit::pipeline_t create_layered_pipeline(size_t width, size_t layers);
+static sprokit::pipeline::setup_duration_t best_setup_time(size_t width, size_t layers);
+
+TEST_PROPERTY(LABELS, timing)
+IMPLEMENT_TEST(setup_scaling)
+{
+  size_t const width = 8;
+  size_t const small_layers = 25;
+  size_t const scale = 8;
+
+  sprokit::pipeline::setup_duration_t const small_time = best_setup_time(width, small_layers);
+  sprokit::pipeline::setup_duration_t const large_time = best_setup_time(width, small_layers * scale);
+
+  // Allow for overhead and noise, but catch setup going quadratic (which
+  // would be a factor of 64).
+  sprokit::pipeline::setup_duration_t const limit = small_time * scale * 4;
+
+  if (limit < large_time)
+  {
+    TEST_ERROR("Setting up a pipeline " << scale << " times larger took "
+               << large_time << " ns rather than " << small_time << " ns");
+  }
+}
+
+sprokit::process_t
+create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config)
+{
+  static bool const modules_loaded = (sprokit::load_known_modules(), true);
+  static sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  (void)modules_loaded;
+
+  return reg->create_process(type, name, config);
+}
+
+sprokit::pipeline_t
+create_layered_pipeline(size_t width, size_t layers)
+{
+  sprokit::process::type_t const source_type = sprokit::process::type_t("numbers");
+  sprokit::process::type_t const node_type = sprokit::process::type_t("multiplication");
+  sprokit::process::type_t const sink_type = sprokit::process::type_t("sink");
+
+  sprokit::process::port_t const source_port = sprokit::process::port_t("number");
+  sprokit::process::port_t const factor1_port = sprokit::process::port_t("factor1");
+  sprokit::process::port_t const factor2_port = sprokit::process::port_t("factor2");
+  sprokit::process::port_t const product_port = sprokit::process::port_t("product");
+  sprokit::process::port_t const sink_port = sprokit::process::port_t("sink");
+
+  sprokit::pipeline_t const pipeline = create_pipeline();
+
+  std::vector<sprokit::process::name_t> prev;
+
+  for (size_t i = 0; i < width; ++i)
+  {
+    sprokit::process::name_t const name = "source" + boost::lexical_cast<std::string>(i);
+
+    pipeline->add_process(create_process(source_type, name));
+    prev.push_back(name);
+  }
+
+  sprokit::process::port_t prev_port = source_port;
+
+  // Each node multiplies two neighbors from the previous layer, so every
+  // output fans out to two nodes.
+  for (size_t l = 0; l < layers; ++l)
+  {
+    std::vector<sprokit::process::name_t> cur;
+
+    for (size_t i = 0; i < width; ++i)
+    {
+      sprokit::process::name_t const name = "node" + boost::lexical_cast<std::string>(l) +
+                                            "_" + boost::lexical_cast<std::string>(i);
+
+      pipeline->add_process(create_process(node_type, name));
+
+      pipeline->connect(prev[i], prev_port,
+                        name, factor1_port);
+      pipeline->connect(prev[(i + 1) % width], prev_port,
+                        name, factor2_port);
+
+      cur.push_back(name);
+    }
+
+    prev.swap(cur);
+    prev_port = product_port;
+  }
+
+  for (size_t i = 0; i < width; ++i)
+  {
+    sprokit::process::name_t const name = "sink" + boost::lexical_cast<std::string>(i);
+
+    pipeline->add_process(create_process(sink_type, name));
+
+    pipeline->connect(prev[i], prev_port,
+                      name, sink_port);
+  }
+
+  return pipeline;
+}
+
+sprokit::pipeline::setup_duration_t
+best_setup_time(size_t width, size_t layers)
+{
+  size_t const runs = 3;
+
+  sprokit::pipeline::setup_duration_t best = 0;
+
+  for (size_t i = 0; i < runs; ++i)
+  {
+    sprokit::pipeline_t const pipeline = create_layered_pipeline(width, layers);
+
+    pipeline->setup_pipeline();
+
+    sprokit::pipeline::setup_timings_t const timings = pipeline->setup_timings();
+    sprokit::pipeline::setup_duration_t total = 0;
+
+    BOOST_FOREACH (sprokit::pipeline::setup_timing_t const& timing, timings)
+    {
+      total += timing.second;
+    }
+
+    if (!i || (total < best))
+    {
+      best = total;
+    }
+  }
+
+  return best;
+}
+
+sprokit::pipeline_t
+create_pipeline()
+{
+  return boost::make_shared<sprokit::pipeline>();
+}
@@ -154,3 +154,105 @@ IMPLEMENT_TEST(increment)
     TEST_ERROR("A stamp with step 2 stepped thrice is not equal than than a stamp with step 3 after two steps");
   }
 }
+
+IMPLEMENT_TEST(origin_null)
+{
+  sprokit::stamp::origin_t const origin = sprokit::stamp::now();
+
+  EXPECT_EXCEPTION(std::runtime_error,
+                   sprokit::stamp::origin_stamp(sprokit::stamp_t(), origin),
+                   "giving a NULL stamp an origin");
+}
+
+IMPLEMENT_TEST(origin)
+{
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  if (stamp->has_origin())
+  {
+    TEST_ERROR("A new stamp has an origin");
+  }
+
+  sprokit::stamp::origin_t const origin = sprokit::stamp::now();
+
+  sprokit::stamp_t const ostamp = sprokit::stamp::origin_stamp(stamp, origin);
+
+  if (!ostamp->has_origin())
+  {
+    TEST_ERROR("A stamp given an origin does not have one");
+  }
+
+  if (ostamp->origin() != origin)
+  {
+    TEST_ERROR("A stamp given an origin has a different origin");
+  }
+
+  if (*ostamp != *stamp)
+  {
+    TEST_ERROR("Giving a stamp an origin changed its value");
+  }
+
+  sprokit::stamp_t const istamp = sprokit::stamp::incremented_stamp(ostamp);
+
+  if (istamp->has_origin())
+  {
+    TEST_ERROR("An incremented stamp kept the origin of the original stamp");
+  }
+}
+
+IMPLEMENT_TEST(stream)
+{
+  sprokit::stamp::increment_t const inc = sprokit::stamp::increment_t(1);
+  sprokit::stamp::stream_t const stream = sprokit::stamp::stream_t(3);
+
+  sprokit::stamp_t const stamp = sprokit::stamp::new_stamp(inc);
+
+  if (stamp->stream() != sprokit::stamp::default_stream)
+  {
+    TEST_ERROR("A new stamp is not in the default stream");
+  }
+
+  sprokit::stamp::origin_t const origin = sprokit::stamp::now();
+
+  sprokit::stamp_t const ostamp = sprokit::stamp::origin_stamp(stamp, origin);
+  sprokit::stamp_t const sstamp = sprokit::stamp::stream_stamp(ostamp, stream);
+
+  if (sstamp->stream() != stream)
+  {
+    TEST_ERROR("A stamp moved to a stream is in a different stream");
+  }
+
+  if (!sstamp->has_origin() || (sstamp->origin() != origin))
+  {
+    TEST_ERROR("Moving a stamp to a stream lost its origin");
+  }
+
+  if (*sstamp == *stamp)
+  {
+    TEST_ERROR("Stamps in different streams are equal");
+  }
+
+  if (!(*stamp < *sstamp))
+  {
+    TEST_ERROR("Stamps are not ordered by stream first");
+  }
+
+  sprokit::stamp_t const istamp = sprokit::stamp::incremented_stamp(sstamp);
+
+  if (istamp->stream() != stream)
+  {
+    TEST_ERROR("An incremented stamp left its stream");
+  }
+
+  if (*istamp < *sstamp)
+  {
+    TEST_ERROR("An incremented stamp is earlier in its stream");
+  }
+
+  if (*istamp < *stamp)
+  {
+    TEST_ERROR("A stamp in a later stream is less than one in the default stream");
+  }
+}
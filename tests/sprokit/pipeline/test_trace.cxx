@@ -0,0 +1,203 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <test_common.h>
+
+#include <sprokit/pipeline/trace.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <sstream>
+#include <string>
+
+#define TEST_ARGS ()
+
+DECLARE_TEST_MAP();
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(1);
+
+  testname_t const testname = argv[1];
+
+  RUN_TEST(testname);
+}
+
+static std::string chrome_trace();
+static bool contains(std::string const& haystack, std::string const& needle);
+
+IMPLEMENT_TEST(disabled)
+{
+  {
+    sprokit::trace::scope const sc("category", "event");
+
+    (void)sc;
+  }
+
+  std::string const output = chrome_trace();
+
+  if (contains(output, "\"event\""))
+  {
+    TEST_ERROR("An event was recorded while tracing was disabled");
+  }
+}
+
+IMPLEMENT_TEST(scope)
+{
+  sprokit::trace::enable();
+  sprokit::trace::name_thread("test_thread");
+
+  {
+    sprokit::trace::scope const sc("category", "event");
+
+    (void)sc;
+  }
+
+  std::string const output = chrome_trace();
+
+  if (!contains(output, "\"ph\":\"X\""))
+  {
+    TEST_ERROR("A complete event was not written");
+  }
+
+  if (!contains(output, "\"cat\":\"category\",\"name\":\"event\""))
+  {
+    TEST_ERROR("The event was not written with its category and name");
+  }
+
+  if (!contains(output, "\"args\":{\"name\":\"test_thread\"}"))
+  {
+    TEST_ERROR("The thread name was not written");
+  }
+}
+
+IMPLEMENT_TEST(ring_wraps)
+{
+  sprokit::trace::enable(2);
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    std::string const name = "event" + boost::lexical_cast<std::string>(i);
+    sprokit::trace::label_t const label = sprokit::trace::intern(name);
+
+    sprokit::trace::scope const sc("category", label);
+
+    (void)sc;
+  }
+
+  std::string const output = chrome_trace();
+
+  if (contains(output, "\"event2\""))
+  {
+    TEST_ERROR("An event which should have been overwritten was written");
+  }
+
+  if (!contains(output, "\"event3\"") ||
+      !contains(output, "\"event4\""))
+  {
+    TEST_ERROR("The newest events were not written");
+  }
+}
+
+IMPLEMENT_TEST(escape)
+{
+  sprokit::trace::enable();
+
+  {
+    sprokit::trace::scope const sc("category", "an \"event\"\\");
+
+    (void)sc;
+  }
+
+  std::string const output = chrome_trace();
+
+  if (!contains(output, "\"an \\\"event\\\"\\\\\""))
+  {
+    TEST_ERROR("The event name was not escaped");
+  }
+}
+
+IMPLEMENT_TEST(stream_state)
+{
+  sprokit::trace::enable();
+
+  {
+    sprokit::trace::scope const sc("category", "event");
+
+    (void)sc;
+  }
+
+  std::ostringstream sstr;
+
+  sstr.fill('*');
+
+  sprokit::trace::write_chrome_trace(sstr);
+
+  if (sstr.fill() != '*')
+  {
+    TEST_ERROR("Writing a trace changed the fill character of the stream");
+  }
+}
+
+IMPLEMENT_TEST(disable)
+{
+  sprokit::trace::enable();
+  sprokit::trace::enable();
+  sprokit::trace::disable();
+
+  if (sprokit::trace::enabled())
+  {
+    TEST_ERROR("Tracing was still enabled after being disabled");
+  }
+
+  sprokit::trace::enable();
+
+  if (!sprokit::trace::enabled())
+  {
+    TEST_ERROR("Tracing was not enabled after being re-enabled");
+  }
+}
+
+std::string
+chrome_trace()
+{
+  std::ostringstream sstr;
+
+  sprokit::trace::write_chrome_trace(sstr);
+
+  return sstr.str();
+}
+
+bool
+contains(std::string const& haystack, std::string const& needle)
+{
+  return (haystack.find(needle) != std::string::npos);
+}
@@ -182,6 +182,33 @@ IMPLEMENT_TEST(one_process)
   v.expect(0, 1, 0, 0);
 }
 
+IMPLEMENT_TEST(process_node)
+{
+  sprokit::pipe_blocks const blocks = sprokit::load_pipe_blocks_from_file(pipe_file);
+
+  test_visitor v;
+
+  std::for_each(blocks.begin(), blocks.end(), boost::apply_visitor(v));
+
+  v.expect(0, 1, 0, 0);
+
+  sprokit::process_pipe_block const& block = boost::get<sprokit::process_pipe_block>(blocks[0]);
+
+  if (!block.node)
+  {
+    TEST_ERROR("The node of the process was not parsed");
+  }
+  else if (*block.node != "mynode")
+  {
+    TEST_ERROR("The node of the process was not parsed correctly");
+  }
+
+  if (block.config_values.size() != 1)
+  {
+    TEST_ERROR("The configuration after the node was not parsed");
+  }
+}
+
 IMPLEMENT_TEST(connected_processes)
 {
   sprokit::pipe_blocks const blocks = sprokit::load_pipe_blocks_from_file(pipe_file);
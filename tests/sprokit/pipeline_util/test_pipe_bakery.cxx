@@ -42,11 +42,15 @@
 #include <sprokit/pipeline/scheduler.h>
 #include <sprokit/pipeline/scheduler_registry.h>
 
+#include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/optional.hpp>
 
 #include <exception>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -1075,6 +1079,124 @@ IMPLEMENT_TEST(cluster_override_mapped)
                    "manually setting a parameter which is mapped in a cluster");
 }
 
+class partition_summary
+  : public boost::static_visitor<>
+{
+  public:
+    void operator () (sprokit::config_pipe_block const& config_block);
+    void operator () (sprokit::process_pipe_block const& process_block);
+    void operator () (sprokit::connect_pipe_block const& connect_block);
+
+    void expect_process(sprokit::process::name_t const& name, sprokit::process::type_t const& type) const;
+    void expect_address(sprokit::process::name_t const& name, sprokit::config::value_t const& address) const;
+    void expect_type(sprokit::process::name_t const& name, sprokit::config::value_t const& type) const;
+    void expect_connection(std::string const& from, std::string const& to) const;
+
+    typedef std::map<sprokit::process::name_t, sprokit::process_pipe_block> process_map_t;
+    typedef std::set<std::string> connections_t;
+
+    process_map_t processes;
+    connections_t connections;
+  private:
+    boost::optional<sprokit::config::value_t> config_value(sprokit::process::name_t const& name, sprokit::config::key_t const& key) const;
+};
+
+static void check_partition_node(sprokit::pipe_blocks const& blocks, sprokit::node_t const& node);
+
+IMPLEMENT_TEST(partition_nodes)
+{
+  sprokit::pipe_blocks const blocks = sprokit::load_pipe_blocks_from_file(pipe_file);
+
+  {
+    partition_summary summary;
+
+    sprokit::pipe_blocks const node_blocks = sprokit::partition_pipe_blocks(blocks, "a");
+
+    std::for_each(node_blocks.begin(), node_blocks.end(), boost::apply_visitor(summary));
+
+    if (summary.processes.size() != 5)
+    {
+      TEST_ERROR("The \'a\' node has " << summary.processes.size() << " processes rather than 5");
+    }
+
+    summary.expect_process("source", "replay");
+    summary.expect_process("tap", "tap");
+    summary.expect_process("sink", "sink");
+    summary.expect_process("_send_0", "socket_output");
+    summary.expect_process("_recv_1", "socket_input");
+
+    summary.expect_address("_send_0", "tcp:127.0.0.1:7000");
+    summary.expect_address("_recv_1", "unix:/tmp/sprokit_partition.1");
+
+    summary.expect_type("_recv_1", "integer");
+
+    summary.expect_connection("source.replay", "_send_0.send");
+    summary.expect_connection("_recv_1.receive", "tap.tap");
+    summary.expect_connection("tap.tap", "sink.sink");
+
+    if (summary.processes["source"].node)
+    {
+      TEST_ERROR("The node was not removed from a partitioned process");
+    }
+
+    check_partition_node(node_blocks, "a");
+  }
+
+  {
+    partition_summary summary;
+
+    sprokit::pipe_blocks const node_blocks = sprokit::partition_pipe_blocks(blocks, "b");
+
+    std::for_each(node_blocks.begin(), node_blocks.end(), boost::apply_visitor(summary));
+
+    if (summary.processes.size() != 3)
+    {
+      TEST_ERROR("The \'b\' node has " << summary.processes.size() << " processes rather than 3");
+    }
+
+    summary.expect_process("pass", "pass");
+    summary.expect_process("_recv_0", "socket_input");
+    summary.expect_process("_send_1", "socket_output");
+
+    summary.expect_address("_recv_0", "tcp:127.0.0.1:7000");
+    summary.expect_address("_send_1", "unix:/tmp/sprokit_partition.1");
+
+    summary.expect_type("_recv_0", "integer");
+
+    summary.expect_connection("_recv_0.receive", "pass.pass");
+    summary.expect_connection("pass.pass", "_send_1.send");
+
+    check_partition_node(node_blocks, "b");
+  }
+}
+
+IMPLEMENT_TEST(partition_unassigned)
+{
+  sprokit::pipe_blocks const blocks = sprokit::load_pipe_blocks_from_file(pipe_file);
+
+  EXPECT_EXCEPTION(sprokit::unassigned_process_exception,
+                   sprokit::partition_pipe_blocks(blocks, "a"),
+                   "partitioning a pipeline with a process without a node");
+}
+
+IMPLEMENT_TEST(partition_missing_address)
+{
+  sprokit::pipe_blocks const blocks = sprokit::load_pipe_blocks_from_file(pipe_file);
+
+  EXPECT_EXCEPTION(sprokit::missing_node_address_exception,
+                   sprokit::partition_pipe_blocks(blocks, "a"),
+                   "partitioning a pipeline with a receiving node without an address");
+}
+
+IMPLEMENT_TEST(partition_invalid_address)
+{
+  sprokit::pipe_blocks const blocks = sprokit::load_pipe_blocks_from_file(pipe_file);
+
+  EXPECT_EXCEPTION(sprokit::invalid_node_address_exception,
+                   sprokit::partition_pipe_blocks(blocks, "a"),
+                   "partitioning a pipeline with a malformed node address");
+}
+
 static sprokit::process_t create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config = sprokit::config::empty_config());
 static sprokit::pipeline_t create_pipeline();
 
@@ -1215,3 +1337,131 @@ setup_map_config_cluster(sprokit::process::name_t const& name, sprokit::path_t c
 
   return cluster;
 }
+
+void
+partition_summary
+::operator () (sprokit::config_pipe_block const& /*config_block*/)
+{
+}
+
+void
+partition_summary
+::operator () (sprokit::process_pipe_block const& process_block)
+{
+  processes[process_block.name] = process_block;
+}
+
+void
+partition_summary
+::operator () (sprokit::connect_pipe_block const& connect_block)
+{
+  sprokit::process::port_addr_t const& from = connect_block.from;
+  sprokit::process::port_addr_t const& to = connect_block.to;
+
+  connections.insert(from.first + "." + from.second + " -> " + to.first + "." + to.second);
+}
+
+void
+partition_summary
+::expect_process(sprokit::process::name_t const& name, sprokit::process::type_t const& type) const
+{
+  process_map_t::const_iterator const i = processes.find(name);
+
+  if (i == processes.end())
+  {
+    TEST_ERROR("The \'" << name << "\' process is missing");
+
+    return;
+  }
+
+  if (i->second.type != type)
+  {
+    TEST_ERROR("The \'" << name << "\' process has the type "
+               "\'" << i->second.type << "\' rather than \'" << type << "\'");
+  }
+}
+
+void
+partition_summary
+::expect_address(sprokit::process::name_t const& name, sprokit::config::value_t const& address) const
+{
+  process_map_t::const_iterator const i = processes.find(name);
+
+  if (i == processes.end())
+  {
+    return;
+  }
+
+  boost::optional<sprokit::config::value_t> const value = config_value(name, "address");
+
+  if (!value || (*value != address))
+  {
+    TEST_ERROR("The \'" << name << "\' process does not use the "
+               "\'" << address << "\' address");
+  }
+}
+
+void
+partition_summary
+::expect_type(sprokit::process::name_t const& name, sprokit::config::value_t const& type) const
+{
+  boost::optional<sprokit::config::value_t> const value = config_value(name, "type");
+
+  if (type.empty() && value)
+  {
+    TEST_ERROR("The \'" << name << "\' process was given the "
+               "\'" << *value << "\' type");
+  }
+  else if (!type.empty() && (!value || (*value != type)))
+  {
+    TEST_ERROR("The \'" << name << "\' process does not use the "
+               "\'" << type << "\' type");
+  }
+}
+
+void
+partition_summary
+::expect_connection(std::string const& from, std::string const& to) const
+{
+  if (!connections.count(from + " -> " + to))
+  {
+    TEST_ERROR("The connection from \'" << from << "\' "
+               "to \'" << to << "\' is missing");
+  }
+}
+
+boost::optional<sprokit::config::value_t>
+partition_summary
+::config_value(sprokit::process::name_t const& name, sprokit::config::key_t const& key) const
+{
+  process_map_t::const_iterator const i = processes.find(name);
+
+  if (i == processes.end())
+  {
+    return boost::none;
+  }
+
+  BOOST_FOREACH (sprokit::config_value_t const& value, i->second.config_values)
+  {
+    sprokit::config::keys_t const& key_path = value.key.key_path;
+
+    if ((key_path.size() == 1) && (key_path[0] == key))
+    {
+      return value.value;
+    }
+  }
+
+  return boost::none;
+}
+
+void
+check_partition_node(sprokit::pipe_blocks const& blocks, sprokit::node_t const& node)
+{
+  sprokit::config_t const conf = sprokit::extract_configuration(blocks);
+  sprokit::config::key_t const node_key = sprokit::config::key_t("_pipeline:_node");
+
+  if (conf->get_value<sprokit::config::value_t>(node_key, "") != node)
+  {
+    TEST_ERROR("The \'" << node << "\' partition is not marked with its node");
+  }
+}
@@ -0,0 +1,178 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <test_common.h>
+
+#include <sprokit/pipeline_util/load_pipe_exception.h>
+#include <sprokit/pipeline_util/path.h>
+
+#include <sprokit/pipeline/modules.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/process_cluster.h>
+#include <sprokit/pipeline/process_registry.h>
+#include <sprokit/pipeline/process_registry_exception.h>
+
+#include <boost/pointer_cast.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include <cstdlib>
+
+#define TEST_ARGS (sprokit::path_t const& cluster_dir)
+
+DECLARE_TEST_MAP();
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(2);
+
+  testname_t const testname = argv[1];
+  sprokit::path_t const cluster_dir = argv[2];
+
+  RUN_TEST(testname, cluster_dir);
+}
+
+static void load_clusters(sprokit::path_t const& cluster_dir, char const* bake);
+static bool is_registered(sprokit::process::type_t const& type);
+static void check_cluster(sprokit::process::type_t const& type);
+
+static sprokit::process::type_t const lazy_type = sprokit::process::type_t("test_lazy_multiplier");
+static sprokit::process::type_t const eager_type = sprokit::process::type_t("test_eager_multiplier");
+static sprokit::process::type_t const malformed_type = sprokit::process::type_t("test_malformed_cluster");
+
+IMPLEMENT_TEST(lazy)
+{
+  load_clusters(cluster_dir, NULL);
+
+  check_cluster(lazy_type);
+  check_cluster(eager_type);
+
+  // The type is known from the header alone, so a broken file is only found
+  // when it is used.
+  if (!is_registered(malformed_type))
+  {
+    TEST_ERROR("A cluster with a valid header was not registered");
+  }
+
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  EXPECT_EXCEPTION(sprokit::load_pipe_exception,
+                   reg->create_process(malformed_type, sprokit::process::name_t("malformed")),
+                   "creating a cluster which does not parse");
+
+  // Failures are not cached as successes.
+  EXPECT_EXCEPTION(sprokit::load_pipe_exception,
+                   reg->create_process(malformed_type, sprokit::process::name_t("malformed")),
+                   "creating a cluster which does not parse again");
+}
+
+IMPLEMENT_TEST(eager)
+{
+  load_clusters(cluster_dir, "eager");
+
+  check_cluster(lazy_type);
+  check_cluster(eager_type);
+
+  if (is_registered(malformed_type))
+  {
+    TEST_ERROR("A cluster which does not parse was registered");
+  }
+}
+
+IMPLEMENT_TEST(parallel)
+{
+  load_clusters(cluster_dir, "parallel");
+
+  check_cluster(lazy_type);
+  check_cluster(eager_type);
+
+  if (is_registered(malformed_type))
+  {
+    TEST_ERROR("A cluster which does not parse was registered");
+  }
+}
+
+void
+load_clusters(sprokit::path_t const& cluster_dir, char const* bake)
+{
+  setenv("SPROKIT_CLUSTER_PATH", cluster_dir.string<std::string>().c_str(), 1);
+
+  if (bake)
+  {
+    setenv("SPROKIT_CLUSTER_BAKE", bake, 1);
+  }
+  else
+  {
+    unsetenv("SPROKIT_CLUSTER_BAKE");
+  }
+
+  sprokit::load_known_modules();
+}
+
+bool
+is_registered(sprokit::process::type_t const& type)
+{
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  sprokit::process::types_t const types = reg->types();
+
+  return (std::find(types.begin(), types.end(), type) != types.end());
+}
+
+void
+check_cluster(sprokit::process::type_t const& type)
+{
+  if (!is_registered(type))
+  {
+    TEST_ERROR("The cluster type " << type << " was not registered");
+
+    return;
+  }
+
+  sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  // The second creation uses the already baked cluster.
+  for (size_t i = 0; i < 2; ++i)
+  {
+    sprokit::process_t const proc = reg->create_process(type, sprokit::process::name_t("cluster"));
+
+    if (!boost::dynamic_pointer_cast<sprokit::process_cluster>(proc))
+    {
+      TEST_ERROR("The " << type << " type did not create a cluster");
+    }
+
+    if (proc->type() != type)
+    {
+      TEST_ERROR("The cluster has the wrong type: " << proc->type());
+    }
+  }
+}
@@ -0,0 +1,1042 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <test_common.h>
+
+#include <sprokit/pipeline/config.h>
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/modules.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/process.h>
+#include <sprokit/pipeline/process_exception.h>
+#include <sprokit/pipeline/process_registry.h>
+#include <sprokit/pipeline/record.h>
+#include <sprokit/pipeline/scheduler.h>
+#include <sprokit/pipeline/scheduler_registry.h>
+#include <sprokit/pipeline/stamp.h>
+
+#include <boost/cstdint.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/function.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <csignal>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_ARGS ()
+
+DECLARE_TEST_MAP();
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(1);
+
+  testname_t const testname = argv[1];
+
+  RUN_TEST(testname);
+}
+
+typedef boost::function<sprokit::pipeline_t ()> pipeline_factory_t;
+
+static sprokit::process_t create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config = sprokit::config::empty_config());
+static sprokit::scheduler_t start_pipeline(sprokit::pipeline_t const& pipeline);
+static void run_pipeline(sprokit::pipeline_t const& pipeline);
+static pid_t run_in_child(pipeline_factory_t const& factory);
+static bool wait_for_child(pid_t pid, int& status, unsigned seconds);
+static void check_numbers(std::string const& path, int32_t start, int32_t end);
+
+static std::string unique_segment(std::string const& test);
+static sprokit::pipeline_t shm_writer_pipeline(std::string const& segment, int32_t start, int32_t end);
+static sprokit::pipeline_t shm_reader_pipeline(std::string const& segment, std::string const& output);
+static void run_shm_pipelines(std::string const& segment, int32_t start, int32_t end, std::string const& output);
+static sprokit::config_t shm_config(std::string const& segment);
+static sprokit::config_t numbers_config(int32_t start, int32_t end);
+
+typedef std::vector<std::string> records_t;
+
+static records_t make_records(size_t count, size_t record_size);
+static std::string record_file(records_t const& records, size_t record_size);
+static void write_file(std::string const& path, std::string const& bytes);
+static std::string read_file(std::string const& path);
+static sprokit::pipeline_t record_pipeline(std::string const& input, size_t record_size, sprokit::config_t const& sink_config);
+static sprokit::config_t record_sink_config(std::string const& output, size_t record_size);
+static void check_record_copy(std::string const& test, sprokit::config_t const& sink_config);
+static void push_record(sprokit::edge_t const& edge, sprokit::stamp_t& stamp, std::string const& bytes);
+static void push_datum(sprokit::edge_t const& edge, sprokit::stamp_t& stamp, sprokit::datum_t const& dat);
+static sprokit::pipeline_t tap_pipeline(std::string const& path);
+static sprokit::pipeline_t socket_output_pipeline(std::string const& address, std::string const& connect_timeout);
+static sprokit::pipeline_t replay_pipeline(std::string const& path, std::string const& timing, std::string const& output);
+
+static size_t const shm_capacity = 256;
+
+IMPLEMENT_TEST(shm_pipeline)
+{
+  std::string const segment = unique_segment("shm_pipeline");
+  std::string const output_path = "test-transport-shm_pipeline-print_number.txt";
+
+  int32_t const start_value = 1;
+  int32_t const end_value = 200;
+
+  // The ring is much smaller than the data, so it wraps around many times.
+  run_shm_pipelines(segment, start_value, end_value, output_path);
+
+  check_numbers(output_path, start_value, end_value);
+}
+
+TEST_PROPERTY(TIMEOUT, 30)
+IMPLEMENT_TEST(shm_processes)
+{
+  std::string const segment = unique_segment("shm_processes");
+  std::string const output_path = "test-transport-shm_processes-print_number.txt";
+
+  int32_t const start_value = 1;
+  int32_t const end_value = 200;
+
+  pid_t const writer = run_in_child(boost::bind(&shm_writer_pipeline, segment, start_value, end_value));
+
+  run_pipeline(shm_reader_pipeline(segment, output_path));
+
+  int status;
+
+  if (!wait_for_child(writer, status, 10))
+  {
+    TEST_ERROR("The writer did not exit");
+  }
+  else if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+  {
+    TEST_ERROR("The writer failed");
+  }
+
+  check_numbers(output_path, start_value, end_value);
+}
+
+TEST_PROPERTY(TIMEOUT, 30)
+IMPLEMENT_TEST(shm_stale_segment)
+{
+  std::string const segment = unique_segment("shm_stale_segment");
+  std::string const output_path = "test-transport-shm_stale_segment-print_number.txt";
+
+  int32_t const start_value = 1;
+  int32_t const end_value = 20;
+
+  // Leave a full ring behind from a writer which never finishes.
+  pid_t const writer = run_in_child(boost::bind(&shm_writer_pipeline, segment, 1000, 1000000));
+
+  usleep(500 * 1000);
+
+  kill(writer, SIGKILL);
+
+  int status;
+
+  wait_for_child(writer, status, 10);
+
+  run_shm_pipelines(segment, start_value, end_value, output_path);
+
+  // Nothing from the earlier writer may show up.
+  check_numbers(output_path, start_value, end_value);
+}
+
+TEST_PROPERTY(TIMEOUT, 30)
+IMPLEMENT_TEST(shm_writer_exits)
+{
+  std::string const segment = unique_segment("shm_writer_exits");
+
+  pid_t const writer = run_in_child(boost::bind(&shm_writer_pipeline, segment, 1, 100000000));
+  pid_t const reader = run_in_child(boost::bind(&shm_reader_pipeline, segment, std::string()));
+
+  usleep(500 * 1000);
+
+  kill(writer, SIGKILL);
+
+  int status;
+
+  wait_for_child(writer, status, 10);
+
+  if (!wait_for_child(reader, status, 10))
+  {
+    TEST_ERROR("The reader kept waiting on a writer which exited");
+
+    kill(reader, SIGKILL);
+    wait_for_child(reader, status, 10);
+  }
+  else if (WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS))
+  {
+    TEST_ERROR("The reader succeeded without the end of the data");
+  }
+
+  shm_unlink(segment.c_str());
+}
+
+IMPLEMENT_TEST(tap_replay)
+{
+  std::string const recording_path = "test-transport-tap_replay.rec";
+  std::string const output_path = "test-transport-tap_replay-print_number.txt";
+
+  int32_t const start_value = 1;
+  int32_t const end_value = 100;
+
+  {
+    sprokit::pipeline_t const pipeline = tap_pipeline(recording_path);
+
+    pipeline->add_process(create_process("numbers", "source", numbers_config(start_value, end_value)));
+
+    pipeline->connect("source", "number",
+                      "tap", "tap");
+
+    run_pipeline(pipeline);
+  }
+
+  run_pipeline(replay_pipeline(recording_path, "fast", output_path));
+
+  check_numbers(output_path, start_value, end_value);
+}
+
+IMPLEMENT_TEST(tap_replay_streams)
+{
+  std::string const recording_path = "test-transport-tap_replay_streams.rec";
+
+  sprokit::stamp::stream_t const other_stream = sprokit::stamp::stream_t(3);
+
+  // Data from two streams, the end of one of them, and then the end of the
+  // default stream.
+  size_t const count = 5;
+  int32_t const values[count] = { 1, 2, 3, 4, 0 };
+  sprokit::stamp::stream_t const streams[count] = { sprokit::stamp::default_stream, other_stream, other_stream,
+                                                    sprokit::stamp::default_stream, sprokit::stamp::default_stream };
+  bool const completes[count] = { false, false, true, false, true };
+
+  {
+    sprokit::pipeline_t const pipeline = tap_pipeline(recording_path);
+
+    pipeline->add_process(create_process("numbers", "source", numbers_config(0, 1)));
+
+    pipeline->connect("source", "number",
+                      "tap", "tap");
+
+    pipeline->setup_pipeline();
+
+    sprokit::process_t const tap = pipeline->process_by_name("tap");
+    sprokit::edge_t const edge = pipeline->edge_for_connection("source", "number",
+                                                               "tap", "tap");
+
+    sprokit::stamp_t stamp = sprokit::stamp::new_stamp(1);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      sprokit::datum_t const dat = (completes[i] ? sprokit::datum::complete_datum() : sprokit::datum::new_datum(values[i]));
+
+      edge->push_datum(sprokit::edge_datum_t(dat, sprokit::stamp::stream_stamp(stamp, streams[i])));
+      stamp = sprokit::stamp::incremented_stamp(stamp);
+
+      tap->step();
+    }
+  }
+
+  sprokit::pipeline_t const pipeline = replay_pipeline(recording_path, "fast", std::string());
+
+  pipeline->setup_pipeline();
+
+  sprokit::process_t const replay = pipeline->process_by_name("replay");
+  sprokit::edge_t const edge = pipeline->edge_for_connection("replay", "replay",
+                                                             "sink", "sink");
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    replay->step();
+  }
+
+  if (edge->datum_count() != count)
+  {
+    TEST_ERROR("Did not replay every recorded datum: " << edge->datum_count() << " of " << count);
+
+    return;
+  }
+
+  sprokit::stamp_t last_stamps[2];
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    sprokit::edge_datum_t const edat = edge->peek_datum(i);
+    sprokit::datum_t const& dat = edat.datum;
+    sprokit::stamp_t const& st = edat.stamp;
+
+    if (st->stream() != streams[i])
+    {
+      TEST_ERROR("Datum " << i << " was replayed in stream " << st->stream() << " "
+                 "rather than " << streams[i]);
+    }
+
+    if (completes[i])
+    {
+      if (dat->type() != sprokit::datum::complete)
+      {
+        TEST_ERROR("Datum " << i << " was not replayed as the end of its stream");
+      }
+    }
+    else if (dat->type() != sprokit::datum::data)
+    {
+      TEST_ERROR("Datum " << i << " was not replayed as data");
+    }
+    else if (dat->get_datum<int32_t>() != values[i])
+    {
+      TEST_ERROR("Datum " << i << " has the wrong payload: "
+                 "Expected: " << values[i] << " "
+                 "Received: " << dat->get_datum<int32_t>());
+    }
+
+    // Stamps still increase within each stream.
+    sprokit::stamp_t& last = last_stamps[(streams[i] == sprokit::stamp::default_stream) ? 0 : 1];
+
+    if (last && !(*last < *st))
+    {
+      TEST_ERROR("Datum " << i << " was replayed with a stamp out of order");
+    }
+
+    last = st;
+  }
+}
+
+TEST_PROPERTY(TIMEOUT, 30)
+IMPLEMENT_TEST(tap_replay_original_timing)
+{
+  std::string const recording_path = "test-transport-tap_replay_original_timing.rec";
+
+  size_t const count = 4;
+  unsigned const gap_ms = 50;
+
+  {
+    sprokit::pipeline_t const pipeline = tap_pipeline(recording_path);
+
+    pipeline->add_process(create_process("numbers", "source", numbers_config(0, 1)));
+
+    pipeline->connect("source", "number",
+                      "tap", "tap");
+
+    pipeline->setup_pipeline();
+
+    sprokit::process_t const tap = pipeline->process_by_name("tap");
+    sprokit::edge_t const edge = pipeline->edge_for_connection("source", "number",
+                                                               "tap", "tap");
+
+    sprokit::stamp_t stamp = sprokit::stamp::new_stamp(1);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (i)
+      {
+        usleep(gap_ms * 1000);
+      }
+
+      push_datum(edge, stamp, (i + 1 < count) ? sprokit::datum::new_datum(int32_t(i)) : sprokit::datum::complete_datum());
+
+      tap->step();
+    }
+  }
+
+  sprokit::pipeline_t const pipeline = replay_pipeline(recording_path, "original", std::string());
+
+  pipeline->setup_pipeline();
+
+  sprokit::process_t const replay = pipeline->process_by_name("replay");
+  sprokit::edge_t const edge = pipeline->edge_for_connection("replay", "replay",
+                                                             "sink", "sink");
+
+  sprokit::stamp::origin_t const begin = sprokit::stamp::now();
+  sprokit::stamp::origin_t times[count];
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    replay->step();
+
+    times[i] = sprokit::stamp::now();
+  }
+
+  // Only lower bounds are checked; a loaded machine may always be late.
+  sprokit::stamp::origin_t const gap_ns = sprokit::stamp::origin_t(gap_ms) * 1000 * 1000;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (times[i] < begin + i * gap_ns)
+    {
+      TEST_ERROR("Datum " << i << " was replayed before its recorded time");
+    }
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    sprokit::datum_t const dat = edge->peek_datum(i).datum;
+
+    if ((i + 1 < count) && ((dat->type() != sprokit::datum::data) || (dat->get_datum<int32_t>() != int32_t(i))))
+    {
+      TEST_ERROR("Datum " << i << " was replayed out of order");
+    }
+  }
+}
+
+IMPLEMENT_TEST(mmap_fixed_size)
+{
+  check_record_copy("mmap_fixed_size", record_sink_config("test-transport-mmap_fixed_size.out", 16));
+}
+
+IMPLEMENT_TEST(mmap_length_prefixed)
+{
+  check_record_copy("mmap_length_prefixed", record_sink_config("test-transport-mmap_length_prefixed.out", 0));
+}
+
+IMPLEMENT_TEST(mmap_truncated_fixed_size)
+{
+  std::string const input_path = "test-transport-mmap_truncated_fixed_size.in";
+
+  std::string const bytes = record_file(make_records(10, 16), 16);
+
+  write_file(input_path, bytes.substr(0, bytes.size() - 3));
+
+  sprokit::pipeline_t const pipeline = record_pipeline(input_path, 16,
+    record_sink_config("test-transport-mmap_truncated_fixed_size.out", 16));
+
+  EXPECT_EXCEPTION(sprokit::invalid_configuration_exception,
+                   pipeline->setup_pipeline(),
+                   "reading a file which does not hold a whole number of records");
+}
+
+IMPLEMENT_TEST(mmap_truncated_length_prefixed)
+{
+  std::string const input_path = "test-transport-mmap_truncated_length_prefixed.in";
+
+  records_t const records = make_records(10, 0);
+  std::string const bytes = record_file(records, 0);
+
+  // Cut into the middle of the last record, then into its size prefix.
+  size_t const last_size = records.back().size();
+  size_t const cuts[] = { last_size / 2 + 1, last_size + 2 };
+
+  BOOST_FOREACH (size_t const cut, cuts)
+  {
+    write_file(input_path, bytes.substr(0, bytes.size() - cut));
+
+    sprokit::pipeline_t const pipeline = record_pipeline(input_path, 0,
+      record_sink_config("test-transport-mmap_truncated_length_prefixed.out", 0));
+
+    pipeline->setup_pipeline();
+
+    sprokit::process_t const source = pipeline->process_by_name("source");
+
+    // The whole records are still read.
+    for (size_t i = 0; i + 1 < records.size(); ++i)
+    {
+      source->step();
+    }
+
+    EXPECT_EXCEPTION(std::runtime_error,
+                     source->step(),
+                     "reading a truncated record");
+  }
+}
+
+IMPLEMENT_TEST(record_sink_ordering)
+{
+  // Small buffers and a short queue keep the I/O thread busy with many
+  // batches.
+  sprokit::config_t const conf = record_sink_config("test-transport-record_sink_ordering.out", 0);
+
+  conf->set_value("buffer_size", "64");
+  conf->set_value("queue_size", "2");
+
+  check_record_copy("record_sink_ordering", conf);
+}
+
+IMPLEMENT_TEST(record_sink_no_thread)
+{
+  sprokit::config_t const conf = record_sink_config("test-transport-record_sink_no_thread.out", 0);
+
+  conf->set_value("buffer_size", "64");
+  conf->set_value("queue_size", "0");
+
+  check_record_copy("record_sink_no_thread", conf);
+}
+
+IMPLEMENT_TEST(record_sink_sync_barrier)
+{
+  sprokit::config_t const conf = record_sink_config("test-transport-record_sink_sync_barrier.out", 0);
+
+  conf->set_value("buffer_size", "64");
+  conf->set_value("sync", "barrier");
+
+  check_record_copy("record_sink_sync_barrier", conf);
+}
+
+IMPLEMENT_TEST(record_sink_sync_always)
+{
+  sprokit::config_t const conf = record_sink_config("test-transport-record_sink_sync_always.out", 0);
+
+  conf->set_value("buffer_size", "64");
+  conf->set_value("sync", "always");
+
+  check_record_copy("record_sink_sync_always", conf);
+}
+
+IMPLEMENT_TEST(record_sink_barriers)
+{
+  std::string const input_path = "test-transport-record_sink_barriers.in";
+  std::string const output_path = "test-transport-record_sink_barriers.out";
+
+  write_file(input_path, record_file(make_records(1, 0), 0));
+
+  // The buffer is far larger than the records, so nothing reaches the file
+  // before a barrier.
+  sprokit::pipeline_t const pipeline = record_pipeline(input_path, 0, record_sink_config(output_path, 0));
+
+  pipeline->setup_pipeline();
+
+  sprokit::process_t const sink = pipeline->process_by_name("sink");
+  sprokit::edge_t const edge = pipeline->edge_for_connection("source", "record",
+                                                             "sink", "record");
+
+  records_t const records = make_records(10, 0);
+  records_t const first(records.begin(), records.begin() + 5);
+  sprokit::stamp_t stamp = sprokit::stamp::new_stamp(1);
+
+  BOOST_FOREACH (std::string const& rec, first)
+  {
+    push_record(edge, stamp, rec);
+    sink->step();
+  }
+
+  push_datum(edge, stamp, sprokit::datum::flush_datum());
+  sink->step();
+
+  if (read_file(output_path) != record_file(first, 0))
+  {
+    TEST_ERROR("The records before a flush were not written when it was passed");
+  }
+
+  for (records_t::const_iterator i = records.begin() + 5; i != records.end(); ++i)
+  {
+    push_record(edge, stamp, *i);
+    sink->step();
+  }
+
+  push_datum(edge, stamp, sprokit::datum::complete_datum());
+  sink->step();
+
+  if (read_file(output_path) != record_file(records, 0))
+  {
+    TEST_ERROR("The records before the end were not written when it was passed");
+  }
+}
+
+IMPLEMENT_TEST(record_sink_write_error)
+{
+  std::string const input_path = "test-transport-record_sink_write_error.in";
+
+  write_file(input_path, record_file(make_records(1, 0), 0));
+
+  sprokit::config_t const conf = record_sink_config("/dev/full", 0);
+
+  conf->set_value("buffer_size", "16");
+
+  sprokit::pipeline_t const pipeline = record_pipeline(input_path, 0, conf);
+
+  pipeline->setup_pipeline();
+
+  sprokit::process_t const sink = pipeline->process_by_name("sink");
+  sprokit::edge_t const edge = pipeline->edge_for_connection("source", "record",
+                                                             "sink", "record");
+
+  sprokit::stamp_t stamp = sprokit::stamp::new_stamp(1);
+
+  push_record(edge, stamp, std::string(64, 'x'));
+  push_datum(edge, stamp, sprokit::datum::flush_datum());
+
+  // The write fails on the I/O thread, so the error shows up at the barrier
+  // at the latest, but may already be seen by the step which queued it.
+  EXPECT_EXCEPTION(std::runtime_error,
+                   sink->step(); sink->step(),
+                   "passing a flush after a failed write");
+}
+
+TEST_PROPERTY(TIMEOUT, 30)
+IMPLEMENT_TEST(socket_connect_timeout)
+{
+  std::string const path = "test-transport-socket_connect_timeout.sock";
+
+  // Nothing ever listens on the address.
+  unlink(path.c_str());
+
+  sprokit::pipeline_t const pipeline = socket_output_pipeline("unix:" + path, "0.5");
+
+  pipeline->setup_pipeline();
+
+  sprokit::process_t const send = pipeline->process_by_name("send");
+  sprokit::edge_t const edge = pipeline->edge_for_connection("numbers", "number",
+                                                             "send", "send");
+
+  sprokit::stamp_t stamp = sprokit::stamp::new_stamp(1);
+
+  push_datum(edge, stamp, sprokit::datum::new_datum<int32_t>(0));
+
+  EXPECT_EXCEPTION(std::runtime_error,
+                   send->step(),
+                   "connecting to an address which nobody listens on");
+}
+
+IMPLEMENT_TEST(socket_negative_connect_timeout)
+{
+  sprokit::pipeline_t const pipeline = socket_output_pipeline("unix:test-transport-socket_negative_connect_timeout.sock", "-1");
+
+  EXPECT_EXCEPTION(sprokit::invalid_configuration_exception,
+                   pipeline->setup_pipeline(),
+                   "configuring a negative connect timeout");
+}
+
+sprokit::process_t
+create_process(sprokit::process::type_t const& type, sprokit::process::name_t const& name, sprokit::config_t config)
+{
+  static bool const modules_loaded = (sprokit::load_known_modules(), true);
+  static sprokit::process_registry_t const reg = sprokit::process_registry::self();
+
+  (void)modules_loaded;
+
+  return reg->create_process(type, name, config);
+}
+
+sprokit::scheduler_t
+start_pipeline(sprokit::pipeline_t const& pipeline)
+{
+  pipeline->setup_pipeline();
+
+  sprokit::scheduler_registry_t const reg = sprokit::scheduler_registry::self();
+
+  // The rings block outside of edges, so each process needs its own thread.
+  sprokit::scheduler_t const scheduler = reg->create_scheduler("thread_per_process", pipeline);
+
+  scheduler->start();
+
+  return scheduler;
+}
+
+void
+run_pipeline(sprokit::pipeline_t const& pipeline)
+{
+  start_pipeline(pipeline)->wait();
+}
+
+pid_t
+run_in_child(pipeline_factory_t const& factory)
+{
+  pid_t const pid = fork();
+
+  if (pid < 0)
+  {
+    TEST_ERROR("Failed to fork");
+  }
+  else if (!pid)
+  {
+    // Exceptions escaping the scheduler's threads abort the child, which the
+    // parent sees as a failure.
+    try
+    {
+      run_pipeline(factory());
+    }
+    catch (std::exception const& e)
+    {
+      std::cerr << "Child failed: " << e.what() << std::endl;
+
+      _exit(EXIT_FAILURE);
+    }
+
+    _exit(EXIT_SUCCESS);
+  }
+
+  return pid;
+}
+
+bool
+wait_for_child(pid_t pid, int& status, unsigned seconds)
+{
+  for (unsigned polls = 0; polls < 10 * seconds; ++polls)
+  {
+    if (waitpid(pid, &status, WNOHANG) == pid)
+    {
+      return true;
+    }
+
+    usleep(100 * 1000);
+  }
+
+  return false;
+}
+
+void
+check_numbers(std::string const& path, int32_t start, int32_t end)
+{
+  std::ifstream fin(path.c_str());
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the output file");
+
+    return;
+  }
+
+  std::string line;
+
+  for (int32_t i = start; i < end; ++i)
+  {
+    if (!std::getline(fin, line))
+    {
+      TEST_ERROR("Failed to read a line from the file");
+
+      return;
+    }
+
+    if (sprokit::config::value_t(line) != boost::lexical_cast<sprokit::config::value_t>(i))
+    {
+      TEST_ERROR("Did not get expected value: "
+                 "Expected: " << i << " "
+                 "Received: " << line);
+    }
+  }
+
+  if (std::getline(fin, line))
+  {
+    TEST_ERROR("More results than expected in the file");
+  }
+}
+
+std::string
+unique_segment(std::string const& test)
+{
+  return "/sprokit-test-transport-" + test + "-" + boost::lexical_cast<std::string>(getpid());
+}
+
+sprokit::pipeline_t
+shm_writer_pipeline(std::string const& segment, int32_t start, int32_t end)
+{
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>();
+
+  pipeline->add_process(create_process("numbers", "source", numbers_config(start, end)));
+  pipeline->add_process(create_process("shm_output", "send", shm_config(segment)));
+
+  pipeline->connect("source", "number",
+                    "send", "send");
+
+  return pipeline;
+}
+
+sprokit::pipeline_t
+shm_reader_pipeline(std::string const& segment, std::string const& output)
+{
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>();
+
+  sprokit::config_t const configr = shm_config(segment);
+
+  configr->set_value("type", "integer");
+
+  pipeline->add_process(create_process("shm_input", "receive", configr));
+
+  if (output.empty())
+  {
+    pipeline->add_process(create_process("sink", "sink"));
+
+    pipeline->connect("receive", "receive",
+                      "sink", "sink");
+  }
+  else
+  {
+    sprokit::config_t const configt = sprokit::config::empty_config();
+
+    configt->set_value("output", output);
+
+    pipeline->add_process(create_process("print_number", "sink", configt));
+
+    pipeline->connect("receive", "receive",
+                      "sink", "number");
+  }
+
+  return pipeline;
+}
+
+void
+run_shm_pipelines(std::string const& segment, int32_t start, int32_t end, std::string const& output)
+{
+  // The sides of a ring are not connected to each other, so they cannot be
+  // in the same pipeline.
+  sprokit::scheduler_t const writer = start_pipeline(shm_writer_pipeline(segment, start, end));
+
+  run_pipeline(shm_reader_pipeline(segment, output));
+
+  writer->wait();
+}
+
+sprokit::config_t
+shm_config(std::string const& segment)
+{
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("segment", segment);
+  conf->set_value("capacity", boost::lexical_cast<sprokit::config::value_t>(shm_capacity));
+
+  return conf;
+}
+
+sprokit::config_t
+numbers_config(int32_t start, int32_t end)
+{
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("start", boost::lexical_cast<sprokit::config::value_t>(start));
+  conf->set_value("end", boost::lexical_cast<sprokit::config::value_t>(end));
+
+  return conf;
+}
+
+records_t
+make_records(size_t count, size_t record_size)
+{
+  records_t records;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    // Without a fixed size, the records vary in length (including empty).
+    size_t const size = (record_size ? record_size : (i * 7) % 97);
+
+    std::string rec(size, char('a' + i % 26));
+
+    std::string const index = boost::lexical_cast<std::string>(i);
+
+    rec.replace(0, std::min(size, index.size()), index, 0, std::min(size, index.size()));
+
+    records.push_back(rec);
+  }
+
+  return records;
+}
+
+std::string
+record_file(records_t const& records, size_t record_size)
+{
+  std::string bytes;
+
+  BOOST_FOREACH (std::string const& rec, records)
+  {
+    if (!record_size)
+    {
+      uint32_t const length = rec.size();
+
+      bytes.append(reinterpret_cast<char const*>(&length), sizeof(length));
+    }
+
+    bytes.append(rec);
+  }
+
+  return bytes;
+}
+
+void
+write_file(std::string const& path, std::string const& bytes)
+{
+  std::ofstream fout(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+  fout.write(bytes.data(), bytes.size());
+
+  if (!fout.good())
+  {
+    TEST_ERROR("Failed to write the file " << path);
+  }
+}
+
+std::string
+read_file(std::string const& path)
+{
+  std::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the file " << path);
+
+    return std::string();
+  }
+
+  std::ostringstream sstr;
+
+  sstr << fin.rdbuf();
+
+  return sstr.str();
+}
+
+sprokit::pipeline_t
+record_pipeline(std::string const& input, size_t record_size, sprokit::config_t const& sink_config)
+{
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>();
+
+  sprokit::config_t const configs = sprokit::config::empty_config();
+
+  configs->set_value("path", input);
+  configs->set_value("record_size", boost::lexical_cast<sprokit::config::value_t>(record_size));
+
+  pipeline->add_process(create_process("mmap_source", "source", configs));
+  pipeline->add_process(create_process("record_sink", "sink", sink_config));
+
+  pipeline->connect("source", "record",
+                    "sink", "record");
+
+  return pipeline;
+}
+
+sprokit::config_t
+record_sink_config(std::string const& output, size_t record_size)
+{
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("path", output);
+  conf->set_value("record_size", boost::lexical_cast<sprokit::config::value_t>(record_size));
+
+  return conf;
+}
+
+void
+check_record_copy(std::string const& test, sprokit::config_t const& sink_config)
+{
+  std::string const input_path = "test-transport-" + test + ".in";
+  std::string const output_path = sink_config->get_value<std::string>("path");
+  size_t const record_size = sink_config->get_value<size_t>("record_size");
+
+  std::string const bytes = record_file(make_records(2000, record_size), record_size);
+
+  write_file(input_path, bytes);
+
+  run_pipeline(record_pipeline(input_path, record_size, sink_config));
+
+  if (read_file(output_path) != bytes)
+  {
+    TEST_ERROR("The records were not written back in order");
+  }
+}
+
+void
+push_record(sprokit::edge_t const& edge, sprokit::stamp_t& stamp, std::string const& bytes)
+{
+  push_datum(edge, stamp, sprokit::datum::new_datum(sprokit::record(bytes)));
+}
+
+void
+push_datum(sprokit::edge_t const& edge, sprokit::stamp_t& stamp, sprokit::datum_t const& dat)
+{
+  edge->push_datum(sprokit::edge_datum_t(dat, stamp));
+
+  stamp = sprokit::stamp::incremented_stamp(stamp);
+}
+
+sprokit::pipeline_t
+tap_pipeline(std::string const& path)
+{
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>();
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("path", path);
+
+  pipeline->add_process(create_process("tap", "tap", conf));
+  pipeline->add_process(create_process("sink", "sink"));
+
+  pipeline->connect("tap", "tap",
+                    "sink", "sink");
+
+  return pipeline;
+}
+
+sprokit::pipeline_t
+replay_pipeline(std::string const& path, std::string const& timing, std::string const& output)
+{
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>();
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("path", path);
+  conf->set_value("timing", timing);
+
+  pipeline->add_process(create_process("replay", "replay", conf));
+
+  if (output.empty())
+  {
+    pipeline->add_process(create_process("sink", "sink"));
+
+    pipeline->connect("replay", "replay",
+                      "sink", "sink");
+  }
+  else
+  {
+    sprokit::config_t const configt = sprokit::config::empty_config();
+
+    configt->set_value("output", output);
+
+    pipeline->add_process(create_process("print_number", "sink", configt));
+
+    pipeline->connect("replay", "replay",
+                      "sink", "number");
+  }
+
+  return pipeline;
+}
+
+sprokit::pipeline_t
+socket_output_pipeline(std::string const& address, std::string const& connect_timeout)
+{
+  sprokit::pipeline_t const pipeline = boost::make_shared<sprokit::pipeline>();
+
+  sprokit::config_t const conf = sprokit::config::empty_config();
+
+  conf->set_value("address", address);
+  conf->set_value("connect_timeout", connect_timeout);
+
+  pipeline->add_process(create_process("numbers", "numbers", numbers_config(0, 10)));
+  pipeline->add_process(create_process("socket_output", "send", conf));
+
+  pipeline->connect("numbers", "number",
+                    "send", "send");
+
+  return pipeline;
+}
@@ -0,0 +1,399 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <test_common.h>
+
+#include <sprokit/scoring/statistics.h>
+
+#include <boost/foreach.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+
+#include <algorithm>
+#include <limits>
+
+#include <cmath>
+#include <cstddef>
+
+#define TEST_ARGS ()
+
+DECLARE_TEST_MAP();
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(1);
+
+  testname_t const testname = argv[1];
+
+  RUN_TEST(testname);
+}
+
+static sprokit::statistics::data_points_t spread_points();
+static bool is_close(double a, double b, double tolerance);
+static void check_quantiles(sprokit::statistics const& stats, sprokit::statistics::data_points_t pts);
+
+static double const relative_accuracy = 0.01;
+
+IMPLEMENT_TEST(moments)
+{
+  sprokit::statistics::data_points_t pts;
+
+  pts.push_back(2);
+  pts.push_back(4);
+  pts.push_back(4);
+  pts.push_back(4);
+  pts.push_back(5);
+  pts.push_back(5);
+  pts.push_back(7);
+  pts.push_back(9);
+
+  sprokit::statistics const stats(pts);
+
+  if (stats.count() != pts.size())
+  {
+    TEST_ERROR("The count is not the number of samples");
+  }
+
+  if (!is_close(stats.sum(), 40, 1e-12))
+  {
+    TEST_ERROR("The sum is incorrect: " << stats.sum());
+  }
+
+  if (!is_close(stats.minimum(), 2, 1e-12) ||
+      !is_close(stats.maximum(), 9, 1e-12) ||
+      !is_close(stats.range(), 7, 1e-12))
+  {
+    TEST_ERROR("The extremes are incorrect");
+  }
+
+  if (!is_close(stats.mean(), 5, 1e-12))
+  {
+    TEST_ERROR("The mean is incorrect: " << stats.mean());
+  }
+
+  if (!is_close(stats.variance(), 4, 1e-12) ||
+      !is_close(stats.standard_deviation(), 2, 1e-12))
+  {
+    TEST_ERROR("The variance is incorrect: " << stats.variance());
+  }
+}
+
+IMPLEMENT_TEST(quantile_accuracy)
+{
+  sprokit::statistics::data_points_t const pts = spread_points();
+
+  sprokit::statistics const stats(pts);
+
+  check_quantiles(stats, pts);
+}
+
+IMPLEMENT_TEST(quantile_empty)
+{
+  sprokit::statistics const stats;
+
+  if (!boost::math::isnan(stats.quantile(0.5)))
+  {
+    TEST_ERROR("A quantile of no samples is not NaN");
+  }
+}
+
+IMPLEMENT_TEST(add_point)
+{
+  sprokit::statistics::data_points_t const pts = spread_points();
+
+  sprokit::statistics stats;
+
+  BOOST_FOREACH (sprokit::statistics::data_point_t const& pt, pts)
+  {
+    stats.add_point(pt);
+  }
+
+  sprokit::statistics const batch(pts);
+
+  if (stats.count() != batch.count())
+  {
+    TEST_ERROR("Adding points one at a time gave a different count");
+  }
+
+  if (!is_close(stats.mean(), batch.mean(), 1e-9) ||
+      !is_close(stats.variance(), batch.variance(), 1e-9))
+  {
+    TEST_ERROR("Adding points one at a time gave different moments");
+  }
+
+  if (stats.histogram() != batch.histogram())
+  {
+    TEST_ERROR("Adding points one at a time gave a different histogram");
+  }
+}
+
+IMPLEMENT_TEST(merge)
+{
+  sprokit::statistics::data_points_t const pts = spread_points();
+  sprokit::statistics::data_points_t::const_iterator const middle = pts.begin() + pts.size() / 3;
+
+  sprokit::statistics const whole(pts);
+
+  sprokit::statistics merged(sprokit::statistics::data_points_t(pts.begin(), middle));
+  sprokit::statistics const other(sprokit::statistics::data_points_t(middle, pts.end()));
+  sprokit::statistics const empty;
+
+  merged.merge(other);
+  merged.merge(empty);
+
+  if (merged.count() != whole.count())
+  {
+    TEST_ERROR("The merged count is incorrect");
+  }
+
+  if (!is_close(merged.sum(), whole.sum(), 1e-9) ||
+      !is_close(merged.mean(), whole.mean(), 1e-9) ||
+      !is_close(merged.variance(), whole.variance(), 1e-9))
+  {
+    TEST_ERROR("The merged moments are incorrect");
+  }
+
+  if (!is_close(merged.minimum(), whole.minimum(), 1e-12) ||
+      !is_close(merged.maximum(), whole.maximum(), 1e-12))
+  {
+    TEST_ERROR("The merged extremes are incorrect");
+  }
+
+  if (merged.histogram() != whole.histogram())
+  {
+    TEST_ERROR("The merged histogram is incorrect");
+  }
+
+  check_quantiles(merged, pts);
+}
+
+IMPLEMENT_TEST(bin_folding)
+{
+  static size_t const max_bins = 2048;
+
+  // Each sample lands in its own bin, so the smallest ones must be folded.
+  sprokit::statistics::data_points_t pts;
+
+  for (size_t i = 0; i < 3 * max_bins; ++i)
+  {
+    pts.push_back(std::pow(1.05, double(i)) * 1e-100);
+  }
+
+  sprokit::statistics const stats(pts);
+  sprokit::statistics::histogram_t const hist = stats.histogram();
+
+  if (max_bins < hist.size())
+  {
+    TEST_ERROR("The histogram was not bounded: " << hist.size() << " bins");
+  }
+
+  size_t total = 0;
+
+  BOOST_FOREACH (sprokit::statistics::bin_t const& bin, hist)
+  {
+    total += bin.second;
+  }
+
+  if (total != pts.size())
+  {
+    TEST_ERROR("Folding bins lost samples: " << total << " of " << pts.size());
+  }
+
+  // The largest magnitudes keep their accuracy.
+  double const q = 0.99;
+  double const expect = pts[size_t(q * (pts.size() - 1))];
+
+  if (!is_close(stats.quantile(q), expect, relative_accuracy))
+  {
+    TEST_ERROR("The upper quantile lost accuracy: "
+               "Expected: " << expect << " "
+               "Received: " << stats.quantile(q));
+  }
+}
+
+IMPLEMENT_TEST(histogram)
+{
+  sprokit::statistics::data_points_t pts;
+
+  pts.push_back(100);
+  pts.push_back(1);
+  pts.push_back(0);
+  pts.push_back(-2);
+  pts.push_back(1);
+  pts.push_back(0);
+  pts.push_back(1);
+
+  sprokit::statistics const stats(pts);
+  sprokit::statistics::histogram_t const hist = stats.histogram();
+
+  if (hist.size() != 4)
+  {
+    TEST_ERROR("The histogram has the wrong number of bins: " << hist.size());
+
+    return;
+  }
+
+  if ((hist[0].second != 1) ||
+      (hist[1].second != 2) ||
+      (hist[2].second != 3) ||
+      (hist[3].second != 1))
+  {
+    TEST_ERROR("The histogram has the wrong counts");
+  }
+
+  if ((hist[1].first < 0) || (0 < hist[1].first) ||
+      !(hist[0].first < hist[1].first) ||
+      !(hist[1].first < hist[2].first) ||
+      !(hist[2].first < hist[3].first))
+  {
+    TEST_ERROR("The histogram is not in increasing order");
+  }
+
+  // Bins hold the samples up to their limit, so the limit is no smaller.
+  if ((hist[2].first < 1) || !is_close(hist[2].first, 1, 2 * relative_accuracy) ||
+      (hist[3].first < 100) || !is_close(hist[3].first, 100, 2 * relative_accuracy))
+  {
+    TEST_ERROR("The positive bin limits are incorrect");
+  }
+
+  if (!is_close(hist[0].first, -2, 2 * relative_accuracy))
+  {
+    TEST_ERROR("The negative bin limit is incorrect: " << hist[0].first);
+  }
+}
+
+IMPLEMENT_TEST(nan)
+{
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+
+  sprokit::statistics::data_points_t pts;
+
+  pts.push_back(1);
+  pts.push_back(nan);
+  pts.push_back(3);
+
+  sprokit::statistics stats(pts, true);
+
+  stats.add_point(nan);
+
+  if (stats.count() != 2)
+  {
+    TEST_ERROR("NaN samples were counted");
+  }
+
+  if (!is_close(stats.mean(), 2, 1e-12) ||
+      !is_close(stats.variance(), 1, 1e-12))
+  {
+    TEST_ERROR("NaN samples affected the moments");
+  }
+
+  if (!is_close(stats.median(), 1, relative_accuracy))
+  {
+    TEST_ERROR("NaN samples affected the quantiles");
+  }
+
+  if (stats.data().size() != 2)
+  {
+    TEST_ERROR("NaN samples were kept");
+  }
+}
+
+IMPLEMENT_TEST(keep_data)
+{
+  sprokit::statistics::data_points_t pts;
+
+  pts.push_back(3);
+  pts.push_back(1);
+  pts.push_back(2);
+
+  sprokit::statistics const dropped(pts);
+
+  if (!dropped.data().empty())
+  {
+    TEST_ERROR("Samples were kept without being requested");
+  }
+
+  sprokit::statistics kept(pts, true);
+
+  kept.add_point(4);
+  kept.merge(sprokit::statistics(pts));
+
+  sprokit::statistics::data_points_t expect = pts;
+
+  expect.push_back(4);
+
+  if (kept.data() != expect)
+  {
+    TEST_ERROR("The kept samples are incorrect");
+  }
+}
+
+sprokit::statistics::data_points_t
+spread_points()
+{
+  sprokit::statistics::data_points_t pts;
+
+  // Negative, zero and positive samples over several orders of magnitude.
+  for (int i = -1000; i <= 5000; ++i)
+  {
+    pts.push_back(i * std::fabs(double(i)) / 7);
+  }
+
+  // The order must not matter.
+  std::reverse(pts.begin() + pts.size() / 2, pts.end());
+
+  return pts;
+}
+
+bool
+is_close(double a, double b, double tolerance)
+{
+  return (std::fabs(a - b) <= tolerance * std::max(std::fabs(a), std::fabs(b)));
+}
+
+void
+check_quantiles(sprokit::statistics const& stats, sprokit::statistics::data_points_t pts)
+{
+  std::sort(pts.begin(), pts.end());
+
+  for (size_t i = 0; i <= 100; ++i)
+  {
+    double const q = i / 100.;
+    double const expect = pts[size_t(q * (pts.size() - 1))];
+    double const received = stats.quantile(q);
+
+    if (!is_close(received, expect, relative_accuracy))
+    {
+      TEST_ERROR("The quantile " << q << " is not within the accuracy: "
+                 "Expected: " << expect << " "
+                 "Received: " << received);
+    }
+  }
+}
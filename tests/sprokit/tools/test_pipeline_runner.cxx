@@ -0,0 +1,478 @@
+/*ckwg +29
+ * Copyright 2014 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <test_common.h>
+
+#include <sprokit/pipeline_util/path.h>
+
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/datum_codec.h>
+#include <sprokit/pipeline/edge.h>
+#include <sprokit/pipeline/modules.h>
+#include <sprokit/pipeline/stamp.h>
+
+#include <boost/cstdint.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_ARGS (sprokit::path_t const& runner, sprokit::path_t const& pipe_dir)
+
+DECLARE_TEST_MAP();
+
+static std::string const pipe_ext = ".pipe";
+
+int
+main(int argc, char* argv[])
+{
+  CHECK_ARGS(3);
+
+  testname_t const testname = argv[1];
+  sprokit::path_t const runner = argv[2];
+  sprokit::path_t const pipe_dir = argv[3];
+
+  RUN_TEST(testname, runner, pipe_dir);
+}
+
+static bool run_command(std::string const& command);
+static void check_numbers(std::string const& path, int32_t start, int32_t end);
+static void run_jobs(sprokit::path_t const& runner, sprokit::path_t const& pipe, std::string const& jobs, size_t count);
+static std::string read_file(std::string const& path);
+static pid_t start_command(std::string const& command);
+static bool wait_for_command(pid_t pid);
+
+typedef std::vector<sprokit::edge_datum_t> edge_data_t;
+
+static edge_data_t node_data(size_t count, sprokit::stamp::stream_t other_stream);
+static void write_recording(std::string const& path, edge_data_t const& data);
+static edge_data_t read_recording(std::string const& path);
+
+static sprokit::process::port_type_t const recording_type = sprokit::process::port_type_t("integer");
+// The layout of a recording as written by the tap process.
+static char const recording_magic[8] = { 'S', 'P', 'R', 'K', 'R', 'E', 'C', '\0' };
+static uint32_t const recording_version = 2;
+
+IMPLEMENT_TEST(partition)
+{
+  sprokit::path_t const send_pipe = pipe_dir / ("partition_shm_send" + pipe_ext);
+  sprokit::path_t const receive_pipe = pipe_dir / ("partition_shm_receive" + pipe_ext);
+  std::string const segment = "sprokit-test-pipeline_runner-partition-" + boost::lexical_cast<std::string>(getpid());
+  std::string const output_path = "test-pipeline_runner-partition-print_number.txt";
+
+  std::ostringstream sstr;
+
+  sstr << runner << " "
+          "--partition " << send_pipe << " "
+          "--partition " << receive_pipe << " "
+          "--setting send:segment=" << segment << " "
+          "--setting receive:segment=" << segment << " "
+          "--setting sink:output=" << output_path;
+
+  if (!run_command(sstr.str()))
+  {
+    TEST_ERROR("The partitions did not run successfully");
+  }
+
+  check_numbers(output_path, 1, 200);
+}
+
+IMPLEMENT_TEST(server)
+{
+  sprokit::path_t const pipe = pipe_dir / ("server_tunable" + pipe_ext);
+  std::string const recording_path = "test-pipeline_runner-server-tap.rec";
+
+  run_jobs(runner, pipe, "tunable:tunable=changed\\n", 1);
+
+  if (read_file(recording_path).find("changed") == std::string::npos)
+  {
+    TEST_ERROR("The job did not see its tunable value");
+  }
+
+  // The second job does not set the tunable value, so it must see the value
+  // from the pipeline again rather than the one from the first job.
+  run_jobs(runner, pipe, "tunable:tunable=changed\\n\\n", 2);
+
+  std::string const recording = read_file(recording_path);
+
+  if (recording.find("base") == std::string::npos)
+  {
+    TEST_ERROR("The second job did not see the original tunable value");
+  }
+
+  if (recording.find("changed") != std::string::npos)
+  {
+    TEST_ERROR("The second job saw the tunable value from the first job");
+  }
+}
+
+TEST_PROPERTY(TIMEOUT, 60)
+IMPLEMENT_TEST(partition_nodes)
+{
+  sprokit::load_known_modules();
+
+  sprokit::path_t const pipe = pipe_dir / ("partition_nodes" + pipe_ext);
+  std::string const input_path = "test-pipeline_runner-partition_nodes.rec";
+  std::string const output_path = "test-pipeline_runner-partition_nodes-tap.rec";
+  std::string const unique = boost::lexical_cast<std::string>(getpid());
+  std::string const unix_address = "unix:test-pipeline_runner-partition_nodes-" + unique + ".sock";
+  std::string const tcp_address = "tcp:127.0.0.1:" + boost::lexical_cast<std::string>(20000 + (getpid() % 20000));
+
+  // The receivers only grant a few credits at a time, so the senders have to
+  // wait on them many times over.
+  size_t const window = 2;
+  size_t const count = 200;
+
+  edge_data_t const input = node_data(count, sprokit::stamp::stream_t(3));
+
+  write_recording(input_path, input);
+
+  std::ostringstream sstr;
+
+  sstr << runner << " "
+          "--pipeline " << pipe << " "
+          "--setting _pipeline:_nodes:a=" << unix_address << " "
+          "--setting _pipeline:_nodes:b=" << tcp_address << " "
+          "--setting _recv_0:window=" << window << " "
+          "--setting _recv_1:window=" << window << " "
+          "--setting source:path=" << input_path << " "
+          "--setting tap:path=" << output_path << " "
+          "--node ";
+
+  std::string const command = sstr.str();
+
+  pid_t const node_b = start_command(command + "b");
+  pid_t const node_a = start_command(command + "a");
+
+  bool const a_success = wait_for_command(node_a);
+  bool const b_success = wait_for_command(node_b);
+
+  if (!a_success || !b_success)
+  {
+    TEST_ERROR("The nodes did not run successfully");
+
+    return;
+  }
+
+  edge_data_t const output = read_recording(output_path);
+
+  if (output.size() != input.size())
+  {
+    TEST_ERROR("The nodes passed " << output.size() << " data "
+               "rather than " << input.size());
+
+    return;
+  }
+
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    sprokit::edge_datum_t const& expect = input[i];
+    sprokit::edge_datum_t const& edat = output[i];
+
+    if (edat.stamp->stream() != expect.stamp->stream())
+    {
+      TEST_ERROR("Datum " << i << " arrived in stream " << edat.stamp->stream() << " "
+                 "rather than " << expect.stamp->stream());
+    }
+
+    if (edat.stamp->index() != expect.stamp->index())
+    {
+      TEST_ERROR("Datum " << i << " arrived with index " << edat.stamp->index() << " "
+                 "rather than " << expect.stamp->index());
+    }
+
+    if (edat.datum->type() != expect.datum->type())
+    {
+      TEST_ERROR("Datum " << i << " arrived with the wrong datum type");
+    }
+    else if ((expect.datum->type() == sprokit::datum::data) &&
+             (edat.datum->get_datum<int32_t>() != expect.datum->get_datum<int32_t>()))
+    {
+      TEST_ERROR("Datum " << i << " has the wrong payload: "
+                 "Expected: " << expect.datum->get_datum<int32_t>() << " "
+                 "Received: " << edat.datum->get_datum<int32_t>());
+    }
+  }
+}
+
+bool
+run_command(std::string const& command)
+{
+  int const status = std::system(command.c_str());
+
+  return ((status != -1) && WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS));
+}
+
+void
+check_numbers(std::string const& path, int32_t start, int32_t end)
+{
+  std::ifstream fin(path.c_str());
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the output file");
+
+    return;
+  }
+
+  std::string line;
+
+  for (int32_t i = start; i < end; ++i)
+  {
+    if (!std::getline(fin, line))
+    {
+      TEST_ERROR("Failed to read a line from the file");
+
+      return;
+    }
+
+    if (line != boost::lexical_cast<std::string>(i))
+    {
+      TEST_ERROR("Did not get expected value: "
+                 "Expected: " << i << " "
+                 "Received: " << line);
+    }
+  }
+
+  if (std::getline(fin, line))
+  {
+    TEST_ERROR("More results than expected in the file");
+  }
+}
+
+void
+run_jobs(sprokit::path_t const& runner, sprokit::path_t const& pipe, std::string const& jobs, size_t count)
+{
+  std::string const replies_path = "test-pipeline_runner-server-replies.txt";
+
+  std::ostringstream sstr;
+
+  sstr << "printf '" << jobs << "quit\\n' | "
+       << runner << " --server "
+          "--pipeline " << pipe << " "
+          "> " << replies_path;
+
+  if (!run_command(sstr.str()))
+  {
+    TEST_ERROR("The server did not run successfully");
+
+    return;
+  }
+
+  std::ifstream fin(replies_path.c_str());
+  std::string line;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    std::string const expect = "ok " + boost::lexical_cast<std::string>(i) + " ";
+
+    if (!std::getline(fin, line))
+    {
+      TEST_ERROR("Did not get a reply for job " << i);
+
+      return;
+    }
+
+    if (line.compare(0, expect.size(), expect))
+    {
+      TEST_ERROR("Job " << i << " did not succeed: " << line);
+    }
+  }
+
+  if (std::getline(fin, line))
+  {
+    TEST_ERROR("More replies than expected: " << line);
+  }
+}
+
+std::string
+read_file(std::string const& path)
+{
+  std::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+
+  if (!fin.good())
+  {
+    TEST_ERROR("Could not open the file " << path);
+
+    return std::string();
+  }
+
+  std::ostringstream sstr;
+
+  sstr << fin.rdbuf();
+
+  return sstr.str();
+}
+
+pid_t
+start_command(std::string const& command)
+{
+  pid_t const pid = fork();
+
+  if (!pid)
+  {
+    execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(NULL));
+
+    _exit(EXIT_FAILURE);
+  }
+
+  return pid;
+}
+
+bool
+wait_for_command(pid_t pid)
+{
+  int status;
+
+  if (pid < 0)
+  {
+    return false;
+  }
+
+  if (waitpid(pid, &status, 0) != pid)
+  {
+    return false;
+  }
+
+  return (WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS));
+}
+
+edge_data_t
+node_data(size_t count, sprokit::stamp::stream_t other_stream)
+{
+  edge_data_t data;
+
+  // The indices a replay gives its data: each stream counts on its own.
+  sprokit::stamp::index_t default_index = 0;
+  sprokit::stamp::index_t other_index = 0;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    bool const other = !(i % 3);
+    sprokit::stamp::stream_t const stream = (other ? other_stream : sprokit::stamp::default_stream);
+    sprokit::stamp::index_t& index = (other ? other_index : default_index);
+
+    data.push_back(sprokit::edge_datum_t(sprokit::datum::new_datum(int32_t(i)),
+                                         sprokit::stamp::restored_stamp(1, index++, stream)));
+  }
+
+  data.push_back(sprokit::edge_datum_t(sprokit::datum::complete_datum(),
+                                       sprokit::stamp::restored_stamp(1, other_index, other_stream)));
+  data.push_back(sprokit::edge_datum_t(sprokit::datum::complete_datum(),
+                                       sprokit::stamp::restored_stamp(1, default_index)));
+
+  return data;
+}
+
+void
+write_recording(std::string const& path, edge_data_t const& data)
+{
+  std::ofstream fout(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+  uint32_t const type_length = recording_type.size();
+
+  fout.write(recording_magic, sizeof(recording_magic));
+  fout.write(reinterpret_cast<char const*>(&recording_version), sizeof(recording_version));
+  fout.write(reinterpret_cast<char const*>(&type_length), sizeof(type_length));
+  fout.write(recording_type.data(), type_length);
+
+  BOOST_FOREACH (sprokit::edge_datum_t const& edat, data)
+  {
+    sprokit::datum_codec::bytes_t const bytes = sprokit::datum_codec::encode(recording_type, edat);
+    uint64_t const offset = 0;
+    uint32_t const length = bytes.size();
+
+    fout.write(reinterpret_cast<char const*>(&offset), sizeof(offset));
+    fout.write(reinterpret_cast<char const*>(&length), sizeof(length));
+    fout.write(bytes.data(), length);
+  }
+
+  if (!fout.good())
+  {
+    TEST_ERROR("Failed to write the recording " << path);
+  }
+}
+
+edge_data_t
+read_recording(std::string const& path)
+{
+  std::string const contents = read_file(path);
+  size_t const header_size = sizeof(recording_magic) + sizeof(uint32_t) + sizeof(uint32_t) + recording_type.size();
+
+  edge_data_t data;
+
+  if ((contents.size() < header_size) || memcmp(contents.data(), recording_magic, sizeof(recording_magic)))
+  {
+    TEST_ERROR("The file " << path << " is not a recording");
+
+    return data;
+  }
+
+  size_t pos = header_size;
+
+  while (pos < contents.size())
+  {
+    uint32_t length;
+
+    pos += sizeof(uint64_t);
+
+    if (contents.size() < pos + sizeof(length))
+    {
+      TEST_ERROR("A record in " << path << " is truncated");
+
+      break;
+    }
+
+    memcpy(&length, contents.data() + pos, sizeof(length));
+    pos += sizeof(length);
+
+    if (contents.size() - pos < length)
+    {
+      TEST_ERROR("A record in " << path << " is truncated");
+
+      break;
+    }
+
+    data.push_back(sprokit::datum_codec::decode(recording_type, contents.substr(pos, length)));
+    pos += length;
+  }
+
+  return data;
+}